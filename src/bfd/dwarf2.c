@@ -124,6 +124,25 @@ struct dwarf2_debug
      calling chain for subsequent calls to bfd_find_inliner_info to
      use. */
   struct funcinfo *inliner_chain;
+
+  /* APPLE LOCAL begin sorted unit ranges  */
+  /* The number of units in ALL_COMP_UNITS.  */
+  unsigned int comp_unit_count;
+
+  /* The address ranges of the first INDEXED_UNIT_COUNT units read,
+     sorted by low address, so that _bfd_dwarf2_find_nearest_line
+     need not walk every unit it has read.  Units read since are
+     checked one at a time until the index is rebuilt.  */
+  struct unit_range *unit_ranges;
+  unsigned int unit_range_count;
+  unsigned int indexed_unit_count;
+
+  /* Indexed units whose address ranges grew after the index was
+     built (see decode_line_info); these too are checked one at a
+     time.  */
+  struct comp_unit *changed_units;
+  unsigned int changed_unit_count;
+  /* APPLE LOCAL end sorted unit ranges  */
 };
 
 struct arange
@@ -133,6 +152,21 @@ struct arange
   bfd_vma high;
 };
 
+/* APPLE LOCAL begin sorted unit ranges  */
+/* One entry of the sorted unit range index.  */
+
+struct unit_range
+{
+  bfd_vma low;
+  bfd_vma high;
+
+  /* The largest HIGH of this and all preceding entries.  */
+  bfd_vma max_high;
+
+  struct comp_unit *unit;
+};
+/* APPLE LOCAL end sorted unit ranges  */
+
 /* A minimal decoding of DWARF2 compilation units.  We only decode
    what's needed to get to the line number information.  */
 
@@ -197,6 +231,16 @@ struct comp_unit
   /* Base address for this unit - from DW_AT_low_pc attribute of
      DW_TAG_compile_unit DIE */
   bfd_vma base_address;
+
+  /* APPLE LOCAL begin sorted unit ranges  */
+  /* The order in which this unit was read; units read later come
+     first in the stash's ALL_COMP_UNITS.  */
+  unsigned int unit_number;
+
+  /* Non-zero if this unit is on the stash's CHANGED_UNITS list.  */
+  int ranges_changed;
+  struct comp_unit *next_changed_unit;
+  /* APPLE LOCAL end sorted unit ranges  */
 };
 
 /* This data structure holds the information of an abbrev.  */
@@ -706,6 +750,12 @@ struct line_info_table
   struct fileinfo* files;
   struct line_info* last_line;  /* largest VMA */
   struct line_info* lcl_head;   /* local head; used in 'add_line_info' */
+  /* APPLE LOCAL begin sorted line table  */
+  /* The entries of 'last_line' in ascending order, built on the first
+     lookup by 'lookup_address_in_line_info_table'.  */
+  struct line_info** sorted_lines;
+  unsigned int num_sorted_lines;
+  /* APPLE LOCAL end sorted line table  */
 };
 
 /* Remember some information about each function.  If the function is
@@ -923,6 +973,36 @@ arange_add (bfd *abfd, struct arange *first_arange, bfd_vma low_pc, bfd_vma high
   first_arange->next = arange;
 }
 
+/* APPLE LOCAL begin sorted unit ranges  */
+/* UNIT is about to have LOW_PC..HIGH_PC added to its address ranges.
+   If that may change which addresses UNIT contains and UNIT is in the
+   stash's sorted range index, put UNIT on the list of units that the
+   index no longer describes.  */
+
+static void
+note_unit_range_change (struct comp_unit *unit,
+			bfd_vma low_pc, bfd_vma high_pc)
+{
+  struct dwarf2_debug *stash = unit->stash;
+  struct arange *arange;
+
+  if (unit->ranges_changed
+      || unit->unit_number >= stash->indexed_unit_count
+      || low_pc == high_pc)
+    return;
+
+  if (low_pc < high_pc)
+    for (arange = &unit->arange; arange; arange = arange->next)
+      if (arange->low <= low_pc && high_pc <= arange->high)
+	return;
+
+  unit->ranges_changed = 1;
+  unit->next_changed_unit = stash->changed_units;
+  stash->changed_units = unit;
+  stash->changed_unit_count++;
+}
+/* APPLE LOCAL end sorted unit ranges  */
+
 /* Decode the line number information for UNIT.  */
 
 static struct line_info_table*
@@ -982,6 +1062,10 @@ decode_line_info (struct comp_unit *unit, struct dwarf2_debug *stash)
   table->files = NULL;
   table->last_line = NULL;
   table->lcl_head = NULL;
+  /* APPLE LOCAL begin sorted line table  */
+  table->sorted_lines = NULL;
+  table->num_sorted_lines = 0;
+  /* APPLE LOCAL end sorted line table  */
 
   line_ptr = stash->dwarf_line_buffer + unit->line_offset;
 
@@ -1152,6 +1236,8 @@ decode_line_info (struct comp_unit *unit, struct dwarf2_debug *stash)
 		    low_pc = address;
 		  if (address > high_pc)
 		    high_pc = address;
+		  /* APPLE LOCAL sorted unit ranges  */
+		  note_unit_range_change (unit, low_pc, high_pc);
 		  arange_add (unit->abfd, &unit->arange, low_pc, high_pc);
 		  break;
 		case DW_LNE_set_address:
@@ -1267,6 +1353,32 @@ decode_line_info (struct comp_unit *unit, struct dwarf2_debug *stash)
   return table;
 }
 
+/* APPLE LOCAL begin sorted line table  */
+/* Fill in TABLE's 'sorted_lines', the reverse of its 'last_line'
+   list.  Return FALSE if we run out of memory.  */
+
+static bfd_boolean
+sort_line_info_table (struct line_info_table *table)
+{
+  struct line_info* each_line;
+  unsigned int count = 0;
+  bfd_size_type amt;
+
+  for (each_line = table->last_line; each_line; each_line = each_line->prev_line)
+    count++;
+
+  amt = (bfd_size_type) count * sizeof (struct line_info *);
+  table->sorted_lines = bfd_alloc (table->abfd, amt);
+  if (table->sorted_lines == NULL)
+    return FALSE;
+
+  table->num_sorted_lines = count;
+  for (each_line = table->last_line; each_line; each_line = each_line->prev_line)
+    table->sorted_lines[--count] = each_line;
+
+  return TRUE;
+}
+
 /* If ADDR is within TABLE set the output parameters and return TRUE,
    otherwise return FALSE.  The output parameters, FILENAME_PTR and
    LINENUMBER_PTR, are pointers to the objects to be filled in.  */
@@ -1278,63 +1390,65 @@ lookup_address_in_line_info_table (struct line_info_table *table,
 				   const char **filename_ptr,
 				   unsigned int *linenumber_ptr)
 {
-  /* Note: table->last_line should be a descendingly sorted list. */
-  struct line_info* next_line = table->last_line;
-  struct line_info* each_line = NULL;
+  struct line_info** lines;
+  struct line_info* next_line;
+  struct line_info* each_line;
+  unsigned int lo, hi;
   *filename_ptr = NULL;
 
-  if (!next_line)
+  if (!table->last_line)
     return FALSE;
 
-  each_line = next_line->prev_line;
+  if (!table->sorted_lines && !sort_line_info_table (table))
+    return FALSE;
+  lines = table->sorted_lines;
+
+  /* Find the first line whose address is above ADDR.  The line
+     before it, if any, is the only one whose range can contain
+     ADDR.  */
+  lo = 0;
+  hi = table->num_sorted_lines;
+  while (lo < hi)
+    {
+      unsigned int mid = (lo + hi) / 2;
 
-  /* Check for large addresses */
-  if (addr > next_line->address)
-    each_line = NULL; /* ensure we skip over the normal case */
+      if (lines[mid]->address <= addr)
+	lo = mid + 1;
+      else
+	hi = mid;
+    }
 
-  /* Normal case: search the list; save  */
-  while (each_line && next_line)
+  if (lo > 0 && lo < table->num_sorted_lines)
     {
-      /* If we have an address match, save this info.  This allows us
-	 to return as good as results as possible for strange debugging
-	 info.  */
-      bfd_boolean addr_match = FALSE;
-      if (each_line->address <= addr && addr < next_line->address)
-	{
-	  addr_match = TRUE;
+      each_line = lines[lo - 1];
+      next_line = lines[lo];
 
-	  /* If this line appears to span functions, and addr is in the
-	     later function, return the first line of that function instead
-	     of the last line of the earlier one.  This check is for GCC
-	     2.95, which emits the first line number for a function late.  */
+      /* If this line appears to span functions, and addr is in the
+	 later function, return the first line of that function instead
+	 of the last line of the earlier one.  This check is for GCC
+	 2.95, which emits the first line number for a function late.  */
 
-	  if (function != NULL)
+      if (function != NULL)
+	{
+	  bfd_vma lowest_pc;
+	  struct arange *arange;
+
+	  /* Find the lowest address in the function's range list */
+	  lowest_pc = function->arange.low;
+	  for (arange = &function->arange;
+	       arange;
+	       arange = arange->next)
 	    {
-	      bfd_vma lowest_pc;
-	      struct arange *arange;
-
-	      /* Find the lowest address in the function's range list */
-	      lowest_pc = function->arange.low;
-	      for (arange = &function->arange;
-		   arange;
-		   arange = arange->next)
-		{
-		  if (function->arange.low < lowest_pc)
-		    lowest_pc = function->arange.low;
-		}
-	      /* Check for spanning function and set outgoing line info */
-	      if (addr >= lowest_pc
-		  && each_line->address < lowest_pc
-		  && next_line->address > lowest_pc)
-		{
-		  *filename_ptr = next_line->filename;
-		  *linenumber_ptr = next_line->line;
-		}
-	      else
-		{
-		  *filename_ptr = each_line->filename;
-		  *linenumber_ptr = each_line->line;
-		}
+	      if (function->arange.low < lowest_pc)
+		lowest_pc = function->arange.low;
+	    }
+	  /* Check for spanning function and set outgoing line info */
+	  if (addr >= lowest_pc
+	      && each_line->address < lowest_pc
+	      && next_line->address > lowest_pc)
+	    {
+	      *filename_ptr = next_line->filename;
+	      *linenumber_ptr = next_line->line;
 	    }
 	  else
 	    {
@@ -1342,22 +1456,25 @@ lookup_address_in_line_info_table (struct line_info_table *table,
 	      *linenumber_ptr = each_line->line;
 	    }
 	}
+      else
+	{
+	  *filename_ptr = each_line->filename;
+	  *linenumber_ptr = each_line->line;
+	}
 
-      if (addr_match && !each_line->end_sequence)
+      if (!each_line->end_sequence)
 	return TRUE; /* we have definitely found what we want */
-
-      next_line = each_line;
-      each_line = each_line->prev_line;
     }
 
-  /* At this point each_line is NULL but next_line is not.  If we found
-     a candidate end-of-sequence point in the loop above, we can return
-     that (compatibility with a bug in the Intel compiler); otherwise,
-     assuming that we found the containing function for this address in
-     this compilation unit, return the first line we have a number for
-     (compatibility with GCC 2.95).  */
+  /* If we found a candidate end-of-sequence point above, we can
+     return that (compatibility with a bug in the Intel compiler);
+     otherwise, assuming that we found the containing function for
+     this address in this compilation unit, return the first line we
+     have a number for (compatibility with GCC 2.95).  For an address
+     past the end of the table that is the last line.  */
   if (*filename_ptr == NULL && function != NULL)
     {
+      next_line = addr > table->last_line->address ? table->last_line : lines[0];
       *filename_ptr = next_line->filename;
       *linenumber_ptr = next_line->line;
       return TRUE;
@@ -1365,6 +1482,7 @@ lookup_address_in_line_info_table (struct line_info_table *table,
 
   return FALSE;
 }
+/* APPLE LOCAL end sorted line table  */
 
 /* Read in the .debug_ranges section for future reference */
 
@@ -2001,6 +2119,166 @@ comp_unit_contains_address (struct comp_unit *unit, bfd_vma addr)
   return FALSE;
 }
 
+/* APPLE LOCAL begin sorted unit ranges  */
+/* Add UNIT, which has just been read, to the front of STASH's list of
+   compilation units.  */
+
+static void
+stash_add_comp_unit (struct dwarf2_debug *stash, struct comp_unit *unit)
+{
+  unit->unit_number = stash->comp_unit_count++;
+  unit->next_unit = stash->all_comp_units;
+  stash->all_comp_units = unit;
+}
+
+static int
+compare_unit_ranges (const void *a, const void *b)
+{
+  const struct unit_range *r1 = a;
+  const struct unit_range *r2 = b;
+
+  if (r1->low < r2->low)
+    return -1;
+  if (r1->low > r2->low)
+    return 1;
+  return 0;
+}
+
+/* Rebuild STASH's sorted index of the address ranges of every unit
+   read so far.  Return FALSE if we run out of memory.  */
+
+static bfd_boolean
+build_unit_range_index (struct dwarf2_debug *stash)
+{
+  struct comp_unit *each;
+  struct arange *arange;
+  struct unit_range *ranges;
+  bfd_size_type amt;
+  bfd_vma max_high;
+  unsigned int count;
+  unsigned int i;
+
+  count = 0;
+  for (each = stash->all_comp_units; each; each = each->next_unit)
+    for (arange = &each->arange; arange; arange = arange->next)
+      if (arange->low < arange->high)
+	count++;
+
+  amt = (bfd_size_type) count * sizeof (struct unit_range);
+  ranges = bfd_malloc (amt);
+  if (ranges == NULL && count != 0)
+    return FALSE;
+
+  i = 0;
+  for (each = stash->all_comp_units; each; each = each->next_unit)
+    for (arange = &each->arange; arange; arange = arange->next)
+      if (arange->low < arange->high)
+	{
+	  ranges[i].low = arange->low;
+	  ranges[i].high = arange->high;
+	  ranges[i].unit = each;
+	  i++;
+	}
+
+  if (count != 0)
+    qsort (ranges, count, sizeof (struct unit_range), compare_unit_ranges);
+
+  max_high = 0;
+  for (i = 0; i < count; i++)
+    {
+      if (ranges[i].high > max_high)
+	max_high = ranges[i].high;
+      ranges[i].max_high = max_high;
+    }
+
+  if (stash->unit_ranges)
+    free (stash->unit_ranges);
+  stash->unit_ranges = ranges;
+  stash->unit_range_count = count;
+  stash->indexed_unit_count = stash->comp_unit_count;
+
+  while (stash->changed_units)
+    {
+      each = stash->changed_units;
+      stash->changed_units = each->next_changed_unit;
+      each->next_changed_unit = NULL;
+      each->ranges_changed = 0;
+    }
+  stash->changed_unit_count = 0;
+
+  return TRUE;
+}
+
+/* Return the unit among those STASH has read that contains ADDR, or
+   NULL if there is none.  When several units contain ADDR this is
+   the one read last, the same unit a walk of ALL_COMP_UNITS calling
+   comp_unit_contains_address would find.  */
+
+static struct comp_unit *
+find_comp_unit_for_address (struct dwarf2_debug *stash, bfd_vma addr)
+{
+  struct comp_unit *each;
+  struct comp_unit *best;
+  unsigned int pending;
+  unsigned int lo, hi;
+
+  /* Rebuild the index once enough units are not described by it that
+     checking them one at a time costs more than sorting again.  */
+  pending = (stash->comp_unit_count - stash->indexed_unit_count
+	     + stash->changed_unit_count);
+  if (pending > 16 + stash->indexed_unit_count / 4
+      && ! build_unit_range_index (stash))
+    {
+      for (each = stash->all_comp_units; each; each = each->next_unit)
+	if (comp_unit_contains_address (each, addr))
+	  return each;
+      return NULL;
+    }
+
+  /* Units read since the index was built are newer than any in it and
+     come first in ALL_COMP_UNITS.  */
+  for (each = stash->all_comp_units;
+       each && each->unit_number >= stash->indexed_unit_count;
+       each = each->next_unit)
+    if (comp_unit_contains_address (each, addr))
+      return each;
+
+  best = NULL;
+  for (each = stash->changed_units; each; each = each->next_changed_unit)
+    if ((best == NULL || each->unit_number > best->unit_number)
+	&& comp_unit_contains_address (each, addr))
+      best = each;
+
+  /* Find the first range starting above ADDR, then walk back over the
+     ranges that might still reach ADDR.  */
+  lo = 0;
+  hi = stash->unit_range_count;
+  while (lo < hi)
+    {
+      unsigned int mid = (lo + hi) / 2;
+
+      if (stash->unit_ranges[mid].low <= addr)
+	lo = mid + 1;
+      else
+	hi = mid;
+    }
+
+  while (lo > 0 && stash->unit_ranges[lo - 1].max_high > addr)
+    {
+      struct unit_range *range = &stash->unit_ranges[--lo];
+
+      each = range->unit;
+      if (addr < range->high
+	  && ! each->error
+	  && ! each->ranges_changed
+	  && (best == NULL || each->unit_number > best->unit_number))
+	best = each;
+    }
+
+  return best;
+}
+/* APPLE LOCAL end sorted unit ranges  */
+
 /* If UNIT contains ADDR, set the output parameters to the values for
    the line containing ADDR.  The output parameters, FILENAME_PTR,
    FUNCTIONNAME_PTR, and LINENUMBER_PTR, are pointers to the objects
@@ -2265,11 +2543,13 @@ _bfd_dwarf2_find_nearest_line (bfd *abfd,
   stash->inliner_chain = NULL;
 
   /* Check the previously read comp. units first.  */
-  for (each = stash->all_comp_units; each; each = each->next_unit)
-    if (comp_unit_contains_address (each, addr))
-      return comp_unit_find_nearest_line (each, addr, filename_ptr,
-					  functionname_ptr, linenumber_ptr,
-					  stash);
+  /* APPLE LOCAL begin sorted unit ranges  */
+  each = find_comp_unit_for_address (stash, addr);
+  if (each)
+    return comp_unit_find_nearest_line (each, addr, filename_ptr,
+					functionname_ptr, linenumber_ptr,
+					stash);
+  /* APPLE LOCAL end sorted unit ranges  */
 
   /* Read each remaining comp. units checking each as they are read.  */
   while (stash->info_ptr < stash->info_ptr_end)
@@ -2323,8 +2603,8 @@ _bfd_dwarf2_find_nearest_line (bfd *abfd,
 
 	  if (each)
 	    {
-	      each->next_unit = stash->all_comp_units;
-	      stash->all_comp_units = each;
+	      /* APPLE LOCAL sorted unit ranges  */
+	      stash_add_comp_unit (stash, each);
 
 	      /* DW_AT_low_pc and DW_AT_high_pc are optional for
 		 compilation units.  If we don't have them (i.e.,
@@ -2537,8 +2817,8 @@ _bfd_dwarf2_find_line (bfd *abfd,
 
 	  if (each)
 	    {
-	      each->next_unit = stash->all_comp_units;
-	      stash->all_comp_units = each;
+	      /* APPLE LOCAL sorted unit ranges  */
+	      stash_add_comp_unit (stash, each);
 
 	      /* DW_AT_low_pc and DW_AT_high_pc are optional for
 		 compilation units.  If we don't have them (i.e.,
@@ -2627,4 +2907,6 @@ _bfd_dwarf2_cleanup_debug_info (bfd *abfd)
   free (stash->dwarf_abbrev_buffer);
   free (stash->dwarf_line_buffer);
   free (stash->dwarf_ranges_buffer);
+  /* APPLE LOCAL sorted unit ranges  */
+  free (stash->unit_ranges);
 }
@@ -1297,6 +1297,14 @@ struct elf_obj_tdata
   /* A place to stash dwarf2 info for this bfd.  */
   void *dwarf2_find_line_info;
 
+  /* APPLE LOCAL begin sorted function index  */
+  /* The function symbols of FUNC_INDEX_SYMBOLS sorted by section and
+     value, used by elf_find_function.  */
+  struct elf_func_index_entry *func_index;
+  bfd_size_type func_index_count;
+  asymbol **func_index_symbols;
+  /* APPLE LOCAL end sorted function index  */
+
   /* An array of stub sections indexed by symbol number, used by the
      MIPS ELF linker.  FIXME: We should figure out some way to only
      include this field for a MIPS ELF target.  */
@@ -6602,20 +6602,49 @@ _bfd_elf_set_arch_mach (bfd *abfd,
   return bfd_default_set_arch_mach (abfd, arch, machine);
 }
 
-/* Find the function to a particular section and offset,
-   for error reporting.  */
+/* APPLE LOCAL begin sorted function index  */
+/* One STT_FUNC or STT_NOTYPE symbol in the index elf_find_function
+   builds, with the file name it would report for the symbol.  */
 
-static bfd_boolean
-elf_find_function (bfd *abfd ATTRIBUTE_UNUSED,
-		   asection *section,
-		   asymbol **symbols,
-		   bfd_vma offset,
-		   const char **filename_ptr,
-		   const char **functionname_ptr)
+struct elf_func_index_entry
 {
+  asection *section;
+  bfd_vma value;
+  /* The symbol's position in the symbol table.  */
+  bfd_size_type order;
+  asymbol *func;
   const char *filename;
-  asymbol *func, *file;
-  bfd_vma low_func;
+};
+
+static int
+elf_func_index_compare (const void *a, const void *b)
+{
+  const struct elf_func_index_entry *e1 = a;
+  const struct elf_func_index_entry *e2 = b;
+
+  if (e1->section->id != e2->section->id)
+    return e1->section->id < e2->section->id ? -1 : 1;
+  if (e1->value != e2->value)
+    return e1->value < e2->value ? -1 : 1;
+  if (e1->order != e2->order)
+    return e1->order < e2->order ? -1 : 1;
+  return 0;
+}
+
+/* Build the index of the function symbols in SYMBOLS that
+   elf_find_function searches, sorted by section, value and position
+   in SYMBOLS.  The file name of each entry is the one a walk of
+   SYMBOLS up to the symbol would choose.  Return FALSE if we run out
+   of memory.  */
+
+static bfd_boolean
+elf_build_func_index (bfd *abfd, asymbol **symbols)
+{
+  struct elf_obj_tdata *tdata = elf_tdata (abfd);
+  struct elf_func_index_entry *entries;
+  bfd_size_type count;
+  bfd_size_type amt;
+  asymbol *file;
   asymbol **p;
   /* ??? Given multiple file symbols, it is impossible to reliably
      choose the right file name for global symbols.  File symbols are
@@ -6627,10 +6656,27 @@ elf_find_function (bfd *abfd ATTRIBUTE_UNUSED,
      file symbols appearing after a given local symbol.  */
   enum { nothing_seen, symbol_seen, file_after_symbol_seen } state;
 
-  filename = NULL;
-  func = NULL;
+  count = 0;
+  for (p = symbols; *p != NULL; p++)
+    {
+      elf_symbol_type *q = (elf_symbol_type *) *p;
+
+      switch (ELF_ST_TYPE (q->internal_elf_sym.st_info))
+	{
+	case STT_NOTYPE:
+	case STT_FUNC:
+	  count++;
+	  break;
+	}
+    }
+
+  amt = count * sizeof (struct elf_func_index_entry);
+  entries = bfd_malloc (amt);
+  if (entries == NULL && count != 0)
+    return FALSE;
+
+  count = 0;
   file = NULL;
-  low_func = 0;
   state = nothing_seen;
 
   for (p = symbols; *p != NULL; p++)
@@ -6652,36 +6698,94 @@ elf_find_function (bfd *abfd ATTRIBUTE_UNUSED,
 	  continue;
 	case STT_NOTYPE:
 	case STT_FUNC:
-	  if (bfd_get_section (&q->symbol) == section
-	      && q->symbol.value >= low_func
-	      && q->symbol.value <= offset)
-	    {
-	      func = (asymbol *) q;
-	      low_func = q->symbol.value;
-	      if (file == NULL)
-		filename = NULL;
-	      else if (ELF_ST_BIND (q->internal_elf_sym.st_info) != STB_LOCAL
-		       && state == file_after_symbol_seen)
-		filename = NULL;
-	      else
-		filename = bfd_asymbol_name (file);
-	    }
+	  entries[count].section = bfd_get_section (&q->symbol);
+	  entries[count].value = q->symbol.value;
+	  entries[count].order = p - symbols;
+	  entries[count].func = &q->symbol;
+	  if (file == NULL)
+	    entries[count].filename = NULL;
+	  else if (ELF_ST_BIND (q->internal_elf_sym.st_info) != STB_LOCAL
+		   && state == file_after_symbol_seen)
+	    entries[count].filename = NULL;
+	  else
+	    entries[count].filename = bfd_asymbol_name (file);
+	  count++;
 	  break;
 	}
       if (state == nothing_seen)
 	state = symbol_seen;
     }
 
-  if (func == NULL)
+  if (count != 0)
+    qsort (entries, count, sizeof (struct elf_func_index_entry),
+	   elf_func_index_compare);
+
+  if (tdata->func_index != NULL)
+    free (tdata->func_index);
+  tdata->func_index = entries;
+  tdata->func_index_count = count;
+  tdata->func_index_symbols = symbols;
+
+  return TRUE;
+}
+
+/* Find the function to a particular section and offset,
+   for error reporting.  */
+
+static bfd_boolean
+elf_find_function (bfd *abfd,
+		   asection *section,
+		   asymbol **symbols,
+		   bfd_vma offset,
+		   const char **filename_ptr,
+		   const char **functionname_ptr)
+{
+  struct elf_obj_tdata *tdata = elf_tdata (abfd);
+  struct elf_func_index_entry *entry;
+  bfd_size_type lo, hi;
+
+  if (symbols == NULL)
+    return FALSE;
+
+  /* The index describes one symbol table; a caller passing a
+     different one gets a new index.  */
+  if (tdata->func_index_symbols != symbols
+      && ! elf_build_func_index (abfd, symbols))
+    return FALSE;
+
+  /* The function is the one with the highest value not above OFFSET
+     in SECTION, and of several with that value, the last in the
+     symbol table.  That is the last entry whose section and value are
+     not above SECTION and OFFSET.  */
+  lo = 0;
+  hi = tdata->func_index_count;
+  while (lo < hi)
+    {
+      bfd_size_type mid = (lo + hi) / 2;
+
+      entry = &tdata->func_index[mid];
+      if (entry->section->id < section->id
+	  || (entry->section->id == section->id && entry->value <= offset))
+	lo = mid + 1;
+      else
+	hi = mid;
+    }
+
+  if (lo == 0)
+    return FALSE;
+
+  entry = &tdata->func_index[lo - 1];
+  if (entry->section != section)
     return FALSE;
 
   if (filename_ptr)
-    *filename_ptr = filename;
+    *filename_ptr = entry->filename;
   if (functionname_ptr)
-    *functionname_ptr = bfd_asymbol_name (func);
+    *functionname_ptr = bfd_asymbol_name (entry->func);
 
   return TRUE;
 }
+/* APPLE LOCAL end sorted function index  */
 
 /* Find the nearest line to a particular section and offset,
    for error reporting.  */
@@ -6917,6 +7021,8 @@ _bfd_elf_close_and_cleanup (bfd *abfd)
       if (elf_shstrtab (abfd) != NULL)
 	_bfd_elf_strtab_free (elf_shstrtab (abfd));
       _bfd_dwarf2_cleanup_debug_info (abfd);
+      /* APPLE LOCAL sorted function index  */
+      free (elf_tdata (abfd)->func_index);
     }
 
   return _bfd_generic_close_and_cleanup (abfd);
@@ -43,6 +43,10 @@ static bfd_boolean unwind_inlines;	/* -i, unwind inlined functions. */
 static bfd_boolean with_functions;	/* -f, show function names.  */
 static bfd_boolean do_demangle;		/* -C, demangle names.  */
 static bfd_boolean base_names;		/* -s, strip directory names.  */
+/* APPLE LOCAL begin addr2line batch  */
+static bfd_boolean batch_mode;		/* -B, resolve addresses in order.  */
+static const char *batch_file;		/* --batch=FILE, read addresses from FILE.  */
+/* APPLE LOCAL end addr2line batch  */
 
 static int naddr;		/* Number of addresses to process.  */
 static char **addr;		/* Hex addresses to process.  */
@@ -52,6 +56,8 @@ static asymbol **syms;		/* Symbol table.  */
 static struct option long_options[] =
 {
   {"basenames", no_argument, NULL, 's'},
+  /* APPLE LOCAL addr2line batch  */
+  {"batch", optional_argument, NULL, 'B'},
   {"demangle", optional_argument, NULL, 'C'},
   {"exe", required_argument, NULL, 'e'},
   {"functions", no_argument, NULL, 'f'},
@@ -65,6 +71,10 @@ static struct option long_options[] =
 static void usage (FILE *, int);
 static void slurp_symtab (bfd *);
 static void find_address_in_section (bfd *, asection *, void *);
+/* APPLE LOCAL begin addr2line batch  */
+static char *translate_pc (bfd *);
+static void translate_batch (bfd *);
+/* APPLE LOCAL end addr2line batch  */
 static void translate_addresses (bfd *);
 static void process_file (const char *, const char *);
 
@@ -78,6 +88,8 @@ usage (FILE *stream, int status)
   fprintf (stream, _(" If no addresses are specified on the command line, they will be read from stdin\n"));
   fprintf (stream, _(" The options are:\n\
   -b --target=<bfdname>  Set the binary file format\n\
+  -B --batch[=<file>]    Read every address first, from <file> if given, and\n\
+                         look them up in increasing order\n\
   -e --exe=<executable>  Set the input file name (default is a.out)\n\
   -i --inlines		 Unwind inlined functions\n\
   -s --basenames         Strip directory names\n\
@@ -149,6 +161,171 @@ find_address_in_section (bfd *abfd, asection *section,
 				 &filename, &functionname, &line);
 }
 
+/* APPLE LOCAL begin addr2line batch  */
+/* Translate the address in PC into file_name:line_number and
+   optionally function name.  Return the text to print for it, in a
+   string allocated with xmalloc.  */
+
+static char *
+translate_pc (bfd *abfd)
+{
+  char *result;
+  char line_buf[32];
+
+  result = xstrdup ("");
+
+  found = FALSE;
+  bfd_map_over_sections (abfd, find_address_in_section, NULL);
+
+  if (! found)
+    {
+      if (with_functions)
+	result = reconcat (result, result, "??\n", NULL);
+      return reconcat (result, result, "??:0\n", NULL);
+    }
+
+  do {
+    if (with_functions)
+      {
+	const char *name;
+	char *alloc = NULL;
+
+	name = functionname;
+	if (name == NULL || *name == '\0')
+	  name = "??";
+	else if (do_demangle)
+	  {
+	    alloc = demangle (abfd, name);
+	    name = alloc;
+	  }
+
+	result = reconcat (result, result, name, "\n", NULL);
+
+	if (alloc != NULL)
+	  free (alloc);
+      }
+
+    if (base_names && filename != NULL)
+      {
+	char *h;
+
+	h = strrchr (filename, '/');
+	if (h != NULL)
+	  filename = h + 1;
+      }
+
+    sprintf (line_buf, ":%u\n", line);
+    result = reconcat (result, result, filename ? filename : "??",
+		       line_buf, NULL);
+    if (!unwind_inlines)
+      found = FALSE;
+    else
+      found = bfd_find_inliner_info (abfd, &filename, &functionname, &line);
+  } while (found);
+
+  return result;
+}
+
+/* One address read by translate_batch.  */
+
+struct batch_address
+{
+  bfd_vma pc;
+  unsigned int index;		/* Position in the input.  */
+};
+
+static int
+compare_batch_addresses (const void *a, const void *b)
+{
+  const struct batch_address *a1 = a;
+  const struct batch_address *a2 = b;
+
+  if (a1->pc != a2->pc)
+    return a1->pc < a2->pc ? -1 : 1;
+  if (a1->index != a2->index)
+    return a1->index < a2->index ? -1 : 1;
+  return 0;
+}
+
+/* Read all the hexadecimal addresses, from the command line, the
+   --batch file or stdin, translate them in increasing order so that
+   the debug information is walked forwards once, then print the
+   results in the order the addresses were given.  */
+
+static void
+translate_batch (bfd *abfd)
+{
+  struct batch_address *addrs = NULL;
+  char **results;
+  unsigned int count = 0;
+  unsigned int alloced = 0;
+  unsigned int i;
+  FILE *in = NULL;
+
+  if (batch_file != NULL)
+    {
+      in = fopen (batch_file, "r");
+      if (in == NULL)
+	fatal (_("cannot open '%s': %s"), batch_file, strerror (errno));
+    }
+  else if (naddr == 0)
+    in = stdin;
+
+  for (;;)
+    {
+      bfd_vma this_pc;
+
+      if (in != NULL)
+	{
+	  char addr_hex[100];
+
+	  if (fgets (addr_hex, sizeof addr_hex, in) == NULL)
+	    break;
+	  this_pc = bfd_scan_vma (addr_hex, NULL, 16);
+	}
+      else
+	{
+	  if (naddr <= 0)
+	    break;
+	  --naddr;
+	  this_pc = bfd_scan_vma (*addr++, NULL, 16);
+	}
+
+      if (count == alloced)
+	{
+	  alloced = alloced ? alloced * 2 : 1024;
+	  addrs = xrealloc (addrs, alloced * sizeof (struct batch_address));
+	}
+      addrs[count].pc = this_pc;
+      addrs[count].index = count;
+      count++;
+    }
+
+  if (in != NULL && in != stdin)
+    fclose (in);
+
+  qsort (addrs, count, sizeof (struct batch_address),
+	 compare_batch_addresses);
+
+  results = xmalloc ((count ? count : 1) * sizeof (char *));
+  for (i = 0; i < count; i++)
+    {
+      pc = addrs[i].pc;
+      results[addrs[i].index] = translate_pc (abfd);
+    }
+
+  for (i = 0; i < count; i++)
+    {
+      fputs (results[i], stdout);
+      free (results[i]);
+    }
+  fflush (stdout);
+
+  free (results);
+  free (addrs);
+}
+/* APPLE LOCAL end addr2line batch  */
+
 /* Read hexadecimal addresses from stdin, translate into
    file_name:line_number and optionally function name.  */
 
@@ -157,8 +334,19 @@ translate_addresses (bfd *abfd)
 {
   int read_stdin = (naddr == 0);
 
+  /* APPLE LOCAL begin addr2line batch  */
+  if (batch_mode)
+    {
+      translate_batch (abfd);
+      return;
+    }
+  /* APPLE LOCAL end addr2line batch  */
+
   for (;;)
     {
+      /* APPLE LOCAL addr2line batch  */
+      char *result;
+
       if (read_stdin)
 	{
 	  char addr_hex[100];
@@ -175,55 +363,11 @@ translate_addresses (bfd *abfd)
 	  pc = bfd_scan_vma (*addr++, NULL, 16);
 	}
 
-      found = FALSE;
-      bfd_map_over_sections (abfd, find_address_in_section, NULL);
-
-      if (! found)
-	{
-	  if (with_functions)
-	    printf ("??\n");
-	  printf ("??:0\n");
-	}
-      else
-	{
-	  do {
-	    if (with_functions)
-	      {
-		const char *name;
-		char *alloc = NULL;
-
-		name = functionname;
-		if (name == NULL || *name == '\0')
-		  name = "??";
-		else if (do_demangle)
-		  {
-		    alloc = demangle (abfd, name);
-		    name = alloc;
-		  }
-
-		printf ("%s\n", name);
-
-		if (alloc != NULL)
-		  free (alloc);
-	      }
-
-	    if (base_names && filename != NULL)
-	      {
-		char *h;
-
-		h = strrchr (filename, '/');
-		if (h != NULL)
-		  filename = h + 1;
-	      }
-
-	    printf ("%s:%u\n", filename ? filename : "??", line);
-	    if (!unwind_inlines)
-	      found = FALSE;
-	    else
-	      found = bfd_find_inliner_info (abfd, &filename, &functionname, &line);
-	  } while (found);
-
-	}
+      /* APPLE LOCAL begin addr2line batch  */
+      result = translate_pc (abfd);
+      fputs (result, stdout);
+      free (result);
+      /* APPLE LOCAL end addr2line batch  */
 
       /* fflush() is essential for using this command as a server
          child process that reads addresses from a pipe and responds
@@ -301,7 +445,7 @@ main (int argc, char **argv)
 
   file_name = NULL;
   target = NULL;
-  while ((c = getopt_long (argc, argv, "b:Ce:sfHhiVv", long_options, (int *) 0))
+  while ((c = getopt_long (argc, argv, "b:BCe:sfHhiVv", long_options, (int *) 0))
 	 != EOF)
     {
       switch (c)
@@ -311,6 +455,12 @@ main (int argc, char **argv)
 	case 'b':
 	  target = optarg;
 	  break;
+	  /* APPLE LOCAL begin addr2line batch  */
+	case 'B':
+	  batch_mode = TRUE;
+	  batch_file = optarg;
+	  break;
+	  /* APPLE LOCAL end addr2line batch  */
 	case 'C':
 	  do_demangle = TRUE;
 	  if (optarg != NULL)
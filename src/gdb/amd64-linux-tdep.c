@@ -222,6 +222,9 @@ amd64_linux_init_abi (struct gdbarch_info info, struct gdbarch *gdbarch)
   /* Enable TLS support.  */
   set_gdbarch_fetch_tls_load_module_address (gdbarch,
                                              svr4_fetch_objfile_link_map);
+
+  /* APPLE LOCAL displaced stepping  */
+  amd64_init_displaced_stepping (gdbarch);
 }
 
 
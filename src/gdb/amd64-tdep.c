@@ -35,6 +35,8 @@
 #include "regset.h"
 #include "symfile.h"
 #include "complaints.h"
+/* APPLE LOCAL displaced stepping  */
+#include "disasm.h"
 
 #include "gdb_assert.h"
 
@@ -1051,6 +1053,231 @@ amd64_regset_from_core_section (struct gdbarch *gdbarch,
   return i386_regset_from_core_section (gdbarch, sect_name, sect_size);
 }
 
+/* APPLE LOCAL begin displaced stepping  */
+/* Displaced stepping.  As on the i386 (see i386-tdep.c), we
+   single-step a copy of the instruction and move anything it left
+   relative to the copy back to the original.  The one complication is
+   %rip-relative addressing: the copy would address memory relative
+   to the scratch area.  We rewrite such an instruction to address
+   memory relative to a register not otherwise used by it instead,
+   and load that register with the value %rip would have had.  */
+
+#define AMD64_MAX_INSN_LENGTH	16
+
+/* Which one-byte opcodes, and which opcodes following 0x0f, take a
+   ModRM byte.  */
+
+static const unsigned char amd64_onebyte_has_modrm[256] = {
+  /*	   0 1 2 3 4 5 6 7 8 9 a b c d e f	      */
+  /* 00 */ 1,1,1,1,0,0,0,0,1,1,1,1,0,0,0,0, /* 00 */
+  /* 10 */ 1,1,1,1,0,0,0,0,1,1,1,1,0,0,0,0, /* 10 */
+  /* 20 */ 1,1,1,1,0,0,0,0,1,1,1,1,0,0,0,0, /* 20 */
+  /* 30 */ 1,1,1,1,0,0,0,0,1,1,1,1,0,0,0,0, /* 30 */
+  /* 40 */ 0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0, /* 40 */
+  /* 50 */ 0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0, /* 50 */
+  /* 60 */ 0,0,1,1,0,0,0,0,0,1,0,1,0,0,0,0, /* 60 */
+  /* 70 */ 0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0, /* 70 */
+  /* 80 */ 1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1, /* 80 */
+  /* 90 */ 0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0, /* 90 */
+  /* a0 */ 0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0, /* a0 */
+  /* b0 */ 0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0, /* b0 */
+  /* c0 */ 1,1,0,0,1,1,1,1,0,0,0,0,0,0,0,0, /* c0 */
+  /* d0 */ 1,1,1,1,0,0,0,0,1,1,1,1,1,1,1,1, /* d0 */
+  /* e0 */ 0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0, /* e0 */
+  /* f0 */ 0,0,0,0,0,0,1,1,0,0,0,0,0,0,1,1  /* f0 */
+};
+
+static const unsigned char amd64_twobyte_has_modrm[256] = {
+  /*	   0 1 2 3 4 5 6 7 8 9 a b c d e f	      */
+  /* 00 */ 1,1,1,1,0,0,0,0,0,0,0,0,0,1,0,1, /* 0f */
+  /* 10 */ 1,1,1,1,1,1,1,1,1,0,0,0,0,0,0,0, /* 1f */
+  /* 20 */ 1,1,1,1,1,1,1,0,1,1,1,1,1,1,1,1, /* 2f */
+  /* 30 */ 0,0,0,0,0,0,0,0,1,0,1,0,0,0,0,0, /* 3f */
+  /* 40 */ 1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1, /* 4f */
+  /* 50 */ 1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1, /* 5f */
+  /* 60 */ 1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1, /* 6f */
+  /* 70 */ 1,1,1,1,1,1,1,0,1,1,1,1,1,1,1,1, /* 7f */
+  /* 80 */ 0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0, /* 8f */
+  /* 90 */ 1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1, /* 9f */
+  /* a0 */ 0,0,0,1,1,1,1,1,0,0,0,1,1,1,1,1, /* af */
+  /* b0 */ 1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1, /* bf */
+  /* c0 */ 1,1,1,1,1,1,1,1,0,0,0,0,0,0,0,0, /* cf */
+  /* d0 */ 1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1, /* df */
+  /* e0 */ 1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1, /* ef */
+  /* f0 */ 1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,0  /* ff */
+};
+
+struct displaced_step_closure
+{
+  /* The register standing in for %rip, or -1 if the instruction
+     doesn't use %rip-relative addressing.  */
+  int tmp_regnum;
+
+  /* That register's value before the step.  */
+  ULONGEST tmp_save;
+
+  /* The instruction as read from the original address; the copy may
+     have been rewritten.  */
+  gdb_byte insn_buf[AMD64_MAX_INSN_LENGTH];
+};
+
+/* Return non-zero if BYTE is a REX prefix.  */
+
+static int
+amd64_rex_prefix_p (gdb_byte byte)
+{
+  return (byte & 0xf0) == 0x40;
+}
+
+/* Return the offset of the ModRM byte of the instruction in BUF whose
+   opcode is at OPCODE, or -1 if it has none.  */
+
+static int
+amd64_modrm_offset (const gdb_byte *buf, const gdb_byte *opcode)
+{
+  if (opcode[0] != 0x0f)
+    return amd64_onebyte_has_modrm[opcode[0]] ? opcode - buf + 1 : -1;
+
+  /* The three-byte opcodes all have a ModRM byte.  */
+  if (opcode[1] == 0x38 || opcode[1] == 0x3a)
+    return opcode - buf + 3;
+
+  return amd64_twobyte_has_modrm[opcode[1]] ? opcode - buf + 2 : -1;
+}
+
+/* The gdbarch_displaced_step_copy_insn method.  */
+
+static struct displaced_step_closure *
+amd64_displaced_step_copy_insn (struct gdbarch *gdbarch,
+				CORE_ADDR from, CORE_ADDR to,
+				struct regcache *regs)
+{
+  struct displaced_step_closure *dsc;
+  gdb_byte buf[AMD64_MAX_INSN_LENGTH];
+  const gdb_byte *opcode;
+  int rex_offset = -1;
+  int modrm_offset;
+
+  dsc = xmalloc (sizeof (struct displaced_step_closure));
+  dsc->tmp_regnum = -1;
+  dsc->tmp_save = 0;
+
+  if (target_read_memory (from, dsc->insn_buf, sizeof buf) != 0)
+    {
+      xfree (dsc);
+      return NULL;
+    }
+  memcpy (buf, dsc->insn_buf, sizeof buf);
+
+  opcode = i386_skip_prefixes (buf, sizeof buf);
+  if (opcode != NULL && amd64_rex_prefix_p (opcode[0]))
+    {
+      rex_offset = opcode - buf;
+      opcode++;
+    }
+  if (opcode == NULL || opcode + 4 > buf + sizeof buf)
+    {
+      xfree (dsc);
+      return NULL;
+    }
+
+  modrm_offset = amd64_modrm_offset (buf, opcode);
+
+  /* Mod 00, R/M 101 is %rip-relative in 64-bit mode.  */
+  if (modrm_offset != -1 && (buf[modrm_offset] & 0xc7) == 0x05)
+    {
+      gdb_byte modrm = buf[modrm_offset];
+      int reg = (modrm >> 3) & 7;
+      int insn_len;
+
+      /* cmpxchg8b and cmpxchg16b use every general register we might
+	 borrow; step those the old way.  */
+      if (opcode[0] == 0x0f && opcode[1] == 0xc7)
+	{
+	  xfree (dsc);
+	  return NULL;
+	}
+
+      /* Nothing with a ModRM byte uses %rsi or %rdi implicitly, so
+	 one of them will do unless the ModRM reg field names it.  A
+	 REX.R prefix moves the reg field to %r8-%r15.  */
+      if (rex_offset != -1 && (buf[rex_offset] & 0x04))
+	reg = -1;
+      if (reg == 6)
+	{
+	  dsc->tmp_regnum = AMD64_RDI_REGNUM;
+	  reg = 7;
+	}
+      else
+	{
+	  dsc->tmp_regnum = AMD64_RSI_REGNUM;
+	  reg = 6;
+	}
+
+      /* Mod 10 takes the same 32-bit displacement as %rip-relative
+	 addressing, so the instruction keeps its length.  Clear REX.B
+	 so the R/M field names the low register.  */
+      buf[modrm_offset] = 0x80 | (modrm & 0x38) | reg;
+      if (rex_offset != -1)
+	buf[rex_offset] &= ~0x01;
+
+      write_memory (to, buf, sizeof buf);
+
+      insn_len = gdb_print_insn (to, gdb_null);
+      if (insn_len <= 0 || insn_len > (int) sizeof buf)
+	{
+	  xfree (dsc);
+	  return NULL;
+	}
+
+      regcache_cooked_read_unsigned (regs, dsc->tmp_regnum, &dsc->tmp_save);
+      regcache_cooked_write_unsigned (regs, dsc->tmp_regnum,
+				      from + insn_len);
+    }
+  else
+    write_memory (to, buf, sizeof buf);
+
+  return dsc;
+}
+
+/* The gdbarch_displaced_step_fixup method.  */
+
+static void
+amd64_displaced_step_fixup (struct gdbarch *gdbarch,
+			    struct displaced_step_closure *dsc,
+			    CORE_ADDR from, CORE_ADDR to,
+			    struct regcache *regs)
+{
+  const gdb_byte *opcode;
+
+  if (dsc->tmp_regnum != -1)
+    regcache_cooked_write_unsigned (regs, dsc->tmp_regnum, dsc->tmp_save);
+
+  opcode = i386_skip_prefixes (dsc->insn_buf, sizeof dsc->insn_buf);
+  if (opcode == NULL)
+    return;
+  if (amd64_rex_prefix_p (opcode[0]))
+    opcode++;
+
+  i386_displaced_step_relocate (opcode, opcode - dsc->insn_buf, from, to,
+				regs, AMD64_RIP_REGNUM, AMD64_RSP_REGNUM, 8);
+}
+
+/* Set up GDBARCH to step over breakpoints out of line.  */
+
+void
+amd64_init_displaced_stepping (struct gdbarch *gdbarch)
+{
+  set_gdbarch_max_insn_length (gdbarch, AMD64_MAX_INSN_LENGTH);
+  set_gdbarch_displaced_step_copy_insn (gdbarch,
+					amd64_displaced_step_copy_insn);
+  set_gdbarch_displaced_step_fixup (gdbarch, amd64_displaced_step_fixup);
+  set_gdbarch_displaced_step_free_closure (gdbarch,
+					   simple_displaced_step_free_closure);
+  set_gdbarch_displaced_step_location (gdbarch,
+				       displaced_step_at_entry_point);
+}
+/* APPLE LOCAL end displaced stepping  */
 
 void
 amd64_init_abi (struct gdbarch_info info, struct gdbarch *gdbarch)
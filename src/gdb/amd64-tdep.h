@@ -61,6 +61,11 @@ enum amd64_regnum
 
 extern void amd64_init_abi (struct gdbarch_info info, struct gdbarch *gdbarch);
 
+/* APPLE LOCAL begin displaced stepping  */
+/* Set up GDBARCH to step over breakpoints out of line.  */
+extern void amd64_init_displaced_stepping (struct gdbarch *gdbarch);
+/* APPLE LOCAL end displaced stepping  */
+
 /* Fill register REGNUM in REGCACHE with the appropriate
    floating-point or SSE register value from *FXSAVE.  If REGNUM is
    -1, do this for all registers.  This function masks off any of the
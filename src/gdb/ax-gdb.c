@@ -1812,6 +1812,37 @@ gen_trace_for_expr (CORE_ADDR scope, struct expression *expr)
   return ax;
 }
 
+/* APPLE LOCAL begin target-side breakpoint conditions  */
+/* Given a GDB expression EXPR, return bytecode which computes its
+   value and leaves it on top of the stack, ready for the agent to
+   test as a breakpoint condition.  No trace bytecodes are emitted;
+   nothing is collected.  SCOPE is the address at which EXPR will be
+   evaluated.  Throws an error if EXPR can't be compiled.  */
+
+struct agent_expr *
+gen_eval_for_expr (CORE_ADDR scope, struct expression *expr)
+{
+  struct cleanup *old_chain = 0;
+  struct agent_expr *ax = new_agent_expr (scope);
+  union exp_element *pc;
+  struct axs_value value;
+
+  old_chain = make_cleanup_free_agent_expr (ax);
+
+  pc = expr->elts;
+  trace_kludge = 0;
+  gen_expr (&pc, ax, &value);
+
+  /* We need the value itself, not its address.  */
+  require_rvalue (ax, &value);
+
+  ax_simple (ax, aop_end);
+
+  discard_cleanups (old_chain);
+  return ax;
+}
+/* APPLE LOCAL end target-side breakpoint conditions  */
+
 static void
 agent_command (char *exp, int from_tty)
 {
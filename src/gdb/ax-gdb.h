@@ -110,4 +110,11 @@ extern struct agent_expr *expr_to_address_and_size (struct expression *EXPR);
    function to discover which registers the expression uses.  */
 extern struct agent_expr *gen_trace_for_expr (CORE_ADDR, struct expression *);
 
+/* APPLE LOCAL begin target-side breakpoint conditions  */
+/* Given a GDB expression EXPR, produce bytecode which leaves its
+   value on top of the stack, for the remote agent to evaluate as a
+   breakpoint condition at the given address.  */
+extern struct agent_expr *gen_eval_for_expr (CORE_ADDR, struct expression *);
+/* APPLE LOCAL end target-side breakpoint conditions  */
+
 #endif /* AX_GDB_H */
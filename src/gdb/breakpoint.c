@@ -359,6 +359,28 @@ Debugger's behavior regarding pending breakpoints is %s.\n"),
 		    value);
 }
 
+/* APPLE LOCAL begin always-inserted breakpoints  */
+/* If non-zero, breakpoints stay in the inferior while it is stopped,
+   and each resume only inserts or removes the locations that changed
+   since the last one.  */
+static int always_inserted_mode = 0;
+
+static void
+show_always_inserted_mode (struct ui_file *file, int from_tty,
+			   struct cmd_list_element *c, const char *value)
+{
+  fprintf_filtered (file, _("\
+Always inserted breakpoint mode is %s.\n"),
+		    value);
+}
+
+int
+breakpoints_always_inserted_mode (void)
+{
+  return always_inserted_mode && target_has_execution;
+}
+/* APPLE LOCAL end always-inserted breakpoints  */
+
 void _initialize_breakpoint (void);
 
 extern int addressprint;	/* Print machine addresses? */
@@ -727,6 +749,11 @@ condition_command (char *arg, int from_tty)
 static void
 condition_command_1 (struct breakpoint *b, char *condition, int from_tty)
 {
+  /* APPLE LOCAL begin always-inserted breakpoints  */
+  /* The target may be evaluating the old condition.  */
+  if (b->loc->inserted)
+    b->loc->dirty = 1;
+  /* APPLE LOCAL end always-inserted breakpoints  */
 
   if (b->cond)
     {
@@ -862,92 +889,206 @@ int
 deprecated_read_memory_nobpt (CORE_ADDR memaddr, gdb_byte *myaddr,
 			      unsigned len)
 {
-  int status;
+  /* APPLE LOCAL begin always-inserted breakpoints  */
+  /* Memory reads already see through inserted breakpoints; see
+     breakpoint_restore_shadows.  */
+  return target_read_memory (memaddr, myaddr, len);
+  /* APPLE LOCAL end always-inserted breakpoints  */
+}
+
+/* APPLE LOCAL begin always-inserted breakpoints  */
+/* Non-zero while breakpoint instructions are being taken out of the
+   target.  Those transfers must see and change the real memory, so
+   breakpoint_restore_shadows and breakpoint_update_shadows leave them
+   alone.  */
+
+static int removing_breakpoints;
+
+static void
+end_removing_breakpoints (void *ignore)
+{
+  removing_breakpoints--;
+}
+/* APPLE LOCAL end always-inserted breakpoints  */
+
+/* APPLE LOCAL begin displaced stepping  */
+/* The memory left out of breakpoint_restore_shadows and
+   breakpoint_update_shadows: the displaced stepping scratch area
+   while an instruction is being stepped there.  */
+
+static CORE_ADDR shadow_exempt_addr;
+static ULONGEST shadow_exempt_len;
+
+void
+breakpoint_exempt_from_shadows (CORE_ADDR addr, ULONGEST len)
+{
+  shadow_exempt_addr = addr;
+  shadow_exempt_len = len;
+}
+/* APPLE LOCAL end displaced stepping  */
+
+/* APPLE LOCAL begin always-inserted breakpoints  */
+
+/* Find the part of the inserted software breakpoint location B that
+   lies within the LEN bytes at MEMADDR.  Return the breakpoint
+   instruction, or NULL if none of it does.  *BP_ADDR, *BP_SIZE and
+   *BPTOFFSET describe the overlap: *BP_SIZE bytes at *BP_ADDR, which
+   are the bytes starting at *BPTOFFSET in the breakpoint.  If FULL is
+   non-NULL, *FULL is set to the length of the whole instruction.  */
+
+static const gdb_byte *
+bp_location_overlap (struct bp_location *b, CORE_ADDR memaddr, LONGEST len,
+		     CORE_ADDR *bp_addr, int *bp_size, int *bptoffset,
+		     int *full)
+{
+  const gdb_byte *bp;
+
+  if (b->loc_type != bp_loc_software_breakpoint || !b->inserted)
+    return NULL;
+  if (b->placed_address + BREAKPOINT_MAX <= memaddr
+      || b->placed_address >= memaddr + len)
+    return NULL;
+
+  *bp_addr = b->placed_address;
+  bp = BREAKPOINT_FROM_PC (bp_addr, bp_size);
+  if (bp == NULL || *bp_size == 0 || *bp_size > BREAKPOINT_MAX)
+    return NULL;
+  if (*bp_addr + *bp_size <= memaddr || *bp_addr >= memaddr + len)
+    return NULL;
+  /* APPLE LOCAL begin displaced stepping  */
+  if (shadow_exempt_len != 0
+      && *bp_addr < shadow_exempt_addr + shadow_exempt_len
+      && shadow_exempt_addr < *bp_addr + *bp_size)
+    return NULL;
+  /* APPLE LOCAL end displaced stepping  */
+  if (full != NULL)
+    *full = *bp_size;
+
+  *bptoffset = 0;
+  if (*bp_addr < memaddr)
+    {
+      /* Only the second part of the breakpoint is in range.  */
+      *bptoffset = memaddr - *bp_addr;
+      *bp_size -= *bptoffset;
+      *bp_addr = memaddr;
+    }
+  if (*bp_addr + *bp_size > memaddr + len)
+    /* Only the first part of the breakpoint is in range.  */
+    *bp_size -= (*bp_addr + *bp_size) - (memaddr + len);
+
+  return bp;
+}
+
+/* Overwrite any inserted software breakpoint instructions in BUF,
+   which holds LEN bytes of target memory read from MEMADDR, with the
+   memory contents they replaced.
+
+   Targets which insert breakpoints themselves (a remote stub
+   answering 'Z0') never show us the breakpoint instruction and leave
+   the shadow contents alone, so only put back the shadow where the
+   memory we read actually holds the breakpoint instruction.  */
+
+void
+breakpoint_restore_shadows (gdb_byte *buf, CORE_ADDR memaddr, LONGEST len)
+{
   struct bp_location *b;
-  CORE_ADDR bp_addr = 0;
-  int bp_size = 0;
 
-  if (BREAKPOINT_FROM_PC (&bp_addr, &bp_size) == NULL)
-    /* No breakpoints on this machine. */
-    return target_read_memory (memaddr, myaddr, len);
+  if (removing_breakpoints)
+    return;
 
   ALL_BP_LOCATIONS (b)
   {
-    if (b->owner->type == bp_none)
-      warning (_("reading through apparently deleted breakpoint #%d?"),
-              b->owner->number);
+    const gdb_byte *bp;
+    CORE_ADDR bp_addr;
+    int bp_size, bptoffset;
 
-    if (b->loc_type != bp_loc_software_breakpoint)
+    bp = bp_location_overlap (b, memaddr, len, &bp_addr, &bp_size,
+			      &bptoffset, NULL);
+    if (bp == NULL)
       continue;
-    if (!b->inserted)
-      continue;
-    /* Addresses and length of the part of the breakpoint that
-       we need to copy.  */
-    /* XXXX The m68k, sh and h8300 have different local and remote
-       breakpoint values.  BREAKPOINT_FROM_PC still manages to
-       correctly determine the breakpoints memory address and size
-       for these targets. */
-    bp_addr = b->address;
-    bp_size = 0;
-    if (BREAKPOINT_FROM_PC (&bp_addr, &bp_size) == NULL)
-      continue;
-    if (bp_size == 0)
-      /* bp isn't valid */
-      continue;
-    if (bp_addr + bp_size <= memaddr)
-      /* The breakpoint is entirely before the chunk of memory we
-         are reading.  */
+
+    if (memcmp (buf + bp_addr - memaddr, bp + bptoffset, bp_size) == 0)
+      memcpy (buf + bp_addr - memaddr, b->shadow_contents + bptoffset,
+	      bp_size);
+  }
+}
+
+/* LEN bytes from WRITEBUF are about to be written to target memory at
+   MEMADDR.  Where they cover an inserted software breakpoint, put them
+   in the breakpoint's shadow contents instead, so that the breakpoint
+   stays in place and removing it later leaves the new bytes behind.
+   Return NULL if no breakpoint is affected, or else a copy of WRITEBUF
+   with the breakpoint instructions put back, to be written instead;
+   the caller must free it.
+
+   A target which inserts breakpoints itself left the shadow holding
+   the breakpoint instruction (see prepare_bp_location_shadow) and
+   keeps its own copy of what's underneath up to date, so such
+   breakpoints are left alone.  */
+
+gdb_byte *
+breakpoint_update_shadows (const gdb_byte *writebuf, CORE_ADDR memaddr,
+			   LONGEST len)
+{
+  struct bp_location *b;
+  gdb_byte *buf = NULL;
+
+  if (removing_breakpoints)
+    return NULL;
+
+  ALL_BP_LOCATIONS (b)
+  {
+    const gdb_byte *bp;
+    CORE_ADDR bp_addr;
+    int bp_size, bptoffset, full;
+
+    bp = bp_location_overlap (b, memaddr, len, &bp_addr, &bp_size,
+			      &bptoffset, &full);
+    if (bp == NULL)
       continue;
-    if (bp_addr >= memaddr + len)
-      /* The breakpoint is entirely after the chunk of memory we are
-         reading. */
+    if (memcmp (b->shadow_contents, bp, full) == 0)
       continue;
-    /* Copy the breakpoint from the shadow contents, and recurse for
-       the things before and after.  */
-    {
-      /* Offset within shadow_contents.  */
-      int bptoffset = 0;
 
-      if (bp_addr < memaddr)
-	{
-	  /* Only copy the second part of the breakpoint.  */
-	  bp_size -= memaddr - bp_addr;
-	  bptoffset = memaddr - bp_addr;
-	  bp_addr = memaddr;
-	}
+    memcpy (b->shadow_contents + bptoffset, writebuf + bp_addr - memaddr,
+	    bp_size);
+    if (buf == NULL)
+      {
+	buf = xmalloc (len);
+	memcpy (buf, writebuf, len);
+      }
+    memcpy (buf + bp_addr - memaddr, bp + bptoffset, bp_size);
+  }
 
-      if (bp_addr + bp_size > memaddr + len)
-	{
-	  /* Only copy the first part of the breakpoint.  */
-	  bp_size -= (bp_addr + bp_size) - (memaddr + len);
-	}
+  return buf;
+}
 
-      memcpy (myaddr + bp_addr - memaddr,
-	      b->shadow_contents + bptoffset, bp_size);
+/* Record that BPT has just been inserted in the target.  */
 
-      if (bp_addr > memaddr)
-	{
-	  /* Copy the section of memory before the breakpoint.  */
-	  status = deprecated_read_memory_nobpt (memaddr, myaddr, bp_addr - memaddr);
-	  if (status != 0)
-	    return status;
-	}
+static void
+mark_bp_location_placed (struct bp_location *bpt)
+{
+  bpt->inserted = 1;
+  bpt->placed_address = bpt->address;
+  bpt->dirty = 0;
+}
 
-      if (bp_addr + bp_size < memaddr + len)
-	{
-	  /* Copy the section of memory after the breakpoint.  */
-	  status = deprecated_read_memory_nobpt (bp_addr + bp_size,
-				      myaddr + bp_addr + bp_size - memaddr,
-				      memaddr + len - (bp_addr + bp_size));
-	  if (status != 0)
-	    return status;
-	}
-      return 0;
-    }
-  }
-  /* Nothing overlaps.  Just call read_memory_noerr.  */
-  return target_read_memory (memaddr, myaddr, len);
+/* Before inserting the software breakpoint BPT, fill its shadow
+   contents with the breakpoint instruction.  A target which inserts
+   breakpoints itself leaves them untouched, and
+   breakpoint_restore_shadows then knows not to use them.  */
+
+static void
+prepare_bp_location_shadow (struct bp_location *bpt)
+{
+  CORE_ADDR addr = bpt->address;
+  const gdb_byte *bp;
+  int len;
+
+  bp = BREAKPOINT_FROM_PC (&addr, &len);
+  if (bp != NULL && len <= BREAKPOINT_MAX)
+    memcpy (bpt->shadow_contents, bp, len);
 }
+/* APPLE LOCAL end always-inserted breakpoints  */
 
 
 /* A wrapper function for inserting catchpoints.  */
@@ -1053,8 +1194,12 @@ insert_bp_location (struct bp_location *bpt,
 	    val = target_insert_hw_breakpoint (bpt->address, 
 					       bpt->shadow_contents);
 	  else
-	    val = target_insert_breakpoint (bpt->address,
-					    bpt->shadow_contents);
+	    {
+	      /* APPLE LOCAL always-inserted breakpoints  */
+	      prepare_bp_location_shadow (bpt);
+	      val = target_insert_breakpoint (bpt->address,
+					      bpt->shadow_contents);
+	    }
 	}
       else
 	{
@@ -1155,7 +1300,8 @@ insert_bp_location (struct bp_location *bpt,
 	    }
 	}
       else
-	bpt->inserted = 1;
+	/* APPLE LOCAL always-inserted breakpoints  */
+	mark_bp_location_placed (bpt);
 
       return val;
     }
@@ -1362,6 +1508,43 @@ in which its expression is valid.\n"),
   return 0;
 }
 
+/* APPLE LOCAL begin always-inserted breakpoints  */
+/* Remove from the target every breakpoint location which is inserted
+   but should no longer be, or no longer as it is: because it has
+   been disabled, deleted as a duplicate, moved, or marked dirty.
+   insert_breakpoints then inserts whatever is missing.  This is what
+   lets breakpoints stay inserted across stops, and keeps a resume
+   from rewriting locations that haven't changed.  */
+
+static void
+remove_stale_bp_locations (void)
+{
+  struct bp_location *b;
+
+  ALL_BP_LOCATIONS (b)
+    {
+      if (!b->inserted
+	  || (b->loc_type != bp_loc_software_breakpoint
+	      && b->loc_type != bp_loc_hardware_breakpoint)
+	  || b->owner->enable_state == bp_permanent)
+	continue;
+
+      if (!b->dirty
+	  && !b->duplicate
+	  && breakpoint_enabled (b->owner)
+	  && b->placed_address == b->address)
+	continue;
+
+      /* If we can't remove it, the memory it was in has most likely
+	 gone away (its shared library was unloaded, say); there's
+	 nothing more we can do for it.  */
+      if (remove_breakpoint (b, mark_uninserted) != 0)
+	b->inserted = 0;
+      b->dirty = 0;
+    }
+}
+/* APPLE LOCAL end always-inserted breakpoints  */
+
 /* insert_breakpoints is used when starting or continuing the program.
    remove_breakpoints is used when the program stops.
    Both return zero if successful,
@@ -1392,6 +1575,9 @@ insert_breakpoints (void)
   breakpoint_update ();
   /* END APPLE LOCAL */
 
+  /* APPLE LOCAL always-inserted breakpoints  */
+  remove_stale_bp_locations ();
+
   ALL_BP_LOCATIONS_SAFE (b, temp)
     {
       /* Permanent breakpoints cannot be inserted or removed.  Disabled
@@ -1712,8 +1898,25 @@ detach_breakpoints (int pid)
   return 0;
 }
 
+/* APPLE LOCAL begin always-inserted breakpoints  */
+static int remove_breakpoint_1 (struct bp_location *, insertion_state_t);
+
 static int
 remove_breakpoint (struct bp_location *b, insertion_state_t is)
+{
+  struct cleanup *old_chain;
+  int val;
+
+  removing_breakpoints++;
+  old_chain = make_cleanup (end_removing_breakpoints, NULL);
+  val = remove_breakpoint_1 (b, is);
+  do_cleanups (old_chain);
+  return val;
+}
+/* APPLE LOCAL end always-inserted breakpoints  */
+
+static int
+remove_breakpoint_1 (struct bp_location *b, insertion_state_t is)
 {
   int val;
 
@@ -1738,12 +1941,16 @@ remove_breakpoint (struct bp_location *b, insertion_state_t is)
 	  || !(section_is_overlay (b->section)))
 	{
 	  /* No overlay handling: just remove the breakpoint.  */
+	  /* APPLE LOCAL begin always-inserted breakpoints  */
+	  /* Remove it from where it was put, even if the location has
+	     since moved.  */
+	  CORE_ADDR addr = b->inserted ? b->placed_address : b->address;
 
 	  if (b->loc_type == bp_loc_hardware_breakpoint)
-	    val = target_remove_hw_breakpoint (b->address, 
-					       b->shadow_contents);
+	    val = target_remove_hw_breakpoint (addr, b->shadow_contents);
 	  else
-	    val = target_remove_breakpoint (b->address, b->shadow_contents);
+	    val = target_remove_breakpoint (addr, b->shadow_contents);
+	  /* APPLE LOCAL end always-inserted breakpoints  */
 	}
       else
 	{
@@ -2046,6 +2253,54 @@ breakpoint_inserted_here_p (CORE_ADDR pc)
   return 0;
 }
 
+/* APPLE LOCAL begin target-side breakpoint conditions  */
+/* Return the condition a remote agent may evaluate on our behalf for
+   the software breakpoint we are about to insert at PC, or NULL if
+   every hit there has to be reported.  That is only safe when the
+   breakpoint at PC is a single user breakpoint with a condition and
+   no ignore count: anything else sharing the address (a step-resume
+   or longjmp breakpoint, another user breakpoint with a different
+   condition) needs to see hits regardless.  */
+
+struct expression *
+breakpoint_target_condition (CORE_ADDR pc)
+{
+  struct bp_location *bpt;
+  struct breakpoint *found = NULL;
+
+  ALL_BP_LOCATIONS (bpt)
+    {
+      struct breakpoint *b = bpt->owner;
+
+      if (bpt->address != pc
+	  || b->enable_state == bp_disabled
+	  || b->enable_state == bp_shlib_disabled
+	  || b->enable_state == bp_call_disabled
+	  || b->enable_state == bp_hand_call_disabled
+	  || b->pending
+	  || !breakpoint_address_is_meaningful (b))
+	continue;
+
+      if (overlay_debugging
+	  && section_is_overlay (bpt->section)
+	  && !section_is_mapped (bpt->section))
+	continue;
+
+      if (found != NULL
+	  || bpt->loc_type != bp_loc_software_breakpoint
+	  || b->type != bp_breakpoint
+	  || b->enable_state != bp_enabled
+	  || b->cond == NULL
+	  || b->ignore_count != 0)
+	return NULL;
+
+      found = b;
+    }
+
+  return found != NULL ? found->cond : NULL;
+}
+/* APPLE LOCAL end target-side breakpoint conditions  */
+
 /* This function returns non-zero iff there is a software breakpoint
    inserted at PC.  */
 
@@ -4523,6 +4778,8 @@ check_duplicates (struct breakpoint *bpt)
   struct bp_location *perm_bp = 0;
   CORE_ADDR address = bpt->loc->address;
   asection *section = bpt->loc->section;
+  /* APPLE LOCAL always-inserted breakpoints  */
+  int changed = 0;
 
   if (! breakpoint_address_is_meaningful (bpt))
     return;
@@ -4547,9 +4804,24 @@ check_duplicates (struct breakpoint *bpt)
 	}
 	
       count++;
+      /* APPLE LOCAL always-inserted breakpoints  */
+      changed |= b->duplicate != (count > 1);
       b->duplicate = count > 1;
     }
 
+  /* APPLE LOCAL begin always-inserted breakpoints  */
+  /* Whether a target may evaluate a breakpoint's condition itself
+     depends on what else shares the address (see
+     breakpoint_target_condition), so a breakpoint inserted with, or
+     without, its condition may need inserting again.  */
+  if (changed)
+    ALL_BP_LOCATIONS (b)
+      if (b->inserted && !b->duplicate
+	  && b->address == address
+	  && b->owner->cond_string != NULL)
+	b->dirty = 1;
+  /* APPLE LOCAL end always-inserted breakpoints  */
+
   /* If we found a permanent breakpoint at this address, go over the
      list again and declare all the other breakpoints there to be the
      duplicates.  */
@@ -4847,7 +5119,8 @@ make_breakpoint_permanent (struct breakpoint *b)
   b->enable_state = bp_permanent;
 
   /* By definition, permanent breakpoints are already present in the code.  */
-  b->loc->inserted = 1;
+  /* APPLE LOCAL always-inserted breakpoints  */
+  mark_bp_location_placed (b->loc);
 }
 
 static struct breakpoint *
@@ -8399,15 +8672,18 @@ gnu_v3_update_exception_catchpoints (enum exception_event_kind ex_event,
     }
   
   nameptr = trigger_func_name;  
-  hash = msymbol_hash (nameptr) % MINIMAL_SYMBOL_HASH_SIZE;
+  /* APPLE LOCAL begin sized msymbol hash  */
+  hash = msymbol_hash (nameptr);
   
   ALL_OBJFILES (objfile)
     {
-      for (msymbol = objfile->msymbol_hash[hash];
+      for (msymbol = MSYMBOL_HASH_BUCKET (objfile, hash);
            msymbol != NULL;
            msymbol = msymbol->hash_next)
-        if (MSYMBOL_TYPE (msymbol) == mst_text
+        if (msymbol->hash_value == hash
+            && MSYMBOL_TYPE (msymbol) == mst_text
             && strcmp_iw (SYMBOL_LINKAGE_NAME (msymbol), nameptr) == 0)
+	  /* APPLE LOCAL end sized msymbol hash  */
           {
             /* We found one, add it here... */
             CORE_ADDR catchpoint_address;
@@ -9098,7 +9374,11 @@ delete_breakpoint (struct breakpoint *bpt)
 	  if (b->type == bp_hardware_breakpoint)
 	    val = target_insert_hw_breakpoint (b->loc->address, b->loc->shadow_contents);
 	  else
-	    val = target_insert_breakpoint (b->loc->address, b->loc->shadow_contents);
+	    {
+	      /* APPLE LOCAL always-inserted breakpoints  */
+	      prepare_bp_location_shadow (b->loc);
+	      val = target_insert_breakpoint (b->loc->address, b->loc->shadow_contents);
+	    }
 
 	  /* If there was an error in the insert, print a message, then stop execution.  */
 	  if (val != 0)
@@ -9128,7 +9408,8 @@ delete_breakpoint (struct breakpoint *bpt)
 	      error_stream(tmp_error_stream); 
 	    }
 	  else
-	    b->loc->inserted = 1;
+	    /* APPLE LOCAL always-inserted breakpoints  */
+	    mark_bp_location_placed (b->loc);
 	}
     }
 
@@ -9954,6 +10235,12 @@ set_ignore_count (int bptnum, int count, int from_tty)
   ALL_BREAKPOINTS (b)
     if (b->number == bptnum)
     {
+      /* APPLE LOCAL begin always-inserted breakpoints  */
+      /* A target-side condition is only used without an ignore
+	 count.  */
+      if (b->loc->inserted && (b->ignore_count == 0) != (count == 0))
+	b->loc->dirty = 1;
+      /* APPLE LOCAL end always-inserted breakpoints  */
       b->ignore_count = count;
       if (from_tty)
 	{
@@ -11177,4 +11464,20 @@ user-query to see if a pending breakpoint should be created."),
 				&breakpoint_show_cmdlist);
 
   pending_break_support = AUTO_BOOLEAN_AUTO;
+
+  /* APPLE LOCAL begin always-inserted breakpoints  */
+  add_setshow_boolean_cmd ("always-inserted", class_support,
+			   &always_inserted_mode, _("\
+Set mode for inserting breakpoints."), _("\
+Show mode for inserting breakpoints."), _("\
+When this mode is off (the default), breakpoints are inserted in the\n\
+inferior when it is resumed, and removed when it stops.  When it is on,\n\
+breakpoints stay inserted while the inferior is stopped, and resuming it\n\
+only inserts or removes those that have changed.  Reads of inferior memory\n\
+show the original contents under an inserted breakpoint either way."),
+			   NULL,
+			   show_always_inserted_mode,
+			   &breakpoint_set_cmdlist,
+			   &breakpoint_show_cmdlist);
+  /* APPLE LOCAL end always-inserted breakpoints  */
 }
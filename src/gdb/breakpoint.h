@@ -270,6 +270,18 @@ struct bp_location
      which to place the breakpoint in order to comply with a
      processor's architectual constraints.  */
   CORE_ADDR requested_address;
+
+  /* APPLE LOCAL begin always-inserted breakpoints  */
+  /* The address this location was inserted at.  Valid only while
+     INSERTED; ADDRESS may move underneath an inserted breakpoint when
+     breakpoints are re-set.  */
+  CORE_ADDR placed_address;
+
+  /* Nonzero if the breakpoint in the target no longer matches this
+     location (its condition or ignore count changed, say), so it
+     must be removed and inserted again before the inferior runs.  */
+  char dirty;
+  /* APPLE LOCAL end always-inserted breakpoints  */
 };
 
 /* This structure is a collection of function pointers that, if available,
@@ -687,6 +699,9 @@ extern int breakpoint_inserted_here_p (CORE_ADDR);
 
 extern int software_breakpoint_inserted_here_p (CORE_ADDR);
 
+/* APPLE LOCAL target-side breakpoint conditions  */
+extern struct expression *breakpoint_target_condition (CORE_ADDR);
+
 /* APPLE LOCAL begin breakpoint MI */
 extern struct breakpoint *find_breakpoint (int);
 extern void breakpoint_print_commands (struct ui_out *, struct breakpoint *);
@@ -748,6 +763,34 @@ extern int insert_breakpoints (void);
 
 extern int remove_breakpoints (void);
 
+/* APPLE LOCAL begin always-inserted breakpoints  */
+/* Return non-zero if breakpoints should stay inserted in the inferior
+   while it is stopped.  */
+extern int breakpoints_always_inserted_mode (void);
+
+/* Overwrite any inserted software breakpoint instructions in BUF,
+   which holds LEN bytes of target memory read from MEMADDR, with the
+   memory contents they replaced.  */
+extern void breakpoint_restore_shadows (gdb_byte *buf, CORE_ADDR memaddr,
+					LONGEST len);
+
+/* Before LEN bytes from WRITEBUF are written to target memory at
+   MEMADDR, move the parts that cover inserted breakpoints into their
+   shadow contents.  Return NULL, or a copy of WRITEBUF to write
+   instead, which still holds the breakpoint instructions; the caller
+   must free it.  */
+extern gdb_byte *breakpoint_update_shadows (const gdb_byte *writebuf,
+					    CORE_ADDR memaddr, LONGEST len);
+/* APPLE LOCAL end always-inserted breakpoints  */
+
+/* APPLE LOCAL begin displaced stepping  */
+/* Let memory transfers within the LEN bytes at ADDR see and change
+   the real target memory, breakpoint instructions and all, rather
+   than the shadows of breakpoints inserted there.  A LEN of zero ends
+   this.  */
+extern void breakpoint_exempt_from_shadows (CORE_ADDR addr, ULONGEST len);
+/* APPLE LOCAL end displaced stepping  */
+
 /* This function can be used to physically insert eventpoints from the
    specified traced inferior process, without modifying the breakpoint
    package's state.  This can be useful for those targets which support
@@ -94,6 +94,11 @@ c_printstr (struct ui_file *stream, const gdb_byte *string,
   int in_quotes = 0;
   int need_comma = 0;
 
+  /* APPLE LOCAL begin partial lazy values  */
+  if (length > 0)
+    val_print_fetch (string + (length - 1) * width, width);
+  /* APPLE LOCAL end partial lazy values  */
+
   /* If the string was not truncated due to `set print elements', and
      the last byte of it is a null, we don't print that, in traditional C
      style.  */
@@ -126,17 +131,24 @@ c_printstr (struct ui_file *stream, const gdb_byte *string,
 	  need_comma = 0;
 	}
 
+      /* APPLE LOCAL begin partial lazy values  */
+      /* Only read the characters we print, or count as repeats of one
+	 we print.  */
+      val_print_fetch (string + i * width, width);
       current_char = extract_unsigned_integer (string + i * width, width);
 
       rep1 = i + 1;
       reps = 1;
-      while (rep1 < length
-	     && extract_unsigned_integer (string + rep1 * width, width)
-	     == current_char)
+      while (rep1 < length)
 	{
+	  val_print_fetch (string + rep1 * width, width);
+	  if (extract_unsigned_integer (string + rep1 * width, width)
+	      != current_char)
+	    break;
 	  ++rep1;
 	  ++reps;
 	}
+      /* APPLE LOCAL end partial lazy values  */
 
       if (reps > repeat_count_threshold)
 	{
@@ -133,6 +133,10 @@ c_val_print (struct type *type, const gdb_byte *valaddr, int embedded_offset,
 		{
 		  unsigned int temp_len;
 
+		  /* APPLE LOCAL partial lazy values  */
+		  val_print_fetch (valaddr + embedded_offset,
+				   min (len, print_max + 1));
+
 		  /* Look for a NULL char. */
 		  for (temp_len = 0;
 		       (valaddr + embedded_offset)[temp_len]
@@ -644,8 +648,8 @@ c_value_print (struct value *val, struct ui_file *stream, int format,
   if (real_type)
     type = real_type;
 
-  return val_print (type, value_contents_all (val),
-		    value_embedded_offset (val),
-		    VALUE_ADDRESS (val) + value_offset (val),
-		    stream, format, 1, 0, pretty);
+  /* APPLE LOCAL partial lazy values  */
+  return val_print_value (type, val, value_embedded_offset (val),
+			  VALUE_ADDRESS (val) + value_offset (val),
+			  stream, format, 1, 0, pretty);
 }
@@ -304,6 +304,18 @@ cli_interpreter_complete (void *data, char *word, char *command_buffer,
         }
 
       xfree (completions);
+
+      /* APPLE LOCAL begin completion name index  */
+      if (symbol_completion_truncated
+	  && (limit == -1 || items_printed < limit))
+	{
+	  if (ui_out_is_mi_like_p (uiout))
+	    ui_out_field_string (uiout, "limited", "true");
+	  else
+	    ui_out_text (uiout, _("\
+*** List may be truncated, max-completions reached. ***\n"));
+	}
+      /* APPLE LOCAL end completion name index  */
     }
 
   /* APPLE LOCAL begin refactor command completion */
@@ -170,9 +170,16 @@ static void ATTR_FORMAT (printf, 4, 0)
 vcomplaint (struct complaints **c, const char *file, int line, const char *fmt,
 	    va_list args)
 {
-  struct complaints *complaints = get_complaints (c);
-  struct complain *complaint = find_complaint (complaints, file, line, fmt);
+  struct complaints *complaints;
+  struct complain *complaint;
   enum complaint_series series;
+
+  /* APPLE LOCAL parallel psymtabs  */
+  if (helper_thread_check_hook)
+    helper_thread_check_hook ();
+
+  complaints = get_complaints (c);
+  complaint = find_complaint (complaints, file, line, fmt);
   gdb_assert (complaints != NULL);
 
   complaint->counter++;
@@ -39,6 +39,8 @@
 #undef savestring
 
 #include "completer.h"
+/* APPLE LOCAL completion name index  */
+#include "exceptions.h"
 
 /* Prototypes for local functions */
 static
@@ -401,6 +403,9 @@ complete_line (const char *text, char *line_buffer, int point)
   rl_completer_word_break_characters =
     current_language->la_word_break_characters();
 
+  /* APPLE LOCAL completion name index  */
+  symbol_completion_truncated = 0;
+
       /* Decide whether to complete on a list of gdb commands or on symbols. */
   tmp_command = (char *) alloca (point + 1);
   p = tmp_command;
@@ -656,7 +661,37 @@ line_completion_function (const char *text, int matches, char *line_buffer, int
 	  xfree (list);
 	}
       index = 0;
-      list = complete_line (text, line_buffer, point);
+      /* APPLE LOCAL begin completion name index  */
+      list = NULL;
+
+      /* A Ctrl-C while we search just abandons the completion; don't
+	 let the quit unwind through readline.  */
+      {
+	volatile struct gdb_exception e;
+
+	TRY_CATCH (e, RETURN_MASK_QUIT)
+	  {
+	    list = complete_line (text, line_buffer, point);
+	  }
+	if (e.reason < 0)
+	  list = NULL;
+      }
+
+      /* If the symbol completions were cut short by "set
+	 max-completions", the ones we have may share a longer prefix
+	 than the ones we missed.  Offer TEXT itself as well, so that
+	 readline doesn't insert that prefix.  */
+      if (list != NULL && symbol_completion_truncated)
+	{
+	  int size;
+
+	  for (size = 0; list[size] != NULL; size++)
+	    ;
+	  list = (char **) xrealloc (list, (size + 2) * sizeof (char *));
+	  list[size] = xstrdup (text);
+	  list[size + 1] = NULL;
+	}
+      /* APPLE LOCAL end completion name index  */
     }
 
   /* If we found a list of potential completions during initialization then
@@ -53,6 +53,13 @@
    multiple of the LINE_SIZE) and a vector of bytes over the range.
    There's another vector which contains the state of the bytes.
 
+   APPLE LOCAL: The blocks are organized as a set-associative cache:
+   the address of a line selects one set of DCACHE_WAYS blocks, and
+   within a set the least recently used block is replaced.  When the
+   cache sees misses on consecutive lines it assumes the user is
+   streaming through memory (x/4096x, printing a large array, dump
+   memory) and reads several lines ahead in a single target transfer.
+
    ENTRY_BAD means that the byte is just plain wrong, and has no
    correspondence with anything else (as it would when the cache is
    turned on, but nothing has been done to it.
@@ -98,8 +105,23 @@
    line, and reduce memory requirements, but increase the risk
    of a line not being in memory */
 
+/* APPLE LOCAL: This is now only the default; the size is settable
+   with "set dcache-size".  */
 #define DCACHE_SIZE 64
 
+/* APPLE LOCAL begin set-associative dcache  */
+/* Number of blocks in each set of the cache.  A line can only live in
+   the set selected by its address, so a lookup compares at most this
+   many addresses.  */
+
+#define DCACHE_WAYS 4
+
+/* Default number of lines read in a single transfer once sequential
+   access has been detected.  Settable with "set dcache-readahead".  */
+
+#define DCACHE_READAHEAD 8
+/* APPLE LOCAL end set-associative dcache  */
+
 /* This value regulates the size of a cache line.  Smaller values
    reduce the time taken to read a single byte, but reduce overall
    throughput.  */
@@ -118,6 +140,20 @@
 static int g_line_power = LINE_SIZE_POWER;
 static int g_line_size = LINE_SIZE;
 
+/* APPLE LOCAL begin set-associative dcache  */
+/* The requested total number of cache lines, and the number of lines
+   to read ahead when streaming (0 disables read-ahead).  */
+
+static int g_cache_size = DCACHE_SIZE;
+static int g_readahead_lines = DCACHE_READAHEAD;
+
+/* The last value of g_cache_size that was accepted; the "set" hook
+   runs after the variable has been changed, so this is what a bad
+   value is replaced with.  */
+
+static int g_cache_size_accepted = DCACHE_SIZE;
+/* APPLE LOCAL end set-associative dcache  */
+
 /* Each cache block holds g_line_size bytes of data
    starting at a multiple-of-g_line_size address.  */
 
@@ -132,7 +168,12 @@ static int g_line_size = LINE_SIZE;
 
 struct dcache_block
   {
-    struct dcache_block *p;	/* next in list */
+    /* APPLE LOCAL begin set-associative dcache  */
+    /* Whether this block holds a line at all.  */
+    int valid;
+    /* Value of the cache's LRU clock when this block was last used.  */
+    unsigned int lru;
+    /* APPLE LOCAL end set-associative dcache  */
     CORE_ADDR addr;		/* Address for which data is recorded.  */
     /* APPLE LOCAL: data and state used to be fixed size.  */
     gdb_byte *data;
@@ -160,18 +201,27 @@ struct dcache_block
 
 struct dcache_struct
   {
-    /* free list */
-    struct dcache_block *free_head;
-    struct dcache_block *free_tail;
-
-    /* in use list */
-    struct dcache_block *valid_head;
-    struct dcache_block *valid_tail;
-
-    /* The cache itself. */
+    /* APPLE LOCAL begin set-associative dcache  */
+    /* The cache itself: NSETS sets of DCACHE_WAYS blocks each, stored
+       set after set.  NSETS is a power of two.  */
     struct dcache_block *the_cache;
+    int nsets;
     gdb_byte *data_block;
     unsigned char *state_block;
+
+    /* Incremented on every access; see dcache_block.lru.  */
+    unsigned int lru_clock;
+
+    /* The line address that would continue the current run of
+       sequential misses, and the length of that run.  */
+    CORE_ADDR next_miss_addr;
+    int streak;
+
+    /* Statistics for "info dcache".  */
+    unsigned long hits;
+    unsigned long misses;
+    unsigned long readaheads;
+    /* APPLE LOCAL end set-associative dcache  */
   };
 
 static struct dcache_block *dcache_hit (DCACHE *dcache, CORE_ADDR addr);
@@ -205,30 +255,45 @@ static DCACHE **g_cache_array = NULL;
 static int g_num_caches = 0;
 static int g_max_num_caches = 0;
 
+/* APPLE LOCAL begin set-associative dcache  */
+/* Total number of blocks in DCACHE.  */
+
+#define DCACHE_NUM_BLOCKS(dcache) ((dcache)->nsets * DCACHE_WAYS)
+
+/* The first block of the set that may hold the line containing
+   ADDR.  */
+
+static struct dcache_block *
+dcache_set (DCACHE *dcache, CORE_ADDR addr)
+{
+  int set = (int) ((addr >> g_line_power) & (dcache->nsets - 1));
+
+  return dcache->the_cache + set * DCACHE_WAYS;
+}
+/* APPLE LOCAL end set-associative dcache  */
+
 /* Free all the data cache blocks, thus discarding all cached data.  */
 
 void
 dcache_invalidate (DCACHE *dcache)
 {
   int i;
-  dcache->valid_head = 0;
-  dcache->valid_tail = 0;
 
-  dcache->free_head = 0;
-  dcache->free_tail = 0;
-
-  for (i = 0; i < DCACHE_SIZE; i++)
+  /* APPLE LOCAL begin set-associative dcache  */
+  for (i = 0; i < DCACHE_NUM_BLOCKS (dcache); i++)
     {
       struct dcache_block *db = dcache->the_cache + i;
 
-      if (!dcache->free_head)
-	dcache->free_head = db;
-      else
-	dcache->free_tail->p = db;
-      dcache->free_tail = db;
-      db->p = 0;
+      db->valid = 0;
+      db->anydirty = 0;
+      db->lru = 0;
     }
 
+  dcache->lru_clock = 0;
+  dcache->streak = 0;
+  dcache->next_miss_addr = 0;
+  /* APPLE LOCAL end set-associative dcache  */
+
   return;
 }
 
@@ -238,20 +303,23 @@ dcache_invalidate (DCACHE *dcache)
 static struct dcache_block *
 dcache_hit (DCACHE *dcache, CORE_ADDR addr)
 {
-  struct dcache_block *db;
-
-  /* Search all cache blocks for one that is at this address.  */
-  db = dcache->valid_head;
+  /* APPLE LOCAL begin set-associative dcache  */
+  struct dcache_block *set = dcache_set (dcache, addr);
+  int i;
 
-  while (db)
+  /* Only the blocks of ADDR's set can hold it.  */
+  for (i = 0; i < DCACHE_WAYS; i++)
     {
-      if (MASK (addr) == db->addr)
+      struct dcache_block *db = set + i;
+
+      if (db->valid && MASK (addr) == db->addr)
 	{
 	  db->refs++;
+	  db->lru = ++dcache->lru_clock;
 	  return db;
 	}
-      db = db->p;
     }
+  /* APPLE LOCAL end set-associative dcache  */
 
   return NULL;
 }
@@ -396,38 +464,35 @@ dcache_read_line (DCACHE *dcache, struct dcache_block *db)
 static struct dcache_block *
 dcache_alloc (DCACHE *dcache, CORE_ADDR addr)
 {
-  struct dcache_block *db;
+  /* APPLE LOCAL begin set-associative dcache  */
+  struct dcache_block *set = dcache_set (dcache, addr);
+  struct dcache_block *db = NULL;
+  int i;
 
-  /* Take something from the free list */
-  db = dcache->free_head;
-  if (db)
+  /* Take an unused block of the set if there is one, otherwise evict
+     the least recently used one.  */
+  for (i = 0; i < DCACHE_WAYS; i++)
     {
-      dcache->free_head = db->p;
+      if (!set[i].valid)
+	{
+	  db = set + i;
+	  break;
+	}
+      if (db == NULL || set[i].lru < db->lru)
+	db = set + i;
     }
-  else
-    {
-      /* Nothing left on free list, so grab one from the valid list */
-      db = dcache->valid_head;
 
-      if (!dcache_write_line (dcache, db))
-	return NULL;
-      
-      dcache->valid_head = db->p;
-    }
+  if (db->valid && !dcache_write_line (dcache, db))
+    return NULL;
 
+  db->valid = 1;
+  db->lru = ++dcache->lru_clock;
+  /* APPLE LOCAL end set-associative dcache  */
   db->addr = MASK(addr);
   db->refs = 0;
   db->anydirty = 0;
   memset (db->state, ENTRY_BAD, g_line_size * sizeof (unsigned char));
 
-  /* append this line to end of valid list */
-  if (!dcache->valid_head)
-    dcache->valid_head = db;
-  else
-    dcache->valid_tail->p = db;
-  dcache->valid_tail = db;
-  db->p = 0;
-
   return db;
 }
 
@@ -435,69 +500,138 @@ dcache_alloc (DCACHE *dcache, CORE_ADDR addr)
 static int
 dcache_writeback (DCACHE *dcache)
 {
-  struct dcache_block *db;
-
-  db = dcache->valid_head;
+  /* APPLE LOCAL begin set-associative dcache  */
+  int i;
 
-  while (db)
+  for (i = 0; i < DCACHE_NUM_BLOCKS (dcache); i++)
     {
-      if (!dcache_write_line (dcache, db))
+      struct dcache_block *db = dcache->the_cache + i;
+
+      if (db->valid && !dcache_write_line (dcache, db))
 	return 0;
-      db = db->p;
     }
+  /* APPLE LOCAL end set-associative dcache  */
   return 1;
 }
 
-
-/* Using the data cache DCACHE return the contents of the byte at
-   address ADDR in the remote machine.  
-
-   Returns 0 on error. */
+/* APPLE LOCAL begin set-associative dcache  */
+/* Read NLINES lines starting at the line address LINE with a single
+   target transfer, and enter them in DCACHE.  Bytes that are dirty in
+   the cache are kept.  The transfer stops short of the first line that
+   is not wholly in cacheable, readable memory regions.  Return the
+   number of lines, starting with LINE, that are now valid in the
+   cache; 0 if nothing could be read.  */
 
 static int
-dcache_peek_byte (DCACHE *dcache, CORE_ADDR addr, gdb_byte *ptr)
+dcache_read_ahead (DCACHE *dcache, CORE_ADDR line, int nlines)
 {
-  struct dcache_block *db = dcache_hit (dcache, addr);
+  struct mem_region *region;
+  CORE_ADDR addr, end;
+  gdb_byte *buf;
+  LONGEST res;
+  int i, j;
+
+  /* Walk every memory region the transfer would touch, and stop it at
+     the first line that is not entirely cacheable and readable.  */
+  addr = line;
+  end = line + nlines * g_line_size;
+  while (addr < end)
+    {
+      region = lookup_mem_region (addr);
+      if (region->attrib.cache != 1 || region->attrib.mode == MEM_WO)
+	{
+	  nlines = (addr - line) / g_line_size;
+	  break;
+	}
+      if (region->hi == 0 || region->hi <= addr)
+	break;
+      addr = region->hi;
+    }
+  if (nlines <= 1)
+    return 0;
 
-  if (!db)
+  buf = xmalloc (nlines * g_line_size);
+  res = target_read (&current_target, TARGET_OBJECT_RAW_MEMORY,
+		     NULL, buf, line, nlines * g_line_size);
+  if (res <= 0)
     {
-      db = dcache_alloc (dcache, addr);
-      if (!db)
-	return 0;
+      xfree (buf);
+      return 0;
     }
-  
-  if (db->state[XFORM (addr)] == ENTRY_BAD)
+  nlines = res / g_line_size;
+
+  for (i = 0; i < nlines; i++)
     {
-      if (!dcache_read_line(dcache, db))
-         return 0;
+      CORE_ADDR addr = line + i * g_line_size;
+      struct dcache_block *db = dcache_hit (dcache, addr);
+
+      if (db == NULL)
+	db = dcache_alloc (dcache, addr);
+      if (db == NULL)
+	break;
+
+      for (j = 0; j < g_line_size; j++)
+	if (db->state[j] != ENTRY_DIRTY)
+	  {
+	    db->data[j] = buf[i * g_line_size + j];
+	    db->state[j] = ENTRY_OK;
+	  }
     }
 
-  *ptr = db->data[XFORM (addr)];
-  return 1;
+  xfree (buf);
+  dcache->readaheads++;
+  return i;
 }
 
+/* Bring the line containing ADDR into DCACHE after a miss, and return
+   its block, or NULL on error.  WANT_LINES is the number of lines the
+   current request still spans, starting with this one; if that is
+   more than one, or if this miss continues a run of sequential
+   misses, several lines are read in one transfer.  */
 
-/* Write the byte at PTR into ADDR in the data cache.
-   Return zero on write error.
- */
-
-static int
-dcache_poke_byte (DCACHE *dcache, CORE_ADDR addr, gdb_byte *ptr)
+static struct dcache_block *
+dcache_fill (DCACHE *dcache, CORE_ADDR addr, int want_lines)
 {
-  struct dcache_block *db = dcache_hit (dcache, addr);
+  CORE_ADDR line = MASK (addr);
+  struct dcache_block *db;
+  int nlines = want_lines;
+  int got = 0;
 
-  if (!db)
+  dcache->misses++;
+
+  if (line == dcache->next_miss_addr)
+    dcache->streak++;
+  else
+    dcache->streak = 0;
+
+  if (dcache->streak > 0 && g_readahead_lines > nlines)
+    nlines = g_readahead_lines;
+
+  /* Consecutive lines fall in consecutive sets; never read more lines
+     than there are sets, so that the read-ahead can't evict the line
+     we were asked for.  */
+  if (nlines > dcache->nsets)
+    nlines = dcache->nsets;
+
+  if (nlines > 1)
+    got = dcache_read_ahead (dcache, line, nlines);
+
+  if (got > 0)
+    db = dcache_hit (dcache, addr);
+  else
     {
-      db = dcache_alloc (dcache, addr);
-      if (!db)
-	return 0;
+      db = dcache_hit (dcache, addr);
+      if (db == NULL)
+	db = dcache_alloc (dcache, addr);
+      if (db == NULL || !dcache_read_line (dcache, db))
+	return NULL;
+      got = 1;
     }
 
-  db->data[XFORM (addr)] = *ptr;
-  db->state[XFORM (addr)] = ENTRY_DIRTY;
-  db->anydirty = 1;
-  return 1;
+  dcache->next_miss_addr = line + got * g_line_size;
+  return db;
 }
+/* APPLE LOCAL end set-associative dcache  */
 
 static void
 dcache_set_data (DCACHE *dcache)
@@ -505,19 +639,32 @@ dcache_set_data (DCACHE *dcache)
 
   int i;
 
-  dcache->data_block = xmalloc (g_line_size * DCACHE_SIZE * sizeof (gdb_byte));
-  dcache->state_block = xmalloc (g_line_size * DCACHE_SIZE * sizeof (unsigned char));
+  /* APPLE LOCAL begin set-associative dcache  */
+  /* Round the requested size up to a power of two number of sets.  */
+  dcache->nsets = 1;
+  while (dcache->nsets * DCACHE_WAYS < g_cache_size)
+    dcache->nsets <<= 1;
+
+  dcache->the_cache = (struct dcache_block *)
+    xcalloc (DCACHE_NUM_BLOCKS (dcache), sizeof (struct dcache_block));
+  dcache->data_block = xmalloc (g_line_size * DCACHE_NUM_BLOCKS (dcache)
+				* sizeof (gdb_byte));
+  dcache->state_block = xmalloc (g_line_size * DCACHE_NUM_BLOCKS (dcache)
+				 * sizeof (unsigned char));
   
-  for (i = 0; i < DCACHE_SIZE; i++)
+  for (i = 0; i < DCACHE_NUM_BLOCKS (dcache); i++)
     {
       dcache->the_cache[i].data = dcache->data_block + (i * g_line_size);
       dcache->the_cache[i].state = dcache->state_block + (i * g_line_size);
     }
+  /* APPLE LOCAL end set-associative dcache  */
 }
 
 static void
 dcache_resize (DCACHE *dcache)
 {
+  /* APPLE LOCAL set-associative dcache  */
+  xfree (dcache->the_cache);
   xfree (dcache->data_block);
   xfree (dcache->state_block);
   dcache_set_data (dcache);
@@ -527,13 +674,10 @@ dcache_resize (DCACHE *dcache)
 DCACHE *
 dcache_init (void)
 {
-  int csize = sizeof (struct dcache_block) * DCACHE_SIZE;
   DCACHE *dcache;
 
   dcache = (DCACHE *) xmalloc (sizeof (*dcache));
-
-  dcache->the_cache = (struct dcache_block *) xmalloc (csize);
-  memset (dcache->the_cache, 0, csize);
+  memset (dcache, 0, sizeof (*dcache));
 
   dcache_set_data (dcache);
 
@@ -585,15 +729,54 @@ int
 dcache_xfer_memory (DCACHE *dcache, CORE_ADDR memaddr, gdb_byte *myaddr,
 		    int len, int should_write)
 {
-  int i;
-  int (*xfunc) (DCACHE *dcache, CORE_ADDR addr, gdb_byte *ptr);
-  xfunc = should_write ? dcache_poke_byte : dcache_peek_byte;
+  /* APPLE LOCAL begin set-associative dcache  */
+  int done = 0;
 
-  for (i = 0; i < len; i++)
+  /* Transfer a line at a time rather than a byte at a time.  */
+  while (done < len)
     {
-      if (!xfunc (dcache, memaddr + i, myaddr + i))
-	return 0;
+      CORE_ADDR addr = memaddr + done;
+      int offset = XFORM (addr);
+      int chunk = g_line_size - offset;
+      struct dcache_block *db;
+
+      if (chunk > len - done)
+	chunk = len - done;
+
+      db = dcache_hit (dcache, addr);
+
+      if (should_write)
+	{
+	  if (db == NULL)
+	    {
+	      db = dcache_alloc (dcache, addr);
+	      if (db == NULL)
+		return 0;
+	    }
+	  memcpy (db->data + offset, myaddr + done, chunk);
+	  memset (db->state + offset, ENTRY_DIRTY, chunk);
+	  db->anydirty = 1;
+	}
+      else
+	{
+	  if (db == NULL || memchr (db->state + offset, ENTRY_BAD, chunk))
+	    {
+	      int want_lines;
+
+	      want_lines = (MASK (memaddr + len - 1) - MASK (addr))
+			   / g_line_size + 1;
+	      db = dcache_fill (dcache, addr, want_lines);
+	      if (db == NULL)
+		return 0;
+	    }
+	  else
+	    dcache->hits++;
+	  memcpy (myaddr + done, db->data + offset, chunk);
+	}
+
+      done += chunk;
     }
+  /* APPLE LOCAL end set-associative dcache  */
 
   /* FIXME: There may be some benefit from moving the cache writeback
      to a higher layer, as it could occur after a sequence of smaller
@@ -616,16 +799,33 @@ dcache_info (char *exp, int tty)
   struct dcache_block *p;
   int i;
 
-  printf_filtered (_("Dcache line width %d, depth %d\n"),
-		   g_line_size, DCACHE_SIZE);
+  /* APPLE LOCAL begin set-associative dcache  */
+  printf_filtered (_("Dcache line width %d, depth %d (%d sets of %d), "
+		     "read-ahead %d lines\n"),
+		   g_line_size,
+		   g_num_caches ? DCACHE_NUM_BLOCKS (g_cache_array[0])
+		   : g_cache_size,
+		   g_num_caches ? g_cache_array[0]->nsets
+		   : g_cache_size / DCACHE_WAYS,
+		   DCACHE_WAYS, g_readahead_lines);
 
   for (i = 0; i < g_num_caches; i++)
     {
-      printf_filtered (_("Cache state:\n"));
+      DCACHE *dcache = g_cache_array[i];
+      int k;
+
+      printf_filtered (_("Cache state: %lu hits, %lu misses, "
+			 "%lu read-ahead transfers\n"),
+		       dcache->hits, dcache->misses, dcache->readaheads);
 
-      for (p = g_cache_array[i]->valid_head; p; p = p->p)
+      for (k = 0; k < DCACHE_NUM_BLOCKS (dcache); k++)
 	{
 	  int j;
+
+	  p = dcache->the_cache + k;
+	  if (!p->valid)
+	    continue;
+
 	  printf_filtered (_("Line at %s, referenced %d times\n"),
 			   paddr (p->addr), p->refs);
 
@@ -638,14 +838,32 @@ dcache_info (char *exp, int tty)
 	  printf_filtered ("\n");
 	}
     }
+  /* APPLE LOCAL end set-associative dcache  */
 }
 
 static void
 set_cache_line_power (char *args, int from_tty, struct cmd_list_element *c)
 {
   int i;
+
+  /* APPLE LOCAL begin set-associative dcache  */
+  /* g_line_size still holds the previous line size here.  */
+  if (g_line_power < 0 || g_line_power > 16
+      || g_cache_size > INT_MAX / 2 / (1 << g_line_power))
+    {
+      for (g_line_power = 0; (1 << g_line_power) < g_line_size; g_line_power++)
+	;
+      error (_("The cache line power must be between 0 and 16, and the "
+	       "dcache size times the line size must fit in an int."));
+    }
+  /* APPLE LOCAL end set-associative dcache  */
+
   if (g_num_caches == 0)
-    return;
+    {
+      /* APPLE LOCAL set-associative dcache  */
+      g_line_size = 1 << g_line_power;
+      return;
+    }
 
   for (i = 0; i < g_num_caches; i++)
       dcache_invalidate (g_cache_array[i]);
@@ -659,6 +877,36 @@ set_cache_line_power (char *args, int from_tty, struct cmd_list_element *c)
     }
 }
 
+/* APPLE LOCAL begin set-associative dcache  */
+static void
+set_dcache_size (char *args, int from_tty, struct cmd_list_element *c)
+{
+  int i;
+
+  if (g_cache_size < DCACHE_WAYS)
+    {
+      g_cache_size = g_cache_size_accepted;
+      error (_("The dcache must hold at least %d lines."), DCACHE_WAYS);
+    }
+  /* The number of sets is rounded up to a power of two, which can
+     double the number of lines actually allocated.  */
+  if (g_cache_size > INT_MAX / 2 / g_line_size)
+    {
+      g_cache_size = g_cache_size_accepted;
+      error (_("The dcache can hold at most %d lines of %d bytes."),
+	     INT_MAX / 2 / g_line_size, g_line_size);
+    }
+  g_cache_size_accepted = g_cache_size;
+
+  for (i = 0; i < g_num_caches; i++)
+    {
+      dcache_invalidate (g_cache_array[i]);
+      dcache_resize (g_cache_array[i]);
+      dcache_invalidate (g_cache_array[i]);
+    }
+}
+/* APPLE LOCAL end set-associative dcache  */
+
 void
 _initialize_dcache (void)
 {
@@ -686,4 +934,26 @@ volatile registers are in use.  By default, this option is off."),
                          set_cache_line_power,
                          NULL,
                          &setlist, &showlist);
+
+  /* APPLE LOCAL begin set-associative dcache  */
+  add_setshow_zinteger_cmd ("dcache-size", class_support,
+			    &g_cache_size, _("\
+Set the number of lines in the data cache."), _("\
+Show the number of lines in the data cache."), _("\
+The number is rounded up so that the cache has a power of two number\n\
+of sets of 4 lines each."),
+			    set_dcache_size,
+			    NULL,
+			    &setlist, &showlist);
+
+  add_setshow_zinteger_cmd ("dcache-readahead", class_support,
+			    &g_readahead_lines, _("\
+Set the number of lines the data cache reads ahead when streaming."), _("\
+Show the number of lines the data cache reads ahead when streaming."), _("\
+When consecutive cache lines are missed, the data cache reads this many\n\
+lines from the target in one transfer.  0 disables read-ahead."),
+			    NULL,
+			    NULL,
+			    &setlist, &showlist);
+  /* APPLE LOCAL end set-associative dcache  */
 }
@@ -1038,6 +1038,15 @@ extern void warning (const char *, ...) ATTR_FORMAT (printf, 1, 2);
 
 extern void vwarning (const char *, va_list args) ATTR_FORMAT (printf, 1, 0);
 
+/* APPLE LOCAL begin parallel psymtabs  */
+/* If set, called on entry to error, quit, warning, complaint and
+   internal-problem reporting, before any global state is touched.
+   Code that runs part of its work on helper threads uses it to pull a
+   helper thread out of routines only the main thread may run; it does
+   not return in that case.  On the main thread it must do nothing.  */
+extern void (*helper_thread_check_hook) (void);
+/* APPLE LOCAL end parallel psymtabs  */
+
 /* List of known OS ABIs.  If you change this, make sure to update the
    table in osabi.c.  */
 enum gdb_osabi
@@ -103,9 +103,26 @@ struct dwarf2_fde
   /* True if this FDE is read from a .eh_frame instead of a .debug_frame
      section.  */
   unsigned char eh_frame_p;
+};
+
+/* APPLE LOCAL begin sorted fde table  */
+/* A sorted table of all the FDEs of an objfile, searched with a
+   binary search by dwarf2_frame_find_fde.  FDEs may overlap, so
+   REACH[I] records the highest end address of ENTRIES[0] through
+   ENTRIES[I]; the lookup uses it to stop walking backwards once no
+   earlier FDE can cover the PC.  LOW and HIGH bound the unrelocated
+   addresses covered by the table so that objfiles which cannot
+   contain a given PC are rejected without a search.  */
 
-  struct dwarf2_fde *next;
+struct dwarf2_fde_table
+{
+  int num_entries;
+  struct dwarf2_fde **entries;
+  CORE_ADDR *reach;
+  CORE_ADDR low;
+  CORE_ADDR high;
 };
+/* APPLE LOCAL end sorted fde table  */
 
 static struct dwarf2_fde *dwarf2_frame_find_fde (CORE_ADDR *pc);
 
@@ -1306,6 +1323,14 @@ struct comp_unit
 
   /* Base for DW_EH_PE_textrel encodings.  */
   bfd_vma tbase;
+
+  /* APPLE LOCAL begin sorted fde table  */
+  /* FDEs decoded so far, in no particular order.  Turned into a
+     struct dwarf2_fde_table once all frame sections are read.  */
+  struct dwarf2_fde **fdes;
+  int num_fdes;
+  int fdes_alloced;
+  /* APPLE LOCAL end sorted fde table  */
 };
 
 const struct objfile_data *dwarf2_frame_objfile_data;
@@ -1581,8 +1606,11 @@ add_cie (struct comp_unit *unit, struct dwarf2_cie *cie)
   unit->cie = cie;
 }
 
+/* APPLE LOCAL begin sorted fde table  */
 /* Find the FDE for *PC.  Return a pointer to the FDE, and store the
-   inital location associated with it into *PC.  */
+   inital location associated with it into *PC.  When several FDEs
+   cover *PC, the one that starts last wins, and among those starting
+   at the same address the one sorted first by qsort_fde_cmp.  */
 
 static struct dwarf2_fde *
 dwarf2_frame_find_fde (CORE_ADDR *pc)
@@ -1591,26 +1619,57 @@ dwarf2_frame_find_fde (CORE_ADDR *pc)
 
   ALL_OBJFILES (objfile)
     {
-      struct dwarf2_fde *fde;
+      struct dwarf2_fde_table *fde_table;
+      struct dwarf2_fde *best;
       CORE_ADDR offset;
+      CORE_ADDR seek_pc;
+      int lo, hi, i;
 
-      fde = objfile_data (objfile, dwarf2_frame_objfile_data);
-      if (fde == NULL)
+      fde_table = objfile_data (objfile, dwarf2_frame_objfile_data);
+      if (fde_table == NULL || fde_table->num_entries == 0)
 	continue;
 
       gdb_assert (objfile->section_offsets);
       offset = objfile_text_section_offset (objfile);
 
-      while (fde)
+      /* Skip objfiles whose FDEs can't possibly cover *PC.  */
+      if (*pc < fde_table->low + offset || *pc >= fde_table->high + offset)
+	continue;
+
+      seek_pc = *pc - offset;
+
+      /* Find the first entry starting after SEEK_PC.  */
+      lo = 0;
+      hi = fde_table->num_entries;
+      while (lo < hi)
 	{
-	  if (*pc >= fde->initial_location + offset
-	      && *pc < fde->initial_location + offset + fde->address_range)
-	    {
-	      *pc = fde->initial_location + offset;
-	      return fde;
-	    }
+	  int mid = lo + (hi - lo) / 2;
+
+	  if (fde_table->entries[mid]->initial_location <= seek_pc)
+	    lo = mid + 1;
+	  else
+	    hi = mid;
+	}
+
+      /* Walk back over the entries starting at or before SEEK_PC
+	 until one of them covers it, then finish the run of entries
+	 that share its initial location so that the preferred one is
+	 returned.  */
+      best = NULL;
+      for (i = hi - 1; i >= 0 && fde_table->reach[i] > seek_pc; i--)
+	{
+	  struct dwarf2_fde *fde = fde_table->entries[i];
+
+	  if (best != NULL && fde->initial_location != best->initial_location)
+	    break;
+	  if (seek_pc < fde->initial_location + fde->address_range)
+	    best = fde;
+	}
 
-	  fde = fde->next;
+      if (best != NULL)
+	{
+	  *pc = best->initial_location + offset;
+	  return best;
 	}
     }
 
@@ -1620,10 +1679,144 @@ dwarf2_frame_find_fde (CORE_ADDR *pc)
 static void
 add_fde (struct comp_unit *unit, struct dwarf2_fde *fde)
 {
-  fde->next = objfile_data (unit->objfile, dwarf2_frame_objfile_data);
-  set_objfile_data (unit->objfile, dwarf2_frame_objfile_data, fde);
+  if (fde->address_range == 0)
+    /* Discard useless FDEs.  */
+    return;
+
+  if (unit->num_fdes == unit->fdes_alloced)
+    {
+      unit->fdes_alloced = unit->fdes_alloced ? unit->fdes_alloced * 2 : 1024;
+      unit->fdes = xrealloc (unit->fdes,
+			     unit->fdes_alloced * sizeof (unit->fdes[0]));
+    }
+  unit->fdes[unit->num_fdes++] = fde;
 }
 
+/* qsort() comparison function for sorting FDEs by initial location.
+   FDEs with the same initial location are ordered by address range,
+   then with the ones read from .debug_frame before the ones from
+   .eh_frame, and finally by their position in the section.  The
+   order is thus total, and exact duplicates end up next to each
+   other with the preferred entry first.  */
+
+static int
+qsort_fde_cmp (const void *a, const void *b)
+{
+  struct dwarf2_fde *aa = *(struct dwarf2_fde **) a;
+  struct dwarf2_fde *bb = *(struct dwarf2_fde **) b;
+
+  if (aa->initial_location != bb->initial_location)
+    return (aa->initial_location < bb->initial_location) ? -1 : 1;
+
+  if (aa->address_range != bb->address_range)
+    return (aa->address_range < bb->address_range) ? -1 : 1;
+
+  if (aa->eh_frame_p != bb->eh_frame_p)
+    return aa->eh_frame_p - bb->eh_frame_p;
+
+  if (aa->instructions != bb->instructions)
+    return (aa->instructions < bb->instructions) ? -1 : 1;
+
+  return 0;
+}
+
+/* Turn the FDEs collected in UNIT into the sorted lookup table of
+   UNIT->objfile.  Exact duplicates and --gc-sections leftovers are
+   squeezed out here; FDEs that merely overlap are all kept and
+   dwarf2_frame_find_fde picks between them.  */
+
+static void
+dwarf2_build_fde_table (struct comp_unit *unit)
+{
+  struct objfile *objfile = unit->objfile;
+  struct dwarf2_fde_table *fde_table, *old_table;
+  struct dwarf2_fde *first_non_zero_fde = NULL;
+  int i;
+
+  /* If frame info was already read for this objfile, merge it in
+     rather than losing it.  */
+  old_table = objfile_data (objfile, dwarf2_frame_objfile_data);
+  if (old_table != NULL)
+    for (i = 0; i < old_table->num_entries; i++)
+      add_fde (unit, old_table->entries[i]);
+
+  fde_table = (struct dwarf2_fde_table *)
+    obstack_alloc (&objfile->objfile_obstack,
+		   sizeof (struct dwarf2_fde_table));
+  fde_table->num_entries = 0;
+  fde_table->entries = NULL;
+  fde_table->reach = NULL;
+  fde_table->low = 0;
+  fde_table->high = 0;
+
+  if (unit->num_fdes > 0)
+    {
+      struct dwarf2_fde *prev = NULL;
+
+      qsort (unit->fdes, unit->num_fdes, sizeof (unit->fdes[0]),
+	     qsort_fde_cmp);
+
+      for (i = 0; i < unit->num_fdes; i++)
+	if (unit->fdes[i]->initial_location != 0)
+	  {
+	    first_non_zero_fde = unit->fdes[i];
+	    break;
+	  }
+
+      fde_table->entries = (struct dwarf2_fde **)
+	obstack_alloc (&objfile->objfile_obstack,
+		       unit->num_fdes * sizeof (fde_table->entries[0]));
+      fde_table->reach = (CORE_ADDR *)
+	obstack_alloc (&objfile->objfile_obstack,
+		       unit->num_fdes * sizeof (fde_table->reach[0]));
+
+      for (i = 0; i < unit->num_fdes; i++)
+	{
+	  struct dwarf2_fde *fde = unit->fdes[i];
+	  CORE_ADDR end;
+
+	  /* Discard leftovers from --gc-sections, which were relocated
+	     to address zero and would shadow real functions.  */
+	  if (fde->initial_location == 0
+	      && first_non_zero_fde != NULL
+	      && (first_non_zero_fde->initial_location
+		  < fde->initial_location + fde->address_range))
+	    continue;
+
+	  /* Squeeze out exact duplicates; the preferred entry sorted
+	     first.  */
+	  if (prev != NULL
+	      && prev->initial_location == fde->initial_location
+	      && prev->address_range == fde->address_range)
+	    continue;
+
+	  end = fde->initial_location + fde->address_range;
+	  if (fde_table->num_entries > 0
+	      && fde_table->reach[fde_table->num_entries - 1] > end)
+	    end = fde_table->reach[fde_table->num_entries - 1];
+
+	  fde_table->entries[fde_table->num_entries] = fde;
+	  fde_table->reach[fde_table->num_entries] = end;
+	  fde_table->num_entries++;
+	  prev = fde;
+	}
+
+      if (fde_table->num_entries > 0)
+	{
+	  fde_table->low = fde_table->entries[0]->initial_location;
+	  fde_table->high = fde_table->reach[fde_table->num_entries - 1];
+	}
+    }
+
+  xfree (unit->fdes);
+  unit->fdes = NULL;
+  unit->num_fdes = 0;
+  unit->fdes_alloced = 0;
+
+  set_objfile_data (objfile, dwarf2_frame_objfile_data, fde_table);
+}
+/* APPLE LOCAL end sorted fde table  */
+
 #ifdef CC_HAS_LONG_LONG
 #define DW64_CIE_ID 0xffffffffffffffffULL
 #else
@@ -1998,6 +2191,11 @@ dwarf2_build_frame_info (struct objfile *objfile)
   unit.objfile = objfile;
   unit.dbase = 0;
   unit.tbase = 0;
+  /* APPLE LOCAL begin sorted fde table  */
+  unit.fdes = NULL;
+  unit.num_fdes = 0;
+  unit.fdes_alloced = 0;
+  /* APPLE LOCAL end sorted fde table  */
 
   /* First add the information from the .eh_frame section.  That way,
      the FDEs from that section are searched last.  */
@@ -2043,6 +2241,9 @@ dwarf2_build_frame_info (struct objfile *objfile)
       while (frame_ptr < unit.dwarf_frame_buffer + unit.dwarf_frame_size)
 	frame_ptr = decode_frame_entry (&unit, frame_ptr, 0);
     }
+
+  /* APPLE LOCAL sorted fde table  */
+  dwarf2_build_fde_table (&unit);
 }
 
 /* Provide a prototype to silence -Wmissing-prototypes.  */
@@ -69,6 +69,25 @@
 #include <ctype.h>
 /* APPLE LOCAL objc_invalidate_objc_class */
 #include "objc-lang.h"
+/* APPLE LOCAL begin dwarf2 index cache  */
+#include "mach-o.h"
+#include "gdb_stat.h"
+#include "gdb_dirent.h"
+#include <utime.h>
+#ifdef HAVE_MMAP
+#include <sys/mman.h>
+#endif
+/* APPLE LOCAL end dwarf2 index cache  */
+/* APPLE LOCAL begin parallel psymtabs  */
+#include <setjmp.h>
+#ifdef HAVE_UNISTD_H
+#include <unistd.h>
+#endif
+#ifdef HAVE_PTHREAD_CREATE
+#include <pthread.h>
+#include <signal.h>
+#endif
+/* APPLE LOCAL end parallel psymtabs  */
 
 /* A note on memory usage for this file.
    
@@ -523,6 +542,24 @@ struct dwarf2_cu
 
   /* APPLE LOCAL debug map */
   struct oso_to_final_addr_map *addr_map;
+
+  /* APPLE LOCAL begin parallel psymtabs  */
+  /* If this compilation unit is being scanned for partial symbols on
+     a helper thread, the job doing it.  */
+  struct dwarf2_psymtab_job *job;
+
+  /* decode_locdesc describes the location to the caller through these.
+     They used to be file statics; they live here so that helper
+     threads scanning different compilation units don't share them.
+
+     ISREG is set if the object lives in a register, and
+     decode_locdesc's return value is the register number.  */
+  int isreg;
+
+  /* APPLE LOCAL: Track the current common block symbol so we can
+     properly offset addresses within that common block.  */
+  char *locdesc_common;
+  /* APPLE LOCAL end parallel psymtabs  */
 };
 
 /* Persistent data held for a compilation unit, even when not
@@ -554,6 +591,13 @@ struct dwarf2_per_cu_data
 
   /* The partial symbol table associated with this compilation unit.  */
   struct partial_symtab *psymtab;
+
+  /* APPLE LOCAL begin dwarf2 index cache  */
+  /* Set iff this is a C++ compilation unit without namespace debug
+     info, whose psymbols were passed to
+     cp_check_possible_namespace_symbols.  */
+  unsigned int cp_namespace_scan : 1;
+  /* APPLE LOCAL end dwarf2 index cache  */
 };
 
 /* APPLE LOCAL begin psym equivalences */
@@ -797,19 +841,6 @@ struct dwarf_block
 /* APPLE LOCAL avoid unused var warning.  */
 /* static struct partial_die_info zeroed_partial_die; */
 
-/* APPLE LOCAL: Track the current common block symbol so we can properly 
-   offset addresses within that common block.  */
-static char *decode_locdesc_common = NULL;
-
-/* FIXME: decode_locdesc sets these variables to describe the location
-   to the caller.  These ought to be a structure or something.   If
-   none of the flags are set, the object lives at the address returned
-   by decode_locdesc.  */
-
-static int isreg;		/* Object lives in register.
-				   decode_locdesc's return value is
-				   the register number.  */
-
 /* FIXME: We might want to set this from BFD via bfd_arch_bits_per_byte,
    but this would require a corresponding change in unpack_field_as_long
    and friends.  */
@@ -969,6 +1000,13 @@ static void dwarf2_build_include_psymtabs (struct dwarf2_cu *,
 
 static void dwarf2_build_psymtabs_hard (struct objfile *, int);
 
+/* APPLE LOCAL begin dwarf2 index cache  */
+static int dwarf2_index_cache_read (struct objfile *);
+
+static void dwarf2_index_cache_write (struct objfile *,
+				      struct partial_symtab *);
+/* APPLE LOCAL end dwarf2 index cache  */
+
 /* APPLE LOCAL begin psym equivalences  */
 static void scan_partial_symbols (struct partial_die_info *,
 				  CORE_ADDR *, CORE_ADDR *,
@@ -979,6 +1017,20 @@ static void scan_partial_symbols (struct partial_die_info *,
 static void add_partial_symbol (struct partial_die_info *,
 				struct dwarf2_cu *);
 
+/* APPLE LOCAL begin parallel psymtabs  */
+struct dwarf2_psymtab_job;
+
+static void dwarf2_add_psymbol (struct dwarf2_cu *, char *, domain_enum,
+				enum address_class, int, CORE_ADDR, int, int);
+
+static void dwarf2_add_psymbol_1 (struct objfile *, enum language, char *,
+				  int, domain_enum, enum address_class, int,
+				  CORE_ADDR, int, int);
+
+static void dwarf2_abandon_psymtab_job (struct dwarf2_psymtab_job *)
+     ATTR_NORETURN;
+/* APPLE LOCAL end parallel psymtabs  */
+
 static int pdi_needs_namespace (enum dwarf_tag tag);
 
 static void add_partial_namespace (struct partial_die_info *pdi,
@@ -2320,6 +2372,546 @@ scan_partial_inlined_function_symbols (struct dwarf2_cu *cu)
 }
 /* APPLE LOCAL end debug inlined section  */
 
+/* APPLE LOCAL begin parallel psymtabs  */
+
+/* A partial symbol found by a helper thread, to be added to the
+   objfile by the main thread.  The arguments are those of
+   dwarf2_add_psymbol.  */
+
+struct dwarf2_pending_psym
+{
+  char *name;
+  int namelength;
+  domain_enum domain;
+  enum address_class class;
+  CORE_ADDR coreaddr;
+  int isa_value;
+  unsigned int global : 1;
+  unsigned int check_namespace : 1;
+};
+
+enum dwarf2_psymtab_job_state
+{
+  /* Not started yet.  */
+  DWARF2_JOB_PENDING,
+  /* Being scanned on a helper thread.  */
+  DWARF2_JOB_RUNNING,
+  /* Scanned; the main thread can build the psymtab from it.  */
+  DWARF2_JOB_DONE,
+  /* The helper thread hit something only the main thread may do.  */
+  DWARF2_JOB_ABANDONED,
+  /* The main thread is reading this compilation unit itself.  */
+  DWARF2_JOB_CLAIMED
+};
+
+/* The partial symbol scan of one compilation unit.  A helper thread
+   reads the DIEs and collects the psymbols; the main thread then turns
+   the result into a psymtab, in .debug_info order, exactly as
+   dwarf2_build_psymtabs_hard would have done.  */
+
+struct dwarf2_psymtab_job
+{
+  struct objfile *objfile;
+  struct dwarf2_per_cu_data *per_cu;
+
+  /* The start of the compilation unit in .debug_info.  */
+  char *info_ptr;
+
+  enum dwarf2_psymtab_job_state state;
+
+  /* The compilation unit, allocated with xmalloc, and whether its
+     abbrev table has been read.  */
+  struct dwarf2_cu *cu;
+  int have_abbrevs;
+
+  struct partial_die_info comp_unit_die;
+  struct equiv_psym_list *equiv_psyms;
+
+  struct dwarf2_pending_psym *pending;
+  int n_pending;
+  int pending_size;
+
+  /* Set if read_partial_die saw a psym equivalence name, which sets
+     psym_equivalences on the serial path.  */
+  int saw_equiv_name;
+
+  /* Where dwarf2_abandon_psymtab_job returns to.  */
+  jmp_buf abandon;
+};
+
+/* "maint set dwarf2 psymtab-threads": how many helper threads scan
+   compilation units for partial symbols.  One means the main thread
+   does everything; zero means one thread per online processor.  */
+static int dwarf2_psymtab_threads = 1;
+
+static void
+show_dwarf2_psymtab_threads (struct ui_file *file, int from_tty,
+			     struct cmd_list_element *c, const char *value)
+{
+  fprintf_filtered (file, _("\
+The number of threads used to build DWARF 2 partial symbol tables is %s.\n"),
+		    value);
+}
+
+/* Leave the scan of JOB's compilation unit to the main thread.  */
+
+static void
+dwarf2_abandon_psymtab_job (struct dwarf2_psymtab_job *job)
+{
+  longjmp (job->abandon, 1);
+}
+
+/* Build the psymtab for a compilation unit a helper thread has
+   scanned, on the main thread.  This is the rest of the loop body of
+   dwarf2_build_psymtabs_hard.  Return a pointer to the next
+   compilation unit.  */
+
+static char *
+dwarf2_finish_psymtab_job (struct objfile *objfile,
+			   struct dwarf2_psymtab_job *job)
+{
+  struct dwarf2_cu *cu = job->cu;
+  struct dwarf2_per_cu_data *this_cu = job->per_cu;
+  struct partial_die_info *comp_unit_die = &job->comp_unit_die;
+  struct dwarf2_pending_psym *pending = job->pending;
+  struct partial_symtab *pst;
+  struct cleanup *back_to;
+  CORE_ADDR baseaddr;
+  char *next_cu;
+  int i;
+
+  /* From here on, CU and the queued psymbols belong to us.  */
+  job->cu = NULL;
+  job->pending = NULL;
+  back_to = make_cleanup (xfree, cu);
+  make_cleanup (xfree, pending);
+  make_cleanup (free_stack_comp_unit, cu);
+  make_cleanup (dwarf2_free_abbrev_table, cu);
+
+  pst = start_psymtab_common (objfile, objfile->section_offsets,
+			      comp_unit_die->name ? comp_unit_die->name : "",
+			      comp_unit_die->lowpc,
+			      objfile->global_psymbols.next,
+			      objfile->static_psymbols.next);
+
+  if (comp_unit_die->dirname)
+    pst->dirname = obsavestring (comp_unit_die->dirname,
+				 strlen (comp_unit_die->dirname),
+				 &objfile->objfile_obstack);
+
+  pst->read_symtab_private = (char *) this_cu;
+
+  baseaddr = objfile_text_section_offset (objfile);
+
+  pst->read_symtab = dwarf2_psymtab_to_symtab;
+
+  if (this_cu->cu != NULL)
+    free_one_cached_comp_unit (this_cu->cu);
+
+  cu->job = NULL;
+  cu->per_cu = this_cu;
+  this_cu->cu = cu;
+  this_cu->psymtab = pst;
+  /* APPLE LOCAL dwarf2 index cache  */
+  this_cu->cp_namespace_scan = (cu->language == language_cplus
+				&& cu->has_namespace_info == 0);
+
+  for (i = 0; i < job->n_pending; i++)
+    dwarf2_add_psymbol_1 (objfile, cu->language, pending[i].name,
+			  pending[i].namelength, pending[i].domain,
+			  pending[i].class, pending[i].global,
+			  pending[i].coreaddr, pending[i].isa_value,
+			  pending[i].check_namespace);
+  job->n_pending = 0;
+
+  /* APPLE LOCAL debug inlined section  */
+  scan_partial_inlined_function_symbols (cu);
+
+  pst->equiv_psyms = job->equiv_psyms;
+  if (job->saw_equiv_name)
+    psym_equivalences = 1;
+  job->equiv_psyms = NULL;
+
+  pst->textlow = comp_unit_die->lowpc + baseaddr;
+  pst->texthigh = comp_unit_die->highpc + baseaddr;
+
+  pst->n_global_syms = objfile->global_psymbols.next -
+    (objfile->global_psymbols.list + pst->globals_offset);
+  pst->n_static_syms = objfile->static_psymbols.next -
+    (objfile->static_psymbols.list + pst->statics_offset);
+  sort_pst_symbols (pst);
+
+  free_named_symtabs (pst->filename);
+
+  next_cu = job->info_ptr + cu->header.length + cu->header.initial_length_size;
+
+  if (comp_unit_die->has_stmt_list)
+    dwarf2_build_include_psymtabs (cu, comp_unit_die, pst);
+
+  do_cleanups (back_to);
+  return next_cu;
+}
+
+#ifdef HAVE_PTHREAD_CREATE
+
+/* Return non-zero if nothing in CU's abbrev table needs the DWARF
+   repository, which only the main thread may open.  */
+
+static int
+dwarf2_abbrevs_helper_safe_p (struct dwarf2_cu *cu)
+{
+  struct abbrev_info *abbrev;
+  unsigned int i, j;
+
+  for (i = 0; i < ABBREV_HASH_SIZE; i++)
+    for (abbrev = cu->dwarf2_abbrevs[i]; abbrev != NULL; abbrev = abbrev->next)
+      for (j = 0; j < abbrev->num_attrs; j++)
+	if (abbrev->attrs[j].name == DW_AT_APPLE_repository_file
+	    || abbrev->attrs[j].form == DW_FORM_APPLE_db_str)
+	  return 0;
+  return 1;
+}
+
+/* Scan JOB's compilation unit for partial symbols.  This runs on a
+   helper thread, so it only does the part of the loop body in
+   dwarf2_build_psymtabs_hard that touches nothing but the compilation
+   unit itself; psymbols are queued on JOB.  Anything else (an error, a
+   complaint, a reference into another compilation unit, the DWARF
+   repository, the C++ name parser) abandons the job, and the main
+   thread reads the compilation unit the usual way.  Return non-zero
+   if the job was finished.  */
+
+static int
+dwarf2_run_psymtab_job (struct dwarf2_psymtab_job *job)
+{
+  struct objfile *objfile = job->objfile;
+  bfd *abfd = objfile->obfd;
+  struct partial_die_info *comp_unit_die = &job->comp_unit_die;
+  struct dwarf2_cu *cu;
+  struct abbrev_info *abbrev;
+  unsigned int bytes_read;
+  char *info_ptr;
+
+  if (setjmp (job->abandon) != 0)
+    return 0;
+
+  cu = xmalloc (sizeof (struct dwarf2_cu));
+  memset (cu, 0, sizeof (struct dwarf2_cu));
+  obstack_init (&cu->comp_unit_obstack);
+  job->cu = cu;
+
+  cu->objfile = objfile;
+  cu->job = job;
+  info_ptr = partial_read_comp_unit_head (&cu->header, job->info_ptr, abfd);
+
+  cu->header.offset = job->info_ptr - dwarf2_per_objfile->info_buffer;
+  cu->header.first_die_ptr = info_ptr;
+  cu->header.cu_head_ptr = job->info_ptr;
+
+  cu->list_in_scope = &file_symbols;
+
+  dwarf2_read_abbrevs (abfd, cu);
+  job->have_abbrevs = 1;
+  if (!dwarf2_abbrevs_helper_safe_p (cu))
+    dwarf2_abandon_psymtab_job (job);
+
+  abbrev = peek_die_abbrev (info_ptr, (int *) &bytes_read, cu);
+  info_ptr = read_partial_die (comp_unit_die, abbrev, bytes_read,
+			       abfd, info_ptr, cu);
+
+  set_cu_language (comp_unit_die->language, cu);
+
+  /* Without namespace info, guess_structure_name runs the C++ name
+     parser, which is not reentrant.  */
+  if ((cu->language == language_cplus || cu->language == language_java)
+      && cu->has_namespace_info == 0)
+    dwarf2_abandon_psymtab_job (job);
+
+  if (comp_unit_die->has_children)
+    {
+      struct partial_die_info *first_die;
+      CORE_ADDR lowpc = ((CORE_ADDR) -1);
+      CORE_ADDR highpc = ((CORE_ADDR) 0);
+
+      first_die = load_partial_dies (abfd, info_ptr, 1, cu);
+
+      scan_partial_symbols (first_die, &lowpc, &highpc, cu,
+			    &job->equiv_psyms);
+
+      if (lowpc == ((CORE_ADDR) -1))
+	lowpc = highpc;
+
+      if (! comp_unit_die->has_pc_info)
+	{
+	  comp_unit_die->lowpc = lowpc;
+	  comp_unit_die->highpc = highpc;
+	}
+    }
+
+  return 1;
+}
+
+/* Release what a helper thread allocated for JOB.  */
+
+static void
+dwarf2_discard_psymtab_job (struct dwarf2_psymtab_job *job)
+{
+  int i;
+
+  if (job->cu != NULL)
+    {
+      if (job->have_abbrevs)
+	dwarf2_free_abbrev_table (job->cu);
+      obstack_free (&job->cu->comp_unit_obstack, NULL);
+      xfree (job->cu);
+      job->cu = NULL;
+    }
+  if (job->equiv_psyms != NULL)
+    {
+      for (i = 0; i < job->equiv_psyms->num_syms; i++)
+	xfree (job->equiv_psyms->sym_list[i]);
+      xfree (job->equiv_psyms->sym_list);
+      xfree (job->equiv_psyms);
+      job->equiv_psyms = NULL;
+    }
+  xfree (job->pending);
+  job->pending = NULL;
+  job->n_pending = 0;
+}
+
+/* The helper threads working on one objfile.  Jobs are handed out in
+   .debug_info order, and at most WINDOW jobs past the one the main
+   thread is waiting for may be in memory at a time.  */
+
+struct dwarf2_psymtab_pool
+{
+  pthread_mutex_t lock;
+  pthread_cond_t cond;
+
+  struct dwarf2_psymtab_job *jobs;
+  int n_jobs;
+
+  /* The next job for a helper thread to take.  */
+  int next;
+
+  /* The job the main thread is waiting for.  */
+  int merged;
+
+  int window;
+  int stop;
+
+  pthread_t *threads;
+  int n_threads;
+};
+
+/* The job the current helper thread is running, if any.  */
+static pthread_key_t dwarf2_psymtab_job_key;
+
+/* Installed as helper_thread_check_hook.  */
+
+static void
+dwarf2_psymtab_helper_check (void)
+{
+  struct dwarf2_psymtab_job *job;
+
+  job = pthread_getspecific (dwarf2_psymtab_job_key);
+  if (job != NULL)
+    dwarf2_abandon_psymtab_job (job);
+}
+
+static void *
+dwarf2_psymtab_helper (void *arg)
+{
+  struct dwarf2_psymtab_pool *pool = arg;
+
+  pthread_mutex_lock (&pool->lock);
+  while (!pool->stop && pool->next < pool->n_jobs)
+    {
+      struct dwarf2_psymtab_job *job;
+      int ok;
+
+      if (pool->next >= pool->merged + pool->window)
+	{
+	  pthread_cond_wait (&pool->cond, &pool->lock);
+	  continue;
+	}
+
+      job = &pool->jobs[pool->next++];
+      job->state = DWARF2_JOB_RUNNING;
+      pthread_mutex_unlock (&pool->lock);
+
+      pthread_setspecific (dwarf2_psymtab_job_key, job);
+      ok = dwarf2_run_psymtab_job (job);
+      pthread_setspecific (dwarf2_psymtab_job_key, NULL);
+
+      pthread_mutex_lock (&pool->lock);
+      job->state = ok ? DWARF2_JOB_DONE : DWARF2_JOB_ABANDONED;
+      pthread_cond_broadcast (&pool->cond);
+    }
+  pthread_mutex_unlock (&pool->lock);
+
+  return NULL;
+}
+
+/* Stop POOL's threads and free everything it still holds.  */
+
+static void
+dwarf2_stop_psymtab_pool (void *arg)
+{
+  struct dwarf2_psymtab_pool *pool = arg;
+  int i;
+
+  pthread_mutex_lock (&pool->lock);
+  pool->stop = 1;
+  pthread_cond_broadcast (&pool->cond);
+  pthread_mutex_unlock (&pool->lock);
+
+  for (i = 0; i < pool->n_threads; i++)
+    pthread_join (pool->threads[i], NULL);
+
+  for (i = 0; i < pool->n_jobs; i++)
+    dwarf2_discard_psymtab_job (&pool->jobs[i]);
+
+  pthread_cond_destroy (&pool->cond);
+  pthread_mutex_destroy (&pool->lock);
+  xfree (pool->threads);
+  xfree (pool->jobs);
+  xfree (pool);
+}
+
+/* Start helper threads to scan OBJFILE's compilation units, if
+   "maint set dwarf2 psymtab-threads" asks for them.  Return NULL if
+   the main thread should do all the work.  */
+
+static struct dwarf2_psymtab_pool *
+dwarf2_start_psymtab_pool (struct objfile *objfile)
+{
+  struct dwarf2_psymtab_pool *pool;
+  int n_threads = dwarf2_psymtab_threads;
+  sigset_t all_signals, old_signals;
+  int i;
+
+  if (n_threads == 0)
+    {
+#ifdef _SC_NPROCESSORS_ONLN
+      n_threads = sysconf (_SC_NPROCESSORS_ONLN);
+#endif
+    }
+  if (n_threads <= 1 || dwarf2_per_objfile->n_comp_units < 2)
+    return NULL;
+
+  /* Without the hook, an error on a helper thread would unwind the
+     main thread's cleanup chain.  */
+  if (helper_thread_check_hook != dwarf2_psymtab_helper_check)
+    return NULL;
+
+  pool = XZALLOC (struct dwarf2_psymtab_pool);
+  pool->n_jobs = dwarf2_per_objfile->n_comp_units;
+  pool->jobs = xcalloc (pool->n_jobs, sizeof (struct dwarf2_psymtab_job));
+  for (i = 0; i < pool->n_jobs; i++)
+    {
+      struct dwarf2_psymtab_job *job = &pool->jobs[i];
+
+      job->objfile = objfile;
+      job->per_cu = dwarf2_per_objfile->all_comp_units[i];
+      job->info_ptr = dwarf2_per_objfile->info_buffer + job->per_cu->offset;
+      job->state = DWARF2_JOB_PENDING;
+    }
+  pool->window = 8 * n_threads;
+
+  pthread_mutex_init (&pool->lock, NULL);
+  pthread_cond_init (&pool->cond, NULL);
+
+  /* Signals are for the main thread; the helpers inherit a mask that
+     blocks them all.  */
+  sigfillset (&all_signals);
+  pthread_sigmask (SIG_BLOCK, &all_signals, &old_signals);
+
+  pool->threads = xcalloc (n_threads, sizeof (pthread_t));
+  for (i = 0; i < n_threads; i++)
+    {
+      if (pthread_create (&pool->threads[pool->n_threads], NULL,
+			  dwarf2_psymtab_helper, pool) != 0)
+	break;
+      pool->n_threads++;
+    }
+
+  pthread_sigmask (SIG_SETMASK, &old_signals, NULL);
+
+  if (pool->n_threads == 0)
+    {
+      dwarf2_stop_psymtab_pool (pool);
+      return NULL;
+    }
+
+  return pool;
+}
+
+/* Wait until job I of POOL can be consumed by the main thread.  Return
+   the job if a helper thread finished it, or NULL if the main thread
+   has to read the compilation unit itself.  */
+
+static struct dwarf2_psymtab_job *
+dwarf2_wait_psymtab_job (struct dwarf2_psymtab_pool *pool, int i)
+{
+  struct dwarf2_psymtab_job *job;
+
+  pthread_mutex_lock (&pool->lock);
+  pool->merged = i;
+  pthread_cond_broadcast (&pool->cond);
+
+  if (i >= pool->n_jobs)
+    {
+      pthread_mutex_unlock (&pool->lock);
+      return NULL;
+    }
+
+  job = &pool->jobs[i];
+
+  /* If no helper has got to it yet, don't wait for one.  Jobs are
+     handed out in order, so this is the next one.  */
+  if (job->state == DWARF2_JOB_PENDING)
+    {
+      job->state = DWARF2_JOB_CLAIMED;
+      pool->next = i + 1;
+    }
+
+  while (job->state == DWARF2_JOB_RUNNING)
+    pthread_cond_wait (&pool->cond, &pool->lock);
+  pthread_mutex_unlock (&pool->lock);
+
+  if (job->state == DWARF2_JOB_DONE)
+    return job;
+
+  dwarf2_discard_psymtab_job (job);
+  return NULL;
+}
+
+#else /* HAVE_PTHREAD_CREATE */
+
+struct dwarf2_psymtab_pool;
+
+static struct dwarf2_psymtab_pool *
+dwarf2_start_psymtab_pool (struct objfile *objfile)
+{
+  return NULL;
+}
+
+static void
+dwarf2_stop_psymtab_pool (void *arg)
+{
+}
+
+static struct dwarf2_psymtab_job *
+dwarf2_wait_psymtab_job (struct dwarf2_psymtab_pool *pool, int i)
+{
+  return NULL;
+}
+
+#endif /* HAVE_PTHREAD_CREATE */
+
+/* APPLE LOCAL end parallel psymtabs  */
+
 /* Build the partial symbol table by doing a quick pass through the
    .debug_info and .debug_abbrev sections.  */
 
@@ -2335,6 +2927,12 @@ dwarf2_build_psymtabs_hard (struct objfile *objfile, int mainline)
   struct partial_symtab *pst;
   struct cleanup *back_to;
   CORE_ADDR lowpc, highpc, baseaddr;
+  /* APPLE LOCAL dwarf2 index cache  */
+  struct partial_symtab *old_psymtabs;
+  /* APPLE LOCAL begin parallel psymtabs  */
+  struct dwarf2_psymtab_pool *pool;
+  int cu_index = 0;
+  /* APPLE LOCAL end parallel psymtabs  */
 
   /* APPLE LOCAL begin dwarf repository  */
   if (bfd_big_endian (abfd) == BFD_ENDIAN_BIG)
@@ -2350,6 +2948,21 @@ dwarf2_build_psymtabs_hard (struct objfile *objfile, int mainline)
 
   create_all_comp_units (objfile);
 
+  /* APPLE LOCAL begin dwarf2 index cache  */
+  if (dwarf2_index_cache_read (objfile))
+    {
+      do_cleanups (back_to);
+      return;
+    }
+  old_psymtabs = objfile->psymtabs;
+  /* APPLE LOCAL end dwarf2 index cache  */
+
+  /* APPLE LOCAL begin parallel psymtabs  */
+  pool = dwarf2_start_psymtab_pool (objfile);
+  if (pool != NULL)
+    make_cleanup (dwarf2_stop_psymtab_pool, pool);
+  /* APPLE LOCAL end parallel psymtabs  */
+
   /* Since the objects we're extracting from .debug_info vary in
      length, only the individual functions to extract them (like
      read_comp_unit_head and load_partial_die) can really know whether
@@ -2372,7 +2985,23 @@ dwarf2_build_psymtabs_hard (struct objfile *objfile, int mainline)
       unsigned int bytes_read;
       struct dwarf2_per_cu_data *this_cu;
 
-      beg_of_comp_unit = info_ptr;
+      /* APPLE LOCAL begin parallel psymtabs  */
+      /* If a helper thread has already scanned this compilation unit,
+	 just build its psymtab.  */
+      if (pool != NULL)
+	{
+	  struct dwarf2_psymtab_job *job;
+
+	  job = dwarf2_wait_psymtab_job (pool, cu_index++);
+	  if (job != NULL)
+	    {
+	      info_ptr = dwarf2_finish_psymtab_job (objfile, job);
+	      continue;
+	    }
+	}
+      /* APPLE LOCAL end parallel psymtabs  */
+
+      beg_of_comp_unit = info_ptr;
 
       memset (&cu, 0, sizeof (cu));
 
@@ -2447,6 +3076,9 @@ dwarf2_build_psymtabs_hard (struct objfile *objfile, int mainline)
       this_cu->cu = &cu;
 
       this_cu->psymtab = pst;
+      /* APPLE LOCAL dwarf2 index cache  */
+      this_cu->cp_namespace_scan = (cu.language == language_cplus
+				    && cu.has_namespace_info == 0);
 
       /* Check if comp unit has_children.
          If so, read the rest of the partial symbols from this comp unit.
@@ -2513,175 +3145,1104 @@ dwarf2_build_psymtabs_hard (struct objfile *objfile, int mainline)
     }
 
   sort_objfile_thumb_psyms (objfile);
+
+  /* APPLE LOCAL dwarf2 index cache  */
+  dwarf2_index_cache_write (objfile, old_psymtabs);
     
   do_cleanups (back_to);
 
-}
+}
+
+/* Load the DIEs for a secondary CU into memory.  */
+
+static void
+load_comp_unit (struct dwarf2_per_cu_data *this_cu, struct objfile *objfile)
+{
+  bfd *abfd = objfile->obfd;
+  char *info_ptr, *beg_of_comp_unit;
+  struct partial_die_info comp_unit_die;
+  struct dwarf2_cu *cu;
+  struct abbrev_info *abbrev;
+  unsigned int bytes_read;
+  struct cleanup *back_to;
+
+  info_ptr = dwarf2_per_objfile->info_buffer + this_cu->offset;
+  beg_of_comp_unit = info_ptr;
+
+  cu = xmalloc (sizeof (struct dwarf2_cu));
+  memset (cu, 0, sizeof (struct dwarf2_cu));
+
+  obstack_init (&cu->comp_unit_obstack);
+
+  cu->objfile = objfile;
+  info_ptr = partial_read_comp_unit_head (&cu->header, info_ptr, abfd);
+
+  /* Complete the cu_header.  */
+  cu->header.offset = beg_of_comp_unit - dwarf2_per_objfile->info_buffer;
+  cu->header.first_die_ptr = info_ptr;
+  cu->header.cu_head_ptr = beg_of_comp_unit;
+
+  /* Read the abbrevs for this compilation unit into a table.  */
+  dwarf2_read_abbrevs (abfd, cu);
+  back_to = make_cleanup (dwarf2_free_abbrev_table, cu);
+
+  /* Read the compilation unit die.  */
+  /* APPLE LOCAL Add cast to avoid type mismatch in arg2 warning.  */
+  abbrev = peek_die_abbrev (info_ptr, (int *) &bytes_read, cu);
+  info_ptr = read_partial_die (&comp_unit_die, abbrev, bytes_read,
+			       abfd, info_ptr, cu);
+
+  /* Set the language we're debugging.  */
+  set_cu_language (comp_unit_die.language, cu);
+
+  /* Link this compilation unit into the compilation unit tree.  */
+  this_cu->cu = cu;
+  cu->per_cu = this_cu;
+
+  /* Check if comp unit has_children.
+     If so, read the rest of the partial symbols from this comp unit.
+     If not, there's no more debug_info for this comp unit. */
+  if (comp_unit_die.has_children)
+    load_partial_dies (abfd, info_ptr, 0, cu);
+
+  do_cleanups (back_to);
+}
+
+/* Create a list of all compilation units in OBJFILE.  We do this only
+   if an inter-comp-unit reference is found; presumably if there is one,
+   there will be many, and one will occur early in the .debug_info section.
+   So there's no point in building this list incrementally.  */
+
+static void
+create_all_comp_units (struct objfile *objfile)
+{
+  int n_allocated;
+  int n_comp_units;
+  struct dwarf2_per_cu_data **all_comp_units;
+  char *info_ptr = dwarf2_per_objfile->info_buffer;
+
+  n_comp_units = 0;
+  n_allocated = 10;
+  all_comp_units = xmalloc (n_allocated
+			    * sizeof (struct dwarf2_per_cu_data *));
+  
+  while (info_ptr < dwarf2_per_objfile->info_buffer + dwarf2_per_objfile->info_size)
+    {
+      struct comp_unit_head cu_header;
+      /* APPLE LOCAL avoid unused var warning.  */
+      /* char *beg_of_comp_unit; */
+      struct dwarf2_per_cu_data *this_cu;
+      unsigned long offset;
+      int bytes_read;
+
+      offset = info_ptr - dwarf2_per_objfile->info_buffer;
+
+      /* Read just enough information to find out where the next
+	 compilation unit is.  */
+      cu_header.initial_length_size = 0;
+      cu_header.length = read_initial_length (objfile->obfd, info_ptr,
+					      &cu_header, &bytes_read);
+
+      /* Save the compilation unit for later lookup.  */
+      this_cu = obstack_alloc (&objfile->objfile_obstack,
+			       sizeof (struct dwarf2_per_cu_data));
+      memset (this_cu, 0, sizeof (*this_cu));
+      this_cu->offset = offset;
+      this_cu->length = cu_header.length + cu_header.initial_length_size;
+
+      if (n_comp_units == n_allocated)
+	{
+	  n_allocated *= 2;
+	  all_comp_units = xrealloc (all_comp_units,
+				     n_allocated
+				     * sizeof (struct dwarf2_per_cu_data *));
+	}
+      all_comp_units[n_comp_units++] = this_cu;
+
+      info_ptr = info_ptr + this_cu->length;
+    }
+
+  dwarf2_per_objfile->all_comp_units
+    = obstack_alloc (&objfile->objfile_obstack,
+		     n_comp_units * sizeof (struct dwarf2_per_cu_data *));
+  memcpy (dwarf2_per_objfile->all_comp_units, all_comp_units,
+	  n_comp_units * sizeof (struct dwarf2_per_cu_data *));
+  xfree (all_comp_units);
+  dwarf2_per_objfile->n_comp_units = n_comp_units;
+}
+
+/* APPLE LOCAL begin psym equivalences  */
+/* EQUIV_PSYMS is an array of equivalence psym names found in the
+   current compile unit so far, along with some book-keeping
+   information (size of the array, etc).  NAME is a new equivalence
+   name to be added to the list.  This function makes sure the array
+   is big enough, allocating memory and updating the book-keeping if
+   necessary, and adds the new name to the array.  */
+
+static void
+add_equiv_psym (struct equiv_psym_list **equiv_psyms,
+		char *name)
+{
+  int i;
+
+  /* If the array has never been allocated, malloc it and start it out
+     with 10 elements.  */
+
+  if (*equiv_psyms == NULL)
+    {
+      *equiv_psyms = (struct equiv_psym_list *) xmalloc 
+                                            (sizeof (struct equiv_psym_list));
+      (*equiv_psyms)->sym_list = (char **) xmalloc (10 * sizeof (char *));
+      (*equiv_psyms)->list_size = 10;
+      (*equiv_psyms)->num_syms = 0;
+      for (i = 0; i < 10; i++)
+	(*equiv_psyms)->sym_list[i] = NULL;
+    }
+
+  /* If the array is full, double its size (using realloc).  */
+
+  if ((*equiv_psyms)->num_syms == (*equiv_psyms)->list_size)
+    {
+      int new_size;
+      new_size = (*equiv_psyms)->list_size * 2;
+      (*equiv_psyms)->sym_list = (char **) xrealloc ((*equiv_psyms)->sym_list,
+						     new_size * sizeof (char *));
+      for (i = (*equiv_psyms)->list_size; i < new_size; i++)
+	(*equiv_psyms)->sym_list[i] = NULL;
+      (*equiv_psyms)->list_size = new_size;
+    }
+
+  /* Insert NAME into the list.  */
+
+  (*equiv_psyms)->sym_list[(*equiv_psyms)->num_syms++] = name;
+}
+/* APPLE LOCAL end psym equivalences  */
+
+/* APPLE LOCAL begin dwarf2 index cache  */
+
+/* An on-disk cache of the partial symbol tables that
+   dwarf2_build_psymtabs_hard builds.  For a large dSYM, most of the
+   startup time goes into scanning .debug_info, and the result depends
+   only on the file's contents.  So we save each compilation unit's
+   psymtab boundaries, psymbols and address range in a file keyed by
+   the objfile's UUID (or its name, if it has no UUID) and its mtime.
+   The next time the same file is loaded, we rebuild the psymtabs from
+   that file and never look at the DIEs.
+
+   The file can be mapped in and used in place.  Its layout is:
+
+     struct dwarf2_index_cache_header  header
+     struct dwarf2_index_cache_cu      cus[n_cus]
+     struct dwarf2_index_cache_psym    psyms[n_psyms]
+     uint32_t                          names[n_names]
+     char                              strtab[strtab_size]
+
+   Every string is stored as an offset into STRTAB.  NAMES holds the
+   psym equivalence names of each compilation unit, followed by the
+   names of its include psymtabs.  The CUs appear in .debug_info
+   order.  Addresses are stored unrelocated.  Everything is in host
+   byte order; a file written on another host fails the magic number
+   check and counts as a miss.  */
+
+#define DWARF2_INDEX_CACHE_MAGIC 0x47444958	/* "GDIX" */
+#define DWARF2_INDEX_CACHE_VERSION 1
+#define DWARF2_INDEX_CACHE_SUFFIX ".gdbindex"
+#define DWARF2_INDEX_CACHE_NO_NAME ((uint32_t) -1)
+
+/* Header flag: the file is keyed by UUID rather than by name.  */
+#define DWARF2_INDEX_CACHE_BY_UUID 0x1
+
+/* CU flag: the CU is C++ with no DW_TAG_namespace info, so its
+   function and variable psymbols went through
+   cp_check_possible_namespace_symbols.  */
+#define DWARF2_INDEX_CU_CP_NAMESPACE 0x1
+
+/* Psymbol flag: the function was marked as Thumb code.  */
+#define DWARF2_INDEX_PSYM_THUMB 0x1
+
+struct dwarf2_index_cache_header
+{
+  uint32_t magic;
+  uint32_t version;
+  uint64_t mtime;
+  uint64_t info_size;
+  uint32_t flags;
+  uint32_t objfile_name;
+  uint32_t n_cus;
+  uint32_t n_psyms;
+  uint32_t n_names;
+  uint32_t strtab_size;
+};
+
+struct dwarf2_index_cache_cu
+{
+  uint64_t textlow;
+  uint64_t texthigh;
+  uint32_t offset;
+  uint32_t filename;
+  uint32_t dirname;
+  uint32_t flags;
+  /* The global psymbols come first, then the static ones.  */
+  uint32_t first_psym;
+  uint32_t n_global_syms;
+  uint32_t n_static_syms;
+  /* The equivalence names come first, then the include names.  */
+  uint32_t first_name;
+  uint32_t n_equiv_names;
+  uint32_t n_include_names;
+};
+
+struct dwarf2_index_cache_psym
+{
+  /* The unrelocated address, for LOC_BLOCK and LOC_STATIC symbols.  */
+  uint64_t value;
+  uint32_t name;
+  uint8_t domain;
+  uint8_t aclass;
+  uint8_t language;
+  uint8_t flags;
+};
+
+/* "maint set dwarf2 index-cache": whether we read and write the cache.  */
+static int dwarf2_index_cache_enabled = 0;
+
+/* "maint set dwarf2 index-cache-directory".  */
+static char *dwarf2_index_cache_directory = NULL;
+
+/* "maint set dwarf2 index-cache-size-limit": the most space, in
+   megabytes, the cache directory may use.  When a write pushes it
+   over that limit, we remove the least recently used files.  Zero
+   means no limit.  */
+static int dwarf2_index_cache_size_limit = 256;
+
+/* Counters for "maint info dwarf2-index-cache".  */
+static int dwarf2_index_cache_hits = 0;
+static int dwarf2_index_cache_misses = 0;
+static int dwarf2_index_cache_writes = 0;
+
+static void
+show_dwarf2_index_cache_enabled (struct ui_file *file, int from_tty,
+				 struct cmd_list_element *c, const char *value)
+{
+  fprintf_filtered (file, _("Use of the DWARF 2 index cache is %s.\n"),
+		    value);
+}
+
+static void
+show_dwarf2_index_cache_directory (struct ui_file *file, int from_tty,
+				   struct cmd_list_element *c,
+				   const char *value)
+{
+  fprintf_filtered (file, _("The DWARF 2 index cache directory is \"%s\".\n"),
+		    value);
+}
+
+static void
+show_dwarf2_index_cache_size_limit (struct ui_file *file, int from_tty,
+				    struct cmd_list_element *c,
+				    const char *value)
+{
+  fprintf_filtered (file, _("\
+The size limit of the DWARF 2 index cache is %s megabytes.\n"),
+		    value);
+}
+
+/* Return the name of the cache file for OBJFILE in a string allocated
+   with xmalloc, or NULL if no cache directory is set.  Set *BY_UUID
+   to 1 if the name is built from OBJFILE's UUID.  */
+
+static char *
+dwarf2_index_cache_file_name (struct objfile *objfile, int *by_uuid)
+{
+  unsigned char uuid[16];
+  const char *kind;
+  char key[2 * sizeof (uuid) + 1];
+  int i;
+
+  if (dwarf2_index_cache_directory == NULL
+      || *dwarf2_index_cache_directory == '\0')
+    return NULL;
+
+  /* A dSYM has the same UUID as its executable, and either one might
+     carry DWARF.  Keep their entries apart.  */
+  kind = objfile->separate_debug_objfile_backlink != NULL ? "-dsym" : "";
+
+  if (bfd_mach_o_get_uuid (objfile->obfd, uuid, sizeof (uuid)))
+    {
+      for (i = 0; i < sizeof (uuid); i++)
+	sprintf (key + 2 * i, "%02x", uuid[i]);
+      *by_uuid = 1;
+      return xstrprintf ("%s/%s%s%s", dwarf2_index_cache_directory, key,
+			 kind, DWARF2_INDEX_CACHE_SUFFIX);
+    }
+
+  *by_uuid = 0;
+  return xstrprintf ("%s/%s-%08lx%s%s", dwarf2_index_cache_directory,
+		     lbasename (objfile->name),
+		     (unsigned long) htab_hash_string (objfile->name),
+		     kind, DWARF2_INDEX_CACHE_SUFFIX);
+}
+
+/* Check the cache file contents in DATA, SIZE bytes long, against
+   OBJFILE and make sure every offset in it is in range.  */
+
+static int
+dwarf2_index_cache_valid_p (struct objfile *objfile, const char *data,
+			    ULONGEST size, int by_uuid)
+{
+  const struct dwarf2_index_cache_header *hdr;
+  const struct dwarf2_index_cache_cu *cus;
+  const struct dwarf2_index_cache_psym *psyms;
+  const uint32_t *names;
+  const char *strtab;
+  ULONGEST need;
+  uint32_t i;
+
+  hdr = (const struct dwarf2_index_cache_header *) data;
+  if (size < sizeof (*hdr)
+      || hdr->magic != DWARF2_INDEX_CACHE_MAGIC
+      || hdr->version != DWARF2_INDEX_CACHE_VERSION)
+    return 0;
+
+  if (hdr->mtime != (uint64_t) objfile->mtime
+      || hdr->info_size != dwarf2_per_objfile->info_size
+      || hdr->n_cus != dwarf2_per_objfile->n_comp_units
+      || ((hdr->flags & DWARF2_INDEX_CACHE_BY_UUID) != 0) != by_uuid)
+    return 0;
+
+  need = sizeof (*hdr)
+    + (ULONGEST) hdr->n_cus * sizeof (struct dwarf2_index_cache_cu)
+    + (ULONGEST) hdr->n_psyms * sizeof (struct dwarf2_index_cache_psym)
+    + (ULONGEST) hdr->n_names * sizeof (uint32_t)
+    + hdr->strtab_size;
+  if (need != size)
+    return 0;
+
+  cus = (const struct dwarf2_index_cache_cu *) (hdr + 1);
+  psyms = (const struct dwarf2_index_cache_psym *) (cus + hdr->n_cus);
+  names = (const uint32_t *) (psyms + hdr->n_psyms);
+  strtab = (const char *) (names + hdr->n_names);
+
+  if (hdr->strtab_size == 0
+      || strtab[hdr->strtab_size - 1] != '\0'
+      || hdr->objfile_name >= hdr->strtab_size)
+    return 0;
+
+  /* Without a UUID, the name in the file name is only a hash.  */
+  if (!by_uuid && strcmp (strtab + hdr->objfile_name, objfile->name) != 0)
+    return 0;
+
+  for (i = 0; i < hdr->n_cus; i++)
+    {
+      const struct dwarf2_index_cache_cu *c = &cus[i];
+
+      if (c->offset != dwarf2_per_objfile->all_comp_units[i]->offset
+	  || c->filename >= hdr->strtab_size
+	  || (c->dirname != DWARF2_INDEX_CACHE_NO_NAME
+	      && c->dirname >= hdr->strtab_size)
+	  || ((ULONGEST) c->first_psym + c->n_global_syms + c->n_static_syms
+	      > hdr->n_psyms)
+	  || ((ULONGEST) c->first_name + c->n_equiv_names + c->n_include_names
+	      > hdr->n_names))
+	return 0;
+    }
+
+  for (i = 0; i < hdr->n_psyms; i++)
+    if (psyms[i].name >= hdr->strtab_size
+	|| psyms[i].domain > METHODS_DOMAIN
+	|| psyms[i].language >= nr_languages)
+      return 0;
+
+  for (i = 0; i < hdr->n_names; i++)
+    if (names[i] >= hdr->strtab_size)
+      return 0;
+
+  return 1;
+}
+
+/* Rebuild the psymtabs for OBJFILE from the validated cache contents
+   in DATA.  This does what dwarf2_build_psymtabs_hard and
+   add_partial_symbol would have done with the DIEs.  */
+
+static void
+dwarf2_index_cache_replay (struct objfile *objfile, const char *data)
+{
+  const struct dwarf2_index_cache_header *hdr;
+  const struct dwarf2_index_cache_cu *cus;
+  const struct dwarf2_index_cache_psym *psyms;
+  const uint32_t *names;
+  const char *strtab;
+  CORE_ADDR baseaddr;
+  uint32_t i, j;
+
+  hdr = (const struct dwarf2_index_cache_header *) data;
+  cus = (const struct dwarf2_index_cache_cu *) (hdr + 1);
+  psyms = (const struct dwarf2_index_cache_psym *) (cus + hdr->n_cus);
+  names = (const uint32_t *) (psyms + hdr->n_psyms);
+  strtab = (const char *) (names + hdr->n_names);
+
+  baseaddr = objfile_text_section_offset (objfile);
+
+  for (i = 0; i < hdr->n_cus; i++)
+    {
+      const struct dwarf2_index_cache_cu *c = &cus[i];
+      struct dwarf2_per_cu_data *this_cu;
+      struct equiv_psym_list *equiv_psyms = NULL;
+      struct partial_symtab *pst;
+      const uint32_t *cu_names;
+
+      this_cu = dwarf2_per_objfile->all_comp_units[i];
+
+      pst = start_psymtab_common (objfile, objfile->section_offsets,
+				  (char *) strtab + c->filename,
+				  c->textlow + baseaddr,
+				  objfile->global_psymbols.next,
+				  objfile->static_psymbols.next);
+      if (c->dirname != DWARF2_INDEX_CACHE_NO_NAME)
+	pst->dirname = obsavestring (strtab + c->dirname,
+				     strlen (strtab + c->dirname),
+				     &objfile->objfile_obstack);
+
+      pst->read_symtab_private = (char *) this_cu;
+      pst->read_symtab = dwarf2_psymtab_to_symtab;
+      this_cu->psymtab = pst;
+      this_cu->cp_namespace_scan
+	= (c->flags & DWARF2_INDEX_CU_CP_NAMESPACE) != 0;
+
+      for (j = 0; j < c->n_global_syms + c->n_static_syms; j++)
+	{
+	  const struct dwarf2_index_cache_psym *p = &psyms[c->first_psym + j];
+	  const char *name = strtab + p->name;
+	  const struct partial_symbol *psym;
+	  CORE_ADDR addr = 0;
+
+	  if (p->aclass == LOC_BLOCK || p->aclass == LOC_STATIC)
+	    addr = p->value + baseaddr;
+
+	  psym = add_psymbol_to_list ((char *) name, strlen (name),
+				      p->domain, p->aclass,
+				      j < c->n_global_syms
+				      ? &objfile->global_psymbols
+				      : &objfile->static_psymbols,
+				      0, addr, p->language, objfile);
+
+	  if (p->flags & DWARF2_INDEX_PSYM_THUMB)
+	    objfile_add_special_psym (objfile, (struct partial_symbol *) psym,
+				      DW_ISA_ARM_thumb);
+
+	  if (this_cu->cp_namespace_scan
+	      && (p->aclass == LOC_BLOCK || p->aclass == LOC_STATIC)
+	      && SYMBOL_CPLUS_DEMANGLED_NAME (psym) != NULL)
+	    cp_check_possible_namespace_symbols (SYMBOL_CPLUS_DEMANGLED_NAME (psym),
+						 objfile);
+	}
+
+      cu_names = names + c->first_name;
+      for (j = 0; j < c->n_equiv_names; j++)
+	add_equiv_psym (&equiv_psyms, xstrdup (strtab + cu_names[j]));
+      pst->equiv_psyms = equiv_psyms;
+      if (equiv_psyms != NULL)
+	psym_equivalences = 1;
+
+      pst->texthigh = c->texthigh + baseaddr;
+      pst->n_global_syms = c->n_global_syms;
+      pst->n_static_syms = c->n_static_syms;
+      sort_pst_symbols (pst);
+
+      free_named_symtabs (pst->filename);
+
+      cu_names += c->n_equiv_names;
+      for (j = 0; j < c->n_include_names; j++)
+	dwarf2_create_include_psymtab ((char *) strtab + cu_names[j], pst,
+				       objfile);
+    }
+
+  sort_objfile_thumb_psyms (objfile);
+}
+
+/* A cache file brought into memory by dwarf2_index_cache_read.  */
+
+struct dwarf2_index_cache_data
+{
+  char *data;
+  size_t size;
+  int mapped;
+};
+
+static void
+dwarf2_index_cache_release (void *arg)
+{
+  struct dwarf2_index_cache_data *d = arg;
+
+#ifdef HAVE_MMAP
+  if (d->mapped)
+    {
+      munmap (d->data, d->size);
+      return;
+    }
+#endif
+  xfree (d->data);
+}
+
+/* Try to build OBJFILE's psymtabs from the index cache.  Return 1 on
+   success, or 0 if the caller has to scan .debug_info after all.  */
+
+static int
+dwarf2_index_cache_read (struct objfile *objfile)
+{
+  struct dwarf2_index_cache_data d;
+  struct cleanup *back_to;
+  struct stat st;
+  char *path;
+  int by_uuid;
+  int fd;
+  int ok;
+
+  if (!dwarf2_index_cache_enabled || dwarf2_per_objfile->n_comp_units == 0)
+    return 0;
+
+  path = dwarf2_index_cache_file_name (objfile, &by_uuid);
+  if (path == NULL)
+    return 0;
+  back_to = make_cleanup (xfree, path);
+
+  fd = open (path, O_RDONLY);
+  if (fd < 0)
+    {
+      dwarf2_index_cache_misses++;
+      do_cleanups (back_to);
+      return 0;
+    }
+
+  if (fstat (fd, &st) < 0
+      || st.st_size < sizeof (struct dwarf2_index_cache_header))
+    {
+      close (fd);
+      dwarf2_index_cache_misses++;
+      do_cleanups (back_to);
+      return 0;
+    }
+
+  d.size = st.st_size;
+  d.data = NULL;
+  d.mapped = 0;
+#ifdef HAVE_MMAP
+  d.data = mmap (NULL, d.size, PROT_READ, MAP_PRIVATE, fd, 0);
+  if (d.data == (char *) MAP_FAILED)
+    d.data = NULL;
+  else
+    d.mapped = 1;
+#endif
+  if (d.data == NULL)
+    {
+      size_t done = 0;
+
+      d.data = xmalloc (d.size);
+      while (done < d.size)
+	{
+	  ssize_t n = read (fd, d.data + done, d.size - done);
+	  if (n <= 0)
+	    break;
+	  done += n;
+	}
+      if (done < d.size)
+	{
+	  xfree (d.data);
+	  close (fd);
+	  dwarf2_index_cache_misses++;
+	  do_cleanups (back_to);
+	  return 0;
+	}
+    }
+  close (fd);
+  make_cleanup (dwarf2_index_cache_release, &d);
+
+  ok = dwarf2_index_cache_valid_p (objfile, d.data, d.size, by_uuid);
+  if (ok)
+    {
+      dwarf2_index_cache_replay (objfile, d.data);
+      dwarf2_index_cache_hits++;
+      /* Bump the file's time so that trimming the cache directory
+	 drops the least recently used files first.  */
+      utime (path, NULL);
+    }
+  else
+    dwarf2_index_cache_misses++;
+
+  do_cleanups (back_to);
+  return ok;
+}
+
+/* A string table under construction, with each distinct string
+   stored once.  */
+
+struct dwarf2_index_cache_strtab_entry
+{
+  const char *str;
+  uint32_t offset;
+};
+
+struct dwarf2_index_cache_strtab
+{
+  htab_t index;
+  struct obstack entries;
+  char *buf;
+  uint32_t size;
+  uint32_t allocated;
+};
+
+static hashval_t
+dwarf2_index_cache_strtab_hash (const void *p)
+{
+  const struct dwarf2_index_cache_strtab_entry *e = p;
+  return htab_hash_string (e->str);
+}
+
+static int
+dwarf2_index_cache_strtab_eq (const void *p1, const void *p2)
+{
+  const struct dwarf2_index_cache_strtab_entry *e1 = p1;
+  const struct dwarf2_index_cache_strtab_entry *e2 = p2;
+  return strcmp (e1->str, e2->str) == 0;
+}
+
+static void
+dwarf2_index_cache_strtab_free (void *arg)
+{
+  struct dwarf2_index_cache_strtab *st = arg;
+
+  htab_delete (st->index);
+  obstack_free (&st->entries, NULL);
+  xfree (st->buf);
+}
+
+/* Return the offset of STR in ST, adding it if it isn't there yet.  */
+
+static uint32_t
+dwarf2_index_cache_add_string (struct dwarf2_index_cache_strtab *st,
+			       const char *str)
+{
+  struct dwarf2_index_cache_strtab_entry e, *ep;
+  void **slot;
+  uint32_t len;
+
+  e.str = str;
+  slot = htab_find_slot (st->index, &e, INSERT);
+  if (*slot != NULL)
+    return ((struct dwarf2_index_cache_strtab_entry *) *slot)->offset;
+
+  len = strlen (str) + 1;
+  if (st->size + len > st->allocated)
+    {
+      while (st->size + len > st->allocated)
+	st->allocated *= 2;
+      st->buf = xrealloc (st->buf, st->allocated);
+    }
+  memcpy (st->buf + st->size, str, len);
+
+  /* ST->buf moves as it grows, so the index keeps a copy of its
+     own.  */
+  ep = obstack_alloc (&st->entries, sizeof (*ep));
+  ep->str = obsavestring (str, len - 1, &st->entries);
+  ep->offset = st->size;
+  *slot = ep;
+
+  st->size += len;
+  return ep->offset;
+}
+
+/* Create DIR and any missing parent directories.  */
+
+static void
+dwarf2_index_cache_make_directory (const char *dir)
+{
+  char *copy = xstrdup (dir);
+  char *p;
+  char sep;
+
+  for (p = copy + 1; *p != '\0'; p++)
+    if (IS_DIR_SEPARATOR (*p))
+      {
+	sep = *p;
+	*p = '\0';
+	mkdir (copy, 0755);
+	*p = sep;
+      }
+  mkdir (copy, 0755);
+  xfree (copy);
+}
+
+/* One file in the cache directory.  */
+
+struct dwarf2_index_cache_entry
+{
+  char *name;
+  off_t size;
+  time_t mtime;
+};
+
+static int
+dwarf2_index_cache_entry_compare (const void *p1, const void *p2)
+{
+  const struct dwarf2_index_cache_entry *e1 = p1;
+  const struct dwarf2_index_cache_entry *e2 = p2;
+
+  if (e1->mtime < e2->mtime)
+    return -1;
+  if (e1->mtime > e2->mtime)
+    return 1;
+  return 0;
+}
+
+/* Store in *ENTRIES an xmalloc'd array describing the files in the
+   cache directory, oldest first, and return how many there are.  */
+
+static int
+dwarf2_index_cache_scan (struct dwarf2_index_cache_entry **entries)
+{
+  struct dwarf2_index_cache_entry *e = NULL;
+  int n = 0, allocated = 0;
+  size_t suffix_len = strlen (DWARF2_INDEX_CACHE_SUFFIX);
+  struct dirent *ent;
+  DIR *dir;
+
+  *entries = NULL;
+  if (dwarf2_index_cache_directory == NULL
+      || *dwarf2_index_cache_directory == '\0')
+    return 0;
+
+  dir = opendir (dwarf2_index_cache_directory);
+  if (dir == NULL)
+    return 0;
+
+  while ((ent = readdir (dir)) != NULL)
+    {
+      size_t len = strlen (ent->d_name);
+      struct stat st;
+      char *name;
+
+      if (len <= suffix_len
+	  || strcmp (ent->d_name + len - suffix_len,
+		     DWARF2_INDEX_CACHE_SUFFIX) != 0)
+	continue;
+
+      name = concat (dwarf2_index_cache_directory, "/", ent->d_name,
+		     (char *) NULL);
+      if (stat (name, &st) < 0)
+	{
+	  xfree (name);
+	  continue;
+	}
+
+      if (n == allocated)
+	{
+	  allocated = allocated ? allocated * 2 : 16;
+	  e = xrealloc (e, allocated * sizeof (*e));
+	}
+      e[n].name = name;
+      e[n].size = st.st_size;
+      e[n].mtime = st.st_mtime;
+      n++;
+    }
+  closedir (dir);
+
+  if (n > 1)
+    qsort (e, n, sizeof (*e), dwarf2_index_cache_entry_compare);
 
-/* Load the DIEs for a secondary CU into memory.  */
+  *entries = e;
+  return n;
+}
 
 static void
-load_comp_unit (struct dwarf2_per_cu_data *this_cu, struct objfile *objfile)
+dwarf2_index_cache_free_entries (struct dwarf2_index_cache_entry *entries,
+				 int n)
 {
-  bfd *abfd = objfile->obfd;
-  char *info_ptr, *beg_of_comp_unit;
-  struct partial_die_info comp_unit_die;
-  struct dwarf2_cu *cu;
-  struct abbrev_info *abbrev;
-  unsigned int bytes_read;
-  struct cleanup *back_to;
-
-  info_ptr = dwarf2_per_objfile->info_buffer + this_cu->offset;
-  beg_of_comp_unit = info_ptr;
-
-  cu = xmalloc (sizeof (struct dwarf2_cu));
-  memset (cu, 0, sizeof (struct dwarf2_cu));
-
-  obstack_init (&cu->comp_unit_obstack);
-
-  cu->objfile = objfile;
-  info_ptr = partial_read_comp_unit_head (&cu->header, info_ptr, abfd);
+  int i;
 
-  /* Complete the cu_header.  */
-  cu->header.offset = beg_of_comp_unit - dwarf2_per_objfile->info_buffer;
-  cu->header.first_die_ptr = info_ptr;
-  cu->header.cu_head_ptr = beg_of_comp_unit;
+  for (i = 0; i < n; i++)
+    xfree (entries[i].name);
+  xfree (entries);
+}
 
-  /* Read the abbrevs for this compilation unit into a table.  */
-  dwarf2_read_abbrevs (abfd, cu);
-  back_to = make_cleanup (dwarf2_free_abbrev_table, cu);
+/* Remove the least recently used cache files until the directory
+   fits in dwarf2_index_cache_size_limit again.  */
 
-  /* Read the compilation unit die.  */
-  /* APPLE LOCAL Add cast to avoid type mismatch in arg2 warning.  */
-  abbrev = peek_die_abbrev (info_ptr, (int *) &bytes_read, cu);
-  info_ptr = read_partial_die (&comp_unit_die, abbrev, bytes_read,
-			       abfd, info_ptr, cu);
+static void
+dwarf2_index_cache_trim (void)
+{
+  struct dwarf2_index_cache_entry *entries;
+  ULONGEST total = 0, limit;
+  int i, n;
 
-  /* Set the language we're debugging.  */
-  set_cu_language (comp_unit_die.language, cu);
+  if (dwarf2_index_cache_size_limit <= 0)
+    return;
+  limit = (ULONGEST) dwarf2_index_cache_size_limit * 1024 * 1024;
 
-  /* Link this compilation unit into the compilation unit tree.  */
-  this_cu->cu = cu;
-  cu->per_cu = this_cu;
+  n = dwarf2_index_cache_scan (&entries);
+  for (i = 0; i < n; i++)
+    total += entries[i].size;
 
-  /* Check if comp unit has_children.
-     If so, read the rest of the partial symbols from this comp unit.
-     If not, there's no more debug_info for this comp unit. */
-  if (comp_unit_die.has_children)
-    load_partial_dies (abfd, info_ptr, 0, cu);
+  /* Never remove the newest file; that is the one we just wrote.  */
+  for (i = 0; i < n - 1 && total > limit; i++)
+    if (unlink (entries[i].name) == 0)
+      total -= entries[i].size;
 
-  do_cleanups (back_to);
+  dwarf2_index_cache_free_entries (entries, n);
 }
 
-/* Create a list of all compilation units in OBJFILE.  We do this only
-   if an inter-comp-unit reference is found; presumably if there is one,
-   there will be many, and one will occur early in the .debug_info section.
-   So there's no point in building this list incrementally.  */
+/* Save the psymtabs dwarf2_build_psymtabs_hard just built for
+   OBJFILE in the index cache.  OLD_PSYMTABS is the head of OBJFILE's
+   psymtab list before the build, so everything in front of it is new.
+   Failures are silent; the cache is only an optimization.  */
 
 static void
-create_all_comp_units (struct objfile *objfile)
-{
-  int n_allocated;
-  int n_comp_units;
-  struct dwarf2_per_cu_data **all_comp_units;
-  char *info_ptr = dwarf2_per_objfile->info_buffer;
+dwarf2_index_cache_write (struct objfile *objfile,
+			  struct partial_symtab *old_psymtabs)
+{
+  struct dwarf2_index_cache_header hdr;
+  struct dwarf2_index_cache_cu *cus;
+  struct dwarf2_index_cache_psym *psyms;
+  struct dwarf2_index_cache_strtab st;
+  struct dwarf2_index_cache_cu *c = NULL;
+  struct partial_symtab **psts, *pst, *cu_pst = NULL;
+  uint32_t *names;
+  struct cleanup *back_to;
+  CORE_ADDR baseaddr;
+  char *path, *tmp;
+  int by_uuid;
+  int n_psts, n_cus, i, k;
+  uint32_t n_psyms = 0, n_names = 0;
+  FILE *fp;
+  int ok;
+
+  if (!dwarf2_index_cache_enabled || dwarf2_per_objfile->n_comp_units == 0)
+    return;
 
-  n_comp_units = 0;
-  n_allocated = 10;
-  all_comp_units = xmalloc (n_allocated
-			    * sizeof (struct dwarf2_per_cu_data *));
-  
-  while (info_ptr < dwarf2_per_objfile->info_buffer + dwarf2_per_objfile->info_size)
-    {
-      struct comp_unit_head cu_header;
-      /* APPLE LOCAL avoid unused var warning.  */
-      /* char *beg_of_comp_unit; */
-      struct dwarf2_per_cu_data *this_cu;
-      unsigned long offset;
-      int bytes_read;
+  path = dwarf2_index_cache_file_name (objfile, &by_uuid);
+  if (path == NULL)
+    return;
+  back_to = make_cleanup (xfree, path);
 
-      offset = info_ptr - dwarf2_per_objfile->info_buffer;
+  /* The new psymtabs are on the front of the list, newest first.
+     Collect them oldest first: every CU's psymtab is then followed by
+     its include psymtabs, in .debug_info order.  */
+  n_psts = 0;
+  for (pst = objfile->psymtabs; pst != old_psymtabs; pst = pst->next)
+    {
+      n_psts++;
+      if (pst->read_symtab_private != NULL)
+	n_psyms += pst->n_global_syms + pst->n_static_syms;
+      else
+	n_names++;
+      if (pst->equiv_psyms != NULL)
+	n_names += pst->equiv_psyms->num_syms;
+    }
+  psts = xmalloc (n_psts * sizeof (*psts));
+  make_cleanup (xfree, psts);
+  i = n_psts;
+  for (pst = objfile->psymtabs; pst != old_psymtabs; pst = pst->next)
+    psts[--i] = pst;
+
+  n_cus = dwarf2_per_objfile->n_comp_units;
+  cus = xcalloc (n_cus, sizeof (*cus));
+  make_cleanup (xfree, cus);
+  psyms = xcalloc (n_psyms + 1, sizeof (*psyms));
+  make_cleanup (xfree, psyms);
+  names = xcalloc (n_names + 1, sizeof (*names));
+  make_cleanup (xfree, names);
+
+  st.index = htab_create_alloc (1024, dwarf2_index_cache_strtab_hash,
+				dwarf2_index_cache_strtab_eq, NULL,
+				xcalloc, xfree);
+  obstack_init (&st.entries);
+  st.allocated = 4096;
+  st.buf = xmalloc (st.allocated);
+  st.size = 0;
+  make_cleanup (dwarf2_index_cache_strtab_free, &st);
 
-      /* Read just enough information to find out where the next
-	 compilation unit is.  */
-      cu_header.initial_length_size = 0;
-      cu_header.length = read_initial_length (objfile->obfd, info_ptr,
-					      &cu_header, &bytes_read);
+  baseaddr = objfile_text_section_offset (objfile);
+  n_psyms = 0;
+  n_names = 0;
+  k = 0;
+  for (i = 0; i < n_psts; i++)
+    {
+      struct dwarf2_per_cu_data *this_cu;
+      struct partial_symbol **p;
+      int j;
 
-      /* Save the compilation unit for later lookup.  */
-      this_cu = obstack_alloc (&objfile->objfile_obstack,
-			       sizeof (struct dwarf2_per_cu_data));
-      memset (this_cu, 0, sizeof (*this_cu));
-      this_cu->offset = offset;
-      this_cu->length = cu_header.length + cu_header.initial_length_size;
+      pst = psts[i];
+      if (pst->read_symtab_private == NULL)
+	{
+	  /* An include psymtab of the CU we last saw.  */
+	  if (cu_pst == NULL
+	      || pst->number_of_dependencies != 1
+	      || pst->dependencies[0] != cu_pst)
+	    {
+	      do_cleanups (back_to);
+	      return;
+	    }
+	  names[n_names++] = dwarf2_index_cache_add_string (&st,
+							    pst->filename);
+	  c->n_include_names++;
+	  continue;
+	}
 
-      if (n_comp_units == n_allocated)
+      this_cu = (struct dwarf2_per_cu_data *) pst->read_symtab_private;
+      if (k >= n_cus
+	  || this_cu != dwarf2_per_objfile->all_comp_units[k])
 	{
-	  n_allocated *= 2;
-	  all_comp_units = xrealloc (all_comp_units,
-				     n_allocated
-				     * sizeof (struct dwarf2_per_cu_data *));
+	  do_cleanups (back_to);
+	  return;
+	}
+      cu_pst = pst;
+      c = &cus[k++];
+
+      c->textlow = pst->textlow - baseaddr;
+      c->texthigh = pst->texthigh - baseaddr;
+      c->offset = this_cu->offset;
+      c->filename = dwarf2_index_cache_add_string (&st, pst->filename);
+      c->dirname = (pst->dirname != NULL
+		    ? dwarf2_index_cache_add_string (&st, pst->dirname)
+		    : DWARF2_INDEX_CACHE_NO_NAME);
+      c->flags = this_cu->cp_namespace_scan ? DWARF2_INDEX_CU_CP_NAMESPACE : 0;
+
+      c->first_psym = n_psyms;
+      c->n_global_syms = pst->n_global_syms;
+      c->n_static_syms = pst->n_static_syms;
+      p = objfile->global_psymbols.list + pst->globals_offset;
+      for (j = 0; j < pst->n_global_syms + pst->n_static_syms; j++)
+	{
+	  struct dwarf2_index_cache_psym *out = &psyms[n_psyms++];
+	  struct partial_symbol *psym;
+
+	  if (j == pst->n_global_syms)
+	    p = objfile->static_psymbols.list + pst->statics_offset;
+	  psym = *p++;
+
+	  out->name = dwarf2_index_cache_add_string (&st,
+						     SYMBOL_LINKAGE_NAME (psym));
+	  out->domain = PSYMBOL_DOMAIN (psym);
+	  out->aclass = PSYMBOL_CLASS (psym);
+	  out->language = SYMBOL_LANGUAGE (psym);
+	  if (out->aclass == LOC_BLOCK || out->aclass == LOC_STATIC)
+	    out->value = SYMBOL_VALUE_ADDRESS (psym) - baseaddr;
+	  if (partial_symbol_special_info (objfile, psym) != NULL)
+	    out->flags |= DWARF2_INDEX_PSYM_THUMB;
 	}
-      all_comp_units[n_comp_units++] = this_cu;
 
-      info_ptr = info_ptr + this_cu->length;
+      c->first_name = n_names;
+      if (pst->equiv_psyms != NULL)
+	for (j = 0; j < pst->equiv_psyms->num_syms; j++)
+	  {
+	    names[n_names++]
+	      = dwarf2_index_cache_add_string (&st,
+					       pst->equiv_psyms->sym_list[j]);
+	    c->n_equiv_names++;
+	  }
     }
 
-  dwarf2_per_objfile->all_comp_units
-    = obstack_alloc (&objfile->objfile_obstack,
-		     n_comp_units * sizeof (struct dwarf2_per_cu_data *));
-  memcpy (dwarf2_per_objfile->all_comp_units, all_comp_units,
-	  n_comp_units * sizeof (struct dwarf2_per_cu_data *));
-  xfree (all_comp_units);
-  dwarf2_per_objfile->n_comp_units = n_comp_units;
-}
-
-/* APPLE LOCAL begin psym equivalences  */
-/* EQUIV_PSYMS is an array of equivalence psym names found in the
-   current compile unit so far, along with some book-keeping
-   information (size of the array, etc).  NAME is a new equivalence
-   name to be added to the list.  This function makes sure the array
-   is big enough, allocating memory and updating the book-keeping if
-   necessary, and adds the new name to the array.  */
+  if (k != n_cus)
+    {
+      do_cleanups (back_to);
+      return;
+    }
 
-static void
-add_equiv_psym (struct equiv_psym_list **equiv_psyms,
-		char *name)
-{
-  int i;
+  memset (&hdr, 0, sizeof (hdr));
+  hdr.magic = DWARF2_INDEX_CACHE_MAGIC;
+  hdr.version = DWARF2_INDEX_CACHE_VERSION;
+  hdr.mtime = objfile->mtime;
+  hdr.info_size = dwarf2_per_objfile->info_size;
+  hdr.flags = by_uuid ? DWARF2_INDEX_CACHE_BY_UUID : 0;
+  hdr.objfile_name = dwarf2_index_cache_add_string (&st, objfile->name);
+  hdr.n_cus = n_cus;
+  hdr.n_psyms = n_psyms;
+  hdr.n_names = n_names;
+  hdr.strtab_size = st.size;
 
-  /* If the array has never been allocated, malloc it and start it out
-     with 10 elements.  */
+  dwarf2_index_cache_make_directory (dwarf2_index_cache_directory);
 
-  if (*equiv_psyms == NULL)
+  /* Write to a temporary file and rename it into place, so that a
+     concurrent reader never sees a partial file.  */
+  tmp = xstrprintf ("%s.%ld.tmp", path, (long) getpid ());
+  make_cleanup (xfree, tmp);
+  fp = fopen (tmp, "wb");
+  if (fp == NULL)
     {
-      *equiv_psyms = (struct equiv_psym_list *) xmalloc 
-                                            (sizeof (struct equiv_psym_list));
-      (*equiv_psyms)->sym_list = (char **) xmalloc (10 * sizeof (char *));
-      (*equiv_psyms)->list_size = 10;
-      (*equiv_psyms)->num_syms = 0;
-      for (i = 0; i < 10; i++)
-	(*equiv_psyms)->sym_list[i] = NULL;
+      do_cleanups (back_to);
+      return;
     }
+  fwrite (&hdr, sizeof (hdr), 1, fp);
+  fwrite (cus, sizeof (*cus), n_cus, fp);
+  fwrite (psyms, sizeof (*psyms), n_psyms, fp);
+  fwrite (names, sizeof (*names), n_names, fp);
+  fwrite (st.buf, 1, st.size, fp);
+  ok = !ferror (fp);
+  if (fclose (fp) != 0)
+    ok = 0;
 
-  /* If the array is full, double its size (using realloc).  */
-
-  if ((*equiv_psyms)->num_syms == (*equiv_psyms)->list_size)
+  if (ok && rename (tmp, path) == 0)
     {
-      int new_size;
-      new_size = (*equiv_psyms)->list_size * 2;
-      (*equiv_psyms)->sym_list = (char **) xrealloc ((*equiv_psyms)->sym_list,
-						     new_size * sizeof (char *));
-      for (i = (*equiv_psyms)->list_size; i < new_size; i++)
-	(*equiv_psyms)->sym_list[i] = NULL;
-      (*equiv_psyms)->list_size = new_size;
+      dwarf2_index_cache_writes++;
+      dwarf2_index_cache_trim ();
     }
+  else
+    unlink (tmp);
 
-  /* Insert NAME into the list.  */
+  do_cleanups (back_to);
+}
 
-  (*equiv_psyms)->sym_list[(*equiv_psyms)->num_syms++] = name;
+/* "maint info dwarf2-index-cache".  */
+
+static void
+maintenance_info_dwarf2_index_cache (char *args, int from_tty)
+{
+  struct dwarf2_index_cache_entry *entries;
+  ULONGEST total = 0;
+  int i, n;
+
+  n = dwarf2_index_cache_scan (&entries);
+  for (i = 0; i < n; i++)
+    total += entries[i].size;
+
+  printf_filtered (_("The DWARF 2 index cache is %s.\n"),
+		   dwarf2_index_cache_enabled ? "enabled" : "disabled");
+  printf_filtered (_("Cache directory: %s\n"),
+		   dwarf2_index_cache_directory != NULL
+		   ? dwarf2_index_cache_directory : "");
+  if (dwarf2_index_cache_size_limit > 0)
+    printf_filtered (_("Size limit: %d MB\n"), dwarf2_index_cache_size_limit);
+  else
+    printf_filtered (_("Size limit: none\n"));
+  printf_filtered (_("Cache files: %d, %s bytes\n"), n, paddr_u (total));
+  for (i = n - 1; i >= 0; i--)
+    printf_filtered ("  %s  %s bytes\n", lbasename (entries[i].name),
+		     paddr_u (entries[i].size));
+  printf_filtered (_("Hits: %d  Misses: %d  Writes: %d\n"),
+		   dwarf2_index_cache_hits, dwarf2_index_cache_misses,
+		   dwarf2_index_cache_writes);
+
+  dwarf2_index_cache_free_entries (entries, n);
 }
-/* APPLE LOCAL end psym equivalences  */
+
+/* "maint flush-dwarf2-index-cache".  */
+
+static void
+maintenance_flush_dwarf2_index_cache (char *args, int from_tty)
+{
+  struct dwarf2_index_cache_entry *entries;
+  int i, n, removed = 0;
+
+  n = dwarf2_index_cache_scan (&entries);
+  for (i = 0; i < n; i++)
+    if (unlink (entries[i].name) == 0)
+      removed++;
+  dwarf2_index_cache_free_entries (entries, n);
+
+  printf_filtered (_("Removed %d files from the DWARF 2 index cache.\n"),
+		   removed);
+}
+
+/* APPLE LOCAL end dwarf2 index cache  */
 
 /* Process all loaded DIEs for compilation unit CU, starting at FIRST_DIE.
    Also set *LOWPC and *HIGHPC to the lowest and highest PC values found
@@ -2873,6 +4434,87 @@ partial_die_full_name (struct partial_die_info *pdi,
     return typename_concat (NULL, parent_scope, pdi->name, cu);
 }
 
+/* APPLE LOCAL begin parallel psymtabs  */
+/* Add a partial symbol NAME to OBJFILE, in the global list if GLOBAL
+   and the static list otherwise.  ISA_VALUE is the DW_AT_APPLE_isa of
+   a function.  */
+
+static void
+dwarf2_add_psymbol_1 (struct objfile *objfile, enum language language,
+		      char *name, int namelength, domain_enum domain,
+		      enum address_class class, int global,
+		      CORE_ADDR coreaddr, int isa_value, int check_namespace)
+{
+  const struct partial_symbol *psym;
+
+  psym = add_psymbol_to_list (name, namelength, domain, class,
+			      global ? &objfile->global_psymbols
+			      : &objfile->static_psymbols,
+			      0, coreaddr, language, objfile);
+
+  /* APPLE LOCAL begin - Differentiate between arm & thumb  */
+  if (isa_value == DW_ISA_ARM_thumb)
+    objfile_add_special_psym (objfile, (struct partial_symbol *) psym,
+			      isa_value);
+  /* APPLE LOCAL end - Differentiate between arm & thumb  */
+
+  /* Check to see if we should scan the name for possible namespace
+     info.  Only do this if this is C++, if we don't have namespace
+     debugging info in the file (CHECK_NAMESPACE), if the psym is of an
+     appropriate type, and if we actually had a mangled name to begin
+     with.  */
+
+  /* FIXME drow/2004-02-22: Why don't we do this for classes, i.e. the
+     cases which do not set CHECK_NAMESPACE?  */
+
+  if (check_namespace
+      && language == language_cplus
+      && psym != NULL
+      && SYMBOL_CPLUS_DEMANGLED_NAME (psym) != NULL)
+    cp_check_possible_namespace_symbols (SYMBOL_CPLUS_DEMANGLED_NAME (psym),
+					 objfile);
+}
+
+/* Add a partial symbol NAME for compilation unit CU.  On a helper
+   thread, the symbol is queued on CU's job for the main thread to
+   add.  */
+
+static void
+dwarf2_add_psymbol (struct dwarf2_cu *cu, char *name, domain_enum domain,
+		    enum address_class class, int global, CORE_ADDR coreaddr,
+		    int isa_value, int check_namespace)
+{
+  struct dwarf2_psymtab_job *job = cu->job;
+  struct dwarf2_pending_psym *p;
+  int namelength = strlen (name);
+
+  if (job == NULL)
+    {
+      dwarf2_add_psymbol_1 (cu->objfile, cu->language, name, namelength,
+			    domain, class, global, coreaddr, isa_value,
+			    check_namespace);
+      return;
+    }
+
+  if (job->n_pending == job->pending_size)
+    {
+      job->pending_size = job->pending_size ? 2 * job->pending_size : 64;
+      job->pending = xrealloc (job->pending,
+			       job->pending_size * sizeof (*job->pending));
+    }
+
+  p = &job->pending[job->n_pending++];
+  p->name = obstack_copy0 (&cu->comp_unit_obstack, name, namelength);
+  p->namelength = namelength;
+  p->domain = domain;
+  p->class = class;
+  p->coreaddr = coreaddr;
+  p->isa_value = isa_value;
+  p->global = global != 0;
+  p->check_namespace = check_namespace != 0;
+}
+/* APPLE LOCAL end parallel psymtabs  */
+
 static void
 add_partial_symbol (struct partial_die_info *pdi, struct dwarf2_cu *cu)
 {
@@ -2881,9 +4523,10 @@ add_partial_symbol (struct partial_die_info *pdi, struct dwarf2_cu *cu)
   char *actual_name;
   /* APPLE LOCAL avoid unused var warning.  */
   /* const char *my_prefix; */
-  const struct partial_symbol *psym = NULL;
   CORE_ADDR baseaddr;
   int built_actual_name = 0;
+  /* APPLE LOCAL parallel psymtabs  */
+  int check_namespace = (cu->has_namespace_info == 0);
 
   baseaddr = objfile_text_section_offset (objfile);
 
@@ -2899,33 +4542,15 @@ add_partial_symbol (struct partial_die_info *pdi, struct dwarf2_cu *cu)
   if (actual_name == NULL)
     actual_name = pdi->name;
 
+  /* APPLE LOCAL begin parallel psymtabs  */
   switch (pdi->tag)
     {
     case DW_TAG_subprogram:
-      if (pdi->is_external)
-	{
-	  /*prim_record_minimal_symbol (actual_name, pdi->lowpc + baseaddr,
-	     mst_text, objfile); */
-	  psym = add_psymbol_to_list (actual_name, strlen (actual_name),
-				      VAR_DOMAIN, LOC_BLOCK,
-				      &objfile->global_psymbols,
-				      0, pdi->lowpc + baseaddr,
-				      cu->language, objfile);
-	}
-      else
-	{
-	  /*prim_record_minimal_symbol (actual_name, pdi->lowpc + baseaddr,
-	     mst_file_text, objfile); */
-	  psym = add_psymbol_to_list (actual_name, strlen (actual_name),
-				      VAR_DOMAIN, LOC_BLOCK,
-				      &objfile->static_psymbols,
-				      0, pdi->lowpc + baseaddr,
-				      cu->language, objfile);
-	}
-      /* APPLE LOCAL begin - Differentiate between arm & thumb  */
-      if (pdi->isa_value == DW_ISA_ARM_thumb)
-        objfile_add_special_psym (objfile, psym, pdi->isa_value);
-      /* APPLE LOCAL end - Differentiate between arm & thumb  */
+      /*prim_record_minimal_symbol (actual_name, pdi->lowpc + baseaddr,
+	 pdi->is_external ? mst_text : mst_file_text, objfile); */
+      dwarf2_add_psymbol (cu, actual_name, VAR_DOMAIN, LOC_BLOCK,
+			  pdi->is_external, pdi->lowpc + baseaddr,
+			  pdi->isa_value, check_namespace);
       break;
     case DW_TAG_variable:
       if (pdi->is_external)
@@ -2947,11 +4572,8 @@ add_partial_symbol (struct partial_die_info *pdi, struct dwarf2_cu *cu)
 	    addr = decode_locdesc (pdi->locdesc, cu);
 	  /* APPLE LOCAL - dwarf repository  */
 	  if (pdi->locdesc || pdi->has_type || pdi->has_repository_type)
-	    psym = add_psymbol_to_list (actual_name, strlen (actual_name),
-					VAR_DOMAIN, LOC_STATIC,
-					&objfile->global_psymbols,
-					0, addr + baseaddr,
-					cu->language, objfile);
+	    dwarf2_add_psymbol (cu, actual_name, VAR_DOMAIN, LOC_STATIC,
+				1, addr + baseaddr, 0, check_namespace);
 	}
       else
 	{
@@ -2961,11 +4583,8 @@ add_partial_symbol (struct partial_die_info *pdi, struct dwarf2_cu *cu)
 	  addr = decode_locdesc (pdi->locdesc, cu);
 	  /*prim_record_minimal_symbol (actual_name, addr + baseaddr,
 	     mst_file_data, objfile); */
-	  psym = add_psymbol_to_list (actual_name, strlen (actual_name),
-				      VAR_DOMAIN, LOC_STATIC,
-				      &objfile->static_psymbols,
-				      0, addr + baseaddr,
-				      cu->language, objfile);
+	  dwarf2_add_psymbol (cu, actual_name, VAR_DOMAIN, LOC_STATIC,
+			      0, addr + baseaddr, 0, check_namespace);
 	}
       break;
     case DW_TAG_typedef:
@@ -2973,16 +4592,12 @@ add_partial_symbol (struct partial_die_info *pdi, struct dwarf2_cu *cu)
     case DW_TAG_subrange_type:
       /* APPLE LOCAL: Put it in the global_psymbols list, not 
          static_psymbols.  */
-      add_psymbol_to_list (actual_name, strlen (actual_name),
-			   VAR_DOMAIN, LOC_TYPEDEF,
-			   &objfile->global_psymbols,
-			   0, (CORE_ADDR) 0, cu->language, objfile);
+      dwarf2_add_psymbol (cu, actual_name, VAR_DOMAIN, LOC_TYPEDEF,
+			  1, (CORE_ADDR) 0, 0, 0);
       break;
     case DW_TAG_namespace:
-      add_psymbol_to_list (actual_name, strlen (actual_name),
-			   VAR_DOMAIN, LOC_TYPEDEF,
-			   &objfile->global_psymbols,
-			   0, (CORE_ADDR) 0, cu->language, objfile);
+      dwarf2_add_psymbol (cu, actual_name, VAR_DOMAIN, LOC_TYPEDEF,
+			  1, (CORE_ADDR) 0, 0, 0);
       break;
     case DW_TAG_class_type:
     case DW_TAG_structure_type:
@@ -2996,48 +4611,27 @@ add_partial_symbol (struct partial_die_info *pdi, struct dwarf2_cu *cu)
 	return;
       /* APPLE LOCAL: Put it in the global_psymbols list, not 
          static_psymbols regardless of which language it came from.  */
-      add_psymbol_to_list (actual_name, strlen (actual_name),
-			   STRUCT_DOMAIN, LOC_TYPEDEF,
-			   &objfile->global_psymbols,
-			   0, (CORE_ADDR) 0, cu->language, objfile);
+      dwarf2_add_psymbol (cu, actual_name, STRUCT_DOMAIN, LOC_TYPEDEF,
+			  1, (CORE_ADDR) 0, 0, 0);
 
       if (cu->language == language_cplus
           || cu->language == language_java)
 	{
 	  /* For C++ and Java, these implicitly act as typedefs as well. */
-	  add_psymbol_to_list (actual_name, strlen (actual_name),
-			       VAR_DOMAIN, LOC_TYPEDEF,
-			       &objfile->global_psymbols,
-			       0, (CORE_ADDR) 0, cu->language, objfile);
+	  dwarf2_add_psymbol (cu, actual_name, VAR_DOMAIN, LOC_TYPEDEF,
+			      1, (CORE_ADDR) 0, 0, 0);
 	}
       break;
     case DW_TAG_enumerator:
           /* APPLE LOCAL: Put it in the global_psymbols list regardless of
              language.  */
-      add_psymbol_to_list (actual_name, strlen (actual_name),
-			   VAR_DOMAIN, LOC_CONST,
-			   &objfile->global_psymbols,
-			   0, (CORE_ADDR) 0, cu->language, objfile);
+      dwarf2_add_psymbol (cu, actual_name, VAR_DOMAIN, LOC_CONST,
+			  1, (CORE_ADDR) 0, 0, 0);
       break;
     default:
       break;
     }
-
-  /* Check to see if we should scan the name for possible namespace
-     info.  Only do this if this is C++, if we don't have namespace
-     debugging info in the file, if the psym is of an appropriate type
-     (otherwise we'll have psym == NULL), and if we actually had a
-     mangled name to begin with.  */
-
-  /* FIXME drow/2004-02-22: Why don't we do this for classes, i.e. the
-     cases which do not set PSYM above?  */
-
-  if (cu->language == language_cplus
-      && cu->has_namespace_info == 0
-      && psym != NULL
-      && SYMBOL_CPLUS_DEMANGLED_NAME (psym) != NULL)
-    cp_check_possible_namespace_symbols (SYMBOL_CPLUS_DEMANGLED_NAME (psym),
-					 objfile);
+  /* APPLE LOCAL end parallel psymtabs  */
 
   if (built_actual_name)
     xfree (actual_name);
@@ -6963,7 +8557,7 @@ read_common_block (struct die_info *die, struct dwarf2_cu *cu)
   if (!nattr)
     nattr = dwarf2_attr (die, DW_AT_name, cu);
   if (nattr)
-    decode_locdesc_common = DW_STRING (nattr);
+    cu->locdesc_common = DW_STRING (nattr);
 
   attr = dwarf2_attr (die, DW_AT_location, cu);
   if (attr)
@@ -7001,7 +8595,7 @@ read_common_block (struct die_info *die, struct dwarf2_cu *cu)
     }
   /* APPLE LOCAL:  Finished processing addresses that may be relative to
      this common block.  */
-  decode_locdesc_common = NULL;
+  cu->locdesc_common = NULL;
 }
 
 /* Read a C++ namespace.  */
@@ -8060,10 +9654,9 @@ load_partial_dies (bfd *abfd, char *info_ptr, int building_psymtab,
 	  if (building_psymtab && part_die->name != NULL)
             /* APPLE LOCAL: Put it in the global_psymbols list, not 
                static_psymbols.  */
-	    add_psymbol_to_list (part_die->name, strlen (part_die->name),
-				 VAR_DOMAIN, LOC_TYPEDEF,
-				 &cu->objfile->global_psymbols,
-				 0, (CORE_ADDR) 0, cu->language, cu->objfile);
+	    /* APPLE LOCAL parallel psymtabs  */
+	    dwarf2_add_psymbol (cu, part_die->name, VAR_DOMAIN, LOC_TYPEDEF,
+				1, (CORE_ADDR) 0, 0, 0);
 	  info_ptr = locate_pdi_sibling (part_die, info_ptr, abfd, cu);
 	  continue;
 	}
@@ -8083,10 +9676,9 @@ load_partial_dies (bfd *abfd, char *info_ptr, int building_psymtab,
 	  else if (building_psymtab)
             /* APPLE LOCAL: Put it in the global_psymbols list regardless
                of language.  */
-	    add_psymbol_to_list (part_die->name, strlen (part_die->name),
-				 VAR_DOMAIN, LOC_CONST,
-				 &cu->objfile->global_psymbols,
-				 0, (CORE_ADDR) 0, cu->language, cu->objfile);
+	    /* APPLE LOCAL parallel psymtabs  */
+	    dwarf2_add_psymbol (cu, part_die->name, VAR_DOMAIN, LOC_CONST,
+				1, (CORE_ADDR) 0, 0, 0);
 
 	  info_ptr = locate_pdi_sibling (part_die, info_ptr, abfd, cu);
 	  continue;
@@ -8279,11 +9871,18 @@ read_partial_die (struct partial_die_info *part_die,
 		  
 		  if (is_equivalence_name)
 		    {
-		      psym_equivalences = 1;
-		      short_end[0] = '\0';
-		      part_die->name = xstrdup (short_name);
+		      /* APPLE LOCAL begin parallel psymtabs  */
+		      /* Don't write into .debug_str; other threads may
+			 be reading it.  The main thread sets the flag when
+			 it takes over a helper's results.  */
+		      if (cu->job == NULL)
+			psym_equivalences = 1;
+		      else
+			cu->job->saw_equiv_name = 1;
+		      part_die->name = savestring (short_name,
+						   short_end - short_name);
+		      /* APPLE LOCAL end parallel psymtabs  */
 		      part_die->equiv_name = part_die->name;
-		      short_end[0] = '$';
 		    }
 		  
 		}
@@ -8438,6 +10037,12 @@ find_partial_die (unsigned long offset, struct dwarf2_cu *cu)
       && offset < cu->header.offset + cu->header.length)
     return find_partial_die_in_comp_unit (offset, cu);
 
+  /* APPLE LOCAL begin parallel psymtabs  */
+  /* Only the main thread may load other compilation units.  */
+  if (cu->job != NULL)
+    dwarf2_abandon_psymtab_job (cu->job);
+  /* APPLE LOCAL end parallel psymtabs  */
+
   per_cu = dwarf2_find_containing_comp_unit (offset, cu->objfile);
 
   if (per_cu->cu == NULL)
@@ -12402,7 +14007,7 @@ dwarf2_fundamental_type (struct objfile *objfile, int typeid,
    callers will only want a very basic result and this can become a
    complaint.
 
-   When the result is a register number, the global isreg flag is set,
+   When the result is a register number, CU's isreg flag is set,
    otherwise it is cleared.
 
    Note that stack[0] is unused except as a default error return. */
@@ -12428,7 +14033,7 @@ decode_locdesc (struct dwarf_block *blk, struct dwarf2_cu *cu)
   i = 0;
   stacki = 0;
   stack[stacki] = 0;
-  isreg = 0;
+  cu->isreg = 0;
 
   /* APPLE LOCAL: Add stack array bounds check.  */
   while (i < size && stacki < LOCDESC_STACKSIZE)
@@ -12503,14 +14108,14 @@ decode_locdesc (struct dwarf_block *blk, struct dwarf2_cu *cu)
 	case DW_OP_reg29:
 	case DW_OP_reg30:
 	case DW_OP_reg31:
-	  isreg = 1;
+	  cu->isreg = 1;
 	  stack[++stacki] = op - DW_OP_reg0;
 	  if (i < size)
 	    dwarf2_complex_location_expr_complaint ();
 	  break;
 
 	case DW_OP_regx:
-	  isreg = 1;
+	  cu->isreg = 1;
 	  unsnd = read_unsigned_leb128 (NULL, (data + i), &bytes_read);
 	  i += bytes_read;
 	  stack[++stacki] = unsnd;
@@ -12526,9 +14131,9 @@ decode_locdesc (struct dwarf_block *blk, struct dwarf2_cu *cu)
             /* APPLE LOCAL: If we're in the middle of processing a 
                DW_TAG_common_block, DW_OP_addr refers to an offset within 
                that common block, I guess. */
-            if (decode_locdesc_common &&
+            if (cu->locdesc_common &&
                 translate_common_symbol_debug_map_address (cu->addr_map, 
-                                           decode_locdesc_common, &addr))
+                                           cu->locdesc_common, &addr))
              {
                 CORE_ADDR off = read_address (objfile->obfd, &data[i], cu,
                                             (int *) &bytes_read);
@@ -13272,6 +14877,56 @@ free_cached_comp_units (void *data)
     }
 }
 
+/* APPLE LOCAL begin maint info memory  */
+/* Store in *SECTIONS the number of bytes of OBJFILE's objfile_obstack
+   that hold the contents of its DWARF 2 sections, and in *CACHED_CUS
+   the number of bytes used by its cached compilation units.  */
+
+void
+dwarf2_objfile_memory_used (struct objfile *objfile, long *sections,
+			    long *cached_cus)
+{
+  struct dwarf2_per_objfile *data;
+  struct dwarf2_per_cu_data *per_cu;
+
+  *sections = 0;
+  *cached_cus = 0;
+
+  data = objfile_data (objfile, dwarf2_objfile_data_key);
+  if (data == NULL)
+    return;
+
+  if (data->info_buffer)
+    *sections += data->info_size;
+  if (data->abbrev_buffer)
+    *sections += data->abbrev_size;
+  if (data->line_buffer)
+    *sections += data->line_size;
+  if (data->str_buffer)
+    *sections += data->str_size;
+  if (data->macinfo_buffer)
+    *sections += data->macinfo_size;
+  if (data->ranges_buffer)
+    *sections += data->ranges_size;
+  if (data->loc_buffer)
+    *sections += data->loc_size;
+  if (data->inlined_buffer)
+    *sections += data->inlined_size;
+
+  for (per_cu = data->read_in_chain;
+       per_cu != NULL;
+       per_cu = per_cu->cu->read_in_chain)
+    {
+      struct dwarf2_cu *cu = per_cu->cu;
+
+      *cached_cus += (sizeof (struct dwarf2_cu)
+		      + obstack_memory_used (&cu->comp_unit_obstack));
+      if (cu->dwarf2_abbrevs != NULL)
+	*cached_cus += obstack_memory_used (&cu->abbrev_obstack);
+    }
+}
+/* APPLE LOCAL end maint info memory  */
+
 /* Increase the age counter on each cached compilation unit, and free
    any that are too old.  */
 
@@ -13607,6 +15262,79 @@ caching, which can slow down startup."),
 			   NULL, NULL, NULL, &setdebuglist, &showdebuglist);
   /* APPLE LOCAL end subroutine inlining  */
 
+  /* APPLE LOCAL begin dwarf2 index cache  */
+  {
+    const char *home = getenv ("HOME");
+    if (home != NULL)
+      dwarf2_index_cache_directory
+	= concat (home, "/Library/Caches/com.apple.gdb/dwarf2-index",
+		  (char *) NULL);
+    else
+      dwarf2_index_cache_directory = xstrdup ("");
+  }
+
+  add_setshow_boolean_cmd ("index-cache", class_maintenance,
+			   &dwarf2_index_cache_enabled, _("\
+Set whether DWARF 2 partial symbol tables are cached on disk."), _("\
+Show whether DWARF 2 partial symbol tables are cached on disk."), _("\
+When on, the partial symbol tables built from a file's DWARF debug\n\
+info are saved in the index cache directory, and are read back from\n\
+there instead of rescanning .debug_info when the file is loaded again."),
+			   NULL,
+			   show_dwarf2_index_cache_enabled,
+			   &set_dwarf2_cmdlist,
+			   &show_dwarf2_cmdlist);
+
+  add_setshow_filename_cmd ("index-cache-directory", class_maintenance,
+			    &dwarf2_index_cache_directory, _("\
+Set the directory that holds the DWARF 2 index cache."), _("\
+Show the directory that holds the DWARF 2 index cache."), NULL,
+			    NULL,
+			    show_dwarf2_index_cache_directory,
+			    &set_dwarf2_cmdlist,
+			    &show_dwarf2_cmdlist);
+
+  add_setshow_zinteger_cmd ("index-cache-size-limit", class_maintenance,
+			    &dwarf2_index_cache_size_limit, _("\
+Set the size limit, in megabytes, of the DWARF 2 index cache."), _("\
+Show the size limit, in megabytes, of the DWARF 2 index cache."), _("\
+When the cache directory grows past this size, the least recently\n\
+used files are removed.  Zero means no limit."),
+			    NULL,
+			    show_dwarf2_index_cache_size_limit,
+			    &set_dwarf2_cmdlist,
+			    &show_dwarf2_cmdlist);
+
+  add_cmd ("dwarf2-index-cache", class_maintenance,
+	   maintenance_info_dwarf2_index_cache, _("\
+Show the DWARF 2 index cache settings, files and statistics."),
+	   &maintenanceinfolist);
+
+  add_cmd ("flush-dwarf2-index-cache", class_maintenance,
+	   maintenance_flush_dwarf2_index_cache, _("\
+Remove all files from the DWARF 2 index cache directory."),
+	   &maintenancelist);
+  /* APPLE LOCAL end dwarf2 index cache  */
+
+  /* APPLE LOCAL begin parallel psymtabs  */
+  add_setshow_zinteger_cmd ("psymtab-threads", class_maintenance,
+			    &dwarf2_psymtab_threads, _("\
+Set the number of threads used to build DWARF 2 partial symbol tables."), _("\
+Show the number of threads used to build DWARF 2 partial symbol tables."), _("\
+With more than one thread, compilation units are scanned for partial\n\
+symbols in parallel.  One means all the work is done by the main\n\
+thread.  Zero means one thread per online processor."),
+			    NULL,
+			    show_dwarf2_psymtab_threads,
+			    &set_dwarf2_cmdlist,
+			    &show_dwarf2_cmdlist);
+
+#ifdef HAVE_PTHREAD_CREATE
+  if (pthread_key_create (&dwarf2_psymtab_job_key, NULL) == 0)
+    helper_thread_check_hook = dwarf2_psymtab_helper_check;
+#endif
+  /* APPLE LOCAL end parallel psymtabs  */
+
   /* APPLE LOCAL begin Inform users about debugging optimized code  */
   add_setshow_boolean_cmd ("inform-optimized", class_support,
 			   &dwarf2_inform_debugging_optimized_code,
@@ -214,6 +214,10 @@ exceptions_state_mc_action_iter_1 (void)
 NORETURN void
 throw_exception (struct gdb_exception exception)
 {
+  /* APPLE LOCAL parallel psymtabs  */
+  if (helper_thread_check_hook)
+    helper_thread_check_hook ();
+
   quit_flag = 0;
   immediate_quit = 0;
 
@@ -390,6 +394,10 @@ throw_it (enum return_reason reason, enum errors error, const char *fmt,
   struct gdb_exception e;
   char *new_message;
 
+  /* APPLE LOCAL parallel psymtabs  */
+  if (helper_thread_check_hook)
+    helper_thread_check_hook ();
+
   /* Save the message.  Create the new message before deleting the
      old, the new message may include the old message text.  */
   new_message = xstrvprintf (fmt, ap);
@@ -23,4 +23,9 @@
 
 #include <regex.h>
 
+/* APPLE LOCAL begin parallel symbol search  */
+extern const char *re_comp_buf (regex_t *re, const char *str);
+extern int re_exec_buf (regex_t *re, const char *str);
+/* APPLE LOCAL end parallel symbol search  */
+
 #endif /* not GDB_REGEX_H */
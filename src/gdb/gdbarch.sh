@@ -671,6 +671,29 @@ M::const struct regset *:regset_from_core_section:const char *sect_name, size_t
 
 # APPLE LOCAL: Translate eh frame regnums into dwarf regnums
 m::int:adjust_ehframe_regnum:int regnum, int eh_frame_p:regnum, eh_frame_p::default_adjust_ehframe_regnum::0
+
+# APPLE LOCAL displaced stepping: The maximum length of an instruction on this architecture.
+V::ULONGEST:max_insn_length:::0:0
+
+# APPLE LOCAL displaced stepping: Copy the instruction at FROM to TO, and make any adjustments
+# necessary to single-step it at that address.  REGS holds the state
+# the thread's registers will have before executing the copy; the
+# method may change it.  Return a closure for displaced_step_fixup, or
+# NULL if the instruction can't be stepped out of line (in which case
+# nothing may have been written to TO).
+M::struct displaced_step_closure *:displaced_step_copy_insn:CORE_ADDR from, CORE_ADDR to, struct regcache *regs:from, to, regs
+
+# APPLE LOCAL displaced stepping: Fix up the state of a thread which has just single-stepped the copy
+# of the instruction at FROM made at TO by displaced_step_copy_insn,
+# leaving it as if it had executed the instruction in place.
+M::void:displaced_step_fixup:struct displaced_step_closure *closure, CORE_ADDR from, CORE_ADDR to, struct regcache *regs:closure, from, to, regs
+
+# APPLE LOCAL displaced stepping: Free a closure returned by displaced_step_copy_insn.
+m::void:displaced_step_free_closure:struct displaced_step_closure *closure:closure::NULL::(! current_gdbarch->displaced_step_free_closure) != (! current_gdbarch->displaced_step_copy_insn)
+
+# APPLE LOCAL displaced stepping: Return the address of a scratch area, at least max_insn_length bytes
+# long, in which to step displaced instructions.
+m::CORE_ADDR:displaced_step_location:void:::NULL::(! current_gdbarch->displaced_step_location) != (! current_gdbarch->displaced_step_copy_insn)
 EOF
 }
 
@@ -781,6 +804,8 @@ struct regset;
 struct disassemble_info;
 struct target_ops;
 struct obstack;
+/* APPLE LOCAL displaced stepping  */
+struct displaced_step_closure;
 
 extern struct gdbarch *current_gdbarch;
 EOF
@@ -0,0 +1,443 @@
+/* Agent expression evaluation for the remote server for GDB.
+   Copyright 2006
+   Free Software Foundation, Inc.
+
+   This file is part of GDB.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 59 Temple Place - Suite 330,
+   Boston, MA 02111-1307, USA.  */
+
+#include "server.h"
+
+/* The deepest stack an expression may use.  GDB's own expressions
+   rarely need more than a handful of entries.  */
+#define AX_STACK_SIZE 100
+
+/* The most bytecodes we'll execute for one evaluation, so that a
+   looping expression can't wedge the inferior.  */
+#define AX_MAX_STEPS 100000
+
+struct agent_expr *
+parse_agent_expr (char **actparm)
+{
+  char *act = *actparm;
+  struct agent_expr *aexpr;
+  unsigned long length;
+  char *end;
+
+  length = strtoul (act, &end, 16);
+  if (end == act || *end != ',' || length == 0 || length > PBUFSIZ / 2)
+    return NULL;
+  act = end + 1;
+
+  aexpr = malloc (sizeof (struct agent_expr));
+  if (aexpr == NULL)
+    return NULL;
+  aexpr->length = length;
+  aexpr->bytes = malloc (length);
+  if (aexpr->bytes == NULL
+      || unhexify ((char *) aexpr->bytes, act, length) != length)
+    {
+      free_agent_expr (aexpr);
+      return NULL;
+    }
+
+  *actparm = act + 2 * length;
+  return aexpr;
+}
+
+void
+free_agent_expr (struct agent_expr *aexpr)
+{
+  if (aexpr == NULL)
+    return;
+  free (aexpr->bytes);
+  free (aexpr);
+}
+
+const char *
+expr_eval_result_string (enum expr_eval_result result)
+{
+  switch (result)
+    {
+    case expr_eval_no_error:
+      return "no error";
+    case expr_eval_empty_expression:
+      return "empty expression";
+    case expr_eval_empty_stack:
+      return "nothing left on the stack";
+    case expr_eval_stack_overflow:
+      return "stack overflow";
+    case expr_eval_stack_underflow:
+      return "stack underflow";
+    case expr_eval_unhandled_opcode:
+      return "unhandled opcode";
+    case expr_eval_unrecognized_opcode:
+      return "unrecognized opcode";
+    case expr_eval_divide_by_zero:
+      return "division by zero";
+    case expr_eval_invalid_goto:
+      return "jump out of the expression";
+    case expr_eval_invalid_register:
+      return "invalid register";
+    case expr_eval_memory_error:
+      return "memory read failed";
+    case expr_eval_too_many_steps:
+      return "too many steps";
+    default:
+      return "unknown error";
+    }
+}
+
+/* Fetch the SIZE-byte big-endian operand at OP.  Bytecode operands
+   are always big-endian, whatever the target's byte order.  */
+
+static ULONGEST
+ax_operand (const unsigned char *op, int size)
+{
+  ULONGEST val = 0;
+  int i;
+
+  for (i = 0; i < size; i++)
+    val = (val << 8) | op[i];
+  return val;
+}
+
+/* Read a SIZE-byte value in the inferior's byte order from BUF, and
+   return it zero-extended.  */
+
+static ULONGEST
+ax_extract_unsigned (const unsigned char *buf, int size)
+{
+  unsigned char u8;
+  unsigned short u16;
+  unsigned int u32;
+  ULONGEST u64;
+
+  switch (size)
+    {
+    case 1:
+      memcpy (&u8, buf, 1);
+      return u8;
+    case 2:
+      memcpy (&u16, buf, 2);
+      return u16;
+    case 4:
+      memcpy (&u32, buf, 4);
+      return u32;
+    default:
+      memcpy (&u64, buf, 8);
+      return u64;
+    }
+}
+
+enum expr_eval_result
+eval_agent_expr (struct agent_expr *aexpr, ULONGEST *rslt)
+{
+  /* APPLE LOCAL gdbserver tracepoints  */
+  return eval_agent_expr_trace (aexpr, rslt, NULL, NULL);
+}
+
+/* APPLE LOCAL begin gdbserver tracepoints  */
+enum expr_eval_result
+eval_agent_expr_trace (struct agent_expr *aexpr, ULONGEST *rslt,
+		       agent_trace_fn trace, void *data)
+/* APPLE LOCAL end gdbserver tracepoints  */
+{
+  ULONGEST stack[AX_STACK_SIZE];
+  unsigned char buf[8];
+  int sp = 0;
+  int pc = 0;
+  int steps = 0;
+  ULONGEST a, b;
+  int size;
+
+  if (aexpr == NULL || aexpr->length == 0)
+    return expr_eval_empty_expression;
+
+/* Check that there are at least N values on the stack, or room for N
+   more of them.  */
+#define NEED_ARGS(N)						\
+  do { if (sp < (N)) return expr_eval_stack_underflow; } while (0)
+#define NEED_ROOM(N)						\
+  do { if (sp + (N) > AX_STACK_SIZE)				\
+	 return expr_eval_stack_overflow; } while (0)
+/* Check that the current instruction's N operand bytes are there.  */
+#define NEED_OPERAND(N)						\
+  do { if (pc + (N) > aexpr->length)				\
+	 return expr_eval_unrecognized_opcode; } while (0)
+
+  while (pc < aexpr->length)
+    {
+      enum agent_op op = aexpr->bytes[pc++];
+
+      if (++steps > AX_MAX_STEPS)
+	return expr_eval_too_many_steps;
+
+      switch (op)
+	{
+	case aop_add:
+	case aop_sub:
+	case aop_mul:
+	case aop_div_signed:
+	case aop_div_unsigned:
+	case aop_rem_signed:
+	case aop_rem_unsigned:
+	case aop_lsh:
+	case aop_rsh_signed:
+	case aop_rsh_unsigned:
+	case aop_bit_and:
+	case aop_bit_or:
+	case aop_bit_xor:
+	case aop_equal:
+	case aop_less_signed:
+	case aop_less_unsigned:
+	  NEED_ARGS (2);
+	  b = stack[--sp];
+	  a = stack[sp - 1];
+	  switch (op)
+	    {
+	    case aop_add:
+	      a = a + b;
+	      break;
+	    case aop_sub:
+	      a = a - b;
+	      break;
+	    case aop_mul:
+	      a = a * b;
+	      break;
+	    case aop_div_signed:
+	      if (b == 0)
+		return expr_eval_divide_by_zero;
+	      /* The most negative value divided by -1 overflows, and
+		 traps on some hosts; negating wraps instead.  */
+	      if ((LONGEST) b == -1)
+		a = -a;
+	      else
+		a = (LONGEST) a / (LONGEST) b;
+	      break;
+	    case aop_div_unsigned:
+	      if (b == 0)
+		return expr_eval_divide_by_zero;
+	      a = a / b;
+	      break;
+	    case aop_rem_signed:
+	      if (b == 0)
+		return expr_eval_divide_by_zero;
+	      if ((LONGEST) b == -1)
+		a = 0;
+	      else
+		a = (LONGEST) a % (LONGEST) b;
+	      break;
+	    case aop_rem_unsigned:
+	      if (b == 0)
+		return expr_eval_divide_by_zero;
+	      a = a % b;
+	      break;
+	    case aop_lsh:
+	      a = b >= 64 ? 0 : a << b;
+	      break;
+	    case aop_rsh_signed:
+	      a = (LONGEST) a >> (b >= 64 ? 63 : b);
+	      break;
+	    case aop_rsh_unsigned:
+	      a = b >= 64 ? 0 : a >> b;
+	      break;
+	    case aop_bit_and:
+	      a = a & b;
+	      break;
+	    case aop_bit_or:
+	      a = a | b;
+	      break;
+	    case aop_bit_xor:
+	      a = a ^ b;
+	      break;
+	    case aop_equal:
+	      a = (a == b);
+	      break;
+	    case aop_less_signed:
+	      a = ((LONGEST) a < (LONGEST) b);
+	      break;
+	    default:
+	      a = (a < b);
+	      break;
+	    }
+	  stack[sp - 1] = a;
+	  break;
+
+	case aop_log_not:
+	  NEED_ARGS (1);
+	  stack[sp - 1] = !stack[sp - 1];
+	  break;
+
+	case aop_bit_not:
+	  NEED_ARGS (1);
+	  stack[sp - 1] = ~stack[sp - 1];
+	  break;
+
+	case aop_ext:
+	case aop_zero_ext:
+	  NEED_OPERAND (1);
+	  NEED_ARGS (1);
+	  size = aexpr->bytes[pc++];
+	  if (size > 0 && size < 64)
+	    {
+	      ULONGEST mask = ((ULONGEST) 1 << size) - 1;
+
+	      a = stack[sp - 1] & mask;
+	      if (op == aop_ext)
+		{
+		  ULONGEST sign = (ULONGEST) 1 << (size - 1);
+
+		  a = (a ^ sign) - sign;
+		}
+	      stack[sp - 1] = a;
+	    }
+	  break;
+
+	case aop_ref8:
+	case aop_ref16:
+	case aop_ref32:
+	case aop_ref64:
+	  NEED_ARGS (1);
+	  size = 1 << (op - aop_ref8);
+	  if (read_inferior_memory ((CORE_ADDR) stack[sp - 1], buf, size) != 0)
+	    return expr_eval_memory_error;
+	  stack[sp - 1] = ax_extract_unsigned (buf, size);
+	  break;
+
+	case aop_if_goto:
+	  NEED_OPERAND (2);
+	  NEED_ARGS (1);
+	  a = ax_operand (aexpr->bytes + pc, 2);
+	  pc += 2;
+	  if (stack[--sp] != 0)
+	    {
+	      if (a >= aexpr->length)
+		return expr_eval_invalid_goto;
+	      pc = a;
+	    }
+	  break;
+
+	case aop_goto:
+	  NEED_OPERAND (2);
+	  a = ax_operand (aexpr->bytes + pc, 2);
+	  if (a >= aexpr->length)
+	    return expr_eval_invalid_goto;
+	  pc = a;
+	  break;
+
+	case aop_const8:
+	case aop_const16:
+	case aop_const32:
+	case aop_const64:
+	  size = 1 << (op - aop_const8);
+	  NEED_OPERAND (size);
+	  NEED_ROOM (1);
+	  stack[sp++] = ax_operand (aexpr->bytes + pc, size);
+	  pc += size;
+	  break;
+
+	case aop_reg:
+	  NEED_OPERAND (2);
+	  NEED_ROOM (1);
+	  a = ax_operand (aexpr->bytes + pc, 2);
+	  pc += 2;
+	  if (a >= register_count ())
+	    return expr_eval_invalid_register;
+	  size = register_size (a);
+	  if (size != 1 && size != 2 && size != 4 && size != 8)
+	    return expr_eval_invalid_register;
+	  collect_register (a, buf);
+	  stack[sp++] = ax_extract_unsigned (buf, size);
+	  break;
+
+	case aop_end:
+	  /* APPLE LOCAL begin gdbserver tracepoints  */
+	  /* Collection expressions are run only for their trace
+	     bytecodes, and may leave nothing behind.  */
+	  if (rslt == NULL)
+	    return expr_eval_no_error;
+	  /* APPLE LOCAL end gdbserver tracepoints  */
+	  if (sp == 0)
+	    return expr_eval_empty_stack;
+	  *rslt = stack[sp - 1];
+	  return expr_eval_no_error;
+
+	case aop_dup:
+	  NEED_ARGS (1);
+	  NEED_ROOM (1);
+	  stack[sp] = stack[sp - 1];
+	  sp++;
+	  break;
+
+	case aop_pop:
+	  NEED_ARGS (1);
+	  sp--;
+	  break;
+
+	case aop_swap:
+	  NEED_ARGS (2);
+	  a = stack[sp - 1];
+	  stack[sp - 1] = stack[sp - 2];
+	  stack[sp - 2] = a;
+	  break;
+
+	case aop_float:
+	case aop_ref_float:
+	case aop_ref_double:
+	case aop_ref_long_double:
+	case aop_l_to_d:
+	case aop_d_to_l:
+	  return expr_eval_unhandled_opcode;
+
+	/* APPLE LOCAL begin gdbserver tracepoints  */
+	case aop_trace:
+	  if (trace == NULL)
+	    return expr_eval_unhandled_opcode;
+	  NEED_ARGS (2);
+	  b = stack[--sp];
+	  a = stack[--sp];
+	  if ((*trace) ((CORE_ADDR) a, b, data) != 0)
+	    return expr_eval_memory_error;
+	  break;
+
+	case aop_trace_quick:
+	case aop_trace16:
+	  if (trace == NULL)
+	    return expr_eval_unhandled_opcode;
+	  size = op == aop_trace_quick ? 1 : 2;
+	  NEED_OPERAND (size);
+	  NEED_ARGS (1);
+	  b = ax_operand (aexpr->bytes + pc, size);
+	  pc += size;
+	  /* The address stays on the stack.  */
+	  if ((*trace) ((CORE_ADDR) stack[sp - 1], b, data) != 0)
+	    return expr_eval_memory_error;
+	  break;
+	/* APPLE LOCAL end gdbserver tracepoints  */
+
+	default:
+	  return expr_eval_unrecognized_opcode;
+	}
+    }
+
+#undef NEED_ARGS
+#undef NEED_ROOM
+#undef NEED_OPERAND
+
+  /* We ran off the end without an aop_end.  */
+  return expr_eval_unrecognized_opcode;
+}
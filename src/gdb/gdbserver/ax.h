@@ -0,0 +1,141 @@
+/* Agent expression support for the remote server for GDB.
+   Copyright 2006
+   Free Software Foundation, Inc.
+
+   This file is part of GDB.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 59 Temple Place - Suite 330,
+   Boston, MA 02111-1307, USA.  */
+
+#ifndef AX_H
+#define AX_H
+
+/* The bytecodes GDB sends us.  These are described in the "Agent
+   Expressions" appendix of the GDB manual, and must agree with the
+   numbering in gdb/ax.h.  */
+
+enum agent_op
+  {
+    aop_float = 0x01,
+    aop_add = 0x02,
+    aop_sub = 0x03,
+    aop_mul = 0x04,
+    aop_div_signed = 0x05,
+    aop_div_unsigned = 0x06,
+    aop_rem_signed = 0x07,
+    aop_rem_unsigned = 0x08,
+    aop_lsh = 0x09,
+    aop_rsh_signed = 0x0a,
+    aop_rsh_unsigned = 0x0b,
+    aop_trace = 0x0c,
+    aop_trace_quick = 0x0d,
+    aop_log_not = 0x0e,
+    aop_bit_and = 0x0f,
+    aop_bit_or = 0x10,
+    aop_bit_xor = 0x11,
+    aop_bit_not = 0x12,
+    aop_equal = 0x13,
+    aop_less_signed = 0x14,
+    aop_less_unsigned = 0x15,
+    aop_ext = 0x16,
+    aop_ref8 = 0x17,
+    aop_ref16 = 0x18,
+    aop_ref32 = 0x19,
+    aop_ref64 = 0x1a,
+    aop_ref_float = 0x1b,
+    aop_ref_double = 0x1c,
+    aop_ref_long_double = 0x1d,
+    aop_l_to_d = 0x1e,
+    aop_d_to_l = 0x1f,
+    aop_if_goto = 0x20,
+    aop_goto = 0x21,
+    aop_const8 = 0x22,
+    aop_const16 = 0x23,
+    aop_const32 = 0x24,
+    aop_const64 = 0x25,
+    aop_reg = 0x26,
+    aop_end = 0x27,
+    aop_dup = 0x28,
+    aop_pop = 0x29,
+    aop_zero_ext = 0x2a,
+    aop_swap = 0x2b,
+    aop_trace16 = 0x30
+  };
+
+/* An agent expression, as received from GDB.  */
+
+struct agent_expr
+{
+  int length;
+  unsigned char *bytes;
+};
+
+/* The ways evaluating an agent expression can go wrong.  */
+
+enum expr_eval_result
+  {
+    expr_eval_no_error,
+    expr_eval_empty_expression,
+    expr_eval_empty_stack,
+    expr_eval_stack_overflow,
+    expr_eval_stack_underflow,
+    expr_eval_unhandled_opcode,
+    expr_eval_unrecognized_opcode,
+    expr_eval_divide_by_zero,
+    expr_eval_invalid_goto,
+    expr_eval_invalid_register,
+    expr_eval_memory_error,
+    expr_eval_too_many_steps
+  };
+
+/* Parse an agent expression in "LENGTH,HEXBYTES" form (LENGTH in hex)
+   starting at *ACTPARM, and advance *ACTPARM past it.  Return NULL if
+   the text is malformed.  */
+
+struct agent_expr *parse_agent_expr (char **actparm);
+
+/* Release an agent expression returned by parse_agent_expr.  */
+
+void free_agent_expr (struct agent_expr *aexpr);
+
+/* Evaluate AEXPR in the context of the current inferior, and store
+   the value left on top of the stack in *RSLT.  */
+
+enum expr_eval_result eval_agent_expr (struct agent_expr *aexpr,
+				       ULONGEST *rslt);
+
+/* APPLE LOCAL begin gdbserver tracepoints  */
+/* A function to record LEN bytes of inferior memory at ADDR, for the
+   aop_trace family of bytecodes.  DATA is passed through unchanged
+   from eval_agent_expr_trace.  Return non-zero if the memory couldn't
+   be recorded.  */
+
+typedef int (*agent_trace_fn) (CORE_ADDR addr, ULONGEST len, void *data);
+
+/* Like eval_agent_expr, but pass the memory named by any trace
+   bytecodes to TRACE.  RSLT may be NULL, in which case the expression
+   need not leave a value on the stack.  */
+
+enum expr_eval_result eval_agent_expr_trace (struct agent_expr *aexpr,
+					     ULONGEST *rslt,
+					     agent_trace_fn trace,
+					     void *data);
+/* APPLE LOCAL end gdbserver tracepoints  */
+
+/* Return a description of RESULT, for debugging output.  */
+
+const char *expr_eval_result_string (enum expr_eval_result result);
+
+#endif /* AX_H */
@@ -134,6 +134,8 @@ add_thread (unsigned long thread_id, void *target_data, unsigned int gdb_id)
   new_thread->target_data = target_data;
   set_inferior_regcache_data (new_thread, new_register_cache ());
   new_thread->gdb_id = gdb_id;
+  /* APPLE LOCAL incremental thread list  */
+  new_thread_notify (gdb_id);
 }
 
 unsigned int
@@ -185,6 +187,8 @@ free_one_thread (struct inferior_list_entry *inf)
 void
 remove_thread (struct thread_info *thread)
 {
+  /* APPLE LOCAL incremental thread list  */
+  dead_thread_notify (thread->gdb_id);
   remove_inferior (&all_threads, (struct inferior_list_entry *) thread);
   free_one_thread (&thread->entry);
 }
@@ -192,6 +196,12 @@ remove_thread (struct thread_info *thread)
 void
 clear_inferiors (void)
 {
+  /* APPLE LOCAL begin incremental thread list  */
+  struct inferior_list_entry *inf;
+
+  for (inf = all_threads.head; inf != NULL; inf = inf->next)
+    dead_thread_notify (get_thread (inf)->gdb_id);
+  /* APPLE LOCAL end incremental thread list  */
   for_each_inferior (&all_threads, free_one_thread);
 
   all_threads.head = all_threads.tail = NULL;
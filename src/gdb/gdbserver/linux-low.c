@@ -38,6 +38,8 @@
 #include <unistd.h>
 #include <errno.h>
 #include <sys/syscall.h>
+/* APPLE LOCAL bulk memory transfer  */
+#include <sys/uio.h>
 
 /* ``all_threads'' is keyed by the LWP ID - it should be the thread ID instead,
    however.  This requires changing the ID in place when we go from !using_threads
@@ -59,6 +61,9 @@ static void linux_resume_one_process (struct inferior_list_entry *entry,
 static void linux_resume (struct thread_resume *resume_info);
 static void stop_all_processes (void);
 static int linux_wait_for_event (struct thread_info *child);
+/* APPLE LOCAL target-side breakpoint conditions  */
+static int linux_step_over_breakpoint (struct process_info *event_child,
+				       CORE_ADDR stop_pc);
 
 struct pending_signals
 {
@@ -438,6 +443,10 @@ static int
 linux_wait_for_event (struct thread_info *child)
 {
   CORE_ADDR stop_pc;
+  /* APPLE LOCAL begin gdbserver tracepoints  */
+  CORE_ADDR trap_pc;
+  int handled;
+  /* APPLE LOCAL end gdbserver tracepoints  */
   struct process_info *event_child;
   int wstat;
 
@@ -507,8 +516,6 @@ linux_wait_for_event (struct thread_info *child)
 	      if (all_threads.head == all_threads.tail)
 		return wstat;
 
-	      dead_thread_notify (event_child->tid);
-
 	      remove_inferior (&all_processes, &event_child->head);
 	      free (event_child);
 	      remove_thread (current_inferior);
@@ -590,7 +597,48 @@ linux_wait_for_event (struct thread_info *child)
       if (debug_threads)
 	fprintf (stderr, "Hit a (non-reinsert) breakpoint.\n");
 
-      if (check_breakpoints (stop_pc) != 0)
+      /* APPLE LOCAL begin target-side breakpoint conditions  */
+      /* A single-step which finishes on one of GDB's breakpoints hasn't
+	 executed it yet; report the completed step, without looking at
+	 the breakpoint's condition.  */
+      if (event_child->stepping && gdb_breakpoint_here (stop_pc))
+	{
+	  event_child->stepping = 0;
+	  return wstat;
+	}
+
+      /* While we are stopping every thread, put off a hit of one of
+	 our silent breakpoints: back the thread up to the breakpoint
+	 and let it go.  The SIGSTOP it has been sent stops it before
+	 it executes anything, and it hits the breakpoint again once it
+	 is resumed.  Handling the hit here would mean stepping over
+	 the breakpoint in the middle of stopping everything.  */
+      if (stopping_threads && the_low_target.set_pc != NULL
+	  && silent_breakpoint_here (stop_pc))
+	{
+	  if (debug_threads)
+	    fprintf (stderr, "Deferring breakpoint hit while stopping.\n");
+	  (*the_low_target.set_pc) (stop_pc);
+	  linux_resume_one_process (&event_child->head, 0, 0);
+	  continue;
+	}
+      /* APPLE LOCAL end target-side breakpoint conditions  */
+
+      /* APPLE LOCAL begin gdbserver tracepoints  */
+      /* A breakpoint handler may collect a trace frame, which should
+	 show the breakpoint's address as its PC rather than wherever the
+	 trap left it.  Put the PC back afterwards, since
+	 check_removed_breakpoint makes the real adjustment when we
+	 resume.  */
+      trap_pc = (*the_low_target.get_pc) ();
+      if (trap_pc != stop_pc && the_low_target.set_pc != NULL)
+	(*the_low_target.set_pc) (stop_pc);
+      handled = check_breakpoints (stop_pc);
+      if (trap_pc != stop_pc && the_low_target.set_pc != NULL)
+	(*the_low_target.set_pc) (trap_pc);
+
+      if (handled)
+      /* APPLE LOCAL end gdbserver tracepoints  */
 	{
 	  /* We hit one of our own breakpoints.  We mark it as a pending
 	     breakpoint, so that check_removed_breakpoint () will do the PC
@@ -598,36 +646,33 @@ linux_wait_for_event (struct thread_info *child)
 	  event_child->pending_is_breakpoint = 1;
 	  event_child->pending_stop_pc = stop_pc;
 
-	  /* Now we need to put the breakpoint back.  We continue in the event
-	     loop instead of simply replacing the breakpoint right away,
-	     in order to not lose signals sent to the thread that hit the
-	     breakpoint.  Unfortunately this increases the window where another
-	     thread could sneak past the removed breakpoint.  For the current
-	     use of server-side breakpoints (thread creation) this is
-	     acceptable; but it needs to be considered before this breakpoint
-	     mechanism can be used in more general ways.  For some breakpoints
-	     it may be necessary to stop all other threads, but that should
-	     be avoided where possible.
-
-	     If breakpoint_reinsert_addr is NULL, that means that we can
-	     use PTRACE_SINGLESTEP on this platform.  Uninsert the breakpoint,
-	     mark it for reinsertion, and single-step.
-
-	     Otherwise, call the target function to figure out where we need
-	     our temporary breakpoint, create it, and continue executing this
-	     process.  */
-	  if (the_low_target.breakpoint_reinsert_addr == NULL)
-	    {
-	      event_child->bp_reinsert = stop_pc;
-	      uninsert_breakpoint (stop_pc);
-	      linux_resume_one_process (&event_child->head, 1, 0);
-	    }
-	  else
-	    {
-	      reinsert_breakpoint_by_bp
-		(stop_pc, (*the_low_target.breakpoint_reinsert_addr) ());
-	      linux_resume_one_process (&event_child->head, 0, 0);
-	    }
+	  /* Now we need to put the breakpoint back.
+
+	     APPLE LOCAL: Stop every other thread, so that none of them
+	     can run past the breakpoint while it is out (a false
+	     condition or a tracepoint must not lose hits), then step
+	     this thread over it, put it back and let everything go
+	     again.  */
+	  {
+	    struct process_info *pending = NULL;
+
+	    /* The step, or stopping the other threads for it, may have
+	       left a status to report.  */
+	    linux_step_over_breakpoint (event_child, stop_pc);
+	    if (child == NULL)
+	      pending = (struct process_info *)
+		find_inferior (&all_processes, status_pending_p, NULL);
+	    else if (event_child->status_pending_p)
+	      pending = event_child;
+	    if (pending != NULL)
+	      {
+		wstat = pending->status_pending;
+		pending->status_pending_p = 0;
+		pending->status_pending = 0;
+		current_inferior = get_process_thread (pending);
+		return wstat;
+	      }
+	  }
 
 	  continue;
 	}
@@ -845,6 +890,137 @@ stop_all_processes (void)
   stopping_threads = 0;
 }
 
+/* APPLE LOCAL begin target-side breakpoint conditions  */
+static void
+mark_running_for_step_over (struct inferior_list_entry *entry)
+{
+  struct process_info *process = (struct process_info *) entry;
+
+  process->stopped_for_step_over = !process->stopped;
+}
+
+static void
+resume_after_step_over (struct inferior_list_entry *entry)
+{
+  struct process_info *process = (struct process_info *) entry;
+
+  if (!process->stopped_for_step_over)
+    return;
+
+  process->stopped_for_step_over = 0;
+
+  /* Threads that stopped with something to report stay stopped; the
+     next wait picks up their status.  */
+  if (!process->status_pending_p)
+    linux_resume_one_process (&process->head, process->stepping, 0);
+}
+
+static void
+clear_step_over_mark (struct inferior_list_entry *entry)
+{
+  ((struct process_info *) entry)->stopped_for_step_over = 0;
+}
+
+/* EVENT_CHILD has hit the gdbserver breakpoint at STOP_PC, and we
+   don't want to report it.  Step EVENT_CHILD over the breakpoint with
+   every other thread stopped, then resume them all.  If EVENT_CHILD
+   stops for some other reason before finishing the step, leave that
+   status pending, leave every thread stopped, and return non-zero;
+   the caller should report it.
+
+   Targets without PTRACE_SINGLESTEP give us the address of the next
+   instruction instead; run EVENT_CHILD to a temporary breakpoint
+   there, whose handler puts the original breakpoint back.  If some
+   other stop comes first, the temporary breakpoint stays, and is
+   handled like any other of ours when the thread reaches it.  */
+
+static int
+linux_step_over_breakpoint (struct process_info *event_child,
+			    CORE_ADDR stop_pc)
+{
+  struct thread_info *saved_inferior = current_inferior;
+  CORE_ADDR reinsert_addr = 0;
+  int wstat, stepped;
+
+  for_each_inferior (&all_processes, mark_running_for_step_over);
+  stop_all_processes ();
+  current_inferior = saved_inferior;
+
+  if (debug_threads)
+    fprintf (stderr, "Stepping %ld over breakpoint at 0x%lx.\n",
+	     event_child->lwpid, (long) stop_pc);
+
+  if (the_low_target.breakpoint_reinsert_addr == NULL)
+    {
+      event_child->bp_reinsert = stop_pc;
+      uninsert_breakpoint (stop_pc);
+      linux_resume_one_process (&event_child->head, 1, 0);
+    }
+  else
+    {
+      reinsert_addr = (*the_low_target.breakpoint_reinsert_addr) ();
+      reinsert_breakpoint_by_bp (stop_pc, reinsert_addr);
+      linux_resume_one_process (&event_child->head, 0, 0);
+    }
+
+  /* Wait for this thread only; the others are stopped.  */
+  linux_wait_for_process (&event_child, &wstat);
+  current_inferior = saved_inferior;
+
+  if (reinsert_addr == 0)
+    {
+      if (WIFSTOPPED (wstat))
+	reinsert_breakpoint (stop_pc);
+      event_child->bp_reinsert = 0;
+      stepped = WIFSTOPPED (wstat) && WSTOPSIG (wstat) == SIGTRAP;
+    }
+  else
+    {
+      stepped = (WIFSTOPPED (wstat) && WSTOPSIG (wstat) == SIGTRAP
+		 && get_stop_pc () == reinsert_addr
+		 && check_breakpoints (reinsert_addr));
+      if (stepped)
+	{
+	  /* Let check_removed_breakpoint back the PC up to the
+	     temporary breakpoint, which its handler has removed.  */
+	  event_child->pending_is_breakpoint = 1;
+	  event_child->pending_stop_pc = reinsert_addr;
+	}
+    }
+
+  if (stepped)
+    linux_resume_one_process (&event_child->head, 0, 0);
+  else if (WIFSTOPPED (wstat)
+	   && WSTOPSIG (wstat) == SIGSTOP
+	   && event_child->stop_expected)
+    {
+      /* A stop we asked for earlier; the thread is still at the
+	 breakpoint and will hit it again, or reach the temporary
+	 one.  */
+      event_child->stop_expected = 0;
+      linux_resume_one_process (&event_child->head, 0, 0);
+    }
+  else if (using_threads
+	   && WIFSTOPPED (wstat)
+	   && (WSTOPSIG (wstat) == __SIGRTMIN
+	       || WSTOPSIG (wstat) == __SIGRTMIN + 1))
+    linux_resume_one_process (&event_child->head, 0, WSTOPSIG (wstat));
+  else
+    {
+      /* Report this the next time we wait.  Any signal arrived before
+	 the breakpoint instruction was executed, so the thread hits
+	 the breakpoint again when it is resumed.  */
+      event_child->status_pending_p = 1;
+      event_child->status_pending = wstat;
+      for_each_inferior (&all_processes, clear_step_over_mark);
+      return 1;
+    }
+
+  for_each_inferior (&all_processes, resume_after_step_over);
+  return 0;
+}
+/* APPLE LOCAL end target-side breakpoint conditions  */
+
 /* Resume execution of the inferior process.
    If STEP is nonzero, single-step it.
    If SIGNAL is nonzero, give it that signal.  */
@@ -1372,6 +1548,94 @@ linux_store_registers (int regno)
 }
 
 
+/* APPLE LOCAL begin bulk memory transfer  */
+/* Transfer up to LEN bytes at MEMADDR in the inferior with as few
+   system calls as possible, reading into READBUF or writing from
+   WRITEBUF (exactly one of them is non-NULL).  Returns the number of
+   bytes actually transferred, which may be less than LEN (or zero)
+   if the kernel refuses; the caller finishes the rest with ptrace.
+   Short transfers aren't worth the extra syscalls, so they are left
+   to ptrace entirely.  */
+
+static int
+linux_xfer_memory_bulk (CORE_ADDR memaddr, unsigned char *readbuf,
+			const unsigned char *writebuf, int len)
+{
+  char filename[64];
+  int fd;
+  int ret;
+
+  /* Don't bother for one or two words.  */
+  if (len < 3 * (int) sizeof (PTRACE_XFER_TYPE))
+    return 0;
+
+#if defined (HAVE_PROCESS_VM_READV) && defined (HAVE_PROCESS_VM_WRITEV)
+  /* Cross Memory Attach moves the whole block in one call, without
+     needing a file descriptor.  It does not override page
+     protections though, so writes to text (breakpoints) will
+     usually fail here and go through /proc or ptrace instead.  */
+  {
+    struct iovec local, remote;
+    ssize_t n;
+
+    local.iov_base = readbuf != NULL ? (void *) readbuf : (void *) writebuf;
+    local.iov_len = len;
+    remote.iov_base = (void *) (unsigned long) memaddr;
+    remote.iov_len = len;
+
+    if (readbuf != NULL)
+      n = process_vm_readv (inferior_pid, &local, 1, &remote, 1, 0);
+    else
+      n = process_vm_writev (inferior_pid, &local, 1, &remote, 1, 0);
+
+    if (n == len)
+      return len;
+    if (n > 0)
+      return n;
+  }
+#endif
+
+  /* We could keep this file open and cache it - possibly one per
+     thread.  That requires some juggling, but is even faster.  */
+  sprintf (filename, "/proc/%ld/mem", (long) inferior_pid);
+#ifdef O_LARGEFILE
+  fd = open (filename, (readbuf != NULL ? O_RDONLY : O_RDWR) | O_LARGEFILE);
+#else
+  fd = open (filename, readbuf != NULL ? O_RDONLY : O_RDWR);
+#endif
+  if (fd == -1)
+    return 0;
+
+  /* If pread64 is available, use it.  It's faster if the kernel
+     supports it (only one syscall), and it's 64-bit safe even on
+     32-bit platforms.  */
+  if (readbuf != NULL)
+    {
+#ifdef HAVE_PREAD64
+      ret = pread64 (fd, readbuf, len, memaddr);
+#else
+      ret = (lseek (fd, memaddr, SEEK_SET) == -1
+	     ? -1 : read (fd, readbuf, len));
+#endif
+    }
+  else
+    {
+#ifdef HAVE_PWRITE64
+      ret = pwrite64 (fd, writebuf, len, memaddr);
+#else
+      ret = (lseek (fd, memaddr, SEEK_SET) == -1
+	     ? -1 : write (fd, writebuf, len));
+#endif
+    }
+
+  close (fd);
+
+  if (ret < 0)
+    return 0;
+  return ret;
+}
+/* APPLE LOCAL end bulk memory transfer  */
+
 /* Copy LEN bytes from inferior's memory starting at MEMADDR
    to debugger memory starting at MYADDR.  */
 
@@ -1379,15 +1643,27 @@ static int
 linux_read_memory (CORE_ADDR memaddr, unsigned char *myaddr, int len)
 {
   register int i;
+  /* APPLE LOCAL begin bulk memory transfer  */
+  register CORE_ADDR addr;
+  register int count;
+  register PTRACE_XFER_TYPE *buffer;
+  int done;
+
+  done = linux_xfer_memory_bulk (memaddr, myaddr, NULL, len);
+  if (done == len)
+    return 0;
+  memaddr += done;
+  myaddr += done;
+  len -= done;
+
   /* Round starting address down to longword boundary.  */
-  register CORE_ADDR addr = memaddr & -(CORE_ADDR) sizeof (PTRACE_XFER_TYPE);
+  addr = memaddr & -(CORE_ADDR) sizeof (PTRACE_XFER_TYPE);
   /* Round ending address up; get number of longwords that makes.  */
-  register int count
-    = (((memaddr + len) - addr) + sizeof (PTRACE_XFER_TYPE) - 1)
-      / sizeof (PTRACE_XFER_TYPE);
+  count = (((memaddr + len) - addr) + sizeof (PTRACE_XFER_TYPE) - 1)
+	  / sizeof (PTRACE_XFER_TYPE);
   /* Allocate buffer of that many longwords.  */
-  register PTRACE_XFER_TYPE *buffer
-    = (PTRACE_XFER_TYPE *) alloca (count * sizeof (PTRACE_XFER_TYPE));
+  buffer = (PTRACE_XFER_TYPE *) alloca (count * sizeof (PTRACE_XFER_TYPE));
+  /* APPLE LOCAL end bulk memory transfer  */
 
   /* Read all the longwords */
   for (i = 0; i < count; i++, addr += sizeof (PTRACE_XFER_TYPE))
@@ -1413,13 +1689,11 @@ static int
 linux_write_memory (CORE_ADDR memaddr, const unsigned char *myaddr, int len)
 {
   register int i;
-  /* Round starting address down to longword boundary.  */
-  register CORE_ADDR addr = memaddr & -(CORE_ADDR) sizeof (PTRACE_XFER_TYPE);
-  /* Round ending address up; get number of longwords that makes.  */
-  register int count
-  = (((memaddr + len) - addr) + sizeof (PTRACE_XFER_TYPE) - 1) / sizeof (PTRACE_XFER_TYPE);
-  /* Allocate buffer of that many longwords.  */
-  register PTRACE_XFER_TYPE *buffer = (PTRACE_XFER_TYPE *) alloca (count * sizeof (PTRACE_XFER_TYPE));
+  /* APPLE LOCAL begin bulk memory transfer  */
+  register CORE_ADDR addr;
+  register int count;
+  register PTRACE_XFER_TYPE *buffer;
+  int done;
   extern int errno;
 
   if (debug_threads)
@@ -1427,6 +1701,22 @@ linux_write_memory (CORE_ADDR memaddr, const unsigned char *myaddr, int len)
       fprintf (stderr, "Writing %02x to %08lx\n", (unsigned)myaddr[0], (long)memaddr);
     }
 
+  done = linux_xfer_memory_bulk (memaddr, NULL, myaddr, len);
+  if (done == len)
+    return 0;
+  memaddr += done;
+  myaddr += done;
+  len -= done;
+
+  /* Round starting address down to longword boundary.  */
+  addr = memaddr & -(CORE_ADDR) sizeof (PTRACE_XFER_TYPE);
+  /* Round ending address up; get number of longwords that makes.  */
+  count = (((memaddr + len) - addr) + sizeof (PTRACE_XFER_TYPE) - 1)
+	  / sizeof (PTRACE_XFER_TYPE);
+  /* Allocate buffer of that many longwords.  */
+  buffer = (PTRACE_XFER_TYPE *) alloca (count * sizeof (PTRACE_XFER_TYPE));
+  /* APPLE LOCAL end bulk memory transfer  */
+
   /* Fill start and end extra bytes of buffer with existing memory data.  */
 
   buffer[0] = ptrace (PTRACE_PEEKTEXT, inferior_pid,
@@ -121,6 +121,13 @@ struct process_info
      and then processed and cleared in linux_resume_one_process.  */
 
   struct thread_resume *resume;
+
+  /* APPLE LOCAL begin target-side breakpoint conditions  */
+  /* If this flag is set, this process was running when another one
+     stopped everything to step over a breakpoint, and should be
+     resumed when the step is done.  */
+  int stopped_for_step_over;
+  /* APPLE LOCAL end target-side breakpoint conditions  */
 };
 
 extern struct inferior_list all_processes;
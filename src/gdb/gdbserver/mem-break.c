@@ -23,6 +23,9 @@
 
 #include "server.h"
 
+/* APPLE LOCAL target-side breakpoint conditions  */
+extern int debug_threads;
+
 const unsigned char *breakpoint_data;
 int breakpoint_len;
 
@@ -44,6 +47,21 @@ struct breakpoint
 
   /* Function to call when we hit this breakpoint.  */
   void (*handler) (CORE_ADDR);
+
+  /* APPLE LOCAL begin target-side breakpoint conditions  */
+  /* Non-zero iff GDB asked for this breakpoint with a 'Z0' packet.  */
+  int gdb_owned;
+
+  /* If non-NULL, GDB only wants to hear about hits of this breakpoint
+     where this evaluates to non-zero.  */
+  struct agent_expr *cond;
+  /* APPLE LOCAL end target-side breakpoint conditions  */
+
+  /* APPLE LOCAL begin gdbserver tracepoints  */
+  /* Non-zero iff nobody wants this breakpoint any more, but a thread
+     is stepping over it.  It is deleted instead of being put back.  */
+  int delete_on_reinsert;
+  /* APPLE LOCAL end gdbserver tracepoints  */
 };
 
 struct breakpoint *breakpoints;
@@ -95,6 +113,8 @@ delete_breakpoint (struct breakpoint *bp)
 	  free (bp);
 	  return;
 	}
+      /* APPLE LOCAL target-side breakpoint conditions  */
+      cur = cur->next;
     }
   warning ("Could not find breakpoint in list.");
 }
@@ -127,9 +147,16 @@ reinsert_breakpoint_handler (CORE_ADDR stop_pc)
   if (orig_bp == NULL)
     error ("no breakpoint to reinsert");
 
-  (*the_target->write_memory) (orig_bp->pc, breakpoint_data,
-			       breakpoint_len);
-  orig_bp->reinserting = 0;
+  /* APPLE LOCAL begin gdbserver tracepoints  */
+  if (orig_bp->delete_on_reinsert)
+    delete_breakpoint (orig_bp);
+  else
+    {
+      (*the_target->write_memory) (orig_bp->pc, breakpoint_data,
+				   breakpoint_len);
+      orig_bp->reinserting = 0;
+    }
+  /* APPLE LOCAL end gdbserver tracepoints  */
   delete_breakpoint (stop_bp);
 }
 
@@ -179,15 +206,171 @@ reinsert_breakpoint (CORE_ADDR stopped_at)
   if (! bp->reinserting)
     error ("Breakpoint already inserted at reinsert time.");
 
+  /* APPLE LOCAL begin gdbserver tracepoints  */
+  if (bp->delete_on_reinsert)
+    {
+      delete_breakpoint (bp);
+      return;
+    }
+  /* APPLE LOCAL end gdbserver tracepoints  */
+
   (*the_target->write_memory) (bp->pc, breakpoint_data,
 			       breakpoint_len);
   bp->reinserting = 0;
 }
 
+/* APPLE LOCAL begin gdbserver tracepoints  */
+/* Delete BP, which nothing needs any more.  If a thread is stepping
+   over it, the breakpoint is out of memory and the step will try to
+   put it back; leave it in the list until then.  */
+
+static void
+release_breakpoint (struct breakpoint *bp)
+{
+  if (bp->reinserting)
+    bp->delete_on_reinsert = 1;
+  else
+    delete_breakpoint (bp);
+}
+/* APPLE LOCAL end gdbserver tracepoints  */
+
+/* APPLE LOCAL begin target-side breakpoint conditions  */
+int
+set_gdb_breakpoint_at (CORE_ADDR where, struct agent_expr *cond)
+{
+  struct breakpoint *bp;
+
+  if (breakpoint_data == NULL)
+    return 1;
+
+  /* GDB may insert the same breakpoint twice, and we may already have
+     one of our own here; either way there's only one breakpoint
+     instruction in memory.  */
+  bp = find_breakpoint_at (where);
+  if (bp == NULL)
+    {
+      set_breakpoint_at (where, NULL);
+      bp = find_breakpoint_at (where);
+      if (bp == NULL)
+	return -1;
+    }
+
+  free_agent_expr (bp->cond);
+  bp->cond = cond;
+  bp->gdb_owned = 1;
+  /* APPLE LOCAL gdbserver tracepoints  */
+  bp->delete_on_reinsert = 0;
+  return 0;
+}
+
+int
+delete_gdb_breakpoint_at (CORE_ADDR where)
+{
+  struct breakpoint *bp;
+
+  if (breakpoint_data == NULL)
+    return 1;
+
+  bp = find_breakpoint_at (where);
+  if (bp == NULL || !bp->gdb_owned)
+    return -1;
+
+  free_agent_expr (bp->cond);
+  bp->cond = NULL;
+  bp->gdb_owned = 0;
+
+  /* Leave our own breakpoints alone.  */
+  if (bp->handler == NULL)
+    /* APPLE LOCAL gdbserver tracepoints  */
+    release_breakpoint (bp);
+  return 0;
+}
+
+int
+gdb_breakpoint_here (CORE_ADDR where)
+{
+  struct breakpoint *bp = find_breakpoint_at (where);
+
+  return bp != NULL && bp->gdb_owned;
+}
+
+int
+silent_breakpoint_here (CORE_ADDR where)
+{
+  struct breakpoint *bp = find_breakpoint_at (where);
+
+  return bp != NULL && !bp->reinserting
+	 && (bp->handler != NULL || bp->cond != NULL);
+}
+
+/* APPLE LOCAL begin gdbserver tracepoints  */
+int
+set_breakpoint_handler_at (CORE_ADDR where, void (*handler) (CORE_ADDR))
+{
+  struct breakpoint *bp;
+
+  if (breakpoint_data == NULL)
+    return 1;
+
+  /* Share a breakpoint GDB has already put here, rather than saving
+     its breakpoint instruction as the original contents.  */
+  bp = find_breakpoint_at (where);
+  if (bp == NULL)
+    set_breakpoint_at (where, handler);
+  else
+    {
+      bp->handler = handler;
+      bp->delete_on_reinsert = 0;
+    }
+  return 0;
+}
+
+void
+clear_breakpoint_handler_at (CORE_ADDR where)
+{
+  struct breakpoint *bp = find_breakpoint_at (where);
+
+  if (bp == NULL)
+    return;
+
+  bp->handler = NULL;
+  if (!bp->gdb_owned)
+    release_breakpoint (bp);
+}
+/* APPLE LOCAL end gdbserver tracepoints  */
+
+/* Return non-zero if GDB should be told about this hit of BP: its
+   condition is true, or couldn't be evaluated.  */
+
+static int
+gdb_breakpoint_condition_true (struct breakpoint *bp)
+{
+  enum expr_eval_result result;
+  ULONGEST value;
+
+  if (bp->cond == NULL)
+    return 1;
+
+  result = eval_agent_expr (bp->cond, &value);
+  if (result != expr_eval_no_error)
+    {
+      /* Let GDB decide.  */
+      if (debug_threads)
+	fprintf (stderr, "Condition at 0x%lx failed: %s.\n",
+		 (long) bp->pc, expr_eval_result_string (result));
+      return 1;
+    }
+
+  return value != 0;
+}
+/* APPLE LOCAL end target-side breakpoint conditions  */
+
 int
 check_breakpoints (CORE_ADDR stop_pc)
 {
   struct breakpoint *bp;
+  /* APPLE LOCAL target-side breakpoint conditions  */
+  int report;
 
   bp = find_breakpoint_at (stop_pc);
   if (bp == NULL)
@@ -198,8 +381,18 @@ check_breakpoints (CORE_ADDR stop_pc)
       return 0;
     }
 
-  (*bp->handler) (bp->pc);
-  return 1;
+  /* APPLE LOCAL begin target-side breakpoint conditions  */
+  /* Work out whether GDB wants this hit before running our own handler,
+     which may delete BP.  */
+  report = bp->gdb_owned && gdb_breakpoint_condition_true (bp);
+
+  if (bp->handler != NULL)
+    (*bp->handler) (bp->pc);
+
+  /* If GDB wants to see this hit, treat it as an ordinary SIGTRAP;
+     otherwise step over the breakpoint and carry on.  */
+  return !report;
+  /* APPLE LOCAL end target-side breakpoint conditions  */
 }
 
 void
@@ -47,10 +47,51 @@ void reinsert_breakpoint (CORE_ADDR where);
 void uninsert_breakpoint (CORE_ADDR where);
 
 /* See if any breakpoint claims ownership of STOP_PC.  Call the handler for
-   the breakpoint, if found.  */
+   the breakpoint, if found.  Return non-zero if the hit should be
+   stepped over silently, or zero if it should be reported to GDB.  */
 
 int check_breakpoints (CORE_ADDR stop_pc);
 
+/* APPLE LOCAL begin target-side breakpoint conditions  */
+struct agent_expr;
+
+/* Insert a breakpoint at WHERE on GDB's behalf.  If COND is non-NULL,
+   hits where it evaluates to zero are stepped over without being
+   reported; the breakpoint takes ownership of COND.  Return 0 on
+   success, 1 if breakpoints aren't supported, or -1 on error.  */
+
+int set_gdb_breakpoint_at (CORE_ADDR where, struct agent_expr *cond);
+
+/* Remove the breakpoint GDB inserted at WHERE.  Return values are as
+   for set_gdb_breakpoint_at.  */
+
+int delete_gdb_breakpoint_at (CORE_ADDR where);
+
+/* Return non-zero if GDB has a breakpoint inserted at WHERE.  */
+
+int gdb_breakpoint_here (CORE_ADDR where);
+
+/* Return non-zero if a hit of the breakpoint at WHERE may be handled
+   without telling GDB: the breakpoint has a handler of our own, or a
+   condition.  */
+
+int silent_breakpoint_here (CORE_ADDR where);
+/* APPLE LOCAL end target-side breakpoint conditions  */
+
+/* APPLE LOCAL begin gdbserver tracepoints  */
+/* Arrange for HANDLER to be called when the breakpoint at WHERE is
+   hit, inserting one there unless GDB already has.  Return 0 on
+   success, or 1 if breakpoints aren't supported.  */
+
+int set_breakpoint_handler_at (CORE_ADDR where,
+			       void (*handler) (CORE_ADDR));
+
+/* Undo set_breakpoint_handler_at.  The breakpoint stays in place if
+   GDB still wants it.  */
+
+void clear_breakpoint_handler_at (CORE_ADDR where);
+/* APPLE LOCAL end gdbserver tracepoints  */
+
 /* See if any breakpoints shadow the target memory area from MEM_ADDR
    to MEM_ADDR + MEM_LEN.  Update the data already read from the target
    (in BUF) if necessary.  */
@@ -200,6 +200,14 @@ register_size (int n)
   return reg_defs[n].size / 8;
 }
 
+/* APPLE LOCAL begin target-side breakpoint conditions  */
+int
+register_count (void)
+{
+  return num_registers;
+}
+/* APPLE LOCAL end target-side breakpoint conditions  */
+
 static unsigned char *
 register_data (int n, int fetch)
 {
@@ -227,6 +235,15 @@ collect_register (int n, void *buf)
   memcpy (buf, register_data (n, 1), register_size (n));
 }
 
+/* APPLE LOCAL begin gdbserver tracepoints  */
+void
+collect_registers (void *buf)
+{
+  memcpy (buf, get_regcache (current_inferior, 1)->registers,
+	  register_bytes);
+}
+/* APPLE LOCAL end gdbserver tracepoints  */
+
 void
 collect_register_as_string (int n, char *buf)
 {
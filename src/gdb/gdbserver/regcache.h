@@ -55,6 +55,12 @@ struct reg *find_register_by_number (int n);
 
 int register_size (int n);
 
+/* APPLE LOCAL begin target-side breakpoint conditions  */
+/* Return the number of registers in the current register set.  */
+
+int register_count (void);
+/* APPLE LOCAL end target-side breakpoint conditions  */
+
 int find_regno (const char *name);
 
 extern const char **gdbserver_expedite_regs;
@@ -69,4 +75,11 @@ void collect_register_as_string (int n, char *buf);
 
 void collect_register_by_name (const char *name, void *buf);
 
+/* APPLE LOCAL begin gdbserver tracepoints  */
+/* Copy the whole register cache, in 'g' packet order, to BUF, which
+   must have room for registers_length () / 2 bytes.  */
+
+void collect_registers (void *buf);
+/* APPLE LOCAL end gdbserver tracepoints  */
+
 #endif /* REGCACHE_H */
@@ -53,6 +53,12 @@ struct sym_cache
 static struct sym_cache *symbol_cache;
 
 int remote_debug = 0;
+/* APPLE LOCAL begin no-ack mode  */
+/* Set once GDB has asked for QStartNoAckMode.  From then on neither
+   side sends or waits for '+'/'-' acknowledgements, which only make
+   sense on lossy links.  */
+int noack_mode = 0;
+/* APPLE LOCAL end no-ack mode  */
 struct ui_file *gdb_stdlog;
 
 static int remote_desc;
@@ -69,6 +75,9 @@ remote_open (char *name)
 {
   int save_fcntl_flags;
   
+  /* APPLE LOCAL no-ack mode  */
+  noack_mode = 0;
+
   if (!strchr (name, ':'))
     {
       remote_desc = open (name, O_RDWR);
@@ -284,20 +293,71 @@ hexify (char *hex, const char *bin, int count)
   return i;
 }
 
+/* APPLE LOCAL begin binary memory read  */
+/* Copy LEN bytes of BUFFER into OUT_BUF, escaping the characters
+   that can't appear raw in a packet body ('$', '#', '}' and the
+   run-length marker '*') as '}' followed by the character XORed with
+   0x20.  Stop before OUT_BUF would exceed OUT_MAXLEN chars.  Store the
+   number of chars written in *OUT_LEN and return the number of bytes
+   of BUFFER consumed.  */
+
+int
+remote_escape_output (const unsigned char *buffer, int len,
+		      unsigned char *out_buf, int *out_len,
+		      int out_maxlen)
+{
+  int input_index, output_index;
+
+  output_index = 0;
+  for (input_index = 0; input_index < len; input_index++)
+    {
+      unsigned char b = buffer[input_index];
+
+      if (b == '$' || b == '#' || b == '}' || b == '*')
+	{
+	  if (output_index + 2 > out_maxlen)
+	    break;
+	  out_buf[output_index++] = '}';
+	  out_buf[output_index++] = b ^ 0x20;
+	}
+      else
+	{
+	  if (output_index + 1 > out_maxlen)
+	    break;
+	  out_buf[output_index++] = b;
+	}
+    }
+
+  *out_len = output_index;
+  return input_index;
+}
+/* APPLE LOCAL end binary memory read  */
+
 /* Send a packet to the remote machine, with error checking.
    The data of the packet is in BUF.  Returns >= 0 on success, -1 otherwise. */
 
 int
 putpkt (char *buf)
 {
+  /* APPLE LOCAL binary memory read  */
+  return putpkt_binary (buf, strlen (buf));
+}
+
+/* APPLE LOCAL begin binary memory read  */
+/* Like putpkt, but send CNT chars of BUF, which may contain NULs.  */
+
+int
+putpkt_binary (char *buf, int cnt)
+{
+  /* APPLE LOCAL end binary memory read  */
   int i;
   unsigned char csum = 0;
   char *buf2;
   char buf3[1];
-  int cnt = strlen (buf);
   char *p;
 
-  buf2 = malloc (PBUFSIZ);
+  /* APPLE LOCAL binary memory read  */
+  buf2 = malloc (cnt + 5);
 
   /* Copy the packet into buffer BUF2, encapsulating it
      and giving it a checksum.  */
@@ -331,6 +391,9 @@ putpkt (char *buf)
 #if defined (NO_ACKS)
       break;
 #endif
+      /* APPLE LOCAL no-ack mode  */
+      if (noack_mode)
+	break;
 
       if (remote_debug)
 	{
@@ -527,6 +590,17 @@ getpkt (char *buf)
       if (csum == (c1 << 4) + c2)
 	break;
 
+      /* APPLE LOCAL begin no-ack mode  */
+      /* Without acks there's no way to ask for the packet again, so
+	 take it as it is.  */
+      if (noack_mode)
+	{
+	  fprintf (stderr, "Bad checksum, sentsum=0x%x, csum=0x%x, buf=%s\n",
+		   (c1 << 4) + c2, csum, buf);
+	  break;
+	}
+      /* APPLE LOCAL end no-ack mode  */
+
       fprintf (stderr, "Bad checksum, sentsum=0x%x, csum=0x%x, buf=%s\n",
 	       (c1 << 4) + c2, csum, buf);
       write (remote_desc, "-", 1);
@@ -539,12 +613,16 @@ getpkt (char *buf)
     }
 
 #if !defined (NO_ACKS)
-  write (remote_desc, "+", 1);
-
-  if (remote_debug)
+  /* APPLE LOCAL no-ack mode  */
+  if (!noack_mode)
     {
-      fprintf (stderr, "[sent ack]\n");
-      fflush (stderr);
+      write (remote_desc, "+", 1);
+
+      if (remote_debug)
+	{
+	  fprintf (stderr, "[sent ack]\n");
+	  fflush (stderr);
+	}
     }
 #endif
 
@@ -615,43 +693,172 @@ outreg (int regno, char *buf)
   return buf;
 }
 
+/* APPLE LOCAL begin incremental thread list  */
+/* Threads created and exited, so that GDB can keep its copy of the
+   thread list up to date without listing every thread again.
+   THREAD_GENERATION counts the changes; change number N is kept in
+   THREAD_CHANGES[N % THREAD_CHANGE_LOG_SIZE] until it is overwritten.
+   REPORTED_THREAD_GENERATION is the generation the last stop reply
+   brought GDB up to.  */
+
+#define THREAD_CHANGE_LOG_SIZE 1024
+
+struct thread_change
+{
+  unsigned int gdb_id;
+  int created;
+};
+
+static struct thread_change thread_changes[THREAD_CHANGE_LOG_SIZE];
+static unsigned long thread_generation;
+static unsigned long reported_thread_generation;
+
+static void
+note_thread_change (unsigned int gdb_id, int created)
+{
+  struct thread_change *change
+    = &thread_changes[thread_generation % THREAD_CHANGE_LOG_SIZE];
+
+  change->gdb_id = gdb_id;
+  change->created = created;
+  thread_generation++;
+}
+
 void
-new_thread_notify (int id)
+new_thread_notify (unsigned int gdb_id)
 {
-  char own_buf[256];
+  note_thread_change (gdb_id, 1);
+}
 
-  /* The `n' response is not yet part of the remote protocol.  Do nothing.  */
-  if (1)
-    return;
+void
+dead_thread_notify (unsigned int gdb_id)
+{
+  note_thread_change (gdb_id, 0);
+}
 
-  if (server_waiting == 0)
-    return;
+/* Write the changes to the thread list after generation GEN to BUF,
+   as a comma separated list of '+' or '-' followed by the thread's
+   id, using at most LEN characters.  Return a pointer past the list,
+   or NULL if the changes are no longer all known, or don't fit.  */
 
-  sprintf (own_buf, "n%x", id);
-  disable_async_io ();
-  putpkt (own_buf);
-  enable_async_io ();
+static char *
+write_thread_changes (unsigned long gen, char *buf, int len)
+{
+  char *end = buf + len;
+  unsigned long n;
+
+  if (gen > thread_generation
+      || thread_generation - gen > THREAD_CHANGE_LOG_SIZE)
+    return NULL;
+
+  for (n = gen; n < thread_generation; n++)
+    {
+      struct thread_change *change
+	= &thread_changes[n % THREAD_CHANGE_LOG_SIZE];
+
+      /* A sign, eight digits and a comma.  */
+      if (end - buf < 11)
+	return NULL;
+      if (n > gen)
+	*buf++ = ',';
+      buf += sprintf (buf, "%c%x", change->created ? '+' : '-',
+		      change->gdb_id);
+    }
+
+  return buf;
 }
 
+/* Reply to 'qThreadChanges:GEN' with the current generation and the
+   changes since GEN, as "GEN[:CHANGES]", or an error if we no longer
+   have them all.  */
+
 void
-dead_thread_notify (int id)
+handle_thread_changes (char *own_buf)
 {
-  char own_buf[256];
+  unsigned long gen;
+  char *p = own_buf + strlen ("qThreadChanges:");
+  char *end;
+
+  gen = strtoul (p, &end, 16);
+  if (end == p || *end != '\0')
+    {
+      write_enn (own_buf);
+      return;
+    }
 
-  /* The `x' response is not yet part of the remote protocol.  Do nothing.  */
-  if (1)
+  p = own_buf + sprintf (own_buf, "%lx", thread_generation);
+  if (gen == thread_generation)
     return;
 
-  sprintf (own_buf, "x%x", id);
-  disable_async_io ();
-  putpkt (own_buf);
-  enable_async_io ();
+  *p++ = ':';
+  p = write_thread_changes (gen, p, PBUFSIZ - 1 - (p - own_buf));
+  if (p == NULL)
+    write_enn (own_buf);
+  else
+    *p = '\0';
 }
+/* APPLE LOCAL end incremental thread list  */
+
+/* APPLE LOCAL begin register batching  */
+/* The registers GDB asked for with QExpediteRegisters.  Stop replies
+   carry them after the target's GDBSERVER_EXPEDITE_REGS.  */
+static int *expedite_regnos;
+static int expedite_count;
+
+int
+set_expedite_registers (const char *list)
+{
+  int *regnos;
+  int count = 0, max = 1;
+  const char *p;
+
+  for (p = list; *p != '\0'; p++)
+    if (*p == ',')
+      max++;
+  regnos = malloc (max * sizeof (int));
+
+  p = list;
+  while (*p != '\0')
+    {
+      char *end;
+      unsigned long regno = strtoul (p, &end, 16);
+
+      if (end == p || regno >= (unsigned long) register_count ()
+	  || (*end != ',' && *end != '\0'))
+	{
+	  free (regnos);
+	  return -1;
+	}
+      regnos[count++] = regno;
+      p = *end == ',' ? end + 1 : end;
+    }
+
+  free (expedite_regnos);
+  expedite_regnos = regnos;
+  expedite_count = count;
+  return 0;
+}
+
+/* Return non-zero if REGNO is one of GDBSERVER_EXPEDITE_REGS.  */
+
+static int
+expedited_by_default (int regno)
+{
+  const char **regp;
+
+  for (regp = gdbserver_expedite_regs; *regp; regp++)
+    if (find_regno (*regp) == regno)
+      return 1;
+  return 0;
+}
+/* APPLE LOCAL end register batching  */
 
 void
 prepare_resume_reply (char *buf, char status, unsigned char signo)
 {
   int nib, sig;
+  /* APPLE LOCAL register batching  */
+  char *start = buf;
 
   *buf++ = status;
 
@@ -693,6 +900,34 @@ prepare_resume_reply (char *buf, char status, unsigned char signo)
 	  regp ++;
 	}
 
+      /* APPLE LOCAL begin register batching  */
+      /* Send what GDB asked for as long as it fits, leaving room for
+	 the thread, its generation, and at least a quarter of the
+	 packet for the changes to the thread list.  */
+      {
+	int reserve = 1;
+	int i;
+
+	if (using_threads)
+	  reserve += (strlen ("thread:;threadgen:;threadchanges:;")
+		      + 8 + 2 * sizeof (unsigned long) + PBUFSIZ / 4);
+
+	for (i = 0; i < expedite_count; i++)
+	  {
+	    int regno = expedite_regnos[i];
+
+	    if (expedited_by_default (regno))
+	      continue;
+	    /* Up to four digits of register number, ':', ';' and the
+	       terminating NUL outreg writes.  */
+	    if (buf - start + 2 * register_size (regno) + 7
+		> PBUFSIZ - reserve)
+	      break;
+	    buf = outreg (regno, buf);
+	  }
+      }
+      /* APPLE LOCAL end register batching  */
+
       /* Formerly, if the debugger had not used any thread features we would not
 	 burden it with a thread status response.  This was for the benefit of
 	 GDB 4.13 and older.  However, in recent GDB versions the check
@@ -720,6 +955,30 @@ prepare_resume_reply (char *buf, char status, unsigned char signo)
 	      buf += strlen (buf);
 	      old_thread_from_wait = thread_from_wait;
 	    }
+
+	  /* APPLE LOCAL begin incremental thread list  */
+	  /* Tell GDB how the thread list changed since the last stop,
+	     if that fits in what is left of the packet; otherwise just
+	     the generation, and GDB will ask.  */
+	  sprintf (buf, "threadgen:%lx;", thread_generation);
+	  buf += strlen (buf);
+	  if (thread_generation != reported_thread_generation)
+	    {
+	      char *changes = buf + strlen ("threadchanges:");
+	      char *end = write_thread_changes (reported_thread_generation,
+						changes,
+						PBUFSIZ - 1 - (buf - start)
+						- strlen ("threadchanges:;"));
+
+	      if (end != NULL)
+		{
+		  memcpy (buf, "threadchanges:", strlen ("threadchanges:"));
+		  *end++ = ';';
+		  buf = end;
+		}
+	    }
+	  reported_thread_generation = thread_generation;
+	  /* APPLE LOCAL end incremental thread list  */
 	}
     }
   /* For W and X, we're done.  */
@@ -116,6 +116,59 @@ attach_inferior (int pid, char *statusptr, int *sigptr)
 
 extern int remote_debug;
 
+/* APPLE LOCAL begin register batching  */
+/* Write register REGNO's value in hex to BUF, from the selected trace
+   frame if there is one.  Return a pointer past the value.  */
+
+static char *
+gdb_register_to_string (int regno, char *buf)
+{
+  if (current_traceframe >= 0)
+    traceframe_register_to_string (regno, buf);
+  else
+    collect_register_as_string (regno, buf);
+  return buf + 2 * register_size (regno);
+}
+
+/* Reply to 'qReadRegisters:N,N,...' with the value of each register
+   in the list, separated by ';'.  */
+
+static void
+handle_read_registers (char *own_buf)
+{
+  char *p = own_buf + strlen ("qReadRegisters:");
+  char *reply, *out;
+
+  /* The values can be longer than the request, so build the reply
+     separately.  */
+  reply = malloc (PBUFSIZ);
+  out = reply;
+  set_desired_inferior (1);
+  while (*p != '\0')
+    {
+      char *end;
+      unsigned long regno = strtoul (p, &end, 16);
+
+      if (end == p || regno >= (unsigned long) register_count ()
+	  || (*end != ',' && *end != '\0')
+	  || out - reply + 2 * register_size (regno) + 2 > PBUFSIZ - 1)
+	{
+	  free (reply);
+	  write_enn (own_buf);
+	  return;
+	}
+      if (out != reply)
+	*out++ = ';';
+      out = gdb_register_to_string (regno, out);
+      p = *end == ',' ? end + 1 : end;
+    }
+  *out = '\0';
+
+  strcpy (own_buf, reply);
+  free (reply);
+}
+/* APPLE LOCAL end register batching  */
+
 /* Handle all of the extended 'q' packets.  */
 void
 handle_query (char *own_buf)
@@ -154,6 +207,38 @@ handle_query (char *own_buf)
 	}
     }
 
+  /* APPLE LOCAL begin binary memory read  */
+  /* Tell GDB how big a packet we can take, and that we understand
+     the binary 'x' memory read.  */
+  if (strcmp ("qSupported", own_buf) == 0
+      || strncmp ("qSupported:", own_buf, 11) == 0)
+    {
+      /* APPLE LOCAL begin target-side breakpoint conditions  */
+      /* APPLE LOCAL register batching  */
+      sprintf (own_buf, "PacketSize=%x;binary-upload+;QStartNoAckMode+"
+	       ";ConditionalBreakpoints+;qReadRegisters+;QExpediteRegisters+",
+	       PBUFSIZ - 1);
+      /* APPLE LOCAL end target-side breakpoint conditions  */
+      return;
+    }
+  /* APPLE LOCAL end binary memory read  */
+
+  /* APPLE LOCAL begin incremental thread list  */
+  if (strncmp ("qThreadChanges:", own_buf, strlen ("qThreadChanges:")) == 0)
+    {
+      handle_thread_changes (own_buf);
+      return;
+    }
+  /* APPLE LOCAL end incremental thread list  */
+
+  /* APPLE LOCAL begin register batching  */
+  if (strncmp ("qReadRegisters:", own_buf, strlen ("qReadRegisters:")) == 0)
+    {
+      handle_read_registers (own_buf);
+      return;
+    }
+  /* APPLE LOCAL end register batching  */
+
   if (the_target->read_auxv != NULL
       && strncmp ("qPart:auxv:read::", own_buf, 17) == 0)
     {
@@ -174,11 +259,30 @@ handle_query (char *own_buf)
       return;
     }
 
+  /* APPLE LOCAL begin gdbserver tracepoints  */
+  if (handle_tracepoint_query (own_buf))
+    return;
+  /* APPLE LOCAL end gdbserver tracepoints  */
+
   /* Otherwise we didn't know what packet it was.  Say we didn't
      understand it.  */
   own_buf[0] = 0;
 }
 
+/* APPLE LOCAL begin gdbserver tracepoints  */
+/* Read memory for GDB's 'm' and 'x' packets: from the selected trace
+   frame if there is one, otherwise from the inferior.  */
+
+static int
+gdb_read_memory (CORE_ADDR memaddr, unsigned char *myaddr, int len)
+{
+  if (current_traceframe >= 0)
+    return traceframe_read_memory (memaddr, myaddr, len);
+
+  return read_inferior_memory (memaddr, myaddr, len);
+}
+/* APPLE LOCAL end gdbserver tracepoints  */
+
 /* Parse vCont packets.  */
 void
 handle_v_cont (char *own_buf, char *status, int *signal)
@@ -353,7 +457,12 @@ int
 main (int argc, char *argv[])
 {
   char ch, status, *own_buf;
-  unsigned char mem_buf[2000];
+  /* APPLE LOCAL begin binary memory read  */
+  unsigned char *mem_buf;
+  int own_len;
+  /* APPLE LOCAL end binary memory read  */
+  /* APPLE LOCAL no-ack mode  */
+  int start_noack;
   int i = 0;
   int signal;
   unsigned int len;
@@ -406,6 +515,8 @@ main (int argc, char *argv[])
   initialize_low ();
 
   own_buf = malloc (PBUFSIZ);
+  /* APPLE LOCAL binary memory read  */
+  mem_buf = malloc (PBUFSIZ);
 
   if (pid == 0)
     {
@@ -445,11 +556,43 @@ main (int argc, char *argv[])
 	  unsigned char sig;
 	  i = 0;
 	  ch = own_buf[i++];
+	  /* APPLE LOCAL binary memory read  */
+	  own_len = -1;
+	  /* APPLE LOCAL no-ack mode  */
+	  start_noack = 0;
 	  switch (ch)
 	    {
 	    case 'q':
 	      handle_query (own_buf);
 	      break;
+	    /* APPLE LOCAL begin no-ack mode  */
+	    case 'Q':
+	      if (strcmp ("QStartNoAckMode", own_buf) == 0)
+		{
+		  /* The OK itself is still acknowledged; acks stop
+		     once it has been sent.  */
+		  write_ok (own_buf);
+		  start_noack = 1;
+		}
+	      /* APPLE LOCAL begin register batching  */
+	      else if (strncmp ("QExpediteRegisters:", own_buf,
+				strlen ("QExpediteRegisters:")) == 0)
+		{
+		  if (set_expedite_registers
+		      (own_buf + strlen ("QExpediteRegisters:")) == 0)
+		    write_ok (own_buf);
+		  else
+		    write_enn (own_buf);
+		}
+	      /* APPLE LOCAL end register batching  */
+	      /* APPLE LOCAL begin gdbserver tracepoints  */
+	      else if (handle_tracepoint_general_set (own_buf))
+		;
+	      /* APPLE LOCAL end gdbserver tracepoints  */
+	      else
+		own_buf[0] = '\0';
+	      break;
+	    /* APPLE LOCAL end no-ack mode  */
 	    case 'd':
 	      /* APPLE LOCAL: Handle all the debug flags here. */
 	      {
@@ -540,21 +683,85 @@ main (int argc, char *argv[])
 	      break;
 	    case 'g':
 	      set_desired_inferior (1);
-	      registers_to_string (own_buf);
+	      /* APPLE LOCAL begin gdbserver tracepoints  */
+	      if (current_traceframe >= 0)
+		traceframe_registers_to_string (own_buf);
+	      else
+		registers_to_string (own_buf);
+	      /* APPLE LOCAL end gdbserver tracepoints  */
 	      break;
 	    case 'G':
+	      /* APPLE LOCAL begin gdbserver tracepoints  */
+	      /* Trace frames are read-only.  */
+	      if (current_traceframe >= 0)
+		{
+		  write_enn (own_buf);
+		  break;
+		}
+	      /* APPLE LOCAL end gdbserver tracepoints  */
 	      set_desired_inferior (1);
 	      registers_from_string (&own_buf[1]);
 	      write_ok (own_buf);
 	      break;
+	    /* APPLE LOCAL begin register batching  */
+	    case 'p':
+	      {
+		char *end;
+		unsigned long regno = strtoul (&own_buf[1], &end, 16);
+
+		if (end == &own_buf[1] || *end != '\0'
+		    || regno >= (unsigned long) register_count ())
+		  {
+		    write_enn (own_buf);
+		    break;
+		  }
+		set_desired_inferior (1);
+		gdb_register_to_string (regno, own_buf);
+	      }
+	      break;
+	    /* APPLE LOCAL end register batching  */
 	    case 'm':
 	      decode_m_packet (&own_buf[1], &mem_addr, &len);
-	      if (read_inferior_memory (mem_addr, mem_buf, len) == 0)
+	      /* APPLE LOCAL begin binary memory read  */
+	      if (len > (PBUFSIZ - 1) / 2)
+		len = (PBUFSIZ - 1) / 2;
+	      /* APPLE LOCAL end binary memory read  */
+	      /* APPLE LOCAL gdbserver tracepoints  */
+	      if (gdb_read_memory (mem_addr, mem_buf, len) == 0)
 		convert_int_to_ascii (mem_buf, own_buf, len);
 	      else
 		write_enn (own_buf);
 	      break;
+	    /* APPLE LOCAL begin binary memory read  */
+	    case 'x':
+	      /* Like 'm', but reply with 'b' followed by the escaped
+		 binary contents.  If escapes make the data too long for
+		 one packet, send as much as fits; GDB asks again for
+		 the rest.  */
+	      decode_m_packet (&own_buf[1], &mem_addr, &len);
+	      if (len > PBUFSIZ - 2)
+		len = PBUFSIZ - 2;
+	      /* APPLE LOCAL gdbserver tracepoints  */
+	      if (gdb_read_memory (mem_addr, mem_buf, len) == 0)
+		{
+		  own_buf[0] = 'b';
+		  remote_escape_output (mem_buf, len,
+					(unsigned char *) own_buf + 1,
+					&own_len, PBUFSIZ - 2);
+		  own_len++;
+		}
+	      else
+		write_enn (own_buf);
+	      break;
+	    /* APPLE LOCAL end binary memory read  */
 	    case 'M':
+	      /* APPLE LOCAL begin gdbserver tracepoints  */
+	      if (current_traceframe >= 0)
+		{
+		  write_enn (own_buf);
+		  break;
+		}
+	      /* APPLE LOCAL end gdbserver tracepoints  */
 	      decode_M_packet (&own_buf[1], &mem_addr, &len, mem_buf);
 	      if (write_inferior_memory (mem_addr, mem_buf, len) == 0)
 		write_ok (own_buf);
@@ -603,6 +810,40 @@ main (int argc, char *argv[])
 		int len = strtol (lenptr + 1, &dataptr, 16);
 		char type = own_buf[1];
 
+		/* APPLE LOCAL begin target-side breakpoint conditions  */
+		if (type == '0')
+		  {
+		    struct agent_expr *cond = NULL;
+		    int res;
+
+		    /* An optional condition follows the breakpoint kind,
+		       as ";X<len>,<bytecodes>".  */
+		    if (strncmp (dataptr, ";X", 2) == 0)
+		      {
+			dataptr += 2;
+			cond = parse_agent_expr (&dataptr);
+			if (cond == NULL)
+			  {
+			    write_enn (own_buf);
+			    break;
+			  }
+		      }
+
+		    res = set_gdb_breakpoint_at (addr, cond);
+		    if (res == 0)
+		      write_ok (own_buf);
+		    else
+		      {
+			free_agent_expr (cond);
+			if (res == 1)
+			  own_buf[0] = '\0';
+			else
+			  write_enn (own_buf);
+		      }
+		    break;
+		  }
+		/* APPLE LOCAL end target-side breakpoint conditions  */
+
 		if (the_target->insert_watchpoint == NULL
 		    || (type < '2' || type > '4'))
 		  {
@@ -633,6 +874,21 @@ main (int argc, char *argv[])
 		int len = strtol (lenptr + 1, &dataptr, 16);
 		char type = own_buf[1];
 
+		/* APPLE LOCAL begin target-side breakpoint conditions  */
+		if (type == '0')
+		  {
+		    int res = delete_gdb_breakpoint_at (addr);
+
+		    if (res == 0)
+		      write_ok (own_buf);
+		    else if (res == 1)
+		      own_buf[0] = '\0';
+		    else
+		      write_enn (own_buf);
+		    break;
+		  }
+		/* APPLE LOCAL end target-side breakpoint conditions  */
+
 		if (the_target->remove_watchpoint == NULL
 		    || (type < '2' || type > '4'))
 		  {
@@ -728,7 +984,15 @@ main (int argc, char *argv[])
 	      break;
 	    }
 
-	  putpkt (own_buf);
+	  /* APPLE LOCAL begin binary memory read  */
+	  if (own_len >= 0)
+	    putpkt_binary (own_buf, own_len);
+	  else
+	    putpkt (own_buf);
+	  /* APPLE LOCAL end binary memory read  */
+	  /* APPLE LOCAL no-ack mode  */
+	  if (start_noack)
+	    noack_mode = 1;
 
 	  if (status == 'W')
 	    fprintf (stderr,
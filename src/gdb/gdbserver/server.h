@@ -60,6 +60,12 @@ extern char *strerror (int);	/* X3.159-1989  4.11.6.2 */
    least the size of a (void *).  */
 typedef long long CORE_ADDR;
 
+/* APPLE LOCAL begin target-side breakpoint conditions  */
+/* The widest integer types we compute with, as in GDB proper.  */
+typedef long long LONGEST;
+typedef unsigned long long ULONGEST;
+/* APPLE LOCAL end target-side breakpoint conditions  */
+
 /* Generic information for tracking a list of ``inferiors'' - threads,
    processes, etc.  */
 struct inferior_list
@@ -81,6 +87,10 @@ struct thread_info;
 
 #include "target.h"
 #include "mem-break.h"
+/* APPLE LOCAL target-side breakpoint conditions  */
+#include "ax.h"
+/* APPLE LOCAL gdbserver tracepoints  */
+#include "tracepoint.h"
 
 /* Target-specific functions */
 
@@ -132,9 +142,14 @@ extern int server_waiting;
 
 extern jmp_buf toplevel;
 
+/* APPLE LOCAL no-ack mode  */
+extern int noack_mode;
+
 /* Functions from remote-utils.c */
 
 int putpkt (char *buf);
+/* APPLE LOCAL binary memory read  */
+int putpkt_binary (char *buf, int cnt);
 int getpkt (char *buf);
 void remote_open (char *name);
 void remote_close (void);
@@ -146,9 +161,18 @@ void unblock_async_io (void);
 void block_async_io (void);
 void convert_ascii_to_int (char *from, unsigned char *to, int n);
 void convert_int_to_ascii (unsigned char *from, char *to, int n);
-void new_thread_notify (int id);
-void dead_thread_notify (int id);
+/* APPLE LOCAL begin incremental thread list  */
+/* Record that the thread GDB knows as GDB_ID was created or exited.  */
+void new_thread_notify (unsigned int gdb_id);
+void dead_thread_notify (unsigned int gdb_id);
+void handle_thread_changes (char *own_buf);
+/* APPLE LOCAL end incremental thread list  */
 void prepare_resume_reply (char *buf, char status, unsigned char sig);
+/* APPLE LOCAL begin register batching  */
+/* Set the registers to add to stop replies from a QExpediteRegisters
+   list of hex register numbers.  Return -1 if the list is bad.  */
+int set_expedite_registers (const char *list);
+/* APPLE LOCAL end register batching  */
 
 void decode_m_packet (char *from, CORE_ADDR * mem_addr_ptr,
 		      unsigned int *len_ptr);
@@ -157,6 +181,10 @@ void decode_M_packet (char *from, CORE_ADDR * mem_addr_ptr,
 
 int unhexify (char *bin, const char *hex, int count);
 int hexify (char *hex, const char *bin, int count);
+/* APPLE LOCAL binary memory read  */
+int remote_escape_output (const unsigned char *buffer, int len,
+			  unsigned char *out_buf, int *out_len,
+			  int out_maxlen);
 
 int look_up_one_symbol (const char *name, CORE_ADDR *addrp);
 
@@ -183,8 +211,13 @@ void init_registers (void);
 
 /* Buffer sizes for transferring memory, registers, etc.  Round up PBUFSIZ to
    hold all the registers, at least.  */
-#define	PBUFSIZ ((registers_length () + 32 > 2000) \
+/* APPLE LOCAL begin binary memory read  */
+/* GDB learns this size from our qSupported reply, so it can be
+   generous; large memory reads are then limited by the link rather
+   than by the number of round trips.  */
+#define	PBUFSIZ ((registers_length () + 32 > 16384) \
 		 ? (registers_length () + 32) \
-		 : 2000)
+		 : 16384)
+/* APPLE LOCAL end binary memory read  */
 
 #endif /* SERVER_H */
@@ -268,8 +268,6 @@ maybe_attach_thread (const td_thrhandle_t *th_p, td_thrinfo_t *ti_p)
   process = inferior_target_data (inferior);
 
 found:
-  new_thread_notify (ti_p->ti_tid);
-
   process->tid = ti_p->ti_tid;
   process->lwpid = ti_p->ti_lid;
 
@@ -0,0 +1,966 @@
+/* Tracepoint support for the remote server for GDB.
+   Copyright 2006
+   Free Software Foundation, Inc.
+
+   This file is part of GDB.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 59 Temple Place - Suite 330,
+   Boston, MA 02111-1307, USA.  */
+
+#include "server.h"
+/* APPLE LOCAL register batching  */
+#include "regdef.h"
+
+#include <ctype.h>
+
+extern int debug_threads;
+
+/* The size of the trace buffer.  Once it fills up, tracing stops;
+   GDB sees that from qTStatus.  */
+#define TRACE_BUFFER_SIZE (1024 * 1024)
+
+/* One thing to collect when a tracepoint is hit.  */
+
+struct tracepoint_action
+{
+  struct tracepoint_action *next;
+
+  /* 'R' to collect the registers, 'M' for a memory range, or 'X' for
+     an agent expression; these are the letters GDB uses in QTDP.  */
+  char type;
+
+  /* For 'M', the range is LEN bytes at OFFSET from the value of
+     register BASEREG, or at address OFFSET if BASEREG is -1.  */
+  int basereg;
+  ULONGEST offset;
+  ULONGEST len;
+
+  /* For 'X', the expression whose trace bytecodes name the memory to
+     collect.  */
+  struct agent_expr *expr;
+};
+
+struct tracepoint
+{
+  struct tracepoint *next;
+
+  /* GDB's number for this tracepoint, and where it is.  */
+  int number;
+  CORE_ADDR address;
+
+  /* Zero if GDB sent this tracepoint disabled.  */
+  int enabled;
+
+  /* Stop tracing once this tracepoint has been hit this many times,
+     or never if zero.  */
+  ULONGEST pass_count;
+  ULONGEST hit_count;
+
+  /* What to collect when the tracepoint is hit.  */
+  struct tracepoint_action *actions;
+
+  /* Non-zero once GDB has started sending the actions for this
+     tracepoint's while-stepping list.  We don't single-step after a
+     hit, so those are parsed and thrown away.  */
+  int stepping_actions;
+};
+
+/* Each frame in the trace buffer starts with this header, followed
+   by DATA_SIZE bytes of blocks.  A register block is 'R' followed by
+   the whole register cache, in 'g' packet order.  A memory block is
+   'M', then a struct traceframe_mem, then the memory itself.  Frames
+   and blocks aren't aligned, so headers are always memcpy'd.  */
+
+struct traceframe
+{
+  int tpnum;
+  CORE_ADDR pc;
+  unsigned int data_size;
+};
+
+struct traceframe_mem
+{
+  CORE_ADDR addr;
+  unsigned int len;
+};
+
+/* A range of memory which GDB told us (with QTro) doesn't change, so
+   it can be read from the inferior when looking at a trace frame.  */
+
+struct readonly_region
+{
+  struct readonly_region *next;
+  CORE_ADDR start;
+  CORE_ADDR end;
+};
+
+static struct tracepoint *tracepoints;
+static struct readonly_region *readonly_regions;
+
+/* Non-zero while the trace experiment is running.  */
+static int tracing;
+
+/* Non-zero while the tracepoints' breakpoints are in the inferior.
+   They can outlive TRACING, when a pass count or a full buffer stops
+   the experiment from a breakpoint handler.  */
+static int tracepoints_inserted;
+
+static unsigned char *trace_buffer;
+static unsigned int trace_buffer_used;
+static int traceframe_count;
+
+/* Set when a frame didn't fit in the trace buffer.  */
+static int trace_buffer_full;
+
+int current_traceframe = -1;
+
+/* Parse a hex number at *PP into *RESULT, and advance *PP past it.
+   Return zero if there were no hex digits.  */
+
+static int
+unpack_varlen_hex (char **pp, ULONGEST *result)
+{
+  char *p = *pp;
+  ULONGEST val = 0;
+
+  while (isxdigit (*p))
+    {
+      int c = *p++;
+
+      val <<= 4;
+      if (c >= '0' && c <= '9')
+	val |= c - '0';
+      else if (c >= 'a' && c <= 'f')
+	val |= c - 'a' + 10;
+      else
+	val |= c - 'A' + 10;
+    }
+
+  if (p == *pp)
+    return 0;
+
+  *pp = p;
+  *result = val;
+  return 1;
+}
+
+static struct tracepoint *
+find_tracepoint (int number, CORE_ADDR address)
+{
+  struct tracepoint *tp;
+
+  for (tp = tracepoints; tp != NULL; tp = tp->next)
+    if (tp->number == number && tp->address == address)
+      return tp;
+
+  return NULL;
+}
+
+static void
+free_tracepoint_actions (struct tracepoint_action *action)
+{
+  while (action != NULL)
+    {
+      struct tracepoint_action *next = action->next;
+
+      free_agent_expr (action->expr);
+      free (action);
+      action = next;
+    }
+}
+
+static void
+remove_tracepoint_breakpoints (void)
+{
+  struct tracepoint *tp;
+
+  if (!tracepoints_inserted)
+    return;
+
+  /* Clearing the handler twice for tracepoints which share an address
+     is harmless.  */
+  for (tp = tracepoints; tp != NULL; tp = tp->next)
+    if (tp->enabled)
+      clear_breakpoint_handler_at (tp->address);
+
+  tracepoints_inserted = 0;
+}
+
+static void
+clear_tracepoints (void)
+{
+  remove_tracepoint_breakpoints ();
+  tracing = 0;
+
+  while (tracepoints != NULL)
+    {
+      struct tracepoint *next = tracepoints->next;
+
+      free_tracepoint_actions (tracepoints->actions);
+      free (tracepoints);
+      tracepoints = next;
+    }
+
+  while (readonly_regions != NULL)
+    {
+      struct readonly_region *next = readonly_regions->next;
+
+      free (readonly_regions);
+      readonly_regions = next;
+    }
+
+  trace_buffer_used = 0;
+  traceframe_count = 0;
+  trace_buffer_full = 0;
+  current_traceframe = -1;
+}
+
+/* Reserve SIZE bytes at the end of the trace buffer, for the frame
+   being collected.  Return NULL, and note that the buffer is full, if
+   there isn't room.  */
+
+static unsigned char *
+trace_buffer_reserve (ULONGEST size)
+{
+  unsigned char *p;
+
+  if (size > TRACE_BUFFER_SIZE - trace_buffer_used)
+    {
+      trace_buffer_full = 1;
+      return NULL;
+    }
+
+  p = trace_buffer + trace_buffer_used;
+  trace_buffer_used += size;
+  return p;
+}
+
+/* Add a register block to the frame being collected.  */
+
+static void
+record_registers (void)
+{
+  int size = registers_length () / 2;
+  unsigned char *p = trace_buffer_reserve (1 + size);
+
+  if (p == NULL)
+    return;
+
+  *p = 'R';
+  collect_registers (p + 1);
+}
+
+/* Add a memory block for the LEN bytes at ADDR to the frame being
+   collected.  Return non-zero if the memory couldn't be read, or the
+   buffer is full.  */
+
+static int
+record_memory (CORE_ADDR addr, ULONGEST len)
+{
+  struct traceframe_mem mem;
+  ULONGEST size = 1 + sizeof (mem) + len;
+  unsigned char *p;
+
+  if (len == 0)
+    return 0;
+
+  p = trace_buffer_reserve (size);
+  if (p == NULL)
+    return -1;
+
+  *p = 'M';
+  mem.addr = addr;
+  mem.len = len;
+  memcpy (p + 1, &mem, sizeof (mem));
+
+  if (read_inferior_memory (addr, p + 1 + sizeof (mem), len) != 0)
+    {
+      /* Leave out what we couldn't read; GDB will say it's
+	 unavailable.  */
+      trace_buffer_used -= size;
+      return -1;
+    }
+
+  return 0;
+}
+
+/* The agent_trace_fn for collection expressions.  */
+
+static int
+record_memory_for_expr (CORE_ADDR addr, ULONGEST len, void *data)
+{
+  return record_memory (addr, len);
+}
+
+/* Store the value of register REGNUM in *VALUE, for a memory range
+   given relative to a base register.  Return zero if the register
+   can't be used as an address.  */
+
+static int
+base_register_value (int regnum, ULONGEST *value)
+{
+  unsigned char buf[8];
+  unsigned int u32;
+
+  if (regnum < 0 || regnum >= register_count ())
+    return 0;
+
+  switch (register_size (regnum))
+    {
+    case 4:
+      collect_register (regnum, buf);
+      memcpy (&u32, buf, 4);
+      *value = u32;
+      return 1;
+    case 8:
+      collect_register (regnum, buf);
+      memcpy (value, buf, 8);
+      return 1;
+    default:
+      return 0;
+    }
+}
+
+/* Collect a trace frame for TP, which the current inferior has just
+   hit.  */
+
+static void
+collect_traceframe (struct tracepoint *tp)
+{
+  struct tracepoint_action *action;
+  struct traceframe frame;
+  unsigned int start = trace_buffer_used;
+  int have_registers = 0;
+
+  if (trace_buffer_reserve (sizeof (frame)) == NULL)
+    return;
+
+  for (action = tp->actions;
+       action != NULL && !trace_buffer_full;
+       action = action->next)
+    switch (action->type)
+      {
+      case 'R':
+	/* Every register is in the one block, so there's no need to
+	   collect them twice.  */
+	if (!have_registers)
+	  record_registers ();
+	have_registers = 1;
+	break;
+
+      case 'M':
+	{
+	  ULONGEST addr = action->offset;
+	  ULONGEST base;
+
+	  if (action->basereg != -1)
+	    {
+	      if (!base_register_value (action->basereg, &base))
+		break;
+	      addr += base;
+	    }
+	  record_memory ((CORE_ADDR) addr, action->len);
+	}
+	break;
+
+      case 'X':
+	{
+	  enum expr_eval_result result;
+
+	  result = eval_agent_expr_trace (action->expr, NULL,
+					  record_memory_for_expr, NULL);
+	  if (result != expr_eval_no_error && debug_threads)
+	    fprintf (stderr, "Collection at tracepoint %d failed: %s.\n",
+		     tp->number, expr_eval_result_string (result));
+	}
+	break;
+      }
+
+  if (trace_buffer_full)
+    {
+      /* Drop the partial frame.  */
+      trace_buffer_used = start;
+      return;
+    }
+
+  frame.tpnum = tp->number;
+  frame.pc = tp->address;
+  frame.data_size = trace_buffer_used - start - sizeof (frame);
+  memcpy (trace_buffer + start, &frame, sizeof (frame));
+  traceframe_count++;
+}
+
+/* The handler for the breakpoints at our tracepoints.  This runs with
+   the inferior stopped at STOP_PC, and it carries on as soon as we
+   return, so it must not wait for GDB.  */
+
+static void
+tracepoint_handler (CORE_ADDR stop_pc)
+{
+  struct tracepoint *tp;
+
+  for (tp = tracepoints; tp != NULL && tracing; tp = tp->next)
+    {
+      if (!tp->enabled || tp->address != stop_pc)
+	continue;
+
+      collect_traceframe (tp);
+      tp->hit_count++;
+
+      if (trace_buffer_full)
+	{
+	  if (debug_threads)
+	    fprintf (stderr, "Trace buffer full; stopping trace.\n");
+	  tracing = 0;
+	}
+      else if (tp->pass_count != 0 && tp->hit_count >= tp->pass_count)
+	{
+	  if (debug_threads)
+	    fprintf (stderr, "Tracepoint %d passed; stopping trace.\n",
+		     tp->number);
+	  tracing = 0;
+	}
+    }
+
+  /* The breakpoints can't be removed from inside their own handler;
+     they stay in place, doing nothing, until GDB next talks to us
+     about the trace.  */
+}
+
+/* Parse the actions in P for tracepoint TP, from a QTDP packet.
+   Return zero if they're malformed.  */
+
+static int
+parse_tracepoint_actions (struct tracepoint *tp, char *p)
+{
+  while (*p != '\0' && *p != '-')
+    {
+      struct tracepoint_action *action;
+      ULONGEST val;
+
+      if (*p == 'S')
+	{
+	  tp->stepping_actions = 1;
+	  p++;
+	  continue;
+	}
+
+      action = malloc (sizeof (struct tracepoint_action));
+      memset (action, 0, sizeof (struct tracepoint_action));
+      action->type = *p++;
+
+      switch (action->type)
+	{
+	case 'R':
+	  /* The mask says which registers GDB wants; we take them all
+	     in one go anyway.  */
+	  if (!unpack_varlen_hex (&p, &val))
+	    goto bad;
+	  break;
+
+	case 'M':
+	  if (!unpack_varlen_hex (&p, &val) || *p++ != ',')
+	    goto bad;
+	  action->basereg = (int) val;
+	  if (!unpack_varlen_hex (&p, &action->offset) || *p++ != ','
+	      || !unpack_varlen_hex (&p, &action->len))
+	    goto bad;
+	  break;
+
+	case 'X':
+	  action->expr = parse_agent_expr (&p);
+	  if (action->expr == NULL)
+	    goto bad;
+	  break;
+
+	default:
+	  goto bad;
+	}
+
+      if (tp->stepping_actions)
+	free_tracepoint_actions (action);
+      else
+	{
+	  action->next = tp->actions;
+	  tp->actions = action;
+	}
+      continue;
+
+    bad:
+      free_tracepoint_actions (action);
+      return 0;
+    }
+
+  return 1;
+}
+
+/* Handle "QTDP:<n>:<addr>:<E|D>:<step>:<pass>[-]", which defines a
+   tracepoint, and "QTDP:-<n>:<addr>:<actions>[-]", which adds actions
+   to one.  */
+
+static void
+cmd_qtdp (char *own_buf)
+{
+  char *p = own_buf + strlen ("QTDP:");
+  struct tracepoint *tp;
+  ULONGEST num, addr, step, pass;
+  int actions = 0;
+
+  if (*p == '-')
+    {
+      actions = 1;
+      p++;
+    }
+
+  if (!unpack_varlen_hex (&p, &num) || *p++ != ':'
+      || !unpack_varlen_hex (&p, &addr) || *p++ != ':')
+    {
+      write_enn (own_buf);
+      return;
+    }
+
+  if (actions)
+    {
+      tp = find_tracepoint ((int) num, (CORE_ADDR) addr);
+      if (tp == NULL || !parse_tracepoint_actions (tp, p))
+	write_enn (own_buf);
+      else
+	write_ok (own_buf);
+      return;
+    }
+
+  if ((*p != 'E' && *p != 'D') || p[1] != ':')
+    {
+      write_enn (own_buf);
+      return;
+    }
+  tp = malloc (sizeof (struct tracepoint));
+  memset (tp, 0, sizeof (struct tracepoint));
+  tp->number = (int) num;
+  tp->address = (CORE_ADDR) addr;
+  tp->enabled = (*p == 'E');
+  p += 2;
+
+  if (!unpack_varlen_hex (&p, &step) || *p++ != ':'
+      || !unpack_varlen_hex (&p, &pass))
+    {
+      free (tp);
+      write_enn (own_buf);
+      return;
+    }
+  tp->pass_count = pass;
+
+  tp->next = tracepoints;
+  tracepoints = tp;
+  write_ok (own_buf);
+}
+
+/* Handle "QTro:<start>,<end>[:<start>,<end>]...".  */
+
+static void
+cmd_qtro (char *own_buf)
+{
+  char *p = own_buf + strlen ("QTro");
+
+  while (readonly_regions != NULL)
+    {
+      struct readonly_region *next = readonly_regions->next;
+
+      free (readonly_regions);
+      readonly_regions = next;
+    }
+
+  while (*p == ':')
+    {
+      struct readonly_region *r;
+      ULONGEST start, end;
+
+      p++;
+      if (!unpack_varlen_hex (&p, &start) || *p++ != ','
+	  || !unpack_varlen_hex (&p, &end))
+	{
+	  write_enn (own_buf);
+	  return;
+	}
+
+      r = malloc (sizeof (struct readonly_region));
+      r->start = (CORE_ADDR) start;
+      r->end = (CORE_ADDR) end;
+      r->next = readonly_regions;
+      readonly_regions = r;
+    }
+
+  write_ok (own_buf);
+}
+
+static void
+cmd_qtstart (char *own_buf)
+{
+  struct tracepoint *tp;
+
+  remove_tracepoint_breakpoints ();
+
+  if (trace_buffer == NULL)
+    {
+      trace_buffer = malloc (TRACE_BUFFER_SIZE);
+      if (trace_buffer == NULL)
+	{
+	  write_enn (own_buf);
+	  return;
+	}
+    }
+
+  trace_buffer_used = 0;
+  traceframe_count = 0;
+  trace_buffer_full = 0;
+  current_traceframe = -1;
+
+  for (tp = tracepoints; tp != NULL; tp = tp->next)
+    {
+      tp->hit_count = 0;
+      /* This can only fail for the first one, if the target has no
+	 breakpoints at all.  */
+      if (tp->enabled
+	  && set_breakpoint_handler_at (tp->address, tracepoint_handler) != 0)
+	{
+	  write_enn (own_buf);
+	  return;
+	}
+    }
+
+  tracepoints_inserted = 1;
+  tracing = 1;
+  write_ok (own_buf);
+}
+
+/* Return the start of the blocks of trace frame NUM, which must
+   exist, and store its header in *FRAME.  */
+
+static unsigned char *
+traceframe_data (int num, struct traceframe *frame)
+{
+  unsigned int offset = 0;
+  int i;
+
+  for (i = 0; ; i++)
+    {
+      memcpy (frame, trace_buffer + offset, sizeof (*frame));
+      if (i == num)
+	return trace_buffer + offset + sizeof (*frame);
+      offset += sizeof (*frame) + frame->data_size;
+    }
+}
+
+/* Return the number of the first trace frame after the current one
+   which satisfies MATCHES, or -1.  */
+
+static int
+find_next_traceframe (int (*matches) (struct traceframe *, ULONGEST,
+				      ULONGEST),
+		      ULONGEST arg1, ULONGEST arg2, struct traceframe *frame)
+{
+  unsigned int offset = 0;
+  int num;
+
+  for (num = 0; num < traceframe_count; num++)
+    {
+      memcpy (frame, trace_buffer + offset, sizeof (*frame));
+      if (num > current_traceframe && (*matches) (frame, arg1, arg2))
+	return num;
+      offset += sizeof (*frame) + frame->data_size;
+    }
+
+  return -1;
+}
+
+static int
+traceframe_pc_matches (struct traceframe *frame, ULONGEST pc,
+		       ULONGEST unused)
+{
+  return frame->pc == (CORE_ADDR) pc;
+}
+
+static int
+traceframe_tdp_matches (struct traceframe *frame, ULONGEST tdp,
+			ULONGEST unused)
+{
+  return frame->tpnum == (int) tdp;
+}
+
+static int
+traceframe_in_range (struct traceframe *frame, ULONGEST start,
+		     ULONGEST end)
+{
+  return frame->pc >= (CORE_ADDR) start && frame->pc <= (CORE_ADDR) end;
+}
+
+static int
+traceframe_outside_range (struct traceframe *frame, ULONGEST start,
+			  ULONGEST end)
+{
+  return !traceframe_in_range (frame, start, end);
+}
+
+/* Handle "QTFrame:<n>", "QTFrame:pc:<addr>", "QTFrame:tdp:<n>",
+   "QTFrame:range:<start>:<end>" and "QTFrame:outside:<start>:<end>".
+   All but the first look for the next matching frame after the
+   current one.  */
+
+static void
+cmd_qtframe (char *own_buf)
+{
+  char *p = own_buf + strlen ("QTFrame:");
+  int (*matches) (struct traceframe *, ULONGEST, ULONGEST);
+  struct traceframe frame;
+  ULONGEST arg1, arg2 = 0;
+  int num;
+
+  if (strncmp (p, "pc:", 3) == 0)
+    {
+      p += 3;
+      matches = traceframe_pc_matches;
+    }
+  else if (strncmp (p, "tdp:", 4) == 0)
+    {
+      p += 4;
+      matches = traceframe_tdp_matches;
+    }
+  else if (strncmp (p, "range:", 6) == 0)
+    {
+      p += 6;
+      matches = traceframe_in_range;
+    }
+  else if (strncmp (p, "outside:", 8) == 0)
+    {
+      p += 8;
+      matches = traceframe_outside_range;
+    }
+  else
+    matches = NULL;
+
+  if (!unpack_varlen_hex (&p, &arg1))
+    {
+      write_enn (own_buf);
+      return;
+    }
+  if ((matches == traceframe_in_range || matches == traceframe_outside_range)
+      && (*p++ != ':' || !unpack_varlen_hex (&p, &arg2)))
+    {
+      write_enn (own_buf);
+      return;
+    }
+
+  if (matches == NULL)
+    {
+      /* "tfind end" sends -1, as a 32-bit number.  */
+      if ((int) arg1 == -1)
+	{
+	  current_traceframe = -1;
+	  write_ok (own_buf);
+	  return;
+	}
+
+      num = -1;
+      if (arg1 < (ULONGEST) traceframe_count)
+	{
+	  num = (int) arg1;
+	  traceframe_data (num, &frame);
+	}
+    }
+  else
+    num = find_next_traceframe (matches, arg1, arg2, &frame);
+
+  if (num == -1)
+    {
+      strcpy (own_buf, "F-1");
+      return;
+    }
+
+  current_traceframe = num;
+  sprintf (own_buf, "F%xT%x", num, frame.tpnum);
+}
+
+int
+handle_tracepoint_general_set (char *own_buf)
+{
+  if (strcmp ("QTinit", own_buf) == 0)
+    {
+      clear_tracepoints ();
+      write_ok (own_buf);
+      return 1;
+    }
+
+  if (strncmp ("QTDP:", own_buf, strlen ("QTDP:")) == 0)
+    {
+      cmd_qtdp (own_buf);
+      return 1;
+    }
+
+  if (strncmp ("QTro", own_buf, strlen ("QTro")) == 0)
+    {
+      cmd_qtro (own_buf);
+      return 1;
+    }
+
+  if (strcmp ("QTStart", own_buf) == 0)
+    {
+      cmd_qtstart (own_buf);
+      return 1;
+    }
+
+  if (strcmp ("QTStop", own_buf) == 0)
+    {
+      tracing = 0;
+      remove_tracepoint_breakpoints ();
+      write_ok (own_buf);
+      return 1;
+    }
+
+  if (strncmp ("QTFrame:", own_buf, strlen ("QTFrame:")) == 0)
+    {
+      cmd_qtframe (own_buf);
+      return 1;
+    }
+
+  return 0;
+}
+
+int
+handle_tracepoint_query (char *own_buf)
+{
+  if (strcmp ("qTStatus", own_buf) == 0)
+    {
+      /* Clean up after an experiment which stopped itself.  */
+      if (!tracing)
+	remove_tracepoint_breakpoints ();
+
+      sprintf (own_buf, "T%d", tracing);
+      return 1;
+    }
+
+  return 0;
+}
+
+/* Return the size of the block at P in a trace frame.  */
+
+static unsigned int
+traceframe_block_size (unsigned char *p)
+{
+  struct traceframe_mem mem;
+
+  if (*p == 'R')
+    return 1 + registers_length () / 2;
+
+  memcpy (&mem, p + 1, sizeof (mem));
+  return 1 + sizeof (mem) + mem.len;
+}
+
+void
+traceframe_registers_to_string (char *buf)
+{
+  struct traceframe frame;
+  unsigned char *p, *end;
+
+  p = traceframe_data (current_traceframe, &frame);
+  for (end = p + frame.data_size; p < end; p += traceframe_block_size (p))
+    if (*p == 'R')
+      {
+	convert_int_to_ascii (p + 1, buf, registers_length () / 2);
+	return;
+      }
+
+  memset (buf, 'x', registers_length ());
+  buf[registers_length ()] = '\0';
+}
+
+/* APPLE LOCAL begin register batching  */
+void
+traceframe_register_to_string (int regno, char *buf)
+{
+  struct traceframe frame;
+  unsigned char *p, *end;
+  int size = register_size (regno);
+
+  p = traceframe_data (current_traceframe, &frame);
+  for (end = p + frame.data_size; p < end; p += traceframe_block_size (p))
+    if (*p == 'R')
+      {
+	convert_int_to_ascii (p + 1 + find_register_by_number (regno)->offset / 8,
+			      buf, size);
+	return;
+      }
+
+  memset (buf, 'x', 2 * size);
+  buf[2 * size] = '\0';
+}
+/* APPLE LOCAL end register batching  */
+
+int
+traceframe_read_memory (CORE_ADDR memaddr, unsigned char *myaddr, int len)
+{
+  struct traceframe frame;
+  unsigned char *data, *p, *end;
+  CORE_ADDR addr = memaddr;
+  CORE_ADDR memend = memaddr + len;
+
+  data = traceframe_data (current_traceframe, &frame);
+  end = data + frame.data_size;
+
+  /* Fill in the request a piece at a time, from whichever block or
+     read-only region covers the next byte.  */
+  while (addr < memend)
+    {
+      struct readonly_region *r;
+      CORE_ADDR piece_end = 0;
+
+      for (p = data; p < end; p += traceframe_block_size (p))
+	{
+	  struct traceframe_mem mem;
+
+	  if (*p != 'M')
+	    continue;
+	  memcpy (&mem, p + 1, sizeof (mem));
+	  if (addr < mem.addr || addr >= mem.addr + mem.len)
+	    continue;
+
+	  piece_end = mem.addr + mem.len;
+	  if (piece_end > memend)
+	    piece_end = memend;
+	  memcpy (myaddr + (addr - memaddr),
+		  p + 1 + sizeof (mem) + (addr - mem.addr),
+		  piece_end - addr);
+	  break;
+	}
+
+      if (piece_end == 0)
+	for (r = readonly_regions; r != NULL; r = r->next)
+	  if (addr >= r->start && addr < r->end)
+	    {
+	      piece_end = r->end;
+	      if (piece_end > memend)
+		piece_end = memend;
+	      if (read_inferior_memory (addr, myaddr + (addr - memaddr),
+					piece_end - addr) != 0)
+		return -1;
+	      break;
+	    }
+
+      if (piece_end == 0)
+	return -1;
+      addr = piece_end;
+    }
+
+  return 0;
+}
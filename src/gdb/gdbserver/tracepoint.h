@@ -0,0 +1,61 @@
+/* Tracepoint support for the remote server for GDB.
+   Copyright 2006
+   Free Software Foundation, Inc.
+
+   This file is part of GDB.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 59 Temple Place - Suite 330,
+   Boston, MA 02111-1307, USA.  */
+
+#ifndef TRACEPOINT_H
+#define TRACEPOINT_H
+
+/* The trace frame GDB is looking at, or -1 if it's looking at the
+   live inferior.  While a frame is selected, register and memory
+   reads are answered from the trace buffer.  */
+
+extern int current_traceframe;
+
+/* Handle a tracepoint packet in OWN_BUF which starts with 'Q':
+   QTinit, QTDP, QTro, QTStart, QTStop or QTFrame.  Return non-zero
+   if it was one of ours, after replacing it with the reply.  */
+
+int handle_tracepoint_general_set (char *own_buf);
+
+/* Likewise for the 'q' packet qTStatus.  */
+
+int handle_tracepoint_query (char *own_buf);
+
+/* Convert the registers collected in the current trace frame to a
+   'g' reply in BUF.  Registers the frame didn't collect are sent as
+   'x's.  */
+
+void traceframe_registers_to_string (char *buf);
+
+/* APPLE LOCAL begin register batching  */
+/* Likewise for the single register REGNO, for a 'p' reply.  */
+
+void traceframe_register_to_string (int regno, char *buf);
+/* APPLE LOCAL end register batching  */
+
+/* Read LEN bytes at MEMADDR in the current trace frame into MYADDR.
+   Memory which wasn't collected can only be read if it lies in one of
+   the read-only ranges GDB gave us.  Return 0 on success, or -1 if
+   some of it isn't available.  */
+
+int traceframe_read_memory (CORE_ADDR memaddr, unsigned char *myaddr,
+			    int len);
+
+#endif /* TRACEPOINT_H */
@@ -1833,7 +1833,8 @@ gdbtk_load_source (ClientData clientData, struct symtab *symtab,
 	  client_data->fp = fdopen (fdes, FOPEN_RB);
 	  clearerr (client_data->fp);
 	  
-          if (symtab->line_charpos == 0)
+	  /* APPLE LOCAL source text cache  */
+          if (!symtab->line_charpos_complete)
             find_source_lines (symtab, fdes);
 
 	  /* We are called with an actual load request, so call ourselves
@@ -442,6 +442,9 @@ i386_linux_init_abi (struct gdbarch_info info, struct gdbarch *gdbarch)
   /* Enable TLS support.  */
   set_gdbarch_fetch_tls_load_module_address (gdbarch,
                                              svr4_fetch_objfile_link_map);
+
+  /* APPLE LOCAL displaced stepping  */
+  i386_init_displaced_stepping (gdbarch);
 }
 
 /* Provide a prototype to silence -Wmissing-prototypes.  */
@@ -307,6 +307,184 @@ i386_breakpoint_from_pc (CORE_ADDR *pc, int *len)
   return break_insn;
 }
 
+/* APPLE LOCAL begin displaced stepping  */
+/* Displaced stepping.  We step over a breakpoint by single-stepping a
+   verbatim copy of the instruction under it (see infrun.c); once the
+   copy has run, anything it left relative to the copy's address has
+   to be moved back to the original.  */
+
+#define I386_MAX_INSN_LENGTH	16
+
+/* Return a pointer to the first byte of INSN past any instruction
+   prefixes, or NULL if the prefixes run to the end of the buffer.  */
+
+const gdb_byte *
+i386_skip_prefixes (const gdb_byte *insn, size_t max_len)
+{
+  const gdb_byte *end = insn + max_len;
+
+  for (; insn < end; insn++)
+    switch (*insn)
+      {
+      case 0x26: case 0x2e: case 0x36: case 0x3e:	/* Segment.  */
+      case 0x64: case 0x65:
+      case 0x66: case 0x67:		/* Operand and address size.  */
+      case 0xf0: case 0xf2: case 0xf3:	/* lock, repne, rep.  */
+	break;
+      default:
+	return insn;
+      }
+
+  return NULL;
+}
+
+/* Return non-zero if INSN is a jump to an absolute address.  */
+
+static int
+i386_absolute_jmp_p (const gdb_byte *insn)
+{
+  /* jmp far (absolute address in operand).  */
+  if (insn[0] == 0xea)
+    return 1;
+
+  /* jmp near and far (absolute address in register or memory).  */
+  if (insn[0] == 0xff)
+    return ((insn[1] & 0x38) == 0x20 || (insn[1] & 0x38) == 0x28);
+
+  return 0;
+}
+
+/* Return non-zero if INSN is a call to an absolute address.  */
+
+static int
+i386_absolute_call_p (const gdb_byte *insn)
+{
+  /* call far (absolute address in operand).  */
+  if (insn[0] == 0x9a)
+    return 1;
+
+  /* call near and far (absolute address in register or memory).  */
+  if (insn[0] == 0xff)
+    return ((insn[1] & 0x38) == 0x10 || (insn[1] & 0x38) == 0x18);
+
+  return 0;
+}
+
+/* Return non-zero if INSN is a return.  */
+
+static int
+i386_ret_p (const gdb_byte *insn)
+{
+  switch (insn[0])
+    {
+    case 0xc2: case 0xc3:	/* ret near */
+    case 0xca: case 0xcb:	/* ret far */
+    case 0xcf:			/* iret */
+      return 1;
+    default:
+      return 0;
+    }
+}
+
+/* Return non-zero if INSN is a call, absolute or relative.  */
+
+static int
+i386_call_p (const gdb_byte *insn)
+{
+  return insn[0] == 0xe8 || i386_absolute_call_p (insn);
+}
+
+/* Return non-zero if INSN is a system call, and store its length in
+   *LENGTHP.  */
+
+static int
+i386_syscall_p (const gdb_byte *insn, int *lengthp)
+{
+  if ((insn[0] == 0xcd && insn[1] == 0x80)	/* int $0x80 */
+      || (insn[0] == 0x0f && insn[1] == 0x34)	/* sysenter */
+      || (insn[0] == 0x0f && insn[1] == 0x05))	/* syscall */
+    {
+      *lengthp = 2;
+      return 1;
+    }
+
+  return 0;
+}
+
+/* Fix up REGS after single-stepping, at TO, a copy of the instruction
+   originally at FROM.  INSN points at its opcode, PREFIX_LEN bytes
+   into the instruction.  PC_REGNUM and SP_REGNUM are the program
+   counter and stack pointer, and ADDR_SIZE the size of a return
+   address.  */
+
+void
+i386_displaced_step_relocate (const gdb_byte *insn, int prefix_len,
+			      CORE_ADDR from,
+			      CORE_ADDR to, struct regcache *regs,
+			      int pc_regnum, int sp_regnum, int addr_size)
+{
+  ULONGEST pc, sp, retaddr;
+  int insn_len;
+
+  regcache_cooked_read_unsigned (regs, pc_regnum, &pc);
+
+  /* Absolute jumps and returns leave the PC where they were told to;
+     anything else, including a relative jump or call, leaves it
+     relative to the copy.  A system call may also have gone
+     somewhere else entirely (sigreturn, say); leave the PC alone
+     unless it's just past the copy.  */
+  if (!i386_absolute_jmp_p (insn) && !i386_absolute_call_p (insn)
+      && !i386_ret_p (insn)
+      && !(i386_syscall_p (insn, &insn_len)
+	   && pc != to + prefix_len + insn_len))
+    regcache_cooked_write_unsigned (regs, pc_regnum, pc - (to - from));
+
+  /* A call pushed the address after the copy; return to the address
+     after the original instead.  */
+  if (i386_call_p (insn))
+    {
+      regcache_cooked_read_unsigned (regs, sp_regnum, &sp);
+      retaddr = read_memory_unsigned_integer (sp, addr_size);
+      write_memory_unsigned_integer (sp, addr_size, retaddr - (to - from));
+    }
+}
+
+/* The gdbarch_displaced_step_fixup method.  The closure is a copy of
+   the instruction, as made by simple_displaced_step_copy_insn.  */
+
+void
+i386_displaced_step_fixup (struct gdbarch *gdbarch,
+			   struct displaced_step_closure *closure,
+			   CORE_ADDR from, CORE_ADDR to,
+			   struct regcache *regs)
+{
+  const gdb_byte *buf = (const gdb_byte *) closure;
+  const gdb_byte *insn;
+
+  insn = i386_skip_prefixes (buf, gdbarch_max_insn_length (gdbarch));
+  if (insn == NULL)
+    return;
+
+  i386_displaced_step_relocate (insn, insn - buf, from, to, regs,
+				I386_EIP_REGNUM, I386_ESP_REGNUM, 4);
+}
+
+/* Set up GDBARCH for displaced stepping.  */
+
+void
+i386_init_displaced_stepping (struct gdbarch *gdbarch)
+{
+  set_gdbarch_max_insn_length (gdbarch, I386_MAX_INSN_LENGTH);
+  set_gdbarch_displaced_step_copy_insn (gdbarch,
+					simple_displaced_step_copy_insn);
+  set_gdbarch_displaced_step_fixup (gdbarch, i386_displaced_step_fixup);
+  set_gdbarch_displaced_step_free_closure (gdbarch,
+					   simple_displaced_step_free_closure);
+  set_gdbarch_displaced_step_location (gdbarch,
+				       displaced_step_at_entry_point);
+}
+/* APPLE LOCAL end displaced stepping  */
+
 /* According to the System V ABI, the registers %ebp, %ebx, %edi, %esi
    and %esp "belong" to the calling function.  Therefore these
    registers should be saved if they're going to be modified.  */
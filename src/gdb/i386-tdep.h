@@ -22,6 +22,8 @@
 #ifndef I386_TDEP_H
 #define I386_TDEP_H
 
+/* APPLE LOCAL displaced stepping  */
+struct displaced_step_closure;
 struct frame_info;
 struct gdbarch;
 struct reggroup;
@@ -195,6 +197,31 @@ extern void i386_svr4_init_abi (struct gdbarch_info, struct gdbarch *);
 
 /* APPLE LOCAL */
 int i386_find_picbase_setup (CORE_ADDR, CORE_ADDR *, enum i386_regnum *);
+
+/* APPLE LOCAL begin displaced stepping  */
+/* Return a pointer to the first byte of INSN, MAX_LEN bytes long,
+   past any instruction prefixes, or NULL if there is none.  */
+extern const gdb_byte *i386_skip_prefixes (const gdb_byte *insn,
+					   size_t max_len);
+
+/* Fix up REGS after single-stepping, at TO, a copy of the instruction
+   originally at FROM.  INSN points at its opcode, PREFIX_LEN bytes
+   into the instruction.  */
+extern void i386_displaced_step_relocate (const gdb_byte *insn,
+					  int prefix_len,
+					  CORE_ADDR from, CORE_ADDR to,
+					  struct regcache *regs,
+					  int pc_regnum, int sp_regnum,
+					  int addr_size);
+
+extern void i386_displaced_step_fixup (struct gdbarch *gdbarch,
+				       struct displaced_step_closure *closure,
+				       CORE_ADDR from, CORE_ADDR to,
+				       struct regcache *regs);
+
+/* Set up GDBARCH to step over breakpoints out of line.  */
+extern void i386_init_displaced_stepping (struct gdbarch *gdbarch);
+/* APPLE LOCAL end displaced stepping  */
 
 
 /* Functions and variables exported from i386bsd-tdep.c.  */
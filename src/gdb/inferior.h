@@ -296,6 +296,20 @@ extern void step_once (int, int, int);
 
 extern void follow_inferior_reset_breakpoints (void);
 
+/* APPLE LOCAL begin displaced stepping  */
+struct displaced_step_closure;
+
+extern struct displaced_step_closure *
+  simple_displaced_step_copy_insn (struct gdbarch *gdbarch,
+				   CORE_ADDR from, CORE_ADDR to,
+				   struct regcache *regs);
+
+extern void simple_displaced_step_free_closure
+  (struct gdbarch *gdbarch, struct displaced_step_closure *closure);
+
+extern CORE_ADDR displaced_step_at_entry_point (struct gdbarch *gdbarch);
+/* APPLE LOCAL end displaced stepping  */
+
 /* From infcmd.c */
 
 extern void tty_command (char *, int);
@@ -537,10 +537,302 @@ static ptid_t saved_singlestep_ptid;
 static int stepping_past_singlestep_breakpoint;
 
 
+/* APPLE LOCAL begin displaced stepping  */
+/* Displaced stepping.
+
+   To step a thread over a breakpoint inserted at its PC, we used to
+   remove every breakpoint, single-step that thread with the others
+   stopped, and then insert every breakpoint again: two memory writes
+   per breakpoint for each instruction stepped over.
+
+   When the architecture supports it, we instead copy the instruction
+   under the breakpoint to a scratch area, point the thread's PC at
+   the copy, and single-step it there with the breakpoints left in
+   place.  Once the step completes, the architecture's
+   displaced_step_fixup method adjusts the PC (and anything else the
+   instruction left relative to the copy, like a pushed return
+   address) so that it looks as though the instruction ran in place.
+
+   Only one thread does a displaced step at a time, and it is the only
+   thread resumed while it does.  */
+
+/* Non-zero if we may use displaced stepping.  */
+static int can_use_displaced_stepping = 1;
+
+static void
+show_can_use_displaced_stepping (struct ui_file *file, int from_tty,
+				 struct cmd_list_element *c,
+				 const char *value)
+{
+  fprintf_filtered (file, _("Displaced stepping is %s.\n"), value);
+}
+
+/* The thread doing a displaced step, or null_ptid.  */
+static ptid_t displaced_step_ptid;
+
+/* The architecture's closure for the step in progress.  */
+static struct displaced_step_closure *displaced_step_closure;
+
+/* The address of the instruction being stepped, and of its copy.  */
+static CORE_ADDR displaced_step_original;
+static CORE_ADDR displaced_step_copy;
+
+/* What the scratch area held before we copied the instruction
+   there, including any breakpoint instructions inserted in it.  */
+static gdb_byte *displaced_step_saved_copy;
+
+static int
+use_displaced_stepping (struct gdbarch *gdbarch)
+{
+  return (can_use_displaced_stepping
+	  && gdbarch_displaced_step_copy_insn_p (gdbarch)
+	  && !SOFTWARE_SINGLE_STEP_P ());
+}
+
+/* An implementation of gdbarch_displaced_step_copy_insn for
+   architectures where the closure need only hold a copy of the
+   instruction.  */
+
+struct displaced_step_closure *
+simple_displaced_step_copy_insn (struct gdbarch *gdbarch,
+				 CORE_ADDR from, CORE_ADDR to,
+				 struct regcache *regs)
+{
+  size_t len = gdbarch_max_insn_length (gdbarch);
+  gdb_byte *buf = xmalloc (len);
+
+  /* Memory reads see through the breakpoint we are stepping over.  */
+  if (target_read_memory (from, buf, len) != 0)
+    {
+      xfree (buf);
+      return NULL;
+    }
+  write_memory (to, buf, len);
+
+  return (struct displaced_step_closure *) buf;
+}
+
+/* The matching gdbarch_displaced_step_free_closure method.  */
+
+void
+simple_displaced_step_free_closure (struct gdbarch *gdbarch,
+				    struct displaced_step_closure *closure)
+{
+  xfree (closure);
+}
+
+/* An implementation of gdbarch_displaced_step_location which uses the
+   code at the executable's entry point, which is finished with by the
+   time anyone sets a breakpoint worth stepping over.  */
+
+CORE_ADDR
+displaced_step_at_entry_point (struct gdbarch *gdbarch)
+{
+  CORE_ADDR addr;
+  int bp_len;
+
+  addr = entry_point_address ();
+  if (addr == 0)
+    error (_("Cannot find a scratch area for displaced stepping."));
+
+  /* Keep clear of any breakpoint at the entry point itself.  */
+  BREAKPOINT_FROM_PC (&addr, &bp_len);
+  return addr + bp_len * 2;
+}
+
+/* A cleanup for when stepping out of line falls through.  */
+
+static void
+end_shadow_exemption (void *ignore)
+{
+  breakpoint_exempt_from_shadows (0, 0);
+}
+
+/* Put the scratch area back as it was and forget the displaced step
+   in progress.  */
+
+static void
+displaced_step_clear (void)
+{
+  if (displaced_step_saved_copy != NULL)
+    {
+      if (target_write_memory (displaced_step_copy,
+			       displaced_step_saved_copy,
+			       gdbarch_max_insn_length (current_gdbarch)) != 0)
+	warning (_("Could not restore the displaced stepping area at 0x%s."),
+		 paddr_nz (displaced_step_copy));
+      xfree (displaced_step_saved_copy);
+      displaced_step_saved_copy = NULL;
+    }
+  breakpoint_exempt_from_shadows (0, 0);
+
+  if (displaced_step_closure != NULL)
+    {
+      gdbarch_displaced_step_free_closure (current_gdbarch,
+					   displaced_step_closure);
+      displaced_step_closure = NULL;
+    }
+
+  displaced_step_ptid = null_ptid;
+}
+
+/* Prepare to single-step the current thread over the breakpoint at
+   its PC by stepping a copy of the instruction there.  Return
+   non-zero if the thread's PC now points at the copy, or zero if the
+   instruction can't be stepped out of line.  */
+
+static int
+displaced_step_prepare (void)
+{
+  struct cleanup *old_chain;
+  struct displaced_step_closure *closure;
+  CORE_ADDR original, copy;
+  ULONGEST len;
+  gdb_byte *saved;
+
+  gdb_assert (ptid_equal (displaced_step_ptid, null_ptid));
+
+  original = read_pc ();
+  copy = gdbarch_displaced_step_location (current_gdbarch);
+  len = gdbarch_max_insn_length (current_gdbarch);
+
+  /* Never step an instruction that overlaps its own copy.  */
+  if (original < copy + len && copy < original + len)
+    return 0;
+
+  /* Breakpoints inserted in the scratch area must not keep the copied
+     instruction out, and must be back in place when we are done; so
+     save, overwrite and restore the real memory there.  */
+  saved = xmalloc (len);
+  old_chain = make_cleanup (xfree, saved);
+  breakpoint_exempt_from_shadows (copy, len);
+  make_cleanup (end_shadow_exemption, NULL);
+  if (target_read_memory (copy, saved, len) != 0)
+    {
+      do_cleanups (old_chain);
+      return 0;
+    }
+
+  closure = gdbarch_displaced_step_copy_insn (current_gdbarch, original,
+					      copy, current_regcache);
+  if (closure == NULL)
+    {
+      do_cleanups (old_chain);
+      return 0;
+    }
+  discard_cleanups (old_chain);
+
+  displaced_step_ptid = inferior_ptid;
+  displaced_step_closure = closure;
+  displaced_step_original = original;
+  displaced_step_copy = copy;
+  displaced_step_saved_copy = saved;
+
+  write_pc (copy);
+
+  if (debug_infrun)
+    fprintf_unfiltered (gdb_stdlog,
+			"infrun: displaced step from 0x%s via 0x%s\n",
+			paddr_nz (original), paddr_nz (copy));
+  return 1;
+}
+
+/* If PTID was doing a displaced step, finish it according to the
+   event WS it reported.  Return non-zero if the copied instruction
+   was executed and the thread now looks as if it had executed the
+   original.  */
+
+static int
+displaced_step_fixup (ptid_t ptid, struct target_waitstatus *ws)
+{
+  struct cleanup *old_chain;
+  int completed = 0;
+
+  if (ptid_equal (displaced_step_ptid, null_ptid))
+    return 0;
+
+  if (ws->kind == TARGET_WAITKIND_EXITED
+      || ws->kind == TARGET_WAITKIND_SIGNALLED)
+    {
+      /* There's no memory left to put back.  */
+      xfree (displaced_step_saved_copy);
+      displaced_step_saved_copy = NULL;
+      displaced_step_clear ();
+      return 0;
+    }
+
+  if (!ptid_equal (ptid, displaced_step_ptid))
+    return 0;
+
+  old_chain = save_inferior_ptid ();
+  inferior_ptid = ptid;
+
+  if (ws->kind == TARGET_WAITKIND_STOPPED
+      && ws->value.sig == TARGET_SIGNAL_TRAP)
+    {
+      gdbarch_displaced_step_fixup (current_gdbarch, displaced_step_closure,
+				    displaced_step_original,
+				    displaced_step_copy, current_regcache);
+      completed = 1;
+    }
+  else
+    {
+      /* Something else happened before the copy ran (a signal
+	 arrived, say).  Put the PC back on the original instruction,
+	 so that it reads sensibly; we'll step over the breakpoint
+	 again when the thread is resumed.  */
+      CORE_ADDR pc = read_pc ();
+
+      if (pc >= displaced_step_copy
+	  && pc < (displaced_step_copy
+		   + gdbarch_max_insn_length (current_gdbarch)))
+	write_pc (displaced_step_original + (pc - displaced_step_copy));
+
+      /* Carry on as though the breakpoints had been taken out for an
+	 ordinary step; that's what handle_inferior_event expects when
+	 a signal interrupts a step over a breakpoint.  */
+      if (breakpoints_inserted)
+	{
+	  remove_breakpoints ();
+	  breakpoints_inserted = 0;
+	}
+    }
+
+  if (debug_infrun)
+    fprintf_unfiltered (gdb_stdlog,
+			"infrun: displaced step %s, pc now 0x%s\n",
+			completed ? "completed" : "cancelled",
+			paddr_nz (read_pc ()));
+
+  displaced_step_clear ();
+  do_cleanups (old_chain);
+  return completed;
+}
+
+/* While a displaced step is in progress only the stepping thread is
+   running, so wait for that thread in particular; otherwise wait for
+   WAITON_PTID.  */
+
+static ptid_t
+displaced_step_waiton_ptid (ptid_t waiton_ptid)
+{
+  if (!ptid_equal (displaced_step_ptid, null_ptid))
+    return displaced_step_ptid;
+  return waiton_ptid;
+}
+/* APPLE LOCAL end displaced stepping  */
+
 /* Things to clean up if we QUIT out of resume ().  */
 static void
 resume_cleanups (void *ignore)
 {
+  /* APPLE LOCAL begin displaced stepping  */
+  if (!ptid_equal (displaced_step_ptid, null_ptid))
+    {
+      write_pc_pid (displaced_step_original, displaced_step_ptid);
+      displaced_step_clear ();
+    }
+  /* APPLE LOCAL end displaced stepping  */
   normal_stop ();
 }
 
@@ -770,9 +1062,30 @@ resume (int step, enum target_signal sig)
   if (should_resume)
     {
       ptid_t resume_ptid;
+      /* APPLE LOCAL displaced stepping  */
+      int displaced = 0;
 
       resume_ptid = RESUME_ALL;	/* Default */
 
+      /* APPLE LOCAL begin displaced stepping  */
+      /* proceed () leaves the breakpoints inserted when we are to step
+	 over one with a displaced step, and they stay inserted across
+	 stops in always-inserted mode.  Step the copy if we can; if
+	 not, fall back to taking the breakpoints out for the step.  */
+      if (step && trap_expected
+	  && breakpoint_inserted_here_p (read_pc ()))
+	{
+	  if (sig == TARGET_SIGNAL_0
+	      && use_displaced_stepping (current_gdbarch))
+	    displaced = displaced_step_prepare ();
+	  if (!displaced)
+	    {
+	      remove_breakpoints ();
+	      breakpoints_inserted = 0;
+	    }
+	}
+      /* APPLE LOCAL end displaced stepping  */
+
       if ((step || singlestep_breakpoints_inserted_p)
 	  && (stepping_past_singlestep_breakpoint
 	      || (!breakpoints_inserted && breakpoint_here_p (read_pc ()))))
@@ -806,6 +1119,13 @@ resume (int step, enum target_signal sig)
 	  resume_ptid = inferior_ptid;
 	}
 
+      /* APPLE LOCAL begin displaced stepping  */
+      /* The other threads would run straight through the copy's
+	 scratch area, so keep them stopped until the step is done.  */
+      if (displaced)
+	resume_ptid = inferior_ptid;
+      /* APPLE LOCAL end displaced stepping  */
+
       if (CANNOT_STEP_BREAKPOINT)
 	{
 	  /* Most targets can step a breakpoint instruction, thus
@@ -1014,9 +1334,21 @@ proceed (CORE_ADDR addr, enum target_signal siggnal, int step)
     oneproc = 1;
 
   if (oneproc)
-    /* We will get a trace trap after one instruction.
-       Continue it automatically and insert breakpoints then.  */
-    trap_expected = 1;
+    {
+      /* We will get a trace trap after one instruction.
+	 Continue it automatically and insert breakpoints then.  */
+      trap_expected = 1;
+
+      /* APPLE LOCAL begin displaced stepping  */
+      /* If we can step over the breakpoint out of line, the
+	 breakpoints can stay in; resume () sorts out the step.  */
+      if (use_displaced_stepping (current_gdbarch))
+	{
+	  insert_breakpoints ();
+	  breakpoints_inserted = 1;
+	}
+      /* APPLE LOCAL end displaced stepping  */
+    }
   else
     {
       insert_breakpoints ();
@@ -1247,10 +1579,12 @@ wait_for_inferior (void)
     {
       if (deprecated_target_wait_hook)
 	/* APPLE LOCAL 3rd arg to target_wait*  */
-	ecs->ptid = deprecated_target_wait_hook (ecs->waiton_ptid, ecs->wp, NULL);
+	/* APPLE LOCAL displaced stepping  */
+	ecs->ptid = deprecated_target_wait_hook (displaced_step_waiton_ptid (ecs->waiton_ptid), ecs->wp, NULL);
       else
 	/* APPLE LOCAL 3rd arg to target_wait*  */
-	ecs->ptid = target_wait (ecs->waiton_ptid, ecs->wp, NULL);
+	/* APPLE LOCAL displaced stepping  */
+	ecs->ptid = target_wait (displaced_step_waiton_ptid (ecs->waiton_ptid), ecs->wp, NULL);
 
       /* Now figure out what to do with the result of the result.  */
       handle_inferior_event (ecs);
@@ -1305,10 +1639,12 @@ fetch_inferior_event (void *client_data)
   if (deprecated_target_wait_hook)
     async_ecs->ptid =
       /* APPLE LOCAL 3rd arg to target_wait*  */
-      deprecated_target_wait_hook (async_ecs->waiton_ptid, async_ecs->wp, client_data);
+      /* APPLE LOCAL displaced stepping  */
+      deprecated_target_wait_hook (displaced_step_waiton_ptid (async_ecs->waiton_ptid), async_ecs->wp, client_data);
   else
     /* APPLE LOCAL 3rd arg to target_wait*  */
-    async_ecs->ptid = target_wait (async_ecs->waiton_ptid, async_ecs->wp, client_data);
+    /* APPLE LOCAL displaced stepping  */
+    async_ecs->ptid = target_wait (displaced_step_waiton_ptid (async_ecs->waiton_ptid), async_ecs->wp, client_data);
 
   /* Now figure out what to do with the result of the result.  */
   handle_inferior_event (async_ecs);
@@ -1515,6 +1851,8 @@ handle_inferior_event (struct execution_control_state *ecs)
   struct frame_id prev_frame_id;
   struct gdb_exception e;
   /* END APPLE LOCAL */
+  /* APPLE LOCAL displaced stepping  */
+  int displaced_step_done;
 
   /* Cache the last pid/waitstatus. */
   target_last_wait_ptid = ecs->ptid;
@@ -1522,6 +1860,13 @@ handle_inferior_event (struct execution_control_state *ecs)
 
   adjust_pc_after_break (ecs);
 
+  /* APPLE LOCAL begin displaced stepping  */
+  /* Do this after adjust_pc_after_break, which must see the PC the
+     copy left behind rather than one next to the breakpoint we just
+     stepped over.  */
+  displaced_step_done = displaced_step_fixup (ecs->ptid, ecs->wp);
+  /* APPLE LOCAL end displaced stepping  */
+
   switch (ecs->infwait_state)
     {
     case infwait_thread_hop_state:
@@ -1893,7 +2238,13 @@ handle_inferior_event (struct execution_control_state *ecs)
       /* Check if a regular breakpoint has been hit before checking
          for a potential single step breakpoint. Otherwise, GDB will
          not see this breakpoint hit when stepping onto breakpoints.  */
-      if (breakpoints_inserted && breakpoint_here_p (stop_pc))
+      /* APPLE LOCAL begin displaced stepping  */
+      /* A displaced step which has just finished stepped over the
+	 breakpoint; one it arrived at has not been hit yet, just as
+	 when the breakpoints are out for the step.  */
+      if (breakpoints_inserted && !displaced_step_done
+	  && breakpoint_here_p (stop_pc))
+      /* APPLE LOCAL end displaced stepping  */
 	{
 	  ecs->random_signal = 0;
 	  if (!breakpoint_thread_match (stop_pc, ecs->ptid))
@@ -1932,7 +2283,18 @@ handle_inferior_event (struct execution_control_state *ecs)
 	      singlestep_breakpoints_inserted_p = 0;
 	    }
 
-	  remove_status = remove_breakpoints ();
+	  /* APPLE LOCAL begin displaced stepping  */
+	  /* If we can step the thread over the breakpoint out of
+	     line, there's no need to take the breakpoints out.  */
+	  if (breakpoints_inserted && use_displaced_stepping (current_gdbarch))
+	    remove_status = 0;
+	  else
+	    {
+	      remove_status = remove_breakpoints ();
+	      if (remove_status == 0)
+		breakpoints_inserted = 0;
+	    }
+	  /* APPLE LOCAL end displaced stepping  */
 	  /* Did we fail to remove breakpoints?  If so, try
 	     to set the PC past the bp.  (There's at least
 	     one situation in which we can fail to remove
@@ -1961,7 +2323,6 @@ handle_inferior_event (struct execution_control_state *ecs)
 	    }
 	  else
 	    {			/* Single step */
-	      breakpoints_inserted = 0;
 	      if (!ptid_equal (inferior_ptid, ecs->ptid))
 		context_switch (ecs);
 	      ecs->waiton_ptid = ecs->ptid;
@@ -2413,11 +2774,16 @@ extern void macosx_print_extra_stop_info (int, CORE_ADDR);
       case BPSTAT_WHAT_SINGLE:
         if (debug_infrun)
 	  fprintf_unfiltered (gdb_stdlog, "infrun: BPSTATE_WHAT_SINGLE\n");
-	if (breakpoints_inserted)
+	/* APPLE LOCAL begin displaced stepping  */
+	/* resume () can step over the breakpoint out of line with the
+	   breakpoints left in.  */
+	if (breakpoints_inserted
+	    && !use_displaced_stepping (current_gdbarch))
 	  {
 	    remove_breakpoints ();
+	    breakpoints_inserted = 0;
 	  }
-	breakpoints_inserted = 0;
+	/* APPLE LOCAL end displaced stepping  */
 	ecs->another_trap = 1;
 	/* Still need to check other stuff, at least the case
 	   where we are stepping and step out of the right range.  */
@@ -3706,7 +4072,13 @@ normal_stop (void)
        DECR_PC_AFTER_BREAK needs to just go away.  */
     deprecated_update_frame_pc_hack (get_current_frame (), read_pc ());
 
-  if (target_has_execution && breakpoints_inserted)
+  /* APPLE LOCAL begin always-inserted breakpoints  */
+  /* In always-inserted mode the breakpoints stay in.  We still clear
+     BREAKPOINTS_INSERTED, so that the next resume brings them up to
+     date with anything changed while we were stopped.  */
+  if (target_has_execution && breakpoints_inserted
+      && !breakpoints_always_inserted_mode ())
+  /* APPLE LOCAL end always-inserted breakpoints  */
     {
       if (remove_breakpoints ())
 	{
@@ -5018,6 +5390,21 @@ function is skipped and the step command stops at a different source line."),
 			   show_step_stop_if_no_debug,
 			   &setlist, &showlist);
 
+  /* APPLE LOCAL begin displaced stepping  */
+  add_setshow_boolean_cmd ("displaced-stepping", class_run,
+			   &can_use_displaced_stepping, _("\
+Set whether to step over breakpoints out of line."), _("\
+Show whether to step over breakpoints out of line."), _("\
+When set, and the target architecture supports it, a thread is stepped\n\
+over a breakpoint by single-stepping a copy of the instruction under it,\n\
+leaving every breakpoint inserted.  Otherwise, all breakpoints are\n\
+removed for the step and inserted again afterwards."),
+			   NULL,
+			   show_can_use_displaced_stepping,
+			   &setlist, &showlist);
+  displaced_step_ptid = null_ptid;
+  /* APPLE LOCAL end displaced stepping  */
+
   /* APPLE LOCAL: minimal-signal-handling mode.  */
   add_setshow_boolean_cmd ("minimal-signal-handling", class_run, &minimal_signal_handling,
 			   "Set whether we run with a minimal signal handling set.",
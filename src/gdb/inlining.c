@@ -3281,6 +3281,42 @@ inlined_subroutine_free_objfile_call_sites (struct rb_tree_node *root)
   xfree (root);
 }
 
+/* APPLE LOCAL begin maint info memory  */
+/* Return the bytes used by the red-black tree ROOT of an objfile's
+   inlined subroutine records, including the records and their address
+   ranges.  CALL_SITES is non-zero for the inlined_call_sites tree and
+   zero for the inlined_subroutine_data tree.  */
+
+long
+inlined_subroutine_memory_used (struct rb_tree_node *root, int call_sites)
+{
+  struct address_range_list *ranges;
+  long bytes = sizeof (struct rb_tree_node);
+
+  if (call_sites)
+    {
+      bytes += sizeof (struct dwarf_inlined_call_record);
+      ranges = ((struct dwarf_inlined_call_record *) root->data)->ranges;
+    }
+  else
+    {
+      bytes += sizeof (struct inlined_call_stack_record);
+      ranges = ((struct inlined_call_stack_record *) root->data)->ranges;
+    }
+
+  if (ranges)
+    bytes += (sizeof (struct address_range_list)
+	      + ranges->nelts * sizeof (struct address_range));
+
+  if (root->left)
+    bytes += inlined_subroutine_memory_used (root->left, call_sites);
+  if (root->right)
+    bytes += inlined_subroutine_memory_used (root->right, call_sites);
+
+  return bytes;
+}
+/* APPLE LOCAL end maint info memory  */
+
 static void
 update_inlined_data_addresses (CORE_ADDR offset,
 			       struct rb_tree_node *tree)
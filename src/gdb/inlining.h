@@ -334,6 +334,8 @@ extern void rb_tree_insert (struct rb_tree_node **, struct rb_tree_node *,
 
 extern void inlined_subroutine_free_objfile_data (struct rb_tree_node *);
 extern void inlined_subroutine_free_objfile_call_sites (struct rb_tree_node *);
+/* APPLE LOCAL maint info memory  */
+extern long inlined_subroutine_memory_used (struct rb_tree_node *, int);
 
 extern void inlined_subroutine_objfile_relocate (struct objfile *,
 						 struct rb_tree_node *,
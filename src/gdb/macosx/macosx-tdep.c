@@ -521,13 +521,14 @@ macosx_find_exception_catchpoints (enum exception_event_kind kind,
       error ("We currently only handle \"throw\" and \"catch\"");
     }
 
-  hash = msymbol_hash (symbol_name) % MINIMAL_SYMBOL_HASH_SIZE;
+  hash = msymbol_hash (symbol_name);
 
   ALL_OBJFILES (objfile)
   {
-    for (msymbol = objfile->msymbol_hash[hash];
+    for (msymbol = MSYMBOL_HASH_BUCKET (objfile, hash);
          msymbol != NULL; msymbol = msymbol->hash_next)
-      if (MSYMBOL_TYPE (msymbol) == mst_text
+      if (msymbol->hash_value == hash
+          && MSYMBOL_TYPE (msymbol) == mst_text
           && (strcmp_iw (SYMBOL_LINKAGE_NAME (msymbol), symbol_name) == 0))
         {
           /* We found one, add it here... */
@@ -1121,6 +1121,17 @@ This does not include information about individual partial symbols,\n\
 just the symbol table structures themselves."),
 	   &maintenanceinfolist);
 
+  /* APPLE LOCAL begin maint info memory  */
+  add_cmd ("memory", class_maintenance, maintenance_info_memory, _("\
+Show how much memory the symbol tables of each object file use.\n\
+Each object file's total is broken down into its obstack, which holds\n\
+the symbols, symbol tables and debug sections, and the caches and\n\
+tables allocated beside it.  Object files using the most memory are\n\
+listed first.  With an argument REGEXP, only list the object files\n\
+whose names match it."),
+	   &maintenanceinfolist);
+  /* APPLE LOCAL end maint info memory  */
+
   add_cmd ("statistics", class_maintenance, maintenance_print_statistics,
 	   _("Print statistics about internal gdb state."),
 	   &maintenanceprintlist);
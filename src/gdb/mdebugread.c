@@ -3708,7 +3708,11 @@ parse_partial_symbols (struct objfile *objfile)
       && objfile->psymtabs->number_of_dependencies == 0
       && objfile->psymtabs->n_global_syms == 0
       && objfile->psymtabs->n_static_syms == 0)
-    objfile->psymtabs = NULL;
+    {
+      objfile->psymtabs = NULL;
+      /* APPLE LOCAL psymtab indexes  */
+      invalidate_psymtab_indexes (objfile);
+    }
   do_cleanups (old_chain);
 }
 
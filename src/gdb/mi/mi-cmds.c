@@ -155,6 +155,8 @@ struct mi_cmd mi_cmds[] =
   { "symbol-info-file", { NULL, 0 }, NULL, NULL },
   { "symbol-info-function", { NULL, 0 }, NULL, NULL },
   { "symbol-info-line", { NULL, 0 }, NULL, NULL },
+  /* APPLE LOCAL maint info memory  */
+  { "symbol-info-memory", { "maint info memory", 1 }, NULL, NULL },
   { "symbol-info-symbol", { NULL, 0 }, NULL, NULL },
   { "symbol-list-functions", { NULL, 0 }, NULL, NULL },
   { "symbol-list-lines", { NULL, 0 }, 0, mi_cmd_symbol_list_lines},
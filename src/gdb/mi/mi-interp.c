@@ -39,6 +39,8 @@
 #include "inlining.h"
 /* APPLE LOCAL end subroutine inlining  */
 #include "gdbthread.h"
+/* APPLE LOCAL parallel symbol search  */
+#include "symtab.h"
 
 struct mi_interp
 {
@@ -92,6 +94,12 @@ static void mi_load_progress (const char *section_name,
 			      unsigned long total_section,
 			      unsigned long total_sent,
 			      unsigned long grand_total);
+/* APPLE LOCAL begin parallel symbol search  */
+static void mi_search_symbols_progress (const char *phase, int done,
+					int total,
+					struct symbol_search *found,
+					int nfound);
+/* APPLE LOCAL end parallel symbol search  */
 
 
 static void *
@@ -154,6 +162,8 @@ mi_interpreter_resume (void *data)
   clear_interpreter_hooks ();
 
   deprecated_show_load_progress = mi_load_progress;
+  /* APPLE LOCAL parallel symbol search  */
+  search_symbols_progress_hook = mi_search_symbols_progress;
   print_frame_more_info_hook = mi_print_frame_more_info;
 
   /* If we're _the_ interpreter, take control. */
@@ -597,6 +607,8 @@ mi_command_loop (int mi_version)
   deprecated_error_hook = 0;
   deprecated_error_begin_hook = 0;
   deprecated_show_load_progress = mi_load_progress;
+  /* APPLE LOCAL parallel symbol search  */
+  search_symbols_progress_hook = mi_search_symbols_progress;
 
   print_frame_more_info_hook = mi_print_frame_more_info;
 
@@ -689,6 +701,80 @@ mi_load_progress (const char *section_name,
     }
 }
 
+/* APPLE LOCAL begin parallel symbol search  */
+/* Installed as search_symbols_progress_hook.  Every half second or
+   so, and whenever there are new matches, print a "+search-symbols"
+   status record saying how far the search has got and listing the
+   new matches, so a front end can show them before the command is
+   done.  */
+
+static void
+mi_search_symbols_progress (const char *phase, int done, int total,
+			    struct symbol_search *found, int nfound)
+{
+  static struct timeval last_update;
+  static struct ui_out *progress_uiout;
+  struct timeval time_now;
+  struct cleanup *cleanup_tuple;
+  long delta;
+
+  if (!interpreter_p || strncmp (interpreter_p, "mi", 2) != 0)
+    return;
+
+  gettimeofday (&time_now, NULL);
+  delta = ((time_now.tv_sec - last_update.tv_sec) * 1000000
+	   + (time_now.tv_usec - last_update.tv_usec));
+  if (found == NULL && delta < 500000)
+    return;
+  last_update = time_now;
+
+  /* The command may be running under another interpreter, and the
+     MI's own ui_out may be holding output for the result record, so
+     build the record in a ui_out of its own.  */
+  if (progress_uiout == NULL)
+    progress_uiout = mi_out_new (mi_version (interp_ui_out
+					     (interp_lookup (interpreter_p))));
+
+  if (current_command_token)
+    fputs_unfiltered (current_command_token, raw_stdout);
+  fputs_unfiltered ("+search-symbols", raw_stdout);
+  cleanup_tuple = make_cleanup_ui_out_tuple_begin_end (progress_uiout, NULL);
+  ui_out_field_string (progress_uiout, "phase", phase);
+  ui_out_field_int (progress_uiout, "done", done);
+  ui_out_field_int (progress_uiout, "total", total);
+  if (found != NULL)
+    {
+      struct cleanup *cleanup_list;
+
+      cleanup_list = make_cleanup_ui_out_list_begin_end (progress_uiout,
+							 "found");
+      for (; found != NULL && nfound > 0; found = found->next, nfound--)
+	{
+	  struct cleanup *cleanup_match;
+
+	  cleanup_match = make_cleanup_ui_out_tuple_begin_end (progress_uiout,
+							       NULL);
+	  if (found->symbol != NULL)
+	    {
+	      ui_out_field_string (progress_uiout, "name",
+				   SYMBOL_PRINT_NAME (found->symbol));
+	      ui_out_field_string (progress_uiout, "file",
+				   found->symtab->filename);
+	    }
+	  else
+	    ui_out_field_string (progress_uiout, "name",
+				 SYMBOL_PRINT_NAME (found->msymbol));
+	  do_cleanups (cleanup_match);
+	}
+      do_cleanups (cleanup_list);
+    }
+  do_cleanups (cleanup_tuple);
+  mi_out_put (progress_uiout, raw_stdout);
+  fputs_unfiltered ("\n", raw_stdout);
+  gdb_flush (raw_stdout);
+}
+/* APPLE LOCAL end parallel symbol search  */
+
 extern initialize_file_ftype _initialize_mi_interp; /* -Wmissing-prototypes */
 
 void
@@ -2800,6 +2800,10 @@ start_remote_counts (struct mi_timestamp *tv, const char *token)
   tv->remotestats.pkt_recvd = 0;
   tv->remotestats.acks_sent = 0;
   tv->remotestats.acks_recvd = 0;
+  /* APPLE LOCAL no-ack mode  */
+  tv->remotestats.round_trips = 0;
+  /* APPLE LOCAL register batching  */
+  tv->remotestats.register_packets = 0;
   timerclear (&tv->remotestats.totaltime);
   tv->saved_remotestats = current_remote_stats;
   if (token)
@@ -2855,12 +2859,25 @@ print_diff (struct mi_timestamp *start, struct mi_timestamp *end)
       fprintf_unfiltered (raw_stdout,
         ",remotestats={packets_sent=\"%d\",packets_received=\"%d\","
         "acks_sent=\"%d\",acks_received=\"%d\","
+        /* APPLE LOCAL no-ack mode  */
+        "round_trips=\"%d\","
+        /* APPLE LOCAL register batching  */
+        "register_packets=\"%d\","
         "time=\"%0.5f\","
-        "total_packets_sent=\"%lld\",total_packets_received=\"%lld\"}",
+        "total_packets_sent=\"%lld\",total_packets_received=\"%lld\","
+        /* APPLE LOCAL no-ack mode  */
+        "total_round_trips=\"%lld\"}",
         start->remotestats.pkt_sent, start->remotestats.pkt_recvd,
         start->remotestats.acks_sent, start->remotestats.acks_recvd,
+        /* APPLE LOCAL no-ack mode  */
+        start->remotestats.round_trips,
+        /* APPLE LOCAL register batching  */
+        start->remotestats.register_packets,
         (double) ((start->remotestats.totaltime.tv_sec * 1000000) + start->remotestats.totaltime.tv_usec) / 1000000.0,
-        total_packets_sent, total_packets_received);
+        (long long) total_packets_sent,
+        (long long) total_packets_received,
+        /* APPLE LOCAL no-ack mode  */
+        (long long) total_round_trips);
     }
 }
 
@@ -106,34 +106,113 @@ msymbol_hash (const char *string)
   return hash;
 }
 
-/* Add the minimal symbol SYM to an objfile's minsym hash table, TABLE.  */
+/* APPLE LOCAL begin sized msymbol hash  */
+/* Add the minimal symbol SYM to OBJFILE's minsym hash table.  */
 void
 add_minsym_to_hash_table (struct minimal_symbol *sym,
-			  struct minimal_symbol **table)
+			  struct objfile *objfile)
 {
   if (sym->hash_next == NULL)
     {
-      unsigned int hash
-	= msymbol_hash (SYMBOL_LINKAGE_NAME (sym)) % MINIMAL_SYMBOL_HASH_SIZE;
-      sym->hash_next = table[hash];
-      table[hash] = sym;
+      unsigned int hash = msymbol_hash (SYMBOL_LINKAGE_NAME (sym));
+      unsigned int index = hash % objfile->msymbol_hash_size;
+
+      sym->hash_value = hash;
+      sym->hash_next = objfile->msymbol_hash[index];
+      objfile->msymbol_hash[index] = sym;
     }
 }
 
-/* Add the minimal symbol SYM to an objfile's minsym demangled hash table,
-   TABLE.  */
+/* Add the minimal symbol SYM to OBJFILE's minsym demangled hash
+   table.  */
 static void
 add_minsym_to_demangled_hash_table (struct minimal_symbol *sym,
-                                  struct minimal_symbol **table)
+				    struct objfile *objfile)
 {
   if (sym->demangled_hash_next == NULL)
     {
-      unsigned int hash = msymbol_hash_iw (SYMBOL_DEMANGLED_NAME (sym)) % MINIMAL_SYMBOL_HASH_SIZE;
-      sym->demangled_hash_next = table[hash];
-      table[hash] = sym;
+      unsigned int hash = msymbol_hash_iw (SYMBOL_DEMANGLED_NAME (sym));
+      unsigned int index = hash % objfile->msymbol_hash_size;
+
+      sym->demangled_hash_value = hash;
+      sym->demangled_hash_next = objfile->msymbol_demangled_hash[index];
+      objfile->msymbol_demangled_hash[index] = sym;
+    }
+}
+
+/* Return the number of buckets to use for the minimal symbol hash
+   tables of an objfile with COUNT minimal symbols: the smallest prime
+   from the table below that keeps the average chain length at or
+   under one, but never less than MINIMAL_SYMBOL_HASH_SIZE.  */
+
+static unsigned int
+minimal_symbol_hash_size (int count)
+{
+  static const unsigned int primes[] =
+  {
+    MINIMAL_SYMBOL_HASH_SIZE, 4093, 8191, 16381, 32749, 65521, 131071,
+    262139, 524287, 1048573, 2097143, 4194301, 8388593, 16777213,
+    33554393, 67108859, 134217689, 268435399, 536870909, 1073741789
+  };
+  int i;
+
+  for (i = 0; i < ARRAY_SIZE (primes) - 1; i++)
+    if (primes[i] >= (unsigned int) count)
+      break;
+  return primes[i];
+}
+
+/* Print the chain length statistics of OBJFILE's minimal symbol
+   hash table named NAME: the demangled name table if DEMANGLED_P,
+   else the linkage name table.  */
+
+static void
+print_minimal_symbol_hash_table_statistics (struct objfile *objfile,
+					    const char *name, int demangled_p)
+{
+  struct minimal_symbol **table;
+  unsigned int i, used = 0;
+  int entries = 0, longest = 0;
+
+  table = demangled_p ? objfile->msymbol_demangled_hash : objfile->msymbol_hash;
+  for (i = 0; i < objfile->msymbol_hash_size; i++)
+    {
+      struct minimal_symbol *msym;
+      int length = 0;
+
+      for (msym = table[i]; msym != NULL;
+	   msym = demangled_p ? msym->demangled_hash_next : msym->hash_next)
+	length++;
+
+      if (length > 0)
+	used++;
+      if (length > longest)
+	longest = length;
+      entries += length;
     }
+
+  printf_filtered (_("    %s: %d entries, %u of %u buckets used, "
+		     "longest chain %d, average chain %.2f\n"),
+		   name, entries, used, objfile->msymbol_hash_size, longest,
+		   used ? (double) entries / used : 0.0);
 }
 
+/* Print the statistics of OBJFILE's minimal symbol hash tables, for
+   "maint print statistics".  */
+
+void
+print_minimal_symbol_hash_statistics (struct objfile *objfile)
+{
+  if (objfile->msymbol_hash_size == 0)
+    return;
+
+  printf_filtered (_("  Minimal symbol hash tables:\n"));
+  print_minimal_symbol_hash_table_statistics (objfile, _("Linkage names"), 0);
+  print_minimal_symbol_hash_table_statistics (objfile, _("Demangled names"),
+					      1);
+}
+/* APPLE LOCAL end sized msymbol hash  */
+
 /* APPLE LOCAL begin return multiple symbols  */
 
 /* This function is very similar to lookup_minimal_symbol, except that it attempts
@@ -152,8 +231,10 @@ lookup_minimal_symbol_all (const char *name, const char *sfile,
   struct minimal_symbol *trampoline_symbol = NULL;
   struct minimal_symbol *ret_symbol;
 
-  unsigned int hash = msymbol_hash (name) % MINIMAL_SYMBOL_HASH_SIZE;
-  unsigned int dem_hash = msymbol_hash_iw (name) % MINIMAL_SYMBOL_HASH_SIZE;
+  /* APPLE LOCAL begin sized msymbol hash  */
+  unsigned int hash = msymbol_hash (name);
+  unsigned int dem_hash = msymbol_hash_iw (name);
+  /* APPLE LOCAL end sized msymbol hash  */
 
 #ifdef SOFUN_ADDRESS_MAYBE_MISSING
   if (sfile != NULL)
@@ -179,20 +260,27 @@ lookup_minimal_symbol_all (const char *name, const char *sfile,
 	       pass++)
 	    {
 	      /* Select hash list according to pass.  */
+	      /* APPLE LOCAL begin sized msymbol hash  */
 	      if (pass == 1)
-		msymbol = objfile->msymbol_hash[hash];
+		msymbol = MSYMBOL_HASH_BUCKET (objfile, hash);
 	      else
-		msymbol = objfile->msymbol_demangled_hash[dem_hash];
+		msymbol = MSYMBOL_DEMANGLED_HASH_BUCKET (objfile, dem_hash);
+	      /* APPLE LOCAL end sized msymbol hash  */
 
 	      while (msymbol != NULL 
 		     && found_symbol == NULL
 		     && found_file_symbol == NULL)
 		{
-		  if ((strcmp (DEPRECATED_SYMBOL_NAME (msymbol), (name)) == 0
+		  /* APPLE LOCAL begin sized msymbol hash  */
+		  if ((pass == 1
+		       ? msymbol->hash_value == hash
+		       : msymbol->demangled_hash_value == dem_hash)
+		      && (strcmp (DEPRECATED_SYMBOL_NAME (msymbol), (name)) == 0
 		      || (SYMBOL_DEMANGLED_NAME (msymbol) != NULL
 			  && strcmp_iw (SYMBOL_DEMANGLED_NAME (msymbol),
 					(name)) == 0))
 		      && (!MSYMBOL_OBSOLETED (msymbol)))
+		    /* APPLE LOCAL end sized msymbol hash  */
 		    {
 		      switch (MSYMBOL_TYPE (msymbol))
 			{
@@ -317,8 +405,10 @@ lookup_minimal_symbol (const char *name, const char *sfile,
   struct minimal_symbol *found_file_symbol = NULL;
   struct minimal_symbol *trampoline_symbol = NULL;
 
-  unsigned int hash = msymbol_hash (name) % MINIMAL_SYMBOL_HASH_SIZE;
-  unsigned int dem_hash = msymbol_hash_iw (name) % MINIMAL_SYMBOL_HASH_SIZE;
+  /* APPLE LOCAL begin sized msymbol hash  */
+  unsigned int hash = msymbol_hash (name);
+  unsigned int dem_hash = msymbol_hash_iw (name);
+  /* APPLE LOCAL end sized msymbol hash  */
 
 #ifdef SOFUN_ADDRESS_MAYBE_MISSING
   if (sfile != NULL)
@@ -342,10 +432,12 @@ lookup_minimal_symbol (const char *name, const char *sfile,
 	  for (pass = 1; pass <= 2 && found_symbol == NULL; pass++)
 	    {
 	      /* Select hash list according to pass.  */
+	      /* APPLE LOCAL begin sized msymbol hash  */
 	      if (pass == 1)
-		msymbol = objfile->msymbol_hash[hash];
+		msymbol = MSYMBOL_HASH_BUCKET (objfile, hash);
 	      else
-		msymbol = objfile->msymbol_demangled_hash[dem_hash];
+		msymbol = MSYMBOL_DEMANGLED_HASH_BUCKET (objfile, dem_hash);
+	      /* APPLE LOCAL end sized msymbol hash  */
 
 	      while (msymbol != NULL && found_symbol == NULL)
 		{
@@ -355,7 +447,14 @@ lookup_minimal_symbol (const char *name, const char *sfile,
 		     do that.  If you want to test the natural names
 		     with strcmp_iw, use SYMBOL_MATCHES_NATURAL_NAME.  */
                   /* APPLE LOCAL fix-and-continue */
-		  if ((strcmp (DEPRECATED_SYMBOL_NAME (msymbol), (name)) == 0
+		  /* APPLE LOCAL begin sized msymbol hash  */
+		  /* Entries whose full hash differs can't match; skip
+		     the string compares for them.  */
+		  if ((pass == 1
+		       ? msymbol->hash_value == hash
+		       : msymbol->demangled_hash_value == dem_hash)
+		      /* APPLE LOCAL end sized msymbol hash  */
+		      && (strcmp (DEPRECATED_SYMBOL_NAME (msymbol), (name)) == 0
 		      || (SYMBOL_DEMANGLED_NAME (msymbol) != NULL
 			  && strcmp_iw (SYMBOL_DEMANGLED_NAME (msymbol),
 					(name)) == 0))
@@ -444,7 +543,8 @@ lookup_minimal_symbol_text (const char *name, struct objfile *objf)
   struct minimal_symbol *found_symbol = NULL;
   struct minimal_symbol *found_file_symbol = NULL;
 
-  unsigned int hash = msymbol_hash (name) % MINIMAL_SYMBOL_HASH_SIZE;
+  /* APPLE LOCAL sized msymbol hash  */
+  unsigned int hash = msymbol_hash (name);
 
   for (objfile = objfile_get_first ();
        objfile != NULL && found_symbol == NULL;
@@ -452,12 +552,15 @@ lookup_minimal_symbol_text (const char *name, struct objfile *objf)
     {
       if (objf == NULL || objf == objfile)
 	{
-	  for (msymbol = objfile->msymbol_hash[hash];
+	  /* APPLE LOCAL sized msymbol hash  */
+	  for (msymbol = MSYMBOL_HASH_BUCKET (objfile, hash);
 	       msymbol != NULL && found_symbol == NULL;
 	       msymbol = msymbol->hash_next)
 	    {
               /* APPLE LOCAL fix-and-continue */
-	      if (strcmp (SYMBOL_LINKAGE_NAME (msymbol), name) == 0 &&
+	      /* APPLE LOCAL sized msymbol hash  */
+	      if (msymbol->hash_value == hash &&
+		  strcmp (SYMBOL_LINKAGE_NAME (msymbol), name) == 0 &&
 		  (MSYMBOL_TYPE (msymbol) == mst_text ||
 		   MSYMBOL_TYPE (msymbol) == mst_file_text) &&
                   !MSYMBOL_OBSOLETED (msymbol))
@@ -502,7 +605,8 @@ lookup_minimal_symbol_solib_trampoline (const char *name,
   struct minimal_symbol *msymbol;
   struct minimal_symbol *found_symbol = NULL;
 
-  unsigned int hash = msymbol_hash (name) % MINIMAL_SYMBOL_HASH_SIZE;
+  /* APPLE LOCAL sized msymbol hash  */
+  unsigned int hash = msymbol_hash (name);
 
   for (objfile = object_files;
        objfile != NULL && found_symbol == NULL;
@@ -510,12 +614,15 @@ lookup_minimal_symbol_solib_trampoline (const char *name,
     {
       if (objf == NULL || objf == objfile)
 	{
-	  for (msymbol = objfile->msymbol_hash[hash];
+	  /* APPLE LOCAL sized msymbol hash  */
+	  for (msymbol = MSYMBOL_HASH_BUCKET (objfile, hash);
 	       msymbol != NULL && found_symbol == NULL;
 	       msymbol = msymbol->hash_next)
 	    {
               /* APPLE LOCAL fix-and-continue */
-	      if (strcmp (SYMBOL_LINKAGE_NAME (msymbol), name) == 0 &&
+	      /* APPLE LOCAL sized msymbol hash  */
+	      if (msymbol->hash_value == hash &&
+		  strcmp (SYMBOL_LINKAGE_NAME (msymbol), name) == 0 &&
 		  MSYMBOL_TYPE (msymbol) == mst_solib_trampoline &&
                   !MSYMBOL_OBSOLETED (msymbol))
 		return msymbol;
@@ -1022,27 +1129,42 @@ build_minimal_symbol_hash_tables (struct objfile *objfile)
 {
   int i;
   struct minimal_symbol *msym;
-
-  /* Clear the hash tables. */
-  for (i = 0; i < MINIMAL_SYMBOL_HASH_SIZE; i++)
+  /* APPLE LOCAL begin sized msymbol hash  */
+  unsigned int size;
+
+  /* Size the tables so that chains stay short however many minimal
+     symbols the objfile has.  The old tables, if any, stay on the
+     obstack, like the old msymbols vector does.  */
+  size = minimal_symbol_hash_size (objfile->minimal_symbol_count);
+  if (objfile->msymbol_hash == NULL || objfile->msymbol_hash_size != size)
     {
-      objfile->msymbol_hash[i] = 0;
-      objfile->msymbol_demangled_hash[i] = 0;
+      objfile->msymbol_hash = (struct minimal_symbol **)
+	obstack_alloc (&objfile->objfile_obstack,
+		       size * sizeof (struct minimal_symbol *));
+      objfile->msymbol_demangled_hash = (struct minimal_symbol **)
+	obstack_alloc (&objfile->objfile_obstack,
+		       size * sizeof (struct minimal_symbol *));
+      objfile->msymbol_hash_size = size;
     }
 
+  /* Clear the hash tables. */
+  memset (objfile->msymbol_hash, 0, size * sizeof (struct minimal_symbol *));
+  memset (objfile->msymbol_demangled_hash, 0,
+	  size * sizeof (struct minimal_symbol *));
+
   /* Now, (re)insert the actual entries. */
   for (i = objfile->minimal_symbol_count, msym = objfile->msymbols;
        i > 0;
        i--, msym++)
     {
       msym->hash_next = 0;
-      add_minsym_to_hash_table (msym, objfile->msymbol_hash);
+      add_minsym_to_hash_table (msym, objfile);
 
       msym->demangled_hash_next = 0;
       if (SYMBOL_SEARCH_NAME (msym) != SYMBOL_LINKAGE_NAME (msym))
-	add_minsym_to_demangled_hash_table (msym,
-                                            objfile->msymbol_demangled_hash);
+	add_minsym_to_demangled_hash_table (msym, objfile);
     }
+  /* APPLE LOCAL end sized msymbol hash  */
 }
 
 /* Add the minimal symbols in the existing bunches to the objfile's official
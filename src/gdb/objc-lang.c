@@ -603,6 +603,10 @@ objc_printstr (struct ui_file *stream, const gdb_byte *string,
   /* If the string was not truncated due to `set print elements', and
      the last byte of it is a null, we don't print that, in
      traditional C style.  */
+  /* APPLE LOCAL begin partial lazy values  */
+  if (length > 0)
+    val_print_fetch (string + length - 1, 1);
+  /* APPLE LOCAL end partial lazy values  */
   if ((!force_ellipses) && length > 0 && string[length-1] == '\0')
     length--;
 
@@ -628,13 +632,21 @@ objc_printstr (struct ui_file *stream, const gdb_byte *string,
 	  need_comma = 0;
 	}
 
+      /* APPLE LOCAL begin partial lazy values  */
+      /* Only read the characters we print, or count as repeats of one
+	 we print.  */
+      val_print_fetch (string + i, 1);
       rep1 = i + 1;
       reps = 1;
-      while (rep1 < length && string[rep1] == string[i])
+      while (rep1 < length)
 	{
+	  val_print_fetch (string + rep1, 1);
+	  if (string[rep1] != string[i])
+	    break;
 	  ++rep1;
 	  ++reps;
 	}
+      /* APPLE LOCAL end partial lazy values  */
 
       if (reps > repeat_count_threshold)
 	{
@@ -1047,6 +1047,8 @@ free_objfile_internal (struct objfile *objfile)
   /* Free the obstacks for non-reusable objfiles */
   bcache_xfree (objfile->psymbol_cache);
   bcache_xfree (objfile->macro_cache);
+  /* APPLE LOCAL psymtab indexes  */
+  invalidate_psymtab_indexes (objfile);
   /* APPLE LOCAL: Also free up the table of "equivalent symbols".  */
   equivalence_table_delete (objfile);
   /* END APPLE LOCAL */
@@ -1330,6 +1332,8 @@ objfile_relocate (struct objfile *objfile, struct section_offsets *new_offsets)
       p->textlow += ANOFFSET (delta, SECT_OFF_TEXT (objfile));
       p->texthigh += ANOFFSET (delta, SECT_OFF_TEXT (objfile));
     }
+    /* APPLE LOCAL psymtab addrmap  */
+    invalidate_psymtab_addrmap (objfile);
   }
 
   {
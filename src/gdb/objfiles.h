@@ -35,6 +35,14 @@ struct bcache;
 struct htab;
 struct symtab;
 struct objfile_data;
+/* APPLE LOCAL psymtab addrmap  */
+struct psymtab_addrmap;
+/* APPLE LOCAL psymtab name index  */
+struct psymtab_name_index;
+/* APPLE LOCAL completion name index  */
+struct completion_name_index;
+/* APPLE LOCAL symtab filename index  */
+struct symtab_filename_index;
 
 /* This structure maintains information on a per-objfile basis about the
    "entry point" of the objfile, and the scope within which the entry point
@@ -210,9 +218,24 @@ struct objstats
 extern void print_objfile_statistics (void);
 extern void print_symbol_bcache_statistics (void);
 
-/* Number of entries in the minimal symbol hash table.  */
+/* APPLE LOCAL begin sized msymbol hash  */
+/* Minimum number of entries in the minimal symbol hash tables.  The
+   tables are sized from the number of minimal symbols of the objfile,
+   see build_minimal_symbol_hash_tables.  */
 #define MINIMAL_SYMBOL_HASH_SIZE 2039
 
+/* The hash chains of OBJFILE that may hold a minimal symbol whose
+   linkage name (resp. demangled name) hashes to HASH, as computed by
+   msymbol_hash (resp. msymbol_hash_iw).  NULL if OBJFILE has no
+   minimal symbols.  */
+#define MSYMBOL_HASH_BUCKET(objfile, hash)				\
+  ((objfile)->msymbol_hash_size == 0 ? NULL				\
+   : (objfile)->msymbol_hash[(hash) % (objfile)->msymbol_hash_size])
+#define MSYMBOL_DEMANGLED_HASH_BUCKET(objfile, hash)			\
+  ((objfile)->msymbol_hash_size == 0 ? NULL				\
+   : (objfile)->msymbol_demangled_hash[(hash) % (objfile)->msymbol_hash_size])
+/* APPLE LOCAL end sized msymbol hash  */
+
 /* Master structure for keeping track of each file from which
    gdb reads symbols.  There are several ways these get allocated: 1.
    The main symbol file, symfile_objfile, set by the symbol-file command,
@@ -272,6 +295,39 @@ struct objfile
 
     struct partial_symtab *free_psymtabs;
 
+    /* APPLE LOCAL begin psymtab addrmap  */
+    /* Interval index over the text ranges of PSYMTABS, used by
+       find_pc_sect_psymtab.  Built lazily and discarded whenever the
+       psymtab list or the psymtab ranges change.  Malloc'd.  */
+
+    struct psymtab_addrmap *psymtab_addrmap;
+    /* APPLE LOCAL end psymtab addrmap  */
+
+    /* APPLE LOCAL begin psymtab name index  */
+    /* Hash table from psymbol names to the PSYMTABS defining them,
+       used by global symbol lookups.  Built lazily and discarded
+       whenever the psymtab list changes.  Malloc'd.  */
+
+    struct psymtab_name_index *psymtab_name_index;
+    /* APPLE LOCAL end psymtab name index  */
+
+    /* APPLE LOCAL begin completion name index  */
+    /* Sorted array of the psymbol and msymbol names, used by symbol
+       completion.  Built lazily and discarded whenever the psymtab
+       list or the minimal symbols change.  Malloc'd.  */
+
+    struct completion_name_index *completion_name_index;
+    /* APPLE LOCAL end completion name index  */
+
+    /* APPLE LOCAL begin symtab filename index  */
+    /* Hash table from the basenames of the SYMTABS and PSYMTABS
+       filenames to the symtabs and psymtabs, used to look up source
+       files by name.  Built lazily and discarded whenever the
+       psymtab list changes.  Malloc'd.  */
+
+    struct symtab_filename_index *symtab_filename_index;
+    /* APPLE LOCAL end symtab filename index  */
+
     /* The object file's BFD.  Can be null if the objfile contains only
        minimal symbols, e.g. the run time common symbols for SunOS4.  */
 
@@ -318,14 +374,20 @@ struct objfile
     struct minimal_symbol *msymbols;
     int minimal_symbol_count;
 
-    /* This is a hash table used to index the minimal symbols by name.  */
+    /* APPLE LOCAL begin sized msymbol hash  */
+    /* This is a hash table used to index the minimal symbols by name.
+       It has MSYMBOL_HASH_SIZE buckets and lives on the
+       objfile_obstack.  Use MSYMBOL_HASH_BUCKET to index it.  */
 
-   struct minimal_symbol *msymbol_hash[MINIMAL_SYMBOL_HASH_SIZE];
+    struct minimal_symbol **msymbol_hash;
 
     /* This hash table is used to index the minimal symbols by their
-       demangled names.  */
+       demangled names.  Same size as MSYMBOL_HASH.  */
+
+    struct minimal_symbol **msymbol_demangled_hash;
 
-    struct minimal_symbol *msymbol_demangled_hash[MINIMAL_SYMBOL_HASH_SIZE];
+    unsigned int msymbol_hash_size;
+    /* APPLE LOCAL end sized msymbol hash  */
 
     int minimal_symbols_demangled;
 
@@ -39,10 +39,16 @@
 #include "gdbthread.h"
 #include "remote.h"
 #include "regcache.h"
+/* APPLE LOCAL register batching  */
+#include "user-regs.h"
 #include "value.h"
 #include "gdb_assert.h"
 #include "observer.h"
 #include "solib.h"
+/* APPLE LOCAL begin target-side breakpoint conditions  */
+#include "ax.h"
+#include "ax-gdb.h"
+/* APPLE LOCAL end target-side breakpoint conditions  */
 
 #include <ctype.h>
 #include <sys/time.h>
@@ -70,6 +76,8 @@
 static void cleanup_sigint_signal_handler (void *dummy);
 static void initialize_sigint_signal_handler (void);
 static int getpkt_sane (char *buf, long sizeof_buf, int forever);
+/* APPLE LOCAL binary memory read  */
+static int getpkt_binary (char *buf, long sizeof_buf, int forever, long *lenp);
 
 static void handle_remote_sigint (int);
 static void handle_remote_sigint_twice (int);
@@ -216,6 +224,10 @@ struct packet_reg
   long regnum; /* GDB's internal register number.  */
   LONGEST pnum; /* Remote protocol register number.  */
   int in_g_packet; /* Always part of G packet.  */
+  /* APPLE LOCAL register batching  */
+  /* One more than the stop count when gdb last had to fetch this
+     register by itself, or zero if it never has.  */
+  uint64_t fetched_stop;
   /* long size in bytes;  == register_size (current_gdbarch, regnum);
      at present.  */
   /* char *name; == REGISTER_NAME (regnum); at present.  */
@@ -251,6 +263,8 @@ struct remote_state
 struct remote_stats *current_remote_stats = NULL;
 uint64_t total_packets_sent = 0;
 uint64_t total_packets_received = 0;
+/* APPLE LOCAL no-ack mode  */
+uint64_t total_round_trips = 0;
 char *remote_debugflags = NULL;
 
 #define PROTOCOL_LOG_BUFSIZE 3072
@@ -286,6 +300,79 @@ struct protocol_log {
 int no_ack_mode = 0;
 enum auto_boolean user_requested_no_ack_mode = AUTO_BOOLEAN_AUTO;
 
+/* APPLE LOCAL begin no-ack mode  */
+/* Set when the stub advertised "QStartNoAckMode+" in its qSupported
+   reply.  With USER_REQUESTED_NO_ACK_MODE left at auto, we switch to
+   no-ack mode when the stub supports it and the connection is one
+   that can't drop or corrupt characters.  */
+static int remote_stub_no_ack_p = 0;
+
+/* Count one exchange in which gdb has to wait for the stub: a reply
+   packet, or an ack for a packet we sent.  Comparing this with the
+   packet counts shows what no-ack mode saves.  */
+
+static void
+note_remote_round_trip (void)
+{
+  if (current_remote_stats)
+    current_remote_stats->round_trips++;
+  total_round_trips++;
+}
+/* APPLE LOCAL end no-ack mode  */
+
+/* APPLE LOCAL begin register batching  */
+/* Counts of the packets that read, write or expedite registers, and
+   of the stops they were spread over.  REMOTE_STOP_REGISTER_PACKETS
+   counts the packets sent since the last stop; after a stop, a high
+   count means frame unwinding or the register window is still
+   fetching registers one at a time.  */
+static uint64_t total_register_packets = 0;
+static uint64_t total_remote_stops = 0;
+static int remote_stop_register_packets = 0;
+static int remote_last_stop_register_packets = 0;
+
+static void
+note_remote_register_packet (void)
+{
+  if (current_remote_stats)
+    current_remote_stats->register_packets++;
+  total_register_packets++;
+  remote_stop_register_packets++;
+}
+
+/* Registers gdb had to fetch by themselves in the last this many
+   stops are expedited.  Older ones are dropped, so that a register
+   read once, say by "print $xmm0", doesn't stay in every stop reply
+   for good.  One still needed comes back after costing a packet.  */
+#define REMOTE_EXPEDITE_STOPS 16
+
+/* Has gdb had to fetch REG by itself in the last
+   REMOTE_EXPEDITE_STOPS stops?  */
+
+static int
+remote_register_recently_fetched (struct packet_reg *reg)
+{
+  return (reg->fetched_stop != 0
+	  && total_remote_stops + 1 - reg->fetched_stop < REMOTE_EXPEDITE_STOPS);
+}
+
+static void
+note_remote_stop (void)
+{
+  total_remote_stops++;
+  remote_last_stop_register_packets = remote_stop_register_packets;
+  remote_stop_register_packets = 0;
+}
+
+/* Registers the user wants in every stop reply, as register names
+   separated by spaces or commas.  */
+static char *remote_expedite_register_names = NULL;
+
+/* The last QExpediteRegisters packet sent on this connection, or
+   NULL if none.  */
+static char *remote_expedite_sent = NULL;
+/* APPLE LOCAL end register batching  */
+
 /* Handle for retreving the remote protocol data from gdbarch.  */
 static struct gdbarch_data *remote_gdbarch_data_handle;
 
@@ -312,6 +399,17 @@ get_remote_state (void)
 #define DEFAULT_MAX_REMOTE_PACKET_SIZE 2000
 static long g_max_remote_packet_size = DEFAULT_MAX_REMOTE_PACKET_SIZE; 
 
+/* APPLE LOCAL begin binary memory read  */
+/* The PacketSize the stub advertised in its reply to ``qSupported'',
+   or zero if it didn't say.  This is the largest packet (in chars,
+   not counting the framing) the stub is prepared to receive or send,
+   so when it is known it replaces the ``g'' packet heuristic and the
+   MAX_REMOTE_PACKET_SIZE cap for memory transfers.  It is kept
+   outside the per-architecture remote_state so that it survives the
+   architecture changing underneath an open connection.  */
+static long remote_explicit_packet_size = 0;
+/* APPLE LOCAL end binary memory read  */
+
 
 static void *
 init_remote_state (struct gdbarch *gdbarch)
@@ -574,6 +672,31 @@ dump_protocol_log (const char *message)
     }
 }
 
+/* APPLE LOCAL begin no-ack mode  */
+static void
+maintenance_print_remote_statistics (char *args, int from_tty)
+{
+  printf_filtered (_("Packets sent: %llu\n"),
+		   (unsigned long long) total_packets_sent);
+  printf_filtered (_("Packets received: %llu\n"),
+		   (unsigned long long) total_packets_received);
+  printf_filtered (_("Round trips: %llu\n"),
+		   (unsigned long long) total_round_trips);
+  /* APPLE LOCAL begin register batching  */
+  printf_filtered (_("Register packets: %llu over %llu stops\n"),
+		   (unsigned long long) total_register_packets,
+		   (unsigned long long) total_remote_stops);
+  printf_filtered (_("Register packets after the previous stop: %d\n"),
+		   remote_last_stop_register_packets);
+  printf_filtered (_("Register packets since the last stop: %d\n"),
+		   remote_stop_register_packets);
+  /* APPLE LOCAL end register batching  */
+  if (remote_desc != NULL)
+    printf_filtered (_("Acks are %s.\n"),
+		     no_ack_mode ? _("disabled") : _("enabled"));
+}
+/* APPLE LOCAL end no-ack mode  */
+
 void
 dump_packets_command (char *unused, int fromtty)
 {
@@ -609,6 +732,21 @@ get_memory_packet_size (struct memory_packet_config *config)
       else
 	what_they_get = config->size;
     }
+  /* APPLE LOCAL begin binary memory read  */
+  else if (remote_explicit_packet_size > 0)
+    {
+      /* The stub told us exactly how much it can take; the memory
+	 transfer buffers are heap allocated, so there is no need to
+	 second-guess it.  */
+      what_they_get = remote_explicit_packet_size;
+      if (config->size > 0
+	  && what_they_get > config->size)
+	what_they_get = config->size;
+      if (what_they_get < MIN_REMOTE_PACKET_SIZE)
+	what_they_get = MIN_REMOTE_PACKET_SIZE;
+      return what_they_get;
+    }
+  /* APPLE LOCAL end binary memory read  */
   else
     {
       what_they_get = (rs->remote_packet_size);
@@ -769,6 +907,13 @@ get_memory_read_packet_size (void)
 {
   struct remote_state *rs = get_remote_state ();
   long size = get_memory_packet_size (&memory_read_packet_config);
+  /* APPLE LOCAL begin binary memory read  */
+  /* remote_read_bytes allocates a reply buffer of this size, so once
+     the stub has told us its packet size the read packets can grow
+     past (rs->remote_packet_size).  */
+  if (remote_explicit_packet_size > 0)
+    return size;
+  /* APPLE LOCAL end binary memory read  */
   /* FIXME: cagney/1999-11-07: Functions like getpkt() need to get an
      extra buffer size argument before the memory read size can be
      increased beyond (rs->remote_packet_size).  */
@@ -1149,21 +1294,86 @@ start_no_ack_mode ()
   return;
 }
 
+/* APPLE LOCAL begin no-ack mode  */
+/* Return non-zero if the remote connection is a byte stream that
+   already guarantees delivery (a TCP socket or a pipe), so that the
+   protocol's own acknowledgements buy nothing.  Serial lines keep
+   them.  */
+
+static int
+remote_transport_reliable_p (void)
+{
+  const char *name;
+
+  if (remote_desc == NULL || remote_desc->ops == NULL)
+    return 0;
+
+  name = remote_desc->ops->name;
+  return (strcmp (name, "tcp") == 0 || strcmp (name, "pipe") == 0);
+}
+
+/* Switch to no-ack mode right after the qSupported handshake if the
+   user asked for it, or if it was left on auto and both the stub and
+   the transport allow it.  */
+
 static void
-set_no_ack_mode_cmd (char *args, int from_tty, struct cmd_list_element *c)
+remote_maybe_start_no_ack_mode (void)
 {
-  user_requested_no_ack_mode = AUTO_BOOLEAN_TRUE;
+  if (no_ack_mode)
+    return;
+
+  switch (user_requested_no_ack_mode)
+    {
+    case AUTO_BOOLEAN_TRUE:
+      start_no_ack_mode ();
+      break;
+    case AUTO_BOOLEAN_AUTO:
+      if (remote_stub_no_ack_p && remote_transport_reliable_p ())
+	start_no_ack_mode ();
+      break;
+    case AUTO_BOOLEAN_FALSE:
+      break;
+    }
+}
+/* APPLE LOCAL end no-ack mode  */
 
+static void
+set_no_ack_mode_cmd (char *args, int from_tty, struct cmd_list_element *c)
+{
   if (remote_desc == NULL)  /* Are we connected yet? */
     return;
 
-  start_no_ack_mode ();
+  /* APPLE LOCAL begin no-ack mode  */
+  /* There is no packet to turn acks back on; that takes effect at the
+     next connection.  */
+  if (user_requested_no_ack_mode == AUTO_BOOLEAN_FALSE && no_ack_mode)
+    {
+      printf_filtered (_("Acks will be used again after reconnecting "
+			 "to the remote stub.\n"));
+      return;
+    }
+
+  remote_maybe_start_no_ack_mode ();
+  /* APPLE LOCAL end no-ack mode  */
 }
 
 static void
 show_no_ack_mode_cmd (struct ui_file *file, int from_tty, 
                       struct cmd_list_element *c, const char *value)
 {
+  /* APPLE LOCAL begin no-ack mode  */
+  if (user_requested_no_ack_mode == AUTO_BOOLEAN_AUTO)
+    {
+      if (remote_desc == 0)
+	printf_filtered ("No ack mode is auto-detected; not yet connected "
+			 "to remote stub.\n");
+      else if (no_ack_mode)
+	printf_filtered ("No ack mode is auto-detected, currently enabled.\n");
+      else
+	printf_filtered ("No ack mode is auto-detected, currently disabled.\n");
+      return;
+    }
+  /* APPLE LOCAL end no-ack mode  */
   if (user_requested_no_ack_mode != AUTO_BOOLEAN_TRUE)
     {
       printf_filtered ("No ack mode is not enabled.\n");
@@ -1339,6 +1549,124 @@ show_remote_protocol_binary_download_cmd (struct ui_file *file, int from_tty,
   show_packet_config_cmd (&remote_protocol_binary_download);
 }
 
+/* APPLE LOCAL begin binary memory read  */
+/* Should we try the 'x' (remote binary upload) packet?
+
+   This is the read-side counterpart of the 'X' packet: memory comes
+   back as escaped binary instead of hex, halving the size of the
+   reply.  Unlike 'X' we never probe for it blindly, since other
+   stubs have used the letter for different purposes; it is only
+   used when the stub advertises "binary-upload+" in its qSupported
+   reply, or when the user forces it on.  */
+
+static struct packet_config remote_protocol_binary_upload;
+
+static void
+set_remote_protocol_binary_upload_cmd (char *args,
+				       int from_tty,
+				       struct cmd_list_element *c)
+{
+  update_packet_config (&remote_protocol_binary_upload);
+}
+
+static void
+show_remote_protocol_binary_upload_cmd (struct ui_file *file, int from_tty,
+					struct cmd_list_element *c,
+					const char *value)
+{
+  show_packet_config_cmd (&remote_protocol_binary_upload);
+}
+
+/* Should we send a 'qSupported' (feature negotiation) request when
+   we connect?  */
+static struct packet_config remote_protocol_qSupported;
+
+static void
+set_remote_protocol_qSupported_packet_cmd (char *args, int from_tty,
+					   struct cmd_list_element *c)
+{
+  update_packet_config (&remote_protocol_qSupported);
+}
+
+static void
+show_remote_protocol_qSupported_packet_cmd (struct ui_file *file,
+					    int from_tty,
+					    struct cmd_list_element *c,
+					    const char *value)
+{
+  show_packet_config_cmd (&remote_protocol_qSupported);
+}
+/* APPLE LOCAL end binary memory read  */
+
+/* APPLE LOCAL begin target-side breakpoint conditions  */
+/* Should we send breakpoint conditions along with 'Z0' packets, so
+   the stub can skip hits where the condition is false without
+   stopping to ask us?  Only used when the stub advertises
+   "ConditionalBreakpoints+" in its qSupported reply, or when the user
+   forces it on.  */
+
+static struct packet_config remote_protocol_conditional_breakpoints;
+
+static void
+set_remote_protocol_conditional_breakpoints_cmd (char *args, int from_tty,
+						 struct cmd_list_element *c)
+{
+  update_packet_config (&remote_protocol_conditional_breakpoints);
+}
+
+static void
+show_remote_protocol_conditional_breakpoints_cmd (struct ui_file *file,
+						  int from_tty,
+						  struct cmd_list_element *c,
+						  const char *value)
+{
+  show_packet_config_cmd (&remote_protocol_conditional_breakpoints);
+}
+/* APPLE LOCAL end target-side breakpoint conditions  */
+
+/* APPLE LOCAL begin register batching  */
+/* Should we read several registers at once with 'qReadRegisters',
+   and tell the stub which registers to include in its stop replies
+   with 'QExpediteRegisters'?  Only used when the stub advertises them
+   in its qSupported reply, or when the user forces them on.  */
+
+static struct packet_config remote_protocol_qReadRegisters;
+
+static void
+set_remote_protocol_qReadRegisters_packet_cmd (char *args, int from_tty,
+					       struct cmd_list_element *c)
+{
+  update_packet_config (&remote_protocol_qReadRegisters);
+}
+
+static void
+show_remote_protocol_qReadRegisters_packet_cmd (struct ui_file *file,
+						int from_tty,
+						struct cmd_list_element *c,
+						const char *value)
+{
+  show_packet_config_cmd (&remote_protocol_qReadRegisters);
+}
+
+static struct packet_config remote_protocol_QExpediteRegisters;
+
+static void
+set_remote_protocol_QExpediteRegisters_packet_cmd (char *args, int from_tty,
+						   struct cmd_list_element *c)
+{
+  update_packet_config (&remote_protocol_QExpediteRegisters);
+}
+
+static void
+show_remote_protocol_QExpediteRegisters_packet_cmd (struct ui_file *file,
+						    int from_tty,
+						    struct cmd_list_element *c,
+						    const char *value)
+{
+  show_packet_config_cmd (&remote_protocol_QExpediteRegisters);
+}
+/* APPLE LOCAL end register batching  */
+
 /* Should we try the 'qPart:auxv' (target auxiliary vector read) request?  */
 static struct packet_config remote_protocol_qPart_auxv;
 
@@ -1464,6 +1792,264 @@ set_thread (int th, int gen)
     continue_thread = th;
 }
 
+/* APPLE LOCAL begin incremental thread list  */
+/* Should we ask for the changes to the thread list with
+   'qThreadChanges'?  Only stubs which report a thread list
+   generation in their stop replies are asked.  */
+
+static struct packet_config remote_protocol_qThreadChanges;
+
+static void
+set_remote_protocol_qThreadChanges_packet_cmd (char *args, int from_tty,
+					       struct cmd_list_element *c)
+{
+  update_packet_config (&remote_protocol_qThreadChanges);
+}
+
+static void
+show_remote_protocol_qThreadChanges_packet_cmd (struct ui_file *file,
+						int from_tty,
+						struct cmd_list_element *c,
+						const char *value)
+{
+  show_packet_config_cmd (&remote_protocol_qThreadChanges);
+}
+
+/* Our copy of the stub's thread list, sorted by thread id.  A stub
+   which numbers the changes to its thread list (its "generation")
+   reports the current generation, and usually the changes, in each
+   stop reply; with those, and 'qThreadChanges' when a stop reply
+   couldn't carry them all, we keep this copy up to date, and can
+   list or check threads without asking the stub about each one.  */
+
+struct remote_thread_entry
+{
+  int tid;
+
+  /* The thread's qThreadExtraInfo string, and the stop it was read
+     at, or NULL.  */
+  char *extra_info;
+  uint64_t extra_info_stop;
+};
+
+static struct remote_thread_entry *remote_thread_cache;
+static int remote_thread_cache_count;
+static int remote_thread_cache_size;
+
+/* Non-zero if REMOTE_THREAD_CACHE holds the stub's thread list as of
+   generation REMOTE_THREAD_CACHE_GEN.  */
+static int remote_thread_cache_valid;
+static ULONGEST remote_thread_cache_gen;
+
+/* The generation the stub reported when it last stopped, if it did;
+   the list can't change until we resume it.  */
+static int remote_stub_thread_gen_p;
+static ULONGEST remote_stub_thread_gen;
+
+static void
+remote_thread_cache_clear (void)
+{
+  int i;
+
+  for (i = 0; i < remote_thread_cache_count; i++)
+    xfree (remote_thread_cache[i].extra_info);
+  remote_thread_cache_count = 0;
+  remote_thread_cache_valid = 0;
+}
+
+/* Return the entry for TID, or NULL if there isn't one.  If INDEX is
+   non-NULL, set it to where the entry is or would go.  */
+
+static struct remote_thread_entry *
+remote_thread_cache_lookup (int tid, int *index)
+{
+  int lo = 0, hi = remote_thread_cache_count;
+
+  while (lo < hi)
+    {
+      int mid = lo + (hi - lo) / 2;
+
+      if (remote_thread_cache[mid].tid < tid)
+	lo = mid + 1;
+      else
+	hi = mid;
+    }
+
+  if (index != NULL)
+    *index = lo;
+  if (lo < remote_thread_cache_count && remote_thread_cache[lo].tid == tid)
+    return &remote_thread_cache[lo];
+  return NULL;
+}
+
+static void
+remote_thread_cache_add (int tid)
+{
+  int i;
+
+  if (remote_thread_cache_lookup (tid, &i) != NULL)
+    return;
+
+  if (remote_thread_cache_count == remote_thread_cache_size)
+    {
+      remote_thread_cache_size = remote_thread_cache_size * 2 + 64;
+      remote_thread_cache
+	= xrealloc (remote_thread_cache,
+		    remote_thread_cache_size * sizeof (*remote_thread_cache));
+    }
+
+  memmove (&remote_thread_cache[i + 1], &remote_thread_cache[i],
+	   (remote_thread_cache_count - i) * sizeof (*remote_thread_cache));
+  remote_thread_cache[i].tid = tid;
+  remote_thread_cache[i].extra_info = NULL;
+  remote_thread_cache[i].extra_info_stop = 0;
+  remote_thread_cache_count++;
+}
+
+static void
+remote_thread_cache_remove (int tid)
+{
+  struct remote_thread_entry *entry;
+  int i;
+
+  entry = remote_thread_cache_lookup (tid, &i);
+  if (entry == NULL)
+    return;
+
+  xfree (entry->extra_info);
+  memmove (&remote_thread_cache[i], &remote_thread_cache[i + 1],
+	   (remote_thread_cache_count - i - 1)
+	   * sizeof (*remote_thread_cache));
+  remote_thread_cache_count--;
+}
+
+/* The stub may have added or removed threads without a stop reply
+   to tell us: it runs thread_db and finds new threads when we answer
+   its symbol look-ups, for instance.  Stop trusting the generation
+   from the last stop until the next one.  */
+
+static void
+remote_forget_thread_generation (void)
+{
+  remote_stub_thread_gen_p = 0;
+}
+
+/* Return non-zero if our copy of the thread list is the stub's
+   current one.  */
+
+static int
+remote_thread_cache_current_p (void)
+{
+  return (remote_thread_cache_valid && remote_stub_thread_gen_p
+	  && remote_thread_cache_gen == remote_stub_thread_gen);
+}
+
+/* Count the changes in the list P, which is a comma separated list of
+   '+' or '-' followed by a thread id in hex, ending at a ';' or the
+   end of the string.  Return -1 if the list is malformed.  */
+
+static int
+remote_count_thread_changes (const char *p)
+{
+  int n = 0;
+
+  while (*p != '\0' && *p != ';')
+    {
+      if ((*p != '+' && *p != '-') || !isxdigit (p[1]))
+	return -1;
+      p++;
+      while (isxdigit (*p))
+	p++;
+      n++;
+      if (*p == ',')
+	p++;
+    }
+  return n;
+}
+
+/* Apply the list of changes P, which takes our copy of the thread list
+   from generation GEN - (number of changes) to GEN.  If our copy isn't
+   at that generation, it stays out of date until we ask the stub.  */
+
+static void
+remote_apply_thread_changes (ULONGEST gen, char *p)
+{
+  int n = (p != NULL) ? remote_count_thread_changes (p) : 0;
+
+  if (!remote_thread_cache_valid || n < 0
+      || remote_thread_cache_gen + n != gen)
+    return;
+
+  while (p != NULL && *p != '\0' && *p != ';')
+    {
+      int created = (*p++ == '+');
+      int tid = strtoul (p, &p, 16);
+
+      if (created)
+	remote_thread_cache_add (tid);
+      else
+	remote_thread_cache_remove (tid);
+      if (*p == ',')
+	p++;
+    }
+  remote_thread_cache_gen = gen;
+}
+
+/* Note the thread list generation GEN and the CHANGES (or NULL) from
+   a stop reply.  */
+
+static void
+remote_note_thread_generation (ULONGEST gen, char *changes)
+{
+  remote_stub_thread_gen_p = 1;
+  remote_stub_thread_gen = gen;
+  if (remote_thread_cache_gen != gen)
+    remote_apply_thread_changes (gen, changes);
+}
+
+/* If our copy of the thread list is out of date, ask the stub for
+   what has changed since.  */
+
+static void
+remote_update_thread_cache (void)
+{
+  struct remote_state *rs = get_remote_state ();
+  char *buf;
+  char *p;
+  ULONGEST gen;
+
+  if (!remote_thread_cache_valid || !remote_stub_thread_gen_p
+      || remote_thread_cache_current_p ()
+      || remote_protocol_qThreadChanges.support == PACKET_DISABLE)
+    return;
+
+  buf = alloca (rs->remote_packet_size);
+  xsnprintf (buf, rs->remote_packet_size, "qThreadChanges:%s",
+	     phex_nz (remote_thread_cache_gen, 0));
+  putpkt (buf);
+  getpkt (buf, rs->remote_packet_size, 0);
+  if (packet_ok (buf, &remote_protocol_qThreadChanges) != PACKET_OK)
+    {
+      /* The stub has forgotten some of the changes; start again.  */
+      remote_thread_cache_clear ();
+      return;
+    }
+
+  gen = strtoul (buf, &p, 16);
+  if (p != buf && *p == ':')
+    p++;
+  else if (p == buf || *p != '\0')
+    {
+      warning (_("Invalid reply to qThreadChanges: %s"), buf);
+      remote_thread_cache_clear ();
+      return;
+    }
+  remote_apply_thread_changes (gen, p);
+  if (!remote_thread_cache_current_p ())
+    remote_thread_cache_clear ();
+}
+/* APPLE LOCAL end incremental thread list  */
+
 /*  Return nonzero if the thread TH is still alive on the remote system.  */
 
 static int
@@ -1472,6 +2058,11 @@ remote_thread_alive (ptid_t ptid)
   int tid = PIDGET (ptid);
   char buf[16];
 
+  /* APPLE LOCAL begin incremental thread list  */
+  if (remote_thread_cache_current_p ())
+    return remote_thread_cache_lookup (tid, NULL) != NULL;
+  /* APPLE LOCAL end incremental thread list  */
+
   if (tid < 0)
     xsnprintf (buf, sizeof (buf), "T-%08x", -tid);
   else
@@ -2223,8 +2814,32 @@ remote_threads_info (void)
   if (remote_desc == 0)		/* paranoia */
     error (_("Command can only be used when connected to the remote target."));
 
+  /* APPLE LOCAL begin incremental thread list  */
+  /* If our copy of the thread list is current, or the stub can tell
+     us what changed, there's no need to list every thread.  */
+  remote_update_thread_cache ();
+  if (remote_thread_cache_current_p ())
+    {
+      int i;
+
+      for (i = 0; i < remote_thread_cache_count; i++)
+	{
+	  tid = remote_thread_cache[i].tid;
+	  if (!in_thread_list (ptid_build (tid, 0, tid)))
+	    add_thread (ptid_build (tid, 0, tid));
+	}
+      return;
+    }
+  /* APPLE LOCAL end incremental thread list  */
+
   if (use_threadinfo_query)
     {
+      /* APPLE LOCAL begin incremental thread list  */
+      /* Remember the list, if we know which generation it is.  */
+      int rebuild = remote_stub_thread_gen_p;
+
+      remote_thread_cache_clear ();
+      /* APPLE LOCAL end incremental thread list  */
       putpkt ("qfThreadInfo");
       bufp = buf;
       getpkt (bufp, (rs->remote_packet_size), 0);
@@ -2243,12 +2858,22 @@ remote_threads_info (void)
 		  tid = strtoul (bufp, &bufp, 16);
 		  if (tid != 0 && !in_thread_list (ptid_build (tid, 0, tid)))
 		    add_thread (ptid_build (tid, 0, tid));
+		  /* APPLE LOCAL incremental thread list  */
+		  if (tid != 0 && rebuild)
+		    remote_thread_cache_add (tid);
 		}
 	      while (*bufp++ == ',');	/* comma-separated list */
 	      putpkt ("qsThreadInfo");
 	      bufp = buf;
 	      getpkt (bufp, (rs->remote_packet_size), 0);
 	    }
+	  /* APPLE LOCAL begin incremental thread list  */
+	  if (rebuild)
+	    {
+	      remote_thread_cache_valid = 1;
+	      remote_thread_cache_gen = remote_stub_thread_gen;
+	    }
+	  /* APPLE LOCAL end incremental thread list  */
 	  return;	/* done */
 	}
     }
@@ -2286,15 +2911,35 @@ remote_threads_extra_info (struct thread_info *tp)
 
   if (use_threadextra_query)
     {
+      /* APPLE LOCAL begin incremental thread list  */
+      /* The string can't change until the target runs again, so
+	 keep it until the next stop.  */
+      struct remote_thread_entry *entry = NULL;
+
+      if (remote_thread_cache_current_p ())
+	entry = remote_thread_cache_lookup (PIDGET (tp->ptid), NULL);
+      if (entry != NULL && entry->extra_info != NULL
+	  && entry->extra_info_stop == total_remote_stops)
+	return entry->extra_info;
+      /* APPLE LOCAL end incremental thread list  */
+
       xsnprintf (bufp, rs->remote_packet_size, "qThreadExtraInfo,%x", 
 		 PIDGET (tp->ptid));
       putpkt (bufp);
       getpkt (bufp, (rs->remote_packet_size), 0);
       if (bufp[0] != 0)
 	{
-	  n = min (strlen (bufp) / 2, sizeof (display_buf));
+	  n = min (strlen (bufp) / 2, sizeof (display_buf) - 1);
 	  result = hex2bin (bufp, display_buf, n);
 	  display_buf [result] = '\0';
+	  /* APPLE LOCAL begin incremental thread list  */
+	  if (entry != NULL)
+	    {
+	      xfree (entry->extra_info);
+	      entry->extra_info = xstrdup (display_buf);
+	      entry->extra_info_stop = total_remote_stops;
+	    }
+	  /* APPLE LOCAL end incremental thread list  */
 	  return display_buf;
 	}
     }
@@ -2341,6 +2986,12 @@ extended_remote_restart (void)
   /* Send the restart command; for reasons I don't understand the
      remote side really expects a number after the "R".  */
   xsnprintf (buf, rs->remote_packet_size, "R%x", 0);
+  /* APPLE LOCAL begin incremental thread list  */
+  /* The reply to '?' below isn't parsed, so we won't learn the new
+     process's generation from it.  */
+  remote_thread_cache_clear ();
+  remote_forget_thread_generation ();
+  /* APPLE LOCAL end incremental thread list  */
   putpkt (buf);
 
   /* Now query for status so this looks just like we restarted
@@ -2357,6 +3008,27 @@ remote_close (int quitting)
   if (remote_desc)
     serial_close (remote_desc);
   remote_desc = NULL;
+  /* APPLE LOCAL begin no-ack mode  */
+  /* The next stub starts out expecting acks.  */
+  no_ack_mode = 0;
+  remote_stub_no_ack_p = 0;
+  /* APPLE LOCAL end no-ack mode  */
+  /* APPLE LOCAL begin register batching  */
+  /* The next stub starts out with its default stop replies.  */
+  xfree (remote_expedite_sent);
+  remote_expedite_sent = NULL;
+  {
+    struct remote_state *rs = get_remote_state ();
+    int i;
+
+    for (i = 0; i < NUM_REGS; i++)
+      rs->regs[i].fetched_stop = 0;
+  }
+  /* APPLE LOCAL end register batching  */
+  /* APPLE LOCAL begin incremental thread list  */
+  remote_thread_cache_clear ();
+  remote_stub_thread_gen_p = 0;
+  /* APPLE LOCAL end incremental thread list  */
 }
 
 /* Query the remote side for the text, data and bss offsets.  */
@@ -2443,6 +3115,120 @@ get_offsets (void)
   objfile_relocate (symfile_objfile, offs);
 }
 
+/* APPLE LOCAL begin binary memory read  */
+/* Ask the stub which optional features it supports with a
+   ``qSupported'' request.  The reply is a semicolon separated list
+   of NAME=VALUE, NAME+ or NAME- entries.  We understand:
+
+     PacketSize=SIZE	the largest packet (hex, in chars) the stub
+			can send or receive;
+     binary-upload+	the stub implements the 'x' packet;
+     QStartNoAckMode+	the stub can drop the '+'/'-' acks;
+     ConditionalBreakpoints+
+			the stub evaluates conditions sent with 'Z0';
+     qReadRegisters+	the stub can read several registers at once;
+     QExpediteRegisters+
+			the stub will put the registers we ask for in
+			its stop replies.
+
+   Anything else is ignored, so stubs may advertise features we don't
+   know about yet.  */
+
+static void
+remote_query_supported (void)
+{
+  struct remote_state *rs = get_remote_state ();
+  char *buf = alloca (rs->remote_packet_size);
+  char *p, *next;
+
+  remote_explicit_packet_size = 0;
+  /* APPLE LOCAL no-ack mode  */
+  remote_stub_no_ack_p = 0;
+
+  if (remote_protocol_qSupported.support == PACKET_DISABLE)
+    return;
+
+  putpkt ("qSupported");
+  getpkt (buf, rs->remote_packet_size, 0);
+  if (packet_ok (buf, &remote_protocol_qSupported) != PACKET_OK)
+    return;
+
+  for (p = buf; *p != '\0'; p = next)
+    {
+      next = strchr (p, ';');
+      if (next != NULL)
+	*next++ = '\0';
+      else
+	next = p + strlen (p);
+
+      if (strncmp (p, "PacketSize=", strlen ("PacketSize=")) == 0)
+	{
+	  char *value = p + strlen ("PacketSize=");
+	  char *end;
+	  long size = strtol (value, &end, 16);
+
+	  if (end == value || *end != '\0' || size <= 0)
+	    warning (_("Remote target reported an invalid PacketSize: %s"),
+		     value);
+	  else
+	    remote_explicit_packet_size = size;
+	}
+      else if (strcmp (p, "binary-upload+") == 0)
+	{
+	  if (remote_protocol_binary_upload.support == PACKET_SUPPORT_UNKNOWN)
+	    remote_protocol_binary_upload.support = PACKET_ENABLE;
+	}
+      /* APPLE LOCAL no-ack mode  */
+      else if (strcmp (p, "QStartNoAckMode+") == 0)
+	remote_stub_no_ack_p = 1;
+      /* APPLE LOCAL begin target-side breakpoint conditions  */
+      else if (strcmp (p, "ConditionalBreakpoints+") == 0)
+	{
+	  if (remote_protocol_conditional_breakpoints.support
+	      == PACKET_SUPPORT_UNKNOWN)
+	    remote_protocol_conditional_breakpoints.support = PACKET_ENABLE;
+	}
+      /* APPLE LOCAL end target-side breakpoint conditions  */
+      /* APPLE LOCAL begin register batching  */
+      else if (strcmp (p, "qReadRegisters+") == 0)
+	{
+	  if (remote_protocol_qReadRegisters.support == PACKET_SUPPORT_UNKNOWN)
+	    remote_protocol_qReadRegisters.support = PACKET_ENABLE;
+	}
+      else if (strcmp (p, "QExpediteRegisters+") == 0)
+	{
+	  if (remote_protocol_QExpediteRegisters.support
+	      == PACKET_SUPPORT_UNKNOWN)
+	    remote_protocol_QExpediteRegisters.support = PACKET_ENABLE;
+	}
+      /* APPLE LOCAL end register batching  */
+    }
+
+  /* A stub which answers qSupported but doesn't mention 'x' doesn't
+     implement it.  */
+  if (remote_protocol_binary_upload.support == PACKET_SUPPORT_UNKNOWN)
+    remote_protocol_binary_upload.support = PACKET_DISABLE;
+  /* APPLE LOCAL begin target-side breakpoint conditions  */
+  if (remote_protocol_conditional_breakpoints.support
+      == PACKET_SUPPORT_UNKNOWN)
+    remote_protocol_conditional_breakpoints.support = PACKET_DISABLE;
+  /* APPLE LOCAL end target-side breakpoint conditions  */
+  /* APPLE LOCAL begin register batching  */
+  if (remote_protocol_qReadRegisters.support == PACKET_SUPPORT_UNKNOWN)
+    remote_protocol_qReadRegisters.support = PACKET_DISABLE;
+  if (remote_protocol_QExpediteRegisters.support == PACKET_SUPPORT_UNKNOWN)
+    remote_protocol_QExpediteRegisters.support = PACKET_DISABLE;
+  /* APPLE LOCAL end register batching  */
+
+  if (remote_debug)
+    fprintf_unfiltered (gdb_stdlog,
+			"remote packet size %ld, binary upload %s\n",
+			remote_explicit_packet_size,
+			remote_protocol_binary_upload.support == PACKET_ENABLE
+			? "enabled" : "disabled");
+}
+/* APPLE LOCAL end binary memory read  */
+
 /* Stub for catch_errors.  */
 
 static int
@@ -2469,6 +3255,11 @@ remote_start_remote (struct ui_out *uiout, void *dummy)
     current_remote_stats->acks_sent++;
   add_outgoing_pkt_to_protocol_log ("+");
 
+  /* APPLE LOCAL binary memory read  */
+  remote_query_supported ();
+  /* APPLE LOCAL no-ack mode  */
+  remote_maybe_start_no_ack_mode ();
+
   /* Let the stub know that we want it to return the thread.  */
   set_thread (-1, 0);
 
@@ -2494,8 +3285,6 @@ remote_start_remote (struct ui_out *uiout, void *dummy)
       get_offsets ();		/* Get text, data & bss offsets.  */
 
       /* APPLE LOCAL */
-      if (user_requested_no_ack_mode == AUTO_BOOLEAN_TRUE)
-        start_no_ack_mode ();
       if (remote_debugflags != NULL)
         send_remote_debugflags_pkt (remote_debugflags);
       send_remote_max_payload_size ();
@@ -2556,6 +3345,18 @@ init_all_packet_configs (void)
   /* Force remote_write_bytes to check whether target supports binary
      downloading.  */
   update_packet_config (&remote_protocol_binary_download);
+  /* APPLE LOCAL begin binary memory read  */
+  update_packet_config (&remote_protocol_binary_upload);
+  update_packet_config (&remote_protocol_qSupported);
+  /* APPLE LOCAL end binary memory read  */
+  /* APPLE LOCAL target-side breakpoint conditions  */
+  update_packet_config (&remote_protocol_conditional_breakpoints);
+  /* APPLE LOCAL begin register batching  */
+  update_packet_config (&remote_protocol_qReadRegisters);
+  update_packet_config (&remote_protocol_QExpediteRegisters);
+  /* APPLE LOCAL end register batching  */
+  /* APPLE LOCAL incremental thread list  */
+  update_packet_config (&remote_protocol_qThreadChanges);
   update_packet_config (&remote_protocol_qPart_auxv);
   update_packet_config (&remote_protocol_qGetTLSAddr);
 }
@@ -2578,6 +3379,8 @@ remote_check_symbols (struct objfile *objfile)
 
   /* Invite target to request symbol lookups.  */
 
+  /* APPLE LOCAL incremental thread list  */
+  remote_forget_thread_generation ();
   putpkt ("qSymbol::");
   getpkt (reply, (rs->remote_packet_size), 0);
   packet_ok (reply, &remote_protocol_qSymbol);
@@ -3026,6 +3829,178 @@ remote_vcont_resume (ptid_t ptid, int step, enum target_signal siggnal)
   return 1;
 }
 
+/* APPLE LOCAL begin register batching  */
+static void
+set_remote_expedite_registers (char *args, int from_tty,
+			       struct cmd_list_element *c)
+{
+  /* The new list goes to the stub when the target is next resumed.  */
+}
+
+static void
+show_remote_expedite_registers (struct ui_file *file, int from_tty,
+				struct cmd_list_element *c, const char *value)
+{
+  if (value == NULL || *value == '\0')
+    fprintf_filtered (file, _("No extra registers are expedited in stop "
+			      "replies.\n"));
+  else
+    fprintf_filtered (file, _("Registers expedited in stop replies: %s\n"),
+		      value);
+}
+
+/* Add raw register REGNUM to the list of REGNUMS, which holds *COUNT
+   entries, if it is a register the stub knows about, it isn't there
+   already, and its value still fits in *SPACE characters of a reply.
+   SEEN has one flag per raw register.  */
+
+static void
+remote_add_register_to_list (struct remote_state *rs, int regnum,
+			     int *regnums, int *count, char *seen,
+			     long *space)
+{
+  long len;
+
+  if (regnum < 0 || regnum >= NUM_REGS || seen[regnum])
+    return;
+  if (!rs->regs[regnum].in_g_packet)
+    return;
+
+  /* Two hex digits a byte, plus room for the register number and
+     separators.  */
+  len = 2 * register_size (current_gdbarch, regnum) + 12;
+  if (len > *space)
+    return;
+
+  seen[regnum] = 1;
+  *space -= len;
+  regnums[(*count)++] = regnum;
+}
+
+/* Fill REGNUMS, which has room for NUM_REGS entries, with the
+   registers we would like the stub to expedite in its stop replies:
+   those the unwinders always need, those the user listed with "set
+   remote expedite-registers", and those gdb has had to fetch one at
+   a time in the last REMOTE_EXPEDITE_STOPS stops.  If ALL, follow
+   them with every other register in the 'g' packet.  The list is cut
+   off once the registers' values would take more than SPACE
+   characters.  Return the number of entries.  */
+
+static int
+remote_expedite_regnums (int *regnums, long space, int all)
+{
+  struct remote_state *rs = get_remote_state ();
+  char *seen = alloca (NUM_REGS);
+  int count = 0;
+  int regnum;
+
+  memset (seen, 0, NUM_REGS);
+
+  remote_add_register_to_list (rs, PC_REGNUM, regnums, &count, seen, &space);
+  remote_add_register_to_list (rs, SP_REGNUM, regnums, &count, seen, &space);
+  remote_add_register_to_list (rs, DEPRECATED_FP_REGNUM, regnums, &count,
+			       seen, &space);
+
+  if (remote_expedite_register_names != NULL)
+    {
+      char *p = remote_expedite_register_names;
+
+      while (*p != '\0')
+	{
+	  char *start;
+
+	  while (*p == ' ' || *p == '\t' || *p == ',')
+	    p++;
+	  start = p;
+	  while (*p != '\0' && *p != ' ' && *p != '\t' && *p != ',')
+	    p++;
+	  if (p == start)
+	    break;
+
+	  regnum = user_reg_map_name_to_regnum (current_gdbarch, start,
+						p - start);
+	  if (regnum < 0)
+	    warning (_("Unknown register \"%.*s\" in expedite-registers."),
+		     (int) (p - start), start);
+	  else
+	    remote_add_register_to_list (rs, regnum, regnums, &count, seen,
+					 &space);
+	}
+    }
+
+  for (regnum = 0; regnum < NUM_REGS; regnum++)
+    if (all || remote_register_recently_fetched (&rs->regs[regnum]))
+      remote_add_register_to_list (rs, regnum, regnums, &count, seen,
+				   &space);
+
+  return count;
+}
+
+/* Has gdb had to fetch any register by itself lately?  If not, it
+   has no idea yet which ones the unwinders will want.  */
+
+static int
+remote_registers_learned (void)
+{
+  struct remote_state *rs = get_remote_state ();
+  int regnum;
+
+  for (regnum = 0; regnum < NUM_REGS; regnum++)
+    if (remote_register_recently_fetched (&rs->regs[regnum]))
+      return 1;
+  return 0;
+}
+
+/* If the registers we'd like expedited have changed since we last
+   told the stub, send it a new QExpediteRegisters list.  Called just
+   before resuming, so the next stop reply carries them.  */
+
+static void
+remote_update_expedite_registers (void)
+{
+  struct remote_state *rs = get_remote_state ();
+  char *buf;
+  char *p;
+  int *regnums;
+  int count, i;
+
+  if (remote_protocol_QExpediteRegisters.support == PACKET_DISABLE
+      || !target_has_registers)
+    return;
+
+  /* Leave half of the stop reply for the thread and the registers
+     the stub always sends.  */
+  regnums = alloca (NUM_REGS * sizeof (int));
+  count = remote_expedite_regnums (regnums, rs->remote_packet_size / 2, 0);
+
+  buf = alloca (rs->remote_packet_size);
+  strcpy (buf, "QExpediteRegisters:");
+  p = buf + strlen (buf);
+  for (i = 0; i < count; i++)
+    {
+      /* Each entry is at most 16 digits and a comma.  */
+      if (p - buf + 18 >= rs->remote_packet_size)
+	break;
+      if (i > 0)
+	*p++ = ',';
+      p += hexnumstr (p, rs->regs[regnums[i]].pnum);
+    }
+  *p = '\0';
+
+  if (remote_expedite_sent != NULL && strcmp (buf, remote_expedite_sent) == 0)
+    return;
+
+  xfree (remote_expedite_sent);
+  remote_expedite_sent = xstrdup (buf);
+
+  putpkt (buf);
+  getpkt (buf, rs->remote_packet_size, 0);
+  note_remote_register_packet ();
+  /* If the stub rejects the list, don't send the same one again.  */
+  packet_ok (buf, &remote_protocol_QExpediteRegisters);
+}
+/* APPLE LOCAL end register batching  */
+
 /* Tell the remote machine to resume.  */
 
 static enum target_signal last_sent_signal = TARGET_SIGNAL_0;
@@ -3047,6 +4022,13 @@ remote_resume (ptid_t ptid, int step, enum target_signal siggnal)
   if (deprecated_target_resume_hook)
     (*deprecated_target_resume_hook) ();
 
+  /* APPLE LOCAL register batching  */
+  remote_update_expedite_registers ();
+  /* APPLE LOCAL begin incremental thread list  */
+  /* The thread list may change while the target runs.  */
+  remote_forget_thread_generation ();
+  /* APPLE LOCAL end incremental thread list  */
+
   /* The vCont packet doesn't need to specify threads via Hc.  */
   if (remote_vcont_resume (ptid, step, siggnal))
     return;
@@ -3349,6 +4331,11 @@ remote_wait (ptid_t ptid, struct target_waitstatus *status,
 	case 'T':		/* Status with PC, SP, FP, ...  */
 	  {
 	    char regs[MAX_REGISTER_SIZE];
+	    /* APPLE LOCAL begin incremental thread list  */
+	    ULONGEST thread_gen = 0;
+	    int thread_gen_p = 0;
+	    char *thread_changes = NULL;
+	    /* APPLE LOCAL end incremental thread list  */
         ULONGEST mach_exc_type = 0;
         ULONGEST mach_exc_data_count = 0;
         ULONGEST mach_exc_data_index = 0;
@@ -3397,6 +4384,20 @@ Packet: '%s'\n"),
 			record_currthread (thread_num);
 			p = p_temp;
 		      }
+		    /* APPLE LOCAL begin incremental thread list  */
+		    else if (strncmp (p, "threadgen", p1 - p) == 0)
+		      {
+			p = unpack_varlen_hex (++p1, &thread_gen);
+			thread_gen_p = 1;
+		      }
+		    else if (strncmp (p, "threadchanges", p1 - p) == 0)
+		      {
+			thread_changes = ++p1;
+			p = strchr (p1, ';');
+			if (p == NULL)
+			  p = p1 + strlen (p1);
+		      }
+		    /* APPLE LOCAL end incremental thread list  */
 		    else if ((strncmp (p, "watch", p1 - p) == 0)
 			     || (strncmp (p, "rwatch", p1 - p) == 0)
 			     || (strncmp (p, "awatch", p1 - p) == 0))
@@ -3466,6 +4467,10 @@ Packet: '%s'\n"),
 		  error (_("Remote register badly formatted: %s\nhere: %s"), 
 			 buf, p);
 	      }
+
+	    /* APPLE LOCAL incremental thread list  */
+	    if (thread_gen_p)
+	      remote_note_thread_generation (thread_gen, thread_changes);
 	  }
 	  /* fall through */
 	case 'S':		/* Old style status, just signal only.  */
@@ -3519,6 +4524,9 @@ Packet: '%s'\n"),
 	}
     }
 got_status:
+  /* APPLE LOCAL register batching  */
+  if (status->kind == TARGET_WAITKIND_STOPPED)
+    note_remote_stop ();
   if (thread_num != -1)
     {
       return ptid_build (thread_num, 0, thread_num);
@@ -3571,6 +4579,11 @@ remote_async_wait (ptid_t ptid, struct target_waitstatus *status,
 	case 'T':		/* Status with PC, SP, FP, ...  */
 	  {
 	    char regs[MAX_REGISTER_SIZE];
+	    /* APPLE LOCAL begin incremental thread list  */
+	    ULONGEST thread_gen = 0;
+	    int thread_gen_p = 0;
+	    char *thread_changes = NULL;
+	    /* APPLE LOCAL end incremental thread list  */
 
 	    /* Expedited reply, containing Signal, {regno, reg} repeat.  */
 	    /*  format is:  'Tssn...:r...;n...:r...;n...:r...;#cc', where
@@ -3616,6 +4629,20 @@ Packet: '%s'\n"),
 			record_currthread (thread_num);
 			p = p_temp;
 		      }
+		    /* APPLE LOCAL begin incremental thread list  */
+		    else if (strncmp (p, "threadgen", p1 - p) == 0)
+		      {
+			p = unpack_varlen_hex (++p1, &thread_gen);
+			thread_gen_p = 1;
+		      }
+		    else if (strncmp (p, "threadchanges", p1 - p) == 0)
+		      {
+			thread_changes = ++p1;
+			p = strchr (p1, ';');
+			if (p == NULL)
+			  p = p1 + strlen (p1);
+		      }
+		    /* APPLE LOCAL end incremental thread list  */
 		    else if ((strncmp (p, "watch", p1 - p) == 0)
 			     || (strncmp (p, "rwatch", p1 - p) == 0)
 			     || (strncmp (p, "awatch", p1 - p) == 0))
@@ -3661,6 +4688,10 @@ Packet: '%s'\n"),
 		  error (_("Remote register badly formatted: %s\nhere: %s"),
 			 buf, p);
 	      }
+
+	    /* APPLE LOCAL incremental thread list  */
+	    if (thread_gen_p)
+	      remote_note_thread_generation (thread_gen, thread_changes);
 	  }
 	  /* fall through */
 	case 'S':		/* Old style status, just signal only.  */
@@ -3717,6 +4748,9 @@ Packet: '%s'\n"),
 	}
     }
 got_status:
+  /* APPLE LOCAL register batching  */
+  if (status->kind == TARGET_WAITKIND_STOPPED)
+    note_remote_stop ();
   if (thread_num != -1)
     {
       return ptid_build (thread_num, 0, thread_num);
@@ -3744,6 +4778,8 @@ fetch_register_using_p (int regnum)
   p += hexnumstr (p, regnum);
   *p++ = '\0';
   remote_send (buf, rs->remote_packet_size);
+  /* APPLE LOCAL register batching  */
+  note_remote_register_packet ();
 
   /* If the stub didn't recognize the packet, or if we got an error,
      tell our caller.  */
@@ -3776,6 +4812,85 @@ fetch_register_using_p (int regnum)
   return 1;
 }
 
+/* APPLE LOCAL begin register batching  */
+/* Fetch REGNUM with a 'qReadRegisters' request, along with any of
+   the registers we'd like expedited that the regcache doesn't have
+   yet; a thread other than the one that stopped, for instance, has
+   none of them.  If ALL, ask for every register in the 'g' packet
+   the regcache doesn't have, as far as the reply allows.  Return 0
+   if the stub didn't recognize the request or gave an error.  */
+
+static int
+fetch_registers_using_qReadRegisters (int regnum, int all)
+{
+  struct remote_state *rs = get_remote_state ();
+  char *buf = alloca (rs->remote_packet_size), *p;
+  char regp[MAX_REGISTER_SIZE];
+  int *wanted = alloca (NUM_REGS * sizeof (int));
+  int *regnums = alloca (NUM_REGS * sizeof (int));
+  int nwanted, count, i;
+
+  /* Leave room for a separator after each value.  */
+  nwanted = remote_expedite_regnums (wanted, rs->remote_packet_size - 32,
+				     all);
+
+  regnums[0] = regnum;
+  count = 1;
+  strcpy (buf, "qReadRegisters:");
+  p = buf + strlen (buf);
+  p += hexnumstr (p, rs->regs[regnum].pnum);
+  for (i = 0; i < nwanted; i++)
+    {
+      if (wanted[i] == regnum || register_cached (wanted[i]) != 0)
+	continue;
+      if (p - buf + 18 >= rs->remote_packet_size)
+	break;
+      *p++ = ',';
+      p += hexnumstr (p, rs->regs[wanted[i]].pnum);
+      regnums[count++] = wanted[i];
+    }
+  *p = '\0';
+
+  putpkt (buf);
+  getpkt (buf, rs->remote_packet_size, 0);
+  note_remote_register_packet ();
+  if (packet_ok (buf, &remote_protocol_qReadRegisters) != PACKET_OK)
+    return 0;
+
+  /* The reply has the value of each register in the order we asked,
+     separated by ';', with 'x's for one the stub can't read.  */
+  p = buf;
+  for (i = 0; i < count; i++)
+    {
+      int size = register_size (current_gdbarch, regnums[i]);
+      int fieldsize;
+
+      if (*p == 'x')
+	{
+	  regcache_raw_supply (current_regcache, regnums[i], NULL);
+	  set_register_cached (regnums[i], -1);
+	  while (*p != '\0' && *p != ';')
+	    p++;
+	}
+      else
+	{
+	  fieldsize = hex2bin (p, regp, size);
+	  if (fieldsize < size)
+	    error (_("Remote reply is too short: %s"), buf);
+	  regcache_raw_supply (current_regcache, regnums[i], regp);
+	  p += 2 * fieldsize;
+	}
+
+      if (*p == ';')
+	p++;
+      else if (i < count - 1)
+	error (_("Remote register badly formatted: %s"), buf);
+    }
+
+  return 1;
+}
+/* APPLE LOCAL end register batching  */
+
 static void
 remote_fetch_registers (int regnum)
 {
@@ -3784,6 +4899,8 @@ remote_fetch_registers (int regnum)
   int i;
   char *p;
   char *regs = alloca (rs->sizeof_g_packet);
+  /* APPLE LOCAL register batching  */
+  int learned = 1;
 
   set_thread (PIDGET (inferior_ptid), 1);
 
@@ -3795,7 +4912,22 @@ remote_fetch_registers (int regnum)
 	internal_error (__FILE__, __LINE__,
 			_("Attempt to fetch a non G-packet register when this "
 			"remote.c does not support the p-packet."));
+
+      /* APPLE LOCAL begin register batching  */
+      /* Ask for this register in future stop replies, and fetch it
+	 together with any others we're missing.  Until gdb has seen
+	 which registers it needs, fetch them all in one go rather
+	 than discovering them one packet at a time.  */
+      learned = remote_registers_learned ();
+      reg->fetched_stop = total_remote_stops + 1;
+      if (remote_protocol_qReadRegisters.support != PACKET_DISABLE
+	  && remote_protocol_p.support != PACKET_DISABLE
+	  && fetch_registers_using_qReadRegisters (regnum, !learned))
+	return;
+      /* APPLE LOCAL end register batching  */
     }
+  /* APPLE LOCAL register batching  */
+  if (regnum < 0 || learned)
       switch (remote_protocol_p.support)
 	{
 	case PACKET_DISABLE:
@@ -3824,6 +4956,8 @@ remote_fetch_registers (int regnum)
 
   sprintf (buf, "g");
   remote_send (buf, (rs->remote_packet_size));
+  /* APPLE LOCAL register batching  */
+  note_remote_register_packet ();
 
   /* Save the size of the packet sent to us by the target.  Its used
      as a heuristic when determining the max size of packets that the
@@ -3953,6 +5087,8 @@ store_register_using_P (int regnum)
   regcache_raw_collect (current_regcache, reg->regnum, regp);
   bin2hex (regp, p, register_size (current_gdbarch, reg->regnum));
   remote_send (buf, rs->remote_packet_size);
+  /* APPLE LOCAL register batching  */
+  note_remote_register_packet ();
 
   return buf[0] != '\0';
 }
@@ -4022,6 +5158,8 @@ remote_store_registers (int regnum)
   /* remote_prepare_to_store insures that register_bytes_found gets set.  */
   bin2hex (regs, p, register_bytes_found);
   remote_send (buf, (rs->remote_packet_size));
+  /* APPLE LOCAL register batching  */
+  note_remote_register_packet ();
 }
 
 
@@ -4160,6 +5298,8 @@ remote_write_bytes (CORE_ADDR memaddr, const gdb_byte *myaddr, int len)
   int nr_bytes;
   int payload_size;
   char *payload_start;
+  /* APPLE LOCAL binary memory read  */
+  struct cleanup *old_chain;
 
   /* Verify that the target can support a binary download.  */
   check_binary_download (memaddr);
@@ -4169,7 +5309,11 @@ remote_write_bytes (CORE_ADDR memaddr, const gdb_byte *myaddr, int len)
   /* Compute the size, and then allocate space for the largest
      possible packet.  Include space for an extra trailing NUL.  */
   sizeof_buf = payload_size + 1;
-  buf = alloca (sizeof_buf);
+  /* APPLE LOCAL begin binary memory read  */
+  /* A negotiated packet size may be too large for alloca.  */
+  buf = xmalloc (sizeof_buf);
+  old_chain = make_cleanup (xfree, buf);
+  /* APPLE LOCAL end binary memory read  */
 
   /* Compute the size of the actual payload by subtracting out the
      packet header and footer overhead: "$M<memaddr>,<len>:...#nn".
@@ -4284,15 +5428,55 @@ remote_write_bytes (CORE_ADDR memaddr, const gdb_byte *myaddr, int len)
 	 uses for errors and errno codes.  We would like a cleaner way
 	 of representing errors (big enough to include errno codes,
 	 bfd_error codes, and others).  But for now just return EIO.  */
+      /* APPLE LOCAL binary memory read  */
+      do_cleanups (old_chain);
       errno = EIO;
       return 0;
     }
 
+  /* APPLE LOCAL binary memory read  */
+  do_cleanups (old_chain);
+
   /* Return NR_BYTES, not TODO, in case escape chars caused us to send
      fewer bytes than we'd planned.  */
   return nr_bytes;
 }
 
+/* APPLE LOCAL begin binary memory read  */
+/* Decode the escaped binary data in BUFFER (LEN chars, as sent in an
+   'X' packet or an 'x' reply) into OUT_BUF, storing at most
+   OUT_MAXLEN bytes.  Return the number of bytes stored.  */
+
+static int
+remote_unescape_input (const char *buffer, long len, gdb_byte *out_buf,
+		       int out_maxlen)
+{
+  long in;
+  int out = 0;
+  int escaped = 0;
+
+  for (in = 0; in < len && out < out_maxlen; in++)
+    {
+      gdb_byte b = buffer[in] & 0xff;
+
+      if (escaped)
+	{
+	  out_buf[out++] = b ^ 0x20;
+	  escaped = 0;
+	}
+      else if (b == 0x7d)
+	escaped = 1;
+      else
+	out_buf[out++] = b;
+    }
+
+  if (escaped)
+    warning (_("Unmatched escape character in remote binary reply."));
+
+  return out;
+}
+/* APPLE LOCAL end binary memory read  */
+
 /* Read memory data directly from the remote machine.
    This does not use the data cache; the data cache uses this.
    MEMADDR is the address in the remote memory space.
@@ -4315,11 +5499,18 @@ remote_read_bytes (CORE_ADDR memaddr, char *myaddr, int len)
   int max_buf_size;		/* Max size of packet output buffer.  */
   long sizeof_buf;
   int origlen;
+  /* APPLE LOCAL begin binary memory read  */
+  int binary = (remote_protocol_binary_upload.support == PACKET_ENABLE);
+  struct cleanup *old_chain;
 
-  /* Create a buffer big enough for this packet.  */
+  /* Create a buffer big enough for this packet.  An escaped binary
+     reply can be up to twice the size of the data it carries, and a
+     negotiated packet size may be too large for alloca.  */
   max_buf_size = get_memory_read_packet_size ();
-  sizeof_buf = max_buf_size + 1; /* Space for trailing NULL.  */
-  buf = alloca (sizeof_buf);
+  sizeof_buf = 2 * max_buf_size + 1; /* Space for trailing NULL.  */
+  buf = xmalloc (sizeof_buf);
+  old_chain = make_cleanup (xfree, buf);
+  /* APPLE LOCAL end binary memory read  */
 
   origlen = len;
   while (len > 0)
@@ -4327,21 +5518,32 @@ remote_read_bytes (CORE_ADDR memaddr, char *myaddr, int len)
       char *p;
       int todo;
       int i;
-
-      todo = min (len, max_buf_size / 2);	/* num bytes that will fit */
+      /* APPLE LOCAL binary memory read  */
+      long pktlen;
+
+      /* APPLE LOCAL begin binary memory read  */
+      /* num bytes that will fit; leave room for the 'b' prefix of a
+	 binary reply.  */
+      if (binary)
+	todo = min (len, max_buf_size - 1);
+      else
+	todo = min (len, max_buf_size / 2);
+      /* APPLE LOCAL end binary memory read  */
 
       /* construct "m"<memaddr>","<len>" */
       /* sprintf (buf, "m%lx,%x", (unsigned long) memaddr, todo); */
       memaddr = remote_address_masked (memaddr);
       p = buf;
-      *p++ = 'm';
+      /* APPLE LOCAL binary memory read  */
+      *p++ = binary ? 'x' : 'm';
       p += hexnumstr (p, (ULONGEST) memaddr);
       *p++ = ',';
       p += hexnumstr (p, (ULONGEST) todo);
       *p = '\0';
 
       putpkt (buf);
-      getpkt (buf, sizeof_buf, 0);
+      /* APPLE LOCAL binary memory read  */
+      getpkt_binary (buf, sizeof_buf, 0, &pktlen);
 
       if (buf[0] == 'E'
 	  && isxdigit (buf[1]) && isxdigit (buf[2])
@@ -4352,10 +5554,46 @@ remote_read_bytes (CORE_ADDR memaddr, char *myaddr, int len)
 	     a cleaner way of representing errors (big enough to
 	     include errno codes, bfd_error codes, and others).  But
 	     for now just return EIO.  */
+	  /* APPLE LOCAL binary memory read  */
+	  do_cleanups (old_chain);
 	  errno = EIO;
 	  return 0;
 	}
 
+      /* APPLE LOCAL begin binary memory read  */
+      if (binary)
+	{
+	  if (buf[0] != 'b')
+	    {
+	      /* An empty reply means the stub doesn't implement 'x'
+		 after all; packet_ok reports that.  */
+	      if (pktlen == 0)
+		packet_ok (buf, &remote_protocol_binary_upload);
+	      do_cleanups (old_chain);
+	      errno = EIO;
+	      return origlen - len;
+	    }
+
+	  /* Reply is 'b' followed by the escaped memory contents.  It
+	     can be short either because the stub ran out of packet
+	     space (escapes take two chars) or because only part of
+	     the memory was readable; in both cases go around again
+	     for the remainder, and let the next request report any
+	     error.  */
+	  i = remote_unescape_input (buf + 1, pktlen - 1,
+				     (gdb_byte *) myaddr, todo);
+	  if (i == 0)
+	    {
+	      do_cleanups (old_chain);
+	      return origlen - len;
+	    }
+	  myaddr += i;
+	  memaddr += i;
+	  len -= i;
+	  continue;
+	}
+      /* APPLE LOCAL end binary memory read  */
+
       /* Reply describes memory byte by byte,
          each byte encoded as two hex characters.  */
 
@@ -4364,12 +5602,16 @@ remote_read_bytes (CORE_ADDR memaddr, char *myaddr, int len)
 	{
 	  /* Reply is short.  This means that we were able to read
 	     only part of what we wanted to.  */
+	  /* APPLE LOCAL binary memory read  */
+	  do_cleanups (old_chain);
 	  return i + (origlen - len);
 	}
       myaddr += todo;
       memaddr += todo;
       len -= todo;
     }
+  /* APPLE LOCAL binary memory read  */
+  do_cleanups (old_chain);
   return origlen;
 }
 
@@ -4415,8 +5657,11 @@ readchar (int timeout)
   ch = serial_readchar (remote_desc, timeout);
   end_remote_timer ();
 
+  /* APPLE LOCAL begin binary memory read  */
+  /* Don't strip the high bit: 'x' replies carry raw 8-bit data.  */
   if (ch >= 0)
-    return (ch & 0x7f);
+    return ch;
+  /* APPLE LOCAL end binary memory read  */
 
   switch ((enum serial_rc) ch)
     {
@@ -4536,6 +5781,9 @@ putpkt_binary (char *buf, int cnt)
       if (no_ack_mode)
         break;
 
+      /* APPLE LOCAL no-ack mode  */
+      note_remote_round_trip ();
+
       /* Read until either a timeout occurs (-2) or '+' is read.  */
       while (1)
 	{
@@ -4784,12 +6032,33 @@ getpkt_sane (char *buf,
 	long sizeof_buf,
 	int forever)
 {
+  /* APPLE LOCAL binary memory read  */
+  return getpkt_binary (buf, sizeof_buf, forever, NULL);
+}
+
+/* APPLE LOCAL begin binary memory read  */
+/* Like getpkt_sane, but if LENP is non-NULL also store the number of
+   chars received there (zero on failure).  Binary replies may contain
+   NULs, so their callers can't use strlen.  */
+
+static int
+getpkt_binary (char *buf,
+	       long sizeof_buf,
+	       int forever,
+	       long *lenp)
+{
+  /* APPLE LOCAL end binary memory read  */
   int c;
   int tries;
   int timeout;
   int val;
 
   strcpy (buf, "timeout");
+  /* APPLE LOCAL binary memory read  */
+  if (lenp != NULL)
+    *lenp = 0;
+  /* APPLE LOCAL no-ack mode  */
+  note_remote_round_trip ();
 
   if (forever)
     {
@@ -4839,6 +6108,9 @@ getpkt_sane (char *buf,
 
       if (val >= 0)
 	{
+	  /* APPLE LOCAL binary memory read  */
+	  if (lenp != NULL)
+	    *lenp = val;
           /* APPLE LOCAL */
           if (current_remote_stats)
             current_remote_stats->pkt_recvd++;
@@ -5069,6 +6341,56 @@ static unsigned char little_break_insn[] = DEPRECATED_LITTLE_REMOTE_BREAKPOINT;
    It is guaranteed by the caller to be long enough to save the number
    of bytes returned by BREAKPOINT_FROM_PC.  */
 
+/* APPLE LOCAL begin target-side breakpoint conditions  */
+/* If the stub evaluates breakpoint conditions, and the breakpoint at
+   ADDR has one it can be given, compile it and append it to the 'Z0'
+   packet being built at P as ";X<len>,<bytes>".  BUF_END is the end
+   of the packet buffer.  Return the new end of the packet.  Anything
+   that can't be compiled (or doesn't fit) is simply left for us to
+   evaluate when the breakpoint is reported.  */
+
+static char *
+remote_add_breakpoint_condition (char *p, char *buf_end, CORE_ADDR addr)
+{
+  struct expression *cond;
+  struct agent_expr *volatile aexpr = NULL;
+  struct cleanup *old_chain;
+  volatile struct gdb_exception e;
+
+  if (remote_protocol_conditional_breakpoints.support != PACKET_ENABLE)
+    return p;
+
+  cond = breakpoint_target_condition (addr);
+  if (cond == NULL)
+    return p;
+
+  TRY_CATCH (e, RETURN_MASK_ERROR)
+    {
+      aexpr = gen_eval_for_expr (addr, cond);
+    }
+  if (e.reason < 0)
+    {
+      if (remote_debug)
+	fprintf_unfiltered (gdb_stdlog,
+			    "not sending condition for breakpoint at %s: %s\n",
+			    paddr_nz (addr), e.message);
+      return p;
+    }
+
+  old_chain = make_cleanup_free_agent_expr (aexpr);
+  if (p + 2 + hexnumlen (aexpr->len) + 1 + 2 * aexpr->len < buf_end)
+    {
+      *(p++) = ';';
+      *(p++) = 'X';
+      p += hexnumstr (p, (ULONGEST) aexpr->len);
+      *(p++) = ',';
+      p += bin2hex ((char *) aexpr->buf, p, aexpr->len);
+    }
+  do_cleanups (old_chain);
+  return p;
+}
+/* APPLE LOCAL end target-side breakpoint conditions  */
+
 static int
 remote_insert_breakpoint (CORE_ADDR addr, bfd_byte *contents_cache)
 {
@@ -5087,6 +6409,9 @@ remote_insert_breakpoint (CORE_ADDR addr, bfd_byte *contents_cache)
     {
       char *buf = alloca (rs->remote_packet_size);
       char *p = buf;
+      /* APPLE LOCAL begin target-side breakpoint conditions  */
+      CORE_ADDR bp_addr = addr;
+      int prefix_len;
 
       addr = remote_address_masked (addr);
       *(p++) = 'Z';
@@ -5094,11 +6419,31 @@ remote_insert_breakpoint (CORE_ADDR addr, bfd_byte *contents_cache)
       *(p++) = ',';
       p += hexnumstr (p, (ULONGEST) addr);
       BREAKPOINT_FROM_PC (&addr, &bp_size);
-      sprintf (p, ",%d", bp_size);
+      p += sprintf (p, ",%d", bp_size);
+      prefix_len = p - buf;
+      p = remote_add_breakpoint_condition (p, buf + rs->remote_packet_size,
+					   bp_addr);
+      *p = '\0';
 
       putpkt (buf);
       getpkt (buf, (rs->remote_packet_size), 0);
 
+      /* A stub which can't digest the condition may still be able to
+	 set the breakpoint; we'll check the condition ourselves.  */
+      if (p != buf + prefix_len && buf[0] == 'E')
+	{
+	  p = buf;
+	  *(p++) = 'Z';
+	  *(p++) = '0';
+	  *(p++) = ',';
+	  p += hexnumstr (p, (ULONGEST) remote_address_masked (bp_addr));
+	  sprintf (p, ",%d", bp_size);
+
+	  putpkt (buf);
+	  getpkt (buf, (rs->remote_packet_size), 0);
+	}
+      /* APPLE LOCAL end target-side breakpoint conditions  */
+
       switch (packet_ok (buf, &remote_protocol_Z[Z_PACKET_SOFTWARE_BP]))
 	{
 	case PACKET_ERROR:
@@ -6156,6 +7501,22 @@ show_remote_cmd (char *args, int from_tty)
   show_remote_protocol_qSymbol_packet_cmd (gdb_stdout, from_tty, NULL, NULL);
   show_remote_protocol_vcont_packet_cmd (gdb_stdout, from_tty, NULL, NULL);
   show_remote_protocol_binary_download_cmd (gdb_stdout, from_tty, NULL, NULL);
+  /* APPLE LOCAL begin binary memory read  */
+  show_remote_protocol_binary_upload_cmd (gdb_stdout, from_tty, NULL, NULL);
+  show_remote_protocol_qSupported_packet_cmd (gdb_stdout, from_tty, NULL, NULL);
+  /* APPLE LOCAL end binary memory read  */
+  /* APPLE LOCAL target-side breakpoint conditions  */
+  show_remote_protocol_conditional_breakpoints_cmd (gdb_stdout, from_tty,
+						    NULL, NULL);
+  /* APPLE LOCAL begin register batching  */
+  show_remote_protocol_qReadRegisters_packet_cmd (gdb_stdout, from_tty,
+						  NULL, NULL);
+  show_remote_protocol_QExpediteRegisters_packet_cmd (gdb_stdout, from_tty,
+						      NULL, NULL);
+  /* APPLE LOCAL end register batching  */
+  /* APPLE LOCAL incremental thread list  */
+  show_remote_protocol_qThreadChanges_packet_cmd (gdb_stdout, from_tty,
+						  NULL, NULL);
   show_remote_protocol_qPart_auxv_packet_cmd (gdb_stdout, from_tty, NULL, NULL);
   show_remote_protocol_qGetTLSAddr_packet_cmd (gdb_stdout, from_tty, NULL, NULL);
   show_max_remote_packet_size (NULL, from_tty);
@@ -6572,6 +7933,10 @@ remote_macosx_attach (char *args, int from_tty)
       forever = 0;
     }
 
+  /* APPLE LOCAL begin incremental thread list  */
+  remote_thread_cache_clear ();
+  remote_forget_thread_generation ();
+  /* APPLE LOCAL end incremental thread list  */
   putpkt (buf);
   
   timed_out = getpkt_sane (buf, rs->remote_packet_size, forever);
@@ -6882,6 +8247,68 @@ Show the maximum size of the address (in bits) in a memory packet."), NULL,
 			 &remote_set_cmdlist, &remote_show_cmdlist,
 			 1);
 
+  /* APPLE LOCAL begin binary memory read  */
+  add_packet_config_cmd (&remote_protocol_binary_upload,
+			 "x", "binary-upload",
+			 set_remote_protocol_binary_upload_cmd,
+			 show_remote_protocol_binary_upload_cmd,
+			 &remote_set_cmdlist, &remote_show_cmdlist,
+			 0);
+
+  add_packet_config_cmd (&remote_protocol_qSupported,
+			 "qSupported", "supported-packets",
+			 set_remote_protocol_qSupported_packet_cmd,
+			 show_remote_protocol_qSupported_packet_cmd,
+			 &remote_set_cmdlist, &remote_show_cmdlist,
+			 0);
+  /* APPLE LOCAL end binary memory read  */
+
+  /* APPLE LOCAL begin target-side breakpoint conditions  */
+  add_packet_config_cmd (&remote_protocol_conditional_breakpoints,
+			 "ConditionalBreakpoints", "conditional-breakpoints",
+			 set_remote_protocol_conditional_breakpoints_cmd,
+			 show_remote_protocol_conditional_breakpoints_cmd,
+			 &remote_set_cmdlist, &remote_show_cmdlist,
+			 0);
+  /* APPLE LOCAL end target-side breakpoint conditions  */
+
+  /* APPLE LOCAL begin register batching  */
+  add_packet_config_cmd (&remote_protocol_qReadRegisters,
+			 "qReadRegisters", "read-registers",
+			 set_remote_protocol_qReadRegisters_packet_cmd,
+			 show_remote_protocol_qReadRegisters_packet_cmd,
+			 &remote_set_cmdlist, &remote_show_cmdlist,
+			 0);
+
+  add_packet_config_cmd (&remote_protocol_QExpediteRegisters,
+			 "QExpediteRegisters", "expedite-registers",
+			 set_remote_protocol_QExpediteRegisters_packet_cmd,
+			 show_remote_protocol_QExpediteRegisters_packet_cmd,
+			 &remote_set_cmdlist, &remote_show_cmdlist,
+			 0);
+
+  add_setshow_string_noescape_cmd ("expedite-registers", class_support,
+				   &remote_expedite_register_names, _("\
+Set the registers the remote stub should send with every stop."), _("\
+Show the registers the remote stub should send with every stop."), _("\
+The value is a list of register names, separated by spaces or commas.\n\
+GDB always asks for the PC, stack pointer and frame pointer, and for\n\
+the registers it had to fetch one at a time in the last 16 stops.\n\
+Only used when the stub supports the QExpediteRegisters packet."),
+				   set_remote_expedite_registers,
+				   show_remote_expedite_registers,
+				   &remote_set_cmdlist, &remote_show_cmdlist);
+  /* APPLE LOCAL end register batching  */
+
+  /* APPLE LOCAL begin incremental thread list  */
+  add_packet_config_cmd (&remote_protocol_qThreadChanges,
+			 "qThreadChanges", "thread-changes",
+			 set_remote_protocol_qThreadChanges_packet_cmd,
+			 show_remote_protocol_qThreadChanges_packet_cmd,
+			 &remote_set_cmdlist, &remote_show_cmdlist,
+			 0);
+  /* APPLE LOCAL end incremental thread list  */
+
   add_packet_config_cmd (&remote_protocol_vcont,
 			 "vCont", "verbose-resume",
 			 set_remote_protocol_vcont_packet_cmd,
@@ -7011,4 +8438,10 @@ with the same name as the exec-file, but in the location given by this variable.
   /* APPLE LOCAL */
   add_cmd ("dump-packets", class_maintenance, dump_packets_command,
            "Print the packet log buffer.", &maintenancelist);
+
+  /* APPLE LOCAL no-ack mode  */
+  add_cmd ("remote-statistics", class_maintenance,
+	   maintenance_print_remote_statistics, _("\
+Print the number of remote protocol packets and round trips so far."),
+	   &maintenanceprintlist);
 }
@@ -86,6 +86,10 @@ struct remote_stats {
   int pkt_recvd;
   int acks_sent;
   int acks_recvd;
+  /* APPLE LOCAL no-ack mode  */
+  int round_trips;
+  /* APPLE LOCAL register batching  */
+  int register_packets;
   int assigned_to_global;
 
   /* The mi token (sequence #) for this command, if available, as a
@@ -104,5 +108,7 @@ struct remote_stats {
 
 extern uint64_t total_packets_sent;
 extern uint64_t total_packets_received;
+/* APPLE LOCAL no-ack mode  */
+extern uint64_t total_round_trips;
 
 #endif
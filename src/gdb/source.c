@@ -47,6 +47,13 @@
 #include "completer.h"
 #include "ui-out.h"
 #include "readline/readline.h"
+/* APPLE LOCAL source path cache  */
+#include "hashtab.h"
+/* APPLE LOCAL begin source text cache  */
+#ifdef HAVE_MMAP
+#include <sys/mman.h>
+#endif
+/* APPLE LOCAL end source text cache  */
 
 #ifndef O_BINARY
 #define O_BINARY 0
@@ -61,8 +68,6 @@ void _initialize_source (void);
 
 /* Prototypes for local functions. */
 
-static int get_filename_and_charpos (struct symtab *, char **);
-
 static void reverse_search_command (char *, int);
 
 static void forward_search_command (char *, int);
@@ -73,6 +78,9 @@ static void source_info (char *, int);
 
 static void show_directories (char *, int);
 
+/* APPLE LOCAL source text cache  */
+static void forget_source_text_cache (void);
+
 /* Path of directories to search for source files.
    Same format as the PATH environment variable's value.  */
 
@@ -90,6 +98,64 @@ static int current_source_line;
 static char *pathname_substitutions = NULL;
 static char **pathname_substitutions_argv = NULL;
 
+/* APPLE LOCAL begin source path cache  */
+/* What find_and_open_source made of each FILENAME and compilation
+   DIRNAME we have asked it about, so that symtabs and psymtabs for
+   the same file (and repeated lookups of files we can't find) don't
+   search the source path again.  FULLNAME is NULL if the file wasn't
+   found.  */
+
+struct source_fullname_entry
+{
+  char *filename;
+  char *dirname;
+  char *fullname;
+};
+
+static htab_t source_fullname_cache;
+
+/* The gdb_realpath of each file name we have been asked about.  */
+
+struct source_realpath_entry
+{
+  char *filename;
+  char *real_path;
+};
+
+static htab_t source_realpath_cache;
+/* APPLE LOCAL end source path cache  */
+
+/* APPLE LOCAL begin source text cache  */
+/* The text of the source files we have listed lines from, mapped
+   into memory (or read, if it can't be mapped).  Listing a few lines
+   of a file, or building its line table as far as some line, then
+   doesn't have to read the whole file into the heap, and listing more
+   of the same file doesn't read it again.  The list is kept in most
+   recently used order, and holds at most SOURCE_TEXT_CACHE_SIZE
+   files.  */
+
+struct source_text
+{
+  struct source_text *next;
+
+  /* The file's name, and what fstat said about it when we mapped
+     it.  */
+  char *fullname;
+  dev_t dev;
+  ino_t ino;
+  off_t st_size;
+  time_t mtime;
+
+  const char *data;
+  size_t size;
+  int mapped;
+};
+
+#define SOURCE_TEXT_CACHE_SIZE 8
+
+static struct source_text *source_text_cache;
+/* APPLE LOCAL end source text cache  */
+
 /* Default number of lines to print with commands like "list".
    This is based on guessing how many long (i.e. more than chars_per_line
    characters) lines there will be.  To be completely correct, "list"
@@ -329,6 +395,11 @@ forget_cached_source_info (void)
 	    {
 	      xfree (s->line_charpos);
 	      s->line_charpos = NULL;
+	      /* APPLE LOCAL begin source text cache  */
+	      s->line_charpos_size = 0;
+	      s->line_charpos_complete = 0;
+	      s->nlines = 0;
+	      /* APPLE LOCAL end source text cache  */
 	    }
 	  if (s->fullname != NULL)
 	    {
@@ -346,8 +417,127 @@ forget_cached_source_info (void)
 	  }
       }
     }
+
+  /* APPLE LOCAL source path cache  */
+  forget_cached_source_paths ();
+  /* APPLE LOCAL source text cache  */
+  forget_source_text_cache ();
+}
+
+/* APPLE LOCAL begin source path cache  */
+static hashval_t
+hash_source_fullname_entry (const void *p)
+{
+  const struct source_fullname_entry *e = p;
+  hashval_t hash = htab_hash_string (e->filename);
+
+  if (e->dirname != NULL)
+    hash = hash * 31 + htab_hash_string (e->dirname);
+  return hash;
+}
+
+static int
+eq_source_fullname_entry (const void *p1, const void *p2)
+{
+  const struct source_fullname_entry *e1 = p1;
+  const struct source_fullname_entry *e2 = p2;
+
+  if (strcmp (e1->filename, e2->filename) != 0)
+    return 0;
+  if (e1->dirname == NULL || e2->dirname == NULL)
+    return e1->dirname == e2->dirname;
+  return strcmp (e1->dirname, e2->dirname) == 0;
+}
+
+static void
+free_source_fullname_entry (void *p)
+{
+  struct source_fullname_entry *e = p;
+
+  xfree (e->filename);
+  xfree (e->dirname);
+  xfree (e->fullname);
+  xfree (e);
+}
+
+static hashval_t
+hash_source_realpath_entry (const void *p)
+{
+  const struct source_realpath_entry *e = p;
+
+  return htab_hash_string (e->filename);
+}
+
+static int
+eq_source_realpath_entry (const void *p1, const void *p2)
+{
+  const struct source_realpath_entry *e1 = p1;
+  const struct source_realpath_entry *e2 = p2;
+
+  return strcmp (e1->filename, e2->filename) == 0;
+}
+
+static void
+free_source_realpath_entry (void *p)
+{
+  struct source_realpath_entry *e = p;
+
+  xfree (e->filename);
+  xfree (e->real_path);
+  xfree (e);
+}
+
+/* Forget the full names and real paths we have cached for source
+   files, but not the full names recorded in the symtabs and
+   psymtabs.  This is enough when the source path grows.  */
+
+void
+forget_cached_source_paths (void)
+{
+  if (source_fullname_cache != NULL)
+    {
+      htab_delete (source_fullname_cache);
+      source_fullname_cache = NULL;
+    }
+  if (source_realpath_cache != NULL)
+    {
+      htab_delete (source_realpath_cache);
+      source_realpath_cache = NULL;
+    }
 }
 
+/* Return the gdb_realpath of FILENAME.  The result belongs to a cache
+   which forget_cached_source_info empties, so copy it if you need it
+   for longer than that.  */
+
+const char *
+source_realpath (const char *filename)
+{
+  struct source_realpath_entry key, *e;
+  void **slot;
+
+  if (source_realpath_cache == NULL)
+    source_realpath_cache
+      = htab_create_alloc (127, hash_source_realpath_entry,
+			   eq_source_realpath_entry,
+			   free_source_realpath_entry, xcalloc, xfree);
+
+  key.filename = (char *) filename;
+  slot = htab_find_slot (source_realpath_cache, &key, INSERT);
+  if (*slot == NULL)
+    {
+      e = XMALLOC (struct source_realpath_entry);
+      e->filename = xstrdup (filename);
+      e->real_path = gdb_realpath (filename);
+      *slot = e;
+    }
+  else
+    e = *slot;
+
+  return e->real_path;
+}
+/* APPLE LOCAL end source path cache  */
+
 void
 init_source_path (void)
 {
@@ -630,7 +820,8 @@ source_info (char *ignore, int from_tty)
     printf_filtered (_("Compilation directory is %s\n"), s->dirname);
   if (s->fullname)
     printf_filtered (_("Located in %s\n"), s->fullname);
-  if (s->nlines)
+  /* APPLE LOCAL source text cache  */
+  if (s->nlines && s->line_charpos_complete)
     printf_filtered (_("Contains %d line%s.\n"), s->nlines,
 		     s->nlines == 1 ? "" : "s");
 
@@ -972,6 +1163,11 @@ add_one_pathname_substitution (const char *old, const char *new)
 {
   int arrsize = 0;
   
+ /* APPLE LOCAL begin source path cache  */
+ /* Files we couldn't find before may be found now.  */
+ forget_cached_source_paths ();
+ /* APPLE LOCAL end source path cache  */
+
  if (pathname_substitutions_argv == NULL)
    {
      pathname_substitutions_argv = (char **) xmalloc (sizeof (char *) * 3);
@@ -1131,6 +1327,46 @@ open_source_file (struct symtab *s)
 			       &s->fullname);
 }
 
+/* APPLE LOCAL begin source path cache  */
+/* Return a malloc'd copy of the full name of the source file FILENAME
+   from OBJFILE compiled in DIRNAME, or NULL if it can't be found.  */
+
+static char *
+cached_source_fullname (struct objfile *objfile, const char *filename,
+			const char *dirname)
+{
+  struct source_fullname_entry key, *e;
+  void **slot;
+  char *fullname = NULL;
+  int fd;
+
+  if (source_fullname_cache == NULL)
+    source_fullname_cache
+      = htab_create_alloc (127, hash_source_fullname_entry,
+			   eq_source_fullname_entry,
+			   free_source_fullname_entry, xcalloc, xfree);
+
+  key.filename = (char *) filename;
+  key.dirname = (char *) dirname;
+  e = htab_find (source_fullname_cache, &key);
+  if (e != NULL)
+    return e->fullname != NULL ? xstrdup (e->fullname) : NULL;
+
+  fd = find_and_open_source (objfile, filename, dirname, &fullname);
+  if (fd >= 0)
+    close (fd);
+
+  e = XMALLOC (struct source_fullname_entry);
+  e->filename = xstrdup (filename);
+  e->dirname = dirname != NULL ? xstrdup (dirname) : NULL;
+  e->fullname = fullname != NULL ? xstrdup (fullname) : NULL;
+  slot = htab_find_slot (source_fullname_cache, &key, INSERT);
+  *slot = e;
+
+  return fullname;
+}
+/* APPLE LOCAL end source path cache  */
+
 /* Finds the fullname that a symtab represents.
 
    If this functions finds the fullname, it will save it in ps->fullname
@@ -1141,8 +1377,6 @@ open_source_file (struct symtab *s)
 char *
 symtab_to_fullname (struct symtab *s)
 {
-  int r;
-
   if (!s)
     return NULL;
 
@@ -1152,18 +1386,11 @@ symtab_to_fullname (struct symtab *s)
   if (s->fullname)
     return s->fullname;
 
-  /* Don't check s->fullname here, the file could have been 
-     deleted/moved/..., look for it again */
-  r = find_and_open_source (s->objfile, s->filename, s->dirname,
-			    &s->fullname);
-
-  if (r)
-    {
-      close (r);
-      return s->fullname;
-    }
-
-  return NULL;
+  /* APPLE LOCAL begin source path cache  */
+  s->fullname = cached_source_fullname (s->objfile, s->filename,
+					s->dirname);
+  return s->fullname;
+  /* APPLE LOCAL end source path cache  */
 }
 
 /* Finds the fullname that a partial_symtab represents.
@@ -1176,8 +1403,6 @@ symtab_to_fullname (struct symtab *s)
 char *
 psymtab_to_fullname (struct partial_symtab *ps)
 {
-  int r;
-
   if (!ps)
     return NULL;
 
@@ -1187,129 +1412,245 @@ psymtab_to_fullname (struct partial_symtab *ps)
   if (ps->fullname)
     return ps->fullname;
 
-  /* Don't check ps->fullname here, the file could have been
-     deleted/moved/..., look for it again */
-  r = find_and_open_source (ps->objfile, ps->filename, ps->dirname,
-			    &ps->fullname);
+  /* APPLE LOCAL begin source path cache  */
+  ps->fullname = cached_source_fullname (ps->objfile, ps->filename,
+					 ps->dirname);
+  return ps->fullname;
+  /* APPLE LOCAL end source path cache  */
+}
+
+/* APPLE LOCAL begin source text cache  */
+static void
+free_source_text (struct source_text *text)
+{
+#ifdef HAVE_MMAP
+  if (text->mapped)
+    munmap ((void *) text->data, text->size);
+  else
+#endif
+    xfree ((void *) text->data);
+  xfree (text->fullname);
+  xfree (text);
+}
+
+/* Unmap the text of every source file.  */
+
+static void
+forget_source_text_cache (void)
+{
+  struct source_text *text;
 
-  if (r) 
+  while ((text = source_text_cache) != NULL)
     {
-      close (r);
-      return ps->fullname;
+      source_text_cache = text->next;
+      free_source_text (text);
     }
-
-  return NULL;
 }
-
-/* Create and initialize the table S->line_charpos that records
-   the positions of the lines in the source file, which is assumed
-   to be open on descriptor DESC.
-   All set S->nlines to the number of such lines.  */
 
-void
-find_source_lines (struct symtab *s, int desc)
+/* Return the text of the source file of symtab S, which is open on
+   DESC.  The text stays valid until the next call.  */
+
+static struct source_text *
+source_text_get (struct symtab *s, int desc)
 {
+  const char *name = s->fullname != NULL ? s->fullname : s->filename;
+  struct source_text *text, **prev;
   struct stat st;
-  int nlines = 0;
-  int lines_allocated = 1000;
-  int *line_charpos;
-  long mtime = 0;
-  int size;
+  int n;
 
-  line_charpos = (int *) xmalloc (lines_allocated * sizeof (int));
   if (fstat (desc, &st) < 0)
     perror_with_name (s->filename);
 
-  if (s && s->objfile && s->objfile->obfd)
-    mtime = bfd_get_mtime (s->objfile->obfd);
-  else if (exec_bfd)
-    mtime = bfd_get_mtime (exec_bfd);
-
-  if (mtime && mtime < st.st_mtime)
-    warning (_("Source file is more recent than executable."));
-
-#ifdef LSEEK_NOT_LINEAR
-  {
-    char c, oldc;
-    int eol = 0;
-
-    /* Have to read it byte by byte to find out where the chars live */
-
-    line_charpos[0] = lseek (desc, 0, SEEK_CUR);
-    nlines = 1;
-    while (myread (desc, &c, 1) > 0)
+  for (prev = &source_text_cache; (text = *prev) != NULL; prev = &text->next)
+    if (strcmp (text->fullname, name) == 0)
       {
-	if (eol && ((c != '\n') || (oldc != '\r')))
+	*prev = text->next;
+	if (text->dev == st.st_dev && text->ino == st.st_ino
+	    && text->st_size == st.st_size && text->mtime == st.st_mtime)
 	  {
-	    eol = 0;
-	    if (nlines == lines_allocated)
-	      {
-		lines_allocated *= 2;
-		line_charpos =
-		  (int *) xrealloc ((char *) line_charpos,
-				    sizeof (int) * lines_allocated);
-	      }
-	    line_charpos[nlines++] = lseek (desc, 0, SEEK_CUR) - 1;
-	  }
-	if ((c == '\n') || (c == '\r'))
-	  {
-	    eol = 1;
-	    oldc = c;
+	    text->next = source_text_cache;
+	    source_text_cache = text;
+	    return text;
 	  }
+
+	/* The file has changed under us.  */
+	free_source_text (text);
+	break;
       }
-  }
-#else /* lseek linear.  */
-  {
-    struct cleanup *old_cleanups;
-    int eol = 0;
-    char oldc;
-    register char *data, *p, *end;
-
-    /* st_size might be a large type, but we only support source files whose 
-       size fits in an int.  */
-    size = (int) st.st_size;
-
-    /* Use malloc, not alloca, because this may be pretty large, and we may
-       run into various kinds of limits on stack size.  */
-    data = (char *) xmalloc (size);
-    old_cleanups = make_cleanup (xfree, data);
-
-    /* Reassign `size' to result of read for systems where \r\n -> \n.  */
-    size = myread (desc, data, size);
-    if (size < 0)
-      perror_with_name (s->filename);
-    end = data + size;
-    p = data;
-    line_charpos[0] = 0;
-    nlines = 1;
-    while (p != end)
+
+  text = XMALLOC (struct source_text);
+  text->fullname = xstrdup (name);
+  text->dev = st.st_dev;
+  text->ino = st.st_ino;
+  text->st_size = st.st_size;
+  text->mtime = st.st_mtime;
+  /* We only support source files whose size fits in an int.  */
+  text->size = (int) st.st_size;
+  text->data = NULL;
+  text->mapped = 0;
+
+#ifdef HAVE_MMAP
+  if (text->size > 0)
+    {
+      void *data = mmap (NULL, text->size, PROT_READ, MAP_PRIVATE, desc, 0);
+
+      if (data != MAP_FAILED)
+	{
+	  text->data = data;
+	  text->mapped = 1;
+	}
+    }
+#endif
+  if (!text->mapped)
+    {
+      char *data = xmalloc (text->size + 1);
+      int size;
+
+      if (lseek (desc, 0, SEEK_SET) < 0
+	  || (size = myread (desc, data, text->size)) < 0)
+	{
+	  xfree (data);
+	  xfree (text->fullname);
+	  xfree (text);
+	  perror_with_name (s->filename);
+	}
+      text->data = data;
+      text->size = size;
+    }
+
+  text->next = source_text_cache;
+  source_text_cache = text;
+
+  /* Drop the least recently used file if there are too many.  */
+  for (n = 1, prev = &source_text_cache->next; *prev != NULL;
+       n++, prev = &(*prev)->next)
+    if (n == SOURCE_TEXT_CACHE_SIZE)
       {
-	char c = *p++;
-	if (eol && ((c != '\n') || (oldc != '\r')))
-	  {
-	    eol = 0;
-	    if (nlines == lines_allocated)
-	      {
-		lines_allocated *= 2;
-		line_charpos =
-		  (int *) xrealloc ((char *) line_charpos,
-				    sizeof (int) * lines_allocated);
-	      }
-	    line_charpos[nlines++] = p - data - 1;
-	  }
-	if ((c == '\n') || (c == '\r'))
-	  {
-	    eol = 1;
-	    oldc = c;
-	  }
+	free_source_text (*prev);
+	*prev = NULL;
+	break;
       }
-    do_cleanups (old_cleanups);
-  }
-#endif /* lseek linear.  */
-  s->nlines = nlines;
-  s->line_charpos =
-    (int *) xrealloc ((char *) line_charpos, nlines * sizeof (int));
 
+  return text;
+}
+
+/* Add to S->line_charpos the positions of the lines of DATA, the
+   SIZE bytes of its source text, until it has LINE entries or covers
+   all of DATA.  A line ends with a newline, a carriage return, or
+   both in that order.  */
+
+static void
+scan_source_lines (struct symtab *s, const char *data, size_t size, int line)
+{
+  const char *end = data + size;
+  const char *p, *nl, *cr, *next;
+  int no_more_newlines = 0;
+
+  if (s->line_charpos == NULL)
+    {
+      s->line_charpos_size = 1000;
+      s->line_charpos = (int *) xmalloc (s->line_charpos_size * sizeof (int));
+      s->line_charpos[0] = 0;
+      s->nlines = 1;
+      s->line_charpos_complete = 0;
+    }
+
+  /* Pick up again at the start of the last line we know about.  */
+  p = data + s->line_charpos[s->nlines - 1];
+  if (p >= end)
+    s->line_charpos_complete = 1;
+
+  while (s->nlines < line && !s->line_charpos_complete)
+    {
+      /* memchr looks at a word or more at a time, which matters for
+	 source files of hundreds of megabytes.  */
+      nl = no_more_newlines ? NULL : memchr (p, '\n', end - p);
+      if (nl == NULL)
+	no_more_newlines = 1;
+      cr = memchr (p, '\r', (nl != NULL ? nl : end) - p);
+
+      if (cr != NULL)
+	next = (cr + 1 < end && cr[1] == '\n') ? cr + 2 : cr + 1;
+      else if (nl != NULL)
+	next = nl + 1;
+      else
+	next = end;
+
+      /* A line only starts if there is something after the end of the
+	 previous one.  */
+      if (next >= end)
+	{
+	  s->line_charpos_complete = 1;
+	  break;
+	}
+
+      if (s->nlines == s->line_charpos_size)
+	{
+	  s->line_charpos_size *= 2;
+	  s->line_charpos = (int *) xrealloc ((char *) s->line_charpos,
+					      (s->line_charpos_size
+					       * sizeof (int)));
+	}
+      s->line_charpos[s->nlines++] = next - data;
+      p = next;
+    }
+}
+
+int
+find_source_lines_upto (struct symtab *s, int desc, int line)
+{
+  struct source_text *text;
+
+  /* Get the text even if the lines we need are already known, to
+     notice a file that has changed since they were found.  It is
+     cached, so this costs an fstat.  */
+  text = source_text_get (s, desc);
+
+  /* The lines found so far are no use if the file has changed since;
+     start again.  */
+  if (s->line_charpos != NULL
+      && (s->line_charpos_mtime != text->mtime
+	  || s->line_charpos_fsize != (long) text->st_size))
+    {
+      xfree (s->line_charpos);
+      s->line_charpos = NULL;
+      s->line_charpos_size = 0;
+      s->nlines = 0;
+    }
+
+  if (s->line_charpos == NULL)
+    {
+      long mtime = 0;
+
+      if (s->objfile && s->objfile->obfd)
+	mtime = bfd_get_mtime (s->objfile->obfd);
+      else if (exec_bfd)
+	mtime = bfd_get_mtime (exec_bfd);
+
+      if (mtime && mtime < text->mtime)
+	warning (_("Source file is more recent than executable."));
+
+      s->line_charpos_mtime = text->mtime;
+      s->line_charpos_fsize = (long) text->st_size;
+    }
+
+  scan_source_lines (s, text->data, text->size, line);
+
+  return line >= 1 && line <= s->nlines;
+}
+/* APPLE LOCAL end source text cache  */
+
+/* Create and initialize the table S->line_charpos that records
+   the positions of the lines in the source file, which is assumed
+   to be open on descriptor DESC.
+   All set S->nlines to the number of such lines.  */
+
+void
+find_source_lines (struct symtab *s, int desc)
+{
+  /* APPLE LOCAL begin source text cache  */
+  find_source_lines_upto (s, desc, INT_MAX);
+  /* APPLE LOCAL end source text cache  */
 }
 
 /* Return the character position of a line LINE in symtab S.
@@ -1354,33 +1695,6 @@ source_charpos_line (struct symtab *s, int chr)
 #endif /* 0 */
 
 
-/* Get full pathname and line number positions for a symtab.
-   Return nonzero if line numbers may have changed.
-   Set *FULLNAME to actual name of the file as found by `openp',
-   or to 0 if the file is not found.  */
-
-static int
-get_filename_and_charpos (struct symtab *s, char **fullname)
-{
-  int desc, linenums_changed = 0;
-
-  desc = open_source_file (s);
-  if (desc < 0)
-    {
-      if (fullname)
-	*fullname = NULL;
-      return 0;
-    }
-  if (fullname)
-    *fullname = s->fullname;
-  if (s->line_charpos == 0)
-    linenums_changed = 1;
-  if (linenums_changed)
-    find_source_lines (s, desc);
-  close (desc);
-  return linenums_changed;
-}
-
 /* Print text describing the full name of the source file S
    and the line number LINE and its corresponding character position.
    The text starts with two Ctrl-z so that the Emacs-GDB interface
@@ -1394,8 +1708,18 @@ int
 identify_source_line (struct symtab *s, int line, int mid_statement,
 		      CORE_ADDR pc)
 {
-  if (s->line_charpos == 0)
-    get_filename_and_charpos (s, (char **) NULL);
+  /* APPLE LOCAL begin source text cache  */
+  if (s->line_charpos == 0
+      || (!s->line_charpos_complete && line > s->nlines))
+    {
+      int desc = open_source_file (s);
+
+      if (desc < 0)
+	return 0;
+      find_source_lines_upto (s, desc, line);
+      close (desc);
+    }
+  /* APPLE LOCAL end source text cache  */
   if (s->fullname == 0)
     return 0;
   if (line > s->nlines)
@@ -1423,11 +1747,14 @@ static void
 print_source_lines_base (struct symtab *s, int line, int nlines, int noerror)
 {
   int desc;
-  FILE *stream;
   int stopline = line + nlines;
   int c, oldc;
   int eol;
   int just_kidding_about_error = 0;
+  /* APPLE LOCAL begin source text cache  */
+  struct source_text *text;
+  const char *p, *end;
+  /* APPLE LOCAL end source text cache  */
 
   /* Regardless of whether we can open the file, set current_source_symtab. */
   current_source_symtab = s;
@@ -1498,26 +1825,24 @@ print_source_lines_base (struct symtab *s, int line, int nlines, int noerror)
       return;
     }
 
-  if (s->line_charpos == 0)
-    find_source_lines (s, desc);
-
-  if (line < 1 || line > s->nlines)
+  /* APPLE LOCAL begin source text cache  */
+  /* Only find the lines we need, and print them straight from the
+     cached text of the file.  */
+  if (!find_source_lines_upto (s, desc, line))
     {
       close (desc);
       error (_("Line number %d out of range; %s has %d lines."),
 	     line, s->filename, s->nlines);
     }
 
-  if (lseek (desc, s->line_charpos[line - 1], 0) < 0)
-    {
-      close (desc);
-      perror_with_name (s->filename);
-    }
-
-  stream = fdopen (desc, FDOPEN_MODE);
-  clearerr (stream);
+  text = source_text_get (s, desc);
+  close (desc);
+  p = text->data + s->line_charpos[line - 1];
+  end = text->data + text->size;
 
-  c = fgetc (stream);
+#define NEXT_SOURCE_CHAR() (p < end ? (unsigned char) *p++ : EOF)
+  c = NEXT_SOURCE_CHAR ();
+  /* APPLE LOCAL end source text cache  */
   eol = 0;
 
   while (nlines-- > 0)
@@ -1550,15 +1875,16 @@ print_source_lines_base (struct symtab *s, int line, int nlines, int noerror)
 	    {
 	      ui_out_text_fmt (uiout, "%c", c);
 	    }
-          c = fgetc (stream);
+	  /* APPLE LOCAL source text cache  */
+          c = NEXT_SOURCE_CHAR ();
           if (c == EOF)
             break;
         }
       
       ui_out_text (uiout, "\n");
     }
-
-  fclose (stream);
+  /* APPLE LOCAL source text cache  */
+#undef NEXT_SOURCE_CHAR
 }
 
 /* Show source lines from the file of symtab S, starting with line
@@ -1694,7 +2020,8 @@ void convert_sal (struct symtab_and_line *sal)
   if (! linetable->lines_are_chars)
     return;
   
-  if (symtab->line_charpos == 0)
+  /* APPLE LOCAL source text cache  */
+  if (symtab->line_charpos == 0 || !symtab->line_charpos_complete)
     {
       fd = open_source_file (symtab);
       if (fd < 0)
@@ -1739,14 +2066,13 @@ forward_search_command (char *regex, int from_tty)
   if (desc < 0)
     perror_with_name (current_source_symtab->filename);
 
-  if (current_source_symtab->line_charpos == 0)
-    find_source_lines (current_source_symtab, desc);
-
-  if (line < 1 || line > current_source_symtab->nlines)
+  /* APPLE LOCAL begin source text cache  */
+  if (!find_source_lines_upto (current_source_symtab, desc, line))
     {
       close (desc);
       error (_("Expression not found"));
     }
+  /* APPLE LOCAL end source text cache  */
 
   if (lseek (desc, current_source_symtab->line_charpos[line - 1], 0) < 0)
     {
@@ -1833,14 +2159,13 @@ reverse_search_command (char *regex, int from_tty)
   if (desc < 0)
     perror_with_name (current_source_symtab->filename);
 
-  if (current_source_symtab->line_charpos == 0)
-    find_source_lines (current_source_symtab, desc);
-
-  if (line < 1 || line > current_source_symtab->nlines)
+  /* APPLE LOCAL begin source text cache  */
+  if (!find_source_lines_upto (current_source_symtab, desc, line))
     {
       close (desc);
       error (_("Expression not found"));
     }
+  /* APPLE LOCAL end source text cache  */
 
   if (lseek (desc, current_source_symtab->line_charpos[line - 1], 0) < 0)
     {
@@ -36,6 +36,13 @@ extern char* symtab_to_fullname (struct symtab *s);
    lines.  */
 extern void find_source_lines (struct symtab *s, int desc);
 
+/* APPLE LOCAL begin source text cache  */
+/* Make sure S->line_charpos covers line LINE of the source file open
+   on DESC, or the whole file if it has fewer lines, and return
+   non-zero if the file has a line LINE.  */
+extern int find_source_lines_upto (struct symtab *s, int desc, int line);
+/* APPLE LOCAL end source text cache  */
+
 /* Return the first line listed by print_source_lines.
    Used by command interpreters to request listing from
    a previous point. */
@@ -73,4 +80,13 @@ extern void clear_current_source_symtab_and_line (void);
 void convert_sal (struct symtab_and_line *sal);
 
 void add_one_pathname_substitution (const char *old, const char *new);
+
+/* APPLE LOCAL begin source path cache  */
+/* Return the gdb_realpath of FILENAME, cached until the next
+   forget_cached_source_info.  The result must not be freed.  */
+extern const char *source_realpath (const char *filename);
+
+/* Empty the caches of source full names and real paths.  */
+extern void forget_cached_source_paths (void);
+/* APPLE LOCAL end source path cache  */
 #endif
@@ -1383,6 +1383,8 @@ replace_psymbols_with_correct_psymbols (struct objfile *exe_obj)
      provide a good example of what is possible to do.  */
 
   dsym_obj->psymtabs = NULL;
+  /* APPLE LOCAL psymtab indexes  */
+  invalidate_psymtab_indexes (dsym_obj);
 
   ALL_OBJFILE_PSYMTABS (exe_obj, exe_pst)
     {
@@ -1465,6 +1467,8 @@ replace_psymbols_with_correct_psymbols (struct objfile *exe_obj)
 
   exe_obj->psymtabs = NULL;
   exe_obj->symtabs = NULL;
+  /* APPLE LOCAL psymtab indexes  */
+  invalidate_psymtab_indexes (exe_obj);
 
   tell_breakpoints_objfile_changed (dsym_obj);
   tell_objc_msgsend_cacher_objfile_changed (dsym_obj);
@@ -3597,14 +3601,17 @@ reread_symbols_for_objfile (struct objfile *objfile, long new_modtime,
   objfile->symtabs = NULL;
   objfile->psymtabs = NULL;
   objfile->free_psymtabs = NULL;
+  /* APPLE LOCAL psymtab indexes  */
+  invalidate_psymtab_indexes (objfile);
   objfile->cp_namespace_symtab = NULL;
   objfile->msymbols = NULL;
   objfile->deprecated_sym_private = NULL;
   objfile->minimal_symbol_count = 0;
-  memset (&objfile->msymbol_hash, 0,
-	  sizeof (objfile->msymbol_hash));
-  memset (&objfile->msymbol_demangled_hash, 0,
-	  sizeof (objfile->msymbol_demangled_hash));
+  /* APPLE LOCAL begin sized msymbol hash  */
+  objfile->msymbol_hash = NULL;
+  objfile->msymbol_demangled_hash = NULL;
+  objfile->msymbol_hash_size = 0;
+  /* APPLE LOCAL end sized msymbol hash  */
   objfile->minimal_symbols_demangled = 0;
   objfile->fundamental_types = NULL;
   clear_objfile_data (objfile);
@@ -4223,6 +4230,8 @@ allocate_psymtab (char *filename, struct objfile *objfile)
   psymtab->objfile = objfile;
   psymtab->next = objfile->psymtabs;
   objfile->psymtabs = psymtab;
+  /* APPLE LOCAL psymtab indexes  */
+  invalidate_psymtab_indexes (objfile);
 #if 0
   {
     struct partial_symtab **prev_pst;
@@ -4269,6 +4278,9 @@ discard_psymtab (struct partial_symtab *pst)
 
   pst->next = pst->objfile->free_psymtabs;
   pst->objfile->free_psymtabs = pst;
+
+  /* APPLE LOCAL psymtab indexes  */
+  invalidate_psymtab_indexes (pst->objfile);
 }
 
 
@@ -4370,6 +4382,8 @@ cashier_psymtab (struct partial_symtab *pst)
 	pst->objfile->psymtabs = ps->next;
       else
 	pprev->next = ps->next;
+      /* APPLE LOCAL psymtab indexes  */
+      invalidate_psymtab_indexes (pst->objfile);
 
       /* FIXME, we can't conveniently deallocate the entries in the
          partial_symbol lists (global_psymbols/static_psymbols) that
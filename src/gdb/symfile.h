@@ -349,6 +349,8 @@ extern void dwarf2_scan_pubtype_for_psymbols (struct partial_symtab *,
 extern void dwarf2_scan_inlined_section_for_psymbols (struct partial_symtab *, 
 						      struct objfile *, 
 						      enum language);
+/* APPLE LOCAL maint info memory  */
+extern void dwarf2_objfile_memory_used (struct objfile *, long *, long *);
 
 /* From dbxread.c */
 
@@ -39,6 +39,9 @@
 #include "gdb_stat.h"
 #include "dictionary.h"
 #include "gdb_assert.h"
+/* APPLE LOCAL maint info memory  */
+#include "ui-out.h"
+#include "hashtab.h"
 
 #include "gdb_string.h"
 #include "readline/readline.h"
@@ -240,10 +243,253 @@ print_objfile_statistics (void)
 		     bcache_memory_used (objfile->psymbol_cache));
     printf_filtered (_("  Total memory used for macro cache: %d\n"),
 		     bcache_memory_used (objfile->macro_cache));
+    /* APPLE LOCAL sized msymbol hash  */
+    print_minimal_symbol_hash_statistics (objfile);
   }
   immediate_quit--;
 }
 
+/* APPLE LOCAL begin maint info memory  */
+
+/* Where the memory of one objfile goes, in bytes.  The fields marked
+   "on the obstack" are estimates of how much of OBSTACK they account
+   for; the other fields are allocated separately.  */
+
+struct objfile_memory_usage
+{
+  struct objfile *objfile;
+
+  long obstack;
+  long minsyms;			/* On the obstack.  */
+  long psymtabs;		/* On the obstack.  */
+  long symtabs;			/* On the obstack.  */
+  long types;			/* On the obstack.  */
+  long dwarf2_sections;		/* On the obstack.  */
+  long psymbol_cache;
+  long macro_cache;
+  long global_psymbols;
+  long static_psymbols;
+  long demangled_names;
+  long dwarf2_cus;
+  long inlining;
+
+  long total;
+};
+
+/* Estimate the memory used by the full symbol tables of OBJFILE: the
+   symtabs, their line tables, and the blocks and symbols of each
+   blockvector.  */
+
+static long
+objfile_symtabs_memory_used (struct objfile *objfile)
+{
+  struct symtab *s;
+  long bytes = 0;
+
+  ALL_OBJFILE_SYMTABS (objfile, s)
+    {
+      bytes += sizeof (struct symtab);
+
+      if (s->linetable != NULL && s->linetable->nitems > 0)
+	bytes += (sizeof (struct linetable)
+		  + (s->linetable->nitems - 1) * sizeof (struct linetable_entry));
+
+      /* Secondary symtabs share the blockvector of their primary.  */
+      if (s->primary)
+	{
+	  struct blockvector *bv = BLOCKVECTOR (s);
+	  int i;
+
+	  bytes += (sizeof (struct blockvector)
+		    + (BLOCKVECTOR_NBLOCKS (bv) - 1) * sizeof (struct block *));
+	  for (i = 0; i < BLOCKVECTOR_NBLOCKS (bv); i++)
+	    {
+	      struct block *b = BLOCKVECTOR_BLOCK (bv, i);
+	      struct dict_iterator iter;
+	      struct symbol *sym;
+
+	      bytes += sizeof (struct block);
+	      ALL_BLOCK_SYMBOLS (b, iter, sym)
+		bytes += sizeof (struct symbol) + sizeof (struct symbol *);
+	    }
+	}
+    }
+
+  return bytes;
+}
+
+static void
+objfile_memory_used (struct objfile *objfile,
+		     struct objfile_memory_usage *usage)
+{
+  struct partial_symtab *ps;
+
+  memset (usage, 0, sizeof (*usage));
+  usage->objfile = objfile;
+
+  usage->obstack = obstack_memory_used (&objfile->objfile_obstack);
+
+  if (objfile->minimal_symbol_count > 0)
+    usage->minsyms = ((objfile->minimal_symbol_count + 1)
+		      * sizeof (struct minimal_symbol)
+		      + 2 * objfile->msymbol_hash_size
+		      * sizeof (struct minimal_symbol *));
+
+  ALL_OBJFILE_PSYMTABS (objfile, ps)
+    usage->psymtabs += sizeof (struct partial_symtab);
+
+  usage->symtabs = objfile_symtabs_memory_used (objfile);
+  usage->types = (OBJSTAT (objfile, n_types)
+		  * (sizeof (struct type) + sizeof (struct main_type)));
+
+  usage->psymbol_cache = bcache_memory_used (objfile->psymbol_cache);
+  usage->macro_cache = bcache_memory_used (objfile->macro_cache);
+  usage->global_psymbols = (objfile->global_psymbols.size
+			    * sizeof (struct partial_symbol *));
+  usage->static_psymbols = (objfile->static_psymbols.size
+			    * sizeof (struct partial_symbol *));
+  if (objfile->demangled_names_hash != NULL)
+    usage->demangled_names = (htab_size (objfile->demangled_names_hash)
+			      * sizeof (void *));
+
+  dwarf2_objfile_memory_used (objfile, &usage->dwarf2_sections,
+			      &usage->dwarf2_cus);
+
+  if (objfile->inlined_subroutine_data != NULL)
+    usage->inlining
+      += inlined_subroutine_memory_used (objfile->inlined_subroutine_data, 0);
+  if (objfile->inlined_call_sites != NULL)
+    usage->inlining
+      += inlined_subroutine_memory_used (objfile->inlined_call_sites, 1);
+
+  usage->total = (usage->obstack + usage->psymbol_cache + usage->macro_cache
+		  + usage->global_psymbols + usage->static_psymbols
+		  + usage->demangled_names + usage->dwarf2_cus
+		  + usage->inlining);
+}
+
+/* qsort comparison function: the objfile using the most memory comes
+   first.  */
+
+static int
+compare_objfile_memory_usage (const void *a, const void *b)
+{
+  const struct objfile_memory_usage *ua = a;
+  const struct objfile_memory_usage *ub = b;
+
+  if (ua->total > ub->total)
+    return -1;
+  if (ua->total < ub->total)
+    return 1;
+  return 0;
+}
+
+static void
+print_memory_usage_field (int indent, const char *label, const char *fldname,
+			  long bytes)
+{
+  ui_out_text (uiout, n_spaces (indent));
+  ui_out_text (uiout, label);
+  ui_out_text (uiout, ": ");
+  ui_out_field_fmt (uiout, fldname, "%ld", bytes);
+  ui_out_text (uiout, "\n");
+}
+
+/* Implement "maint info memory [REGEXP]": report, for each objfile
+   whose name matches REGEXP, how many bytes its symbol tables use,
+   broken down by where they live.  The objfiles using the most
+   memory are listed first.  */
+
+void
+maintenance_info_memory (char *regexp, int from_tty)
+{
+  struct objfile *objfile;
+  struct objfile_memory_usage *usage;
+  struct cleanup *cleanup, *list_cleanup;
+  int n_objfiles = 0;
+  int i;
+  long total = 0;
+
+  if (regexp)
+    re_comp (regexp);
+
+  ALL_OBJFILES (objfile)
+    n_objfiles++;
+
+  usage = xcalloc (n_objfiles + 1, sizeof (struct objfile_memory_usage));
+  cleanup = make_cleanup (xfree, usage);
+
+  n_objfiles = 0;
+  immediate_quit++;
+  ALL_OBJFILES (objfile)
+    if (! regexp || re_exec (objfile->name))
+      objfile_memory_used (objfile, &usage[n_objfiles++]);
+  immediate_quit--;
+
+  qsort (usage, n_objfiles, sizeof (struct objfile_memory_usage),
+	 compare_objfile_memory_usage);
+
+  list_cleanup = make_cleanup_ui_out_list_begin_end (uiout, "objfiles");
+  for (i = 0; i < n_objfiles; i++)
+    {
+      struct objfile_memory_usage *u = &usage[i];
+      struct cleanup *tuple_cleanup;
+      long other;
+
+      QUIT;
+
+      tuple_cleanup = make_cleanup_ui_out_tuple_begin_end (uiout, "objfile");
+      ui_out_text (uiout, "Objfile `");
+      ui_out_field_string (uiout, "name", u->objfile->name);
+      ui_out_text (uiout, "': ");
+      ui_out_field_fmt (uiout, "total", "%ld", u->total);
+      ui_out_text (uiout, " bytes\n");
+
+      print_memory_usage_field (2, _("Objfile obstack"), "obstack",
+				u->obstack);
+      print_memory_usage_field (4, _("Minimal symbols"), "minimal-symbols",
+				u->minsyms);
+      print_memory_usage_field (4, _("Partial symbol tables"),
+				"partial-symtabs", u->psymtabs);
+      print_memory_usage_field (4, _("Full symbol tables"), "symtabs",
+				u->symtabs);
+      print_memory_usage_field (4, _("Types"), "types", u->types);
+      print_memory_usage_field (4, _("DWARF 2 sections"), "dwarf2-sections",
+				u->dwarf2_sections);
+      other = (u->obstack - u->minsyms - u->psymtabs - u->symtabs
+	       - u->types - u->dwarf2_sections);
+      print_memory_usage_field (4, _("Other"), "other",
+				other > 0 ? other : 0);
+      print_memory_usage_field (2, _("Partial symbol cache"),
+				"psymbol-cache", u->psymbol_cache);
+      print_memory_usage_field (2, _("Macro cache"), "macro-cache",
+				u->macro_cache);
+      print_memory_usage_field (2, _("Global partial symbol list"),
+				"global-psymbols", u->global_psymbols);
+      print_memory_usage_field (2, _("Static partial symbol list"),
+				"static-psymbols", u->static_psymbols);
+      print_memory_usage_field (2, _("Demangled name hash table"),
+				"demangled-names", u->demangled_names);
+      print_memory_usage_field (2, _("DWARF 2 cached compilation units"),
+				"dwarf2-cus", u->dwarf2_cus);
+      print_memory_usage_field (2, _("Inlined subroutine records"),
+				"inlining", u->inlining);
+      do_cleanups (tuple_cleanup);
+
+      total += u->total;
+    }
+  do_cleanups (list_cleanup);
+
+  ui_out_text (uiout, "Total: ");
+  ui_out_field_fmt (uiout, "total", "%ld", total);
+  ui_out_text (uiout, " bytes in ");
+  ui_out_field_int (uiout, "count", n_objfiles);
+  ui_out_text (uiout, n_objfiles == 1 ? " objfile.\n" : " objfiles.\n");
+
+  do_cleanups (cleanup);
+}
+/* APPLE LOCAL end maint info memory  */
+
 static void
 dump_objfile (struct objfile *objfile)
 {
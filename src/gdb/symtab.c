@@ -62,6 +62,16 @@
 /* APPLE LOCAL: So we can complain.  */
 #include "complaints.h"
 
+/* APPLE LOCAL begin parallel symbol search  */
+#ifdef HAVE_UNISTD_H
+#include <unistd.h>
+#endif
+#ifdef HAVE_PTHREAD_CREATE
+#include <pthread.h>
+#include <signal.h>
+#endif
+/* APPLE LOCAL end parallel symbol search  */
+
 /* APPLE LOCAL begin cache lookup values for improved performance  */
 
 asection * cached_mapped_section = NULL;
@@ -211,6 +221,290 @@ struct type *builtin_type_error;
 
 const struct block *block_found;
 
+/* APPLE LOCAL begin symtab filename index  */
+/* Each objfile keeps a hash table from the basenames of its symtab
+   and psymtab filenames to the symtabs and psymtabs themselves, so
+   that looking up a source file only has to look at the ones which
+   could match, rather than finding the full name of every one.  Any
+   match -- exact, by full path or by real path -- has the same
+   basename as the file asked for or as its real path.  */
+
+struct symtab_filename_node
+{
+  /* The symtab or psymtab.  */
+  void *tab;
+  int is_psymtab;
+  hashval_t hash;
+
+  /* Index of the next node in the same bucket, or -1.  Each bucket
+     keeps its symtabs, and its psymtabs, in list order.  */
+  int next;
+};
+
+struct symtab_filename_index
+{
+  /* OBJFILE->symtabs and OBJFILE->psymtabs when the index was last
+     brought up to date.  */
+  struct symtab *symtabs;
+  struct partial_symtab *psymtabs;
+
+  int n_buckets;
+  int *buckets;
+  int n_nodes;
+  int nodes_size;
+  struct symtab_filename_node *nodes;
+};
+
+void
+invalidate_symtab_filename_index (struct objfile *objfile)
+{
+  struct symtab_filename_index *index = objfile->symtab_filename_index;
+
+  if (index == NULL)
+    return;
+
+  xfree (index->buckets);
+  xfree (index->nodes);
+  xfree (index);
+  objfile->symtab_filename_index = NULL;
+}
+
+/* Hash a basename the way FILENAME_CMP compares them.  */
+
+static hashval_t
+hash_symtab_basename (const char *name)
+{
+#ifdef HAVE_DOS_BASED_FILE_SYSTEM
+  hashval_t hash = 0;
+
+  for (; *name != '\0'; name++)
+    hash = hash * 67 + tolower ((unsigned char) *name) - 113;
+  return hash;
+#else
+  return htab_hash_string (name);
+#endif
+}
+
+static void
+symtab_filename_index_add (struct symtab_filename_index *index, void *tab,
+			   int is_psymtab, const char *filename)
+{
+  struct symtab_filename_node *node;
+  int bucket;
+
+  if (index->n_nodes == index->nodes_size)
+    {
+      index->nodes_size = index->nodes_size * 2 + 16;
+      index->nodes = xrealloc (index->nodes, (index->nodes_size
+					      * sizeof (*index->nodes)));
+    }
+
+  node = &index->nodes[index->n_nodes];
+  node->tab = tab;
+  node->is_psymtab = is_psymtab;
+  node->hash = hash_symtab_basename (lbasename (filename));
+  bucket = node->hash % index->n_buckets;
+  node->next = index->buckets[bucket];
+  index->buckets[bucket] = index->n_nodes++;
+}
+
+/* Add the symtabs of OBJFILE in front of INDEX->symtabs to INDEX.  */
+
+static void
+symtab_filename_index_add_symtabs (struct objfile *objfile,
+				   struct symtab_filename_index *index)
+{
+  struct symtab *s;
+  struct symtab **new_symtabs;
+  int n, i;
+
+  n = 0;
+  for (s = objfile->symtabs; s != index->symtabs; s = s->next)
+    n++;
+
+  /* Add them last to first, so that prepending their nodes leaves
+     each bucket in list order.  */
+  new_symtabs = xmalloc ((n + 1) * sizeof (struct symtab *));
+  i = 0;
+  for (s = objfile->symtabs; s != index->symtabs; s = s->next)
+    new_symtabs[i++] = s;
+  while (i > 0)
+    {
+      s = new_symtabs[--i];
+      symtab_filename_index_add (index, s, 0, s->filename);
+    }
+  xfree (new_symtabs);
+
+  index->symtabs = objfile->symtabs;
+}
+
+static struct symtab_filename_index *
+build_symtab_filename_index (struct objfile *objfile)
+{
+  struct symtab_filename_index *index;
+  struct partial_symtab *pst;
+  struct partial_symtab **psymtabs;
+  struct symtab *s;
+  int n, i;
+
+  index = XMALLOC (struct symtab_filename_index);
+  memset (index, 0, sizeof (struct symtab_filename_index));
+
+  n = 0;
+  ALL_OBJFILE_PSYMTABS_INCL_OBSOLETED (objfile, pst)
+    n++;
+  ALL_OBJFILE_SYMTABS_INCL_OBSOLETED (objfile, s)
+    n++;
+
+  /* Leave room for the symtabs that expanding the psymtabs will
+     add.  */
+  index->n_buckets = (2 * n) | 1;
+  index->buckets = xmalloc (index->n_buckets * sizeof (int));
+  for (i = 0; i < index->n_buckets; i++)
+    index->buckets[i] = -1;
+
+  psymtabs = xmalloc ((n + 1) * sizeof (struct partial_symtab *));
+  n = 0;
+  ALL_OBJFILE_PSYMTABS_INCL_OBSOLETED (objfile, pst)
+    psymtabs[n++] = pst;
+  while (n > 0)
+    {
+      pst = psymtabs[--n];
+      symtab_filename_index_add (index, pst, 1, pst->filename);
+    }
+  xfree (psymtabs);
+  index->psymtabs = objfile->psymtabs;
+
+  index->symtabs = NULL;
+  symtab_filename_index_add_symtabs (objfile, index);
+
+  return index;
+}
+
+/* Return the filename index of OBJFILE, bringing it up to date
+   first.  */
+
+static struct symtab_filename_index *
+objfile_symtab_filename_index (struct objfile *objfile)
+{
+  struct symtab_filename_index *index = objfile->symtab_filename_index;
+  struct symtab *s;
+
+  if (index != NULL && index->psymtabs != objfile->psymtabs)
+    invalidate_symtab_filename_index (objfile);
+  else if (index != NULL && index->symtabs != objfile->symtabs)
+    {
+      /* Symtabs are only ever added at the front of the list; if
+	 the old head is gone, the list was replaced.  Rebuild too
+	 if the buckets have got crowded.  */
+      for (s = objfile->symtabs; s != NULL; s = s->next)
+	if (s == index->symtabs)
+	  break;
+      if ((s == NULL && index->symtabs != NULL)
+	  || index->n_nodes > 2 * index->n_buckets)
+	invalidate_symtab_filename_index (objfile);
+      else
+	symtab_filename_index_add_symtabs (objfile, index);
+    }
+
+  if (objfile->symtab_filename_index == NULL)
+    objfile->symtab_filename_index = build_symtab_filename_index (objfile);
+
+  return objfile->symtab_filename_index;
+}
+
+/* Return an xmalloc'd, NULL-terminated vector of the symtabs (or
+   psymtabs, if IS_PSYMTAB is non-zero) whose filenames have the
+   basename BASE, in the order ALL_SYMTABS (or ALL_PSYMTABS) would
+   visit them.  Obsoleted ones are left out.  */
+
+static void **
+lookup_tabs_by_basename (const char *base, int is_psymtab)
+{
+  struct objfile *objfile;
+  struct symtab_filename_index *index;
+  struct symtab_filename_node *node;
+  hashval_t hash = hash_symtab_basename (base);
+  void **vec;
+  int n, size, i;
+
+  n = 0;
+  size = 8;
+  vec = xmalloc (size * sizeof (void *));
+
+  ALL_OBJFILES (objfile)
+    {
+      index = objfile_symtab_filename_index (objfile);
+      for (i = index->buckets[hash % index->n_buckets]; i != -1;
+	   i = node->next)
+	{
+	  const char *filename;
+
+	  node = &index->nodes[i];
+	  if (node->hash != hash || node->is_psymtab != is_psymtab)
+	    continue;
+
+	  if (is_psymtab)
+	    {
+	      struct partial_symtab *pst = node->tab;
+
+	      if (PSYMTAB_OBSOLETED (pst) == 51)
+		continue;
+	      filename = pst->filename;
+	    }
+	  else
+	    {
+	      struct symtab *s = node->tab;
+
+	      if (SYMTAB_OBSOLETED (s) == 51)
+		continue;
+	      filename = s->filename;
+	    }
+	  if (FILENAME_CMP (lbasename (filename), base) != 0)
+	    continue;
+
+	  if (n + 1 == size)
+	    {
+	      size *= 2;
+	      vec = xrealloc (vec, size * sizeof (void *));
+	    }
+	  vec[n++] = node->tab;
+	}
+    }
+
+  vec[n] = NULL;
+  return vec;
+}
+
+/* Return an xmalloc'd, NULL-terminated vector of the symtabs, or
+   psymtabs if IS_PSYMTAB is non-zero, which might be the file NAME:
+   those with the basename of NAME, followed by those with the
+   basename of REAL_PATH (its real path, or NULL) if that differs.  */
+
+static void **
+lookup_tabs_for_filename (const char *name, const char *real_path,
+			  int is_psymtab)
+{
+  void **vec, **more;
+  int n, m;
+
+  vec = lookup_tabs_by_basename (lbasename (name), is_psymtab);
+  if (real_path == NULL
+      || FILENAME_CMP (lbasename (real_path), lbasename (name)) == 0)
+    return vec;
+
+  more = lookup_tabs_by_basename (lbasename (real_path), is_psymtab);
+  for (n = 0; vec[n] != NULL; n++)
+    ;
+  for (m = 0; more[m] != NULL; m++)
+    ;
+  vec = xrealloc (vec, (n + m + 1) * sizeof (void *));
+  memcpy (vec + n, more, (m + 1) * sizeof (void *));
+  xfree (more);
+  return vec;
+}
+/* APPLE LOCAL end symtab filename index  */
+
 /* Check for a symtab of a specific name; first in symtabs, then in
    psymtabs.  *If* there is no '/' in the name, a match after a '/'
    in the symtab filename will also work.  */
@@ -220,9 +514,12 @@ lookup_symtab (const char *name)
 {
   struct symtab *s;
   struct partial_symtab *ps;
-  struct objfile *objfile;
   char *real_path = NULL;
   char *full_path = NULL;
+  /* APPLE LOCAL begin symtab filename index  */
+  struct symtab **candidates;
+  int i;
+  /* APPLE LOCAL end symtab filename index  */
 
   /* Here we are interested in canonicalizing an absolute path, not
      absolutizing a relative path.  */
@@ -230,15 +527,24 @@ lookup_symtab (const char *name)
     {
       full_path = xfullpath (name);
       make_cleanup (xfree, full_path);
-      real_path = gdb_realpath (name);
+      /* APPLE LOCAL source path cache  */
+      real_path = xstrdup (source_realpath (name));
       make_cleanup (xfree, real_path);
     }
 
 got_symtab:
 
+  /* APPLE LOCAL begin symtab filename index  */
+  /* Only symtabs with the right basename can match.  */
+  candidates = (struct symtab **) lookup_tabs_for_filename (name, real_path,
+							    0);
+  make_cleanup (xfree, candidates);
+  /* APPLE LOCAL end symtab filename index  */
+
   /* First, search for an exact match */
 
-  ALL_SYMTABS (objfile, s)
+  /* APPLE LOCAL symtab filename index  */
+  for (i = 0; (s = candidates[i]) != NULL; i++)
   {
     if (FILENAME_CMP (name, s->filename) == 0)
       {
@@ -262,8 +568,8 @@ got_symtab:
         char *fullname = symtab_to_fullname (s);
         if (fullname != NULL)
           {
-            char *rp = gdb_realpath (fullname);
-            make_cleanup (xfree, rp);
+	    /* APPLE LOCAL source path cache  */
+            const char *rp = source_realpath (fullname);
             if (FILENAME_CMP (real_path, rp) == 0)
               {
                 return s;
@@ -275,7 +581,8 @@ got_symtab:
   /* Now, search for a matching tail (only if name doesn't have any dirs) */
 
   if (lbasename (name) == name)
-    ALL_SYMTABS (objfile, s)
+    /* APPLE LOCAL symtab filename index  */
+    for (i = 0; (s = candidates[i]) != NULL; i++)
     {
       if (FILENAME_CMP (lbasename (s->filename), name) == 0)
 	return s;
@@ -335,13 +642,16 @@ lookup_symtab_all (const char *name)
 {
   struct symtab *s;
   struct partial_symtab **pst_arr;
-  struct objfile *objfile;
   char *real_path = NULL;
   char *full_path = NULL;
 
   struct symtab **sym_arr;
   int num_found;
   int max_num;
+  /* APPLE LOCAL begin symtab filename index  */
+  struct symtab **candidates;
+  int i;
+  /* APPLE LOCAL end symtab filename index  */
 
   num_found = 0;
   max_num = 5;
@@ -354,7 +664,8 @@ lookup_symtab_all (const char *name)
     {
       full_path = xfullpath (name);
       make_cleanup (xfree, full_path);
-      real_path = gdb_realpath (name);
+      /* APPLE LOCAL source path cache  */
+      real_path = xstrdup (source_realpath (name));
       make_cleanup (xfree, real_path);
 
       /* If FULL_PATH and REAL_PATH are the same, we're going to be doing
@@ -376,7 +687,6 @@ lookup_symtab_all (const char *name)
   pst_arr = lookup_partial_symtab_all (name, 1);
   if (pst_arr)
     {
-      int i;
       for (i = 0; pst_arr[i] != NULL; i++)
 	{
 	  
@@ -391,9 +701,17 @@ lookup_symtab_all (const char *name)
       xfree (pst_arr);
     }
 
+  /* APPLE LOCAL begin symtab filename index  */
+  /* Only symtabs with the right basename can match.  */
+  candidates = (struct symtab **) lookup_tabs_for_filename (name, real_path,
+							    0);
+  make_cleanup (xfree, candidates);
+  /* APPLE LOCAL end symtab filename index  */
+
   /* Now search the symtabs.  First, search for an exact match */
 
-  ALL_SYMTABS (objfile, s)
+  /* APPLE LOCAL symtab filename index  */
+  for (i = 0; (s = candidates[i]) != NULL; i++)
   {
     if (FILENAME_CMP (name, s->filename) == 0)
       {
@@ -419,8 +737,8 @@ lookup_symtab_all (const char *name)
         const char *fullname = symtab_to_fullname (s);
         if (fullname != NULL)
           {
-            char *rp = gdb_realpath (fullname);
-            make_cleanup (xfree, rp);
+	    /* APPLE LOCAL source path cache  */
+            const char *rp = source_realpath (fullname);
             if (FILENAME_CMP (real_path, rp) == 0)
               {
                 sym_arr = add_symtab_to_array (sym_arr, s, &num_found, &max_num);
@@ -435,7 +753,8 @@ lookup_symtab_all (const char *name)
      already got that from the direct compare above.  */
 
   if (lbasename (name) == name)
-    ALL_SYMTABS (objfile, s)
+    /* APPLE LOCAL symtab filename index  */
+    for (i = 0; (s = candidates[i]) != NULL; i++)
     {
       const char *s_basename = lbasename (s->filename);
 
@@ -464,9 +783,12 @@ struct partial_symtab *
 lookup_partial_symtab (const char *name)
 {
   struct partial_symtab *pst;
-  struct objfile *objfile;
   char *full_path = NULL;
   char *real_path = NULL;
+  /* APPLE LOCAL begin symtab filename index  */
+  struct partial_symtab **candidates;
+  int i;
+  /* APPLE LOCAL end symtab filename index  */
 
   /* Here we are interested in canonicalizing an absolute path, not
      absolutizing a relative path.  */
@@ -474,11 +796,19 @@ lookup_partial_symtab (const char *name)
     {
       full_path = xfullpath (name);
       make_cleanup (xfree, full_path);
-      real_path = gdb_realpath (name);
+      /* APPLE LOCAL source path cache  */
+      real_path = xstrdup (source_realpath (name));
       make_cleanup (xfree, real_path);
     }
 
-  ALL_PSYMTABS (objfile, pst)
+  /* APPLE LOCAL begin symtab filename index  */
+  /* Only psymtabs with the right basename can match.  */
+  candidates = (struct partial_symtab **)
+    lookup_tabs_for_filename (name, real_path, 1);
+  make_cleanup (xfree, candidates);
+
+  for (i = 0; (pst = candidates[i]) != NULL; i++)
+  /* APPLE LOCAL end symtab filename index  */
   {
     if (FILENAME_CMP (name, pst->filename) == 0)
       {
@@ -500,14 +830,12 @@ lookup_partial_symtab (const char *name)
 
     if (real_path != NULL)
       {
-        char *rp = NULL;
+        /* APPLE LOCAL source path cache  */
+        const char *rp = NULL;
         if (pst->fullname == NULL)
           source_full_path_of (pst->filename, &pst->fullname);
         if (pst->fullname != NULL)
-          {
-            rp = gdb_realpath (pst->fullname);
-            make_cleanup (xfree, rp);
-          }
+          rp = source_realpath (pst->fullname);
         if (rp != NULL && FILENAME_CMP (real_path, rp) == 0)
           {
             return pst;
@@ -518,7 +846,8 @@ lookup_partial_symtab (const char *name)
   /* Now, search for a matching tail (only if name doesn't have any dirs) */
 
   if (lbasename (name) == name)
-    ALL_PSYMTABS (objfile, pst)
+    /* APPLE LOCAL symtab filename index  */
+    for (i = 0; (pst = candidates[i]) != NULL; i++)
     {
       if (FILENAME_CMP (lbasename (pst->filename), name) == 0)
         return (pst);
@@ -554,9 +883,12 @@ struct partial_symtab **
 lookup_partial_symtab_all (const char *name, int only_unread)
 {
   struct partial_symtab *pst;
-  struct objfile *objfile;
   char *full_path = NULL;
   char *real_path = NULL;
+  /* APPLE LOCAL begin symtab filename index  */
+  struct partial_symtab **candidates;
+  int i;
+  /* APPLE LOCAL end symtab filename index  */
 
   struct partial_symtab **psym_arr;
   int num_found;
@@ -574,7 +906,8 @@ lookup_partial_symtab_all (const char *name, int only_unread)
     {
       full_path = xfullpath (name);
       make_cleanup (xfree, full_path);
-      real_path = gdb_realpath (name);
+      /* APPLE LOCAL source path cache  */
+      real_path = xstrdup (source_realpath (name));
       make_cleanup (xfree, real_path);
 
       /* If FULL_PATH and REAL_PATH are the same, we're going to be doing
@@ -583,7 +916,14 @@ lookup_partial_symtab_all (const char *name, int only_unread)
         real_path = NULL;
     }
 
-  ALL_PSYMTABS (objfile, pst)
+  /* APPLE LOCAL begin symtab filename index  */
+  /* Only psymtabs with the right basename can match.  */
+  candidates = (struct partial_symtab **)
+    lookup_tabs_for_filename (name, real_path, 1);
+  make_cleanup (xfree, candidates);
+
+  for (i = 0; (pst = candidates[i]) != NULL; i++)
+  /* APPLE LOCAL end symtab filename index  */
   {
     if (FILENAME_CMP (name, pst->filename) == 0)
       {
@@ -612,13 +952,11 @@ lookup_partial_symtab_all (const char *name, int only_unread)
 
     if (real_path != NULL)
       {
-        char *rp = NULL;
+        /* APPLE LOCAL source path cache  */
+        const char *rp = NULL;
 	psymtab_to_fullname (pst);
         if (pst->fullname != NULL)
-          {
-            rp = gdb_realpath (pst->fullname);
-            make_cleanup (xfree, rp);
-          }
+          rp = source_realpath (pst->fullname);
 	if (rp != NULL && FILENAME_CMP (real_path, rp) == 0)
 	  {
 	    if (only_unread && pst->readin)
@@ -634,7 +972,8 @@ lookup_partial_symtab_all (const char *name, int only_unread)
   /* Now, search for a matching tail (only if name doesn't have any dirs) */
 
   if (lbasename (name) == name)
-    ALL_PSYMTABS (objfile, pst)
+    /* APPLE LOCAL symtab filename index  */
+    for (i = 0; (pst = candidates[i]) != NULL; i++)
     {
       /* Don't pass here if the pst->filename doesn't have any dirs either,
 	 since we've already gotten that above.  */
@@ -1090,6 +1429,549 @@ init_address_context (struct address_context *addr_ctx)
 
 /* APPLE LOCAL end addr_ctx.  */
 
+/* APPLE LOCAL begin psymtab addrmap  */
+/* An interval index over the [textlow, texthigh) ranges of the
+   psymtabs of one objfile.  The psymtabs are kept in an array sorted
+   by TEXTLOW, which is treated as an implicit balanced binary tree
+   (the root of the subrange [LO, HI] is its midpoint); MAX_HIGH[I]
+   holds the largest TEXTHIGH in the subtree rooted at I.  That lets
+   us find every psymtab containing an address in O(log n + matches)
+   even when ranges overlap, as they do for OBJF_REORDERED objfiles.  */
+
+struct psymtab_addrmap
+{
+  /* OBJFILE->psymtabs at the time the map was built.  Psymtabs are
+     prepended to that list, so a different head means the map is
+     stale.  */
+  struct partial_symtab *head;
+
+  /* Number of psymtabs with a non-empty text range.  */
+  int count;
+
+  /* The psymtabs, sorted by TEXTLOW.  */
+  struct partial_symtab **psymtabs;
+
+  /* Position of each psymtab in OBJFILE->psymtabs; lookups return
+     their matches in list order, as the old linear search did.  */
+  int *order;
+
+  CORE_ADDR *max_high;
+
+  /* Scratch space for the results of a lookup.  */
+  struct partial_symtab **matches;
+  int *match_order;
+};
+
+struct psymtab_addrmap_entry
+{
+  struct partial_symtab *pst;
+  int order;
+};
+
+static int
+compare_psymtab_addrmap_entries (const void *a, const void *b)
+{
+  const struct psymtab_addrmap_entry *ea = a;
+  const struct psymtab_addrmap_entry *eb = b;
+
+  if (ea->pst->textlow != eb->pst->textlow)
+    return ea->pst->textlow < eb->pst->textlow ? -1 : 1;
+  return ea->order - eb->order;
+}
+
+static CORE_ADDR
+psymtab_addrmap_fill_max (struct psymtab_addrmap *map, int lo, int hi)
+{
+  int mid;
+  CORE_ADDR high, sub;
+
+  if (lo > hi)
+    return 0;
+
+  mid = lo + (hi - lo) / 2;
+  high = map->psymtabs[mid]->texthigh;
+  sub = psymtab_addrmap_fill_max (map, lo, mid - 1);
+  if (sub > high)
+    high = sub;
+  sub = psymtab_addrmap_fill_max (map, mid + 1, hi);
+  if (sub > high)
+    high = sub;
+
+  map->max_high[mid] = high;
+  return high;
+}
+
+void
+invalidate_psymtab_addrmap (struct objfile *objfile)
+{
+  struct psymtab_addrmap *map = objfile->psymtab_addrmap;
+
+  if (map == NULL)
+    return;
+
+  xfree (map->psymtabs);
+  xfree (map->order);
+  xfree (map->max_high);
+  xfree (map->matches);
+  xfree (map->match_order);
+  xfree (map);
+  objfile->psymtab_addrmap = NULL;
+}
+
+static struct psymtab_addrmap *
+build_psymtab_addrmap (struct objfile *objfile)
+{
+  struct psymtab_addrmap *map;
+  struct psymtab_addrmap_entry *entries;
+  struct partial_symtab *pst;
+  int n, i;
+
+  n = 0;
+  ALL_OBJFILE_PSYMTABS (objfile, pst)
+    n++;
+
+  entries = xmalloc ((n ? n : 1) * sizeof (struct psymtab_addrmap_entry));
+  n = 0;
+  i = 0;
+  ALL_OBJFILE_PSYMTABS (objfile, pst)
+    {
+      if (pst->textlow < pst->texthigh)
+	{
+	  entries[n].pst = pst;
+	  entries[n].order = i;
+	  n++;
+	}
+      i++;
+    }
+  qsort (entries, n, sizeof (struct psymtab_addrmap_entry),
+	 compare_psymtab_addrmap_entries);
+
+  map = XMALLOC (struct psymtab_addrmap);
+  map->head = objfile->psymtabs;
+  map->count = n;
+  if (n == 0)
+    n = 1;
+  map->psymtabs = xmalloc (n * sizeof (struct partial_symtab *));
+  map->order = xmalloc (n * sizeof (int));
+  map->max_high = xmalloc (n * sizeof (CORE_ADDR));
+  map->matches = xmalloc (n * sizeof (struct partial_symtab *));
+  map->match_order = xmalloc (n * sizeof (int));
+
+  for (i = 0; i < map->count; i++)
+    {
+      map->psymtabs[i] = entries[i].pst;
+      map->order[i] = entries[i].order;
+    }
+  xfree (entries);
+
+  psymtab_addrmap_fill_max (map, 0, map->count - 1);
+  return map;
+}
+
+/* Add every psymtab in the subtree [LO, HI] of MAP that contains PC
+   to MAP->matches, keeping the matches sorted by list order.  */
+
+static void
+psymtab_addrmap_collect (struct psymtab_addrmap *map, int lo, int hi,
+			 CORE_ADDR pc, int *nmatches)
+{
+  while (lo <= hi)
+    {
+      int mid = lo + (hi - lo) / 2;
+      struct partial_symtab *pst;
+
+      if (map->max_high[mid] <= pc)
+	return;
+
+      psymtab_addrmap_collect (map, lo, mid - 1, pc, nmatches);
+
+      pst = map->psymtabs[mid];
+      if (pst->textlow > pc)
+	return;
+
+      if (pc < pst->texthigh)
+	{
+	  int j = *nmatches;
+
+	  while (j > 0 && map->match_order[j - 1] > map->order[mid])
+	    {
+	      map->matches[j] = map->matches[j - 1];
+	      map->match_order[j] = map->match_order[j - 1];
+	      j--;
+	    }
+	  map->matches[j] = pst;
+	  map->match_order[j] = map->order[mid];
+	  (*nmatches)++;
+	}
+
+      lo = mid + 1;
+    }
+}
+
+/* Return the number of psymtabs of OBJFILE whose text range contains
+   PC, and store them, in psymtab list order, into *MATCHES.  The
+   vector belongs to the objfile's addrmap and is only valid until the
+   next lookup.  */
+
+static int
+psymtab_addrmap_lookup (struct objfile *objfile, CORE_ADDR pc,
+			struct partial_symtab ***matches)
+{
+  struct psymtab_addrmap *map = objfile->psymtab_addrmap;
+  int nmatches = 0;
+
+  if (objfile->psymtabs == NULL)
+    return 0;
+
+  if (map != NULL && map->head != objfile->psymtabs)
+    {
+      invalidate_psymtab_addrmap (objfile);
+      map = NULL;
+    }
+  if (map == NULL)
+    {
+      map = build_psymtab_addrmap (objfile);
+      objfile->psymtab_addrmap = map;
+    }
+
+  psymtab_addrmap_collect (map, 0, map->count - 1, pc, &nmatches);
+  *matches = map->matches;
+  return nmatches;
+}
+/* APPLE LOCAL end psymtab addrmap  */
+
+/* APPLE LOCAL begin psymtab name index  */
+/* A hash table from the search names of the psymbols of one objfile
+   to the psymtabs defining them, so that a global symbol lookup only
+   looks at the psymtabs which might define the symbol, instead of
+   binary-searching every psymtab of every objfile.
+
+   Names are hashed with msymbol_hash_iw, which agrees with the
+   strcmp_iw matching lookup_partial_symbol does.  Only the hash is
+   kept, not the name; lookup_partial_symbol still checks each
+   candidate, so a collision just costs an extra search.
+
+   The global and static psymbols have separate tables.  Hashing a
+   C++ or Java psymbol's search name demangles it, and static
+   psymbols are only demangled when needed (see symbol_set_names), so
+   the static table is built by the first lookup that falls through to
+   the static psymbols.  */
+
+struct psymtab_name_node
+{
+  unsigned int hash;
+
+  /* Position of the defining psymtab in OBJFILE->psymtabs.  */
+  int order;
+
+  /* Index of the next node in the same bucket, or -1.  Each bucket is
+     sorted by ORDER.  */
+  int next;
+
+  unsigned char domain;
+};
+
+struct psymtab_name_index
+{
+  /* OBJFILE->psymtabs and the lengths of its psymbol lists when the
+     index was built; if any of them change, the index is stale.  */
+  struct partial_symtab *head;
+  int n_global_psymbols;
+  int n_static_psymbols;
+
+  /* Every psymtab, obsoleted ones included, in list order.  */
+  int n_psymtabs;
+  struct partial_symtab **psymtabs;
+
+  /* The static psymbols' table, then the global psymbols'.  BUCKETS
+     is NULL until the table is built.  */
+  struct
+  {
+    /* Non-zero if some psymbols are matched by something other than
+       their search name (as Ada's are), in which case every psymtab
+       is a candidate.  */
+    int unusable;
+
+    int n_buckets;
+    int *buckets;
+    struct psymtab_name_node *nodes;
+  } table[2];
+
+  /* Positions of the psymtabs with psym equivalences.  */
+  int n_equiv;
+  int *equiv;
+};
+
+void
+invalidate_psymtab_name_index (struct objfile *objfile)
+{
+  struct psymtab_name_index *index = objfile->psymtab_name_index;
+
+  if (index == NULL)
+    return;
+
+  xfree (index->psymtabs);
+  xfree (index->table[0].buckets);
+  xfree (index->table[0].nodes);
+  xfree (index->table[1].buckets);
+  xfree (index->table[1].nodes);
+  xfree (index->equiv);
+  xfree (index);
+  objfile->psymtab_name_index = NULL;
+}
+
+/* APPLE LOCAL begin psymtab indexes  */
+void
+invalidate_psymtab_indexes (struct objfile *objfile)
+{
+  invalidate_psymtab_addrmap (objfile);
+  invalidate_psymtab_name_index (objfile);
+  invalidate_completion_name_index (objfile);
+  invalidate_symtab_filename_index (objfile);
+}
+/* APPLE LOCAL end psymtab indexes  */
+
+/* Add the N psymbols at PSYMS, from the psymtab at position ORDER, to
+   INDEX's table for global psymbols if GLOBAL is non-zero, or static
+   ones otherwise.  */
+
+static void
+psymtab_name_index_add (struct psymtab_name_index *index, int *n_nodes,
+			struct partial_symbol **psyms, int n, int order,
+			int global)
+{
+  int *buckets = index->table[global].buckets;
+  struct psymtab_name_node *nodes = index->table[global].nodes;
+  int i;
+
+  for (i = 0; i < n; i++)
+    {
+      struct partial_symbol *psym = psyms[i];
+      struct psymtab_name_node *node;
+      unsigned int hash;
+      int bucket;
+
+      if (SYMBOL_LANGUAGE (psym) == language_ada)
+	index->table[global].unusable = 1;
+
+      hash = msymbol_hash_iw (SYMBOL_SEARCH_NAME (psym));
+      bucket = hash % index->table[global].n_buckets;
+
+      /* Overloads and duplicate psymbols are common; one node per
+	 psymtab is enough.  */
+      if (buckets[bucket] != -1)
+	{
+	  node = &nodes[buckets[bucket]];
+	  if (node->order == order && node->hash == hash
+	      && node->domain == SYMBOL_DOMAIN (psym))
+	    continue;
+	}
+
+      node = &nodes[*n_nodes];
+      node->hash = hash;
+      node->order = order;
+      node->domain = SYMBOL_DOMAIN (psym);
+      node->next = buckets[bucket];
+      buckets[bucket] = (*n_nodes)++;
+    }
+}
+
+/* Build INDEX's table for the global psymbols of OBJFILE if GLOBAL is
+   non-zero, or for the static ones otherwise.  */
+
+static void
+build_psymtab_name_table (struct objfile *objfile,
+			  struct psymtab_name_index *index, int global)
+{
+  struct partial_symbol **list;
+  struct partial_symtab *pst;
+  int n_psyms, n_nodes, i;
+
+  list = (global ? objfile->global_psymbols.list
+	  : objfile->static_psymbols.list);
+
+  n_psyms = 0;
+  for (i = 0; i < index->n_psymtabs; i++)
+    {
+      pst = index->psymtabs[i];
+      n_psyms += global ? pst->n_global_syms : pst->n_static_syms;
+    }
+
+  index->table[global].n_buckets = n_psyms | 1;
+  index->table[global].buckets = xmalloc (index->table[global].n_buckets
+					  * sizeof (int));
+  for (i = 0; i < index->table[global].n_buckets; i++)
+    index->table[global].buckets[i] = -1;
+  index->table[global].nodes = xmalloc ((n_psyms + 1)
+					* sizeof (struct psymtab_name_node));
+
+  /* Add the psymtabs last to first, so that prepending their nodes
+     leaves each bucket in list order.  */
+  n_nodes = 0;
+  for (i = index->n_psymtabs - 1; i >= 0; i--)
+    {
+      pst = index->psymtabs[i];
+      if (global)
+	psymtab_name_index_add (index, &n_nodes, list + pst->globals_offset,
+				pst->n_global_syms, i, 1);
+      else
+	psymtab_name_index_add (index, &n_nodes, list + pst->statics_offset,
+				pst->n_static_syms, i, 0);
+    }
+}
+
+static struct psymtab_name_index *
+build_psymtab_name_index (struct objfile *objfile)
+{
+  struct psymtab_name_index *index;
+  struct partial_symtab *pst;
+  int i;
+
+  index = XMALLOC (struct psymtab_name_index);
+  memset (index, 0, sizeof (struct psymtab_name_index));
+  index->head = objfile->psymtabs;
+  index->n_global_psymbols = (objfile->global_psymbols.next
+			      - objfile->global_psymbols.list);
+  index->n_static_psymbols = (objfile->static_psymbols.next
+			      - objfile->static_psymbols.list);
+
+  ALL_OBJFILE_PSYMTABS_INCL_OBSOLETED (objfile, pst)
+    {
+      index->n_psymtabs++;
+      if (pst->equiv_psyms != NULL)
+	index->n_equiv++;
+    }
+
+  index->psymtabs = xmalloc ((index->n_psymtabs + 1)
+			     * sizeof (struct partial_symtab *));
+  index->equiv = xmalloc ((index->n_equiv + 1) * sizeof (int));
+
+  i = 0;
+  index->n_equiv = 0;
+  ALL_OBJFILE_PSYMTABS_INCL_OBSOLETED (objfile, pst)
+    {
+      if (pst->equiv_psyms != NULL)
+	index->equiv[index->n_equiv++] = i;
+      index->psymtabs[i++] = pst;
+    }
+
+  return index;
+}
+
+/* Store in *RESULT an xmalloc'd vector of the psymtabs of OBJFILE
+   which may define NAME in DOMAIN, among their global psymbols if
+   GLOBAL is non-zero or their static psymbols otherwise, and return
+   its length.  The psymtabs come in list order, skipping obsoleted
+   ones, and include any with psym equivalences if those are on.  The
+   caller must xfree *RESULT, which may be NULL.  */
+
+static int
+lookup_psymtabs_by_name (struct objfile *objfile, const char *name,
+			 int global, domain_enum domain,
+			 struct partial_symtab ***result)
+{
+  struct psymtab_name_index *index = objfile->psymtab_name_index;
+  struct partial_symtab **vec;
+  unsigned int hash;
+  int n, i, node, last;
+  int *equiv, *equiv_end;
+
+  *result = NULL;
+  if (objfile->psymtabs == NULL)
+    return 0;
+
+  if (index != NULL
+      && (index->head != objfile->psymtabs
+	  || index->n_global_psymbols != (objfile->global_psymbols.next
+					  - objfile->global_psymbols.list)
+	  || index->n_static_psymbols != (objfile->static_psymbols.next
+					  - objfile->static_psymbols.list)))
+    {
+      invalidate_psymtab_name_index (objfile);
+      index = NULL;
+    }
+  if (index == NULL)
+    {
+      index = build_psymtab_name_index (objfile);
+      objfile->psymtab_name_index = index;
+    }
+
+  global = global != 0;
+  if (index->table[global].buckets == NULL)
+    build_psymtab_name_table (objfile, index, global);
+
+  vec = xmalloc ((index->n_psymtabs + 1) * sizeof (struct partial_symtab *));
+  n = 0;
+
+  if (index->table[global].unusable)
+    {
+      for (i = 0; i < index->n_psymtabs; i++)
+	if (PSYMTAB_OBSOLETED (index->psymtabs[i]) != 51)
+	  vec[n++] = index->psymtabs[i];
+      *result = vec;
+      return n;
+    }
+
+  /* Walk the bucket, which is in list order, merging in the
+     psymtabs with equivalences as we go.  */
+  hash = msymbol_hash_iw (name);
+  node = index->table[global].buckets[hash % index->table[global].n_buckets];
+  equiv = index->equiv;
+  equiv_end = psym_equivalences ? equiv + index->n_equiv : equiv;
+  last = -1;
+  while (node != -1 || equiv < equiv_end)
+    {
+      struct psymtab_name_node *p = (node != -1
+				     ? &index->table[global].nodes[node]
+				     : NULL);
+      int order;
+
+      if (p != NULL && (p->hash != hash || p->domain != domain))
+	{
+	  node = p->next;
+	  continue;
+	}
+
+      if (p == NULL || (equiv < equiv_end && *equiv < p->order))
+	order = *equiv++;
+      else
+	{
+	  order = p->order;
+	  node = p->next;
+	}
+
+      if (order != last
+	  && PSYMTAB_OBSOLETED (index->psymtabs[order]) != 51)
+	vec[n++] = index->psymtabs[order];
+      last = order;
+    }
+
+  if (n == 0)
+    {
+      xfree (vec);
+      return 0;
+    }
+
+  *result = vec;
+  return n;
+}
+
+/* Iterate PS over every psymtab which may define NAME in DOMAIN, as
+   found by lookup_psymtabs_by_name, objfile by objfile.  VEC, N and I
+   are scratch variables; VEC is freed and cleared when each objfile's
+   psymtabs are exhausted.  Expanding a psymtab in the loop body can
+   throw, so callers free VEC with a free_current_contents cleanup,
+   which also covers leaving the loop early.  */
+
+#define ALL_PSYMTABS_DEFINING(objfile, ps, vec, n, i, name, global, domain) \
+  ALL_OBJFILES (objfile)						\
+    for ((n) = lookup_psymtabs_by_name ((objfile), (name), (global),	\
+					(domain), &(vec)), (i) = 0;	\
+	 (i) < (n) ? ((ps) = (vec)[(i)], 1)				\
+		   : (xfree (vec), (vec) = NULL, 0);			\
+	 (i)++)
+/* APPLE LOCAL end psymtab name index  */
+
 /* Find which partial symtab contains PC and SECTION.  Return 0 if
    none.  We return the psymtab that contains a symbol whose address
    exactly matches PC, or, if we cannot find an exact match, the
@@ -1132,100 +2014,93 @@ find_pc_sect_psymtab (CORE_ADDR pc, asection *section)
      we can hoist the psymtab-invariant sections check out.  */
   ALL_OBJFILES (objfile)
   {
+    /* APPLE LOCAL begin psymtab addrmap  */
+    struct partial_symtab **matches;
+    struct partial_symtab *best_pst;
+    struct partial_symbol *best_psym = NULL;
+    int nmatches, i;
+    /* APPLE LOCAL end psymtab addrmap  */
+
     /* APPLE LOCAL: We were passed in the section, so don't look in 
        objfiles that don't even share the bfd with that section...  */
 
     if (skip_non_matching_bfd (section, objfile))
       continue;
-    
-    ALL_OBJFILE_PSYMTABS (objfile, pst)
+
+    /* APPLE LOCAL begin psymtab addrmap  */
+    /* Only the psymtabs whose range contains PC are returned, in the
+       order the old ALL_OBJFILE_PSYMTABS walk would have seen them.  */
+    nmatches = psymtab_addrmap_lookup (objfile, pc, &matches);
+    if (nmatches == 0)
+      continue;
+
+    pst = matches[0];
+    best_pst = pst;
+
+    /* An objfile that has its functions reordered might have
+       many partial symbol tables containing the PC, but
+       we want the partial symbol table that contains the
+       function containing the PC.  */
+    if (!(objfile->flags & OBJF_REORDERED) &&
+	section == 0)	/* can't validate section this way */
+      {
+	cached_psymtab = pst;
+	return (pst);
+      }
+
+    if (msymbol == NULL)
+      {
+	cached_psymtab = pst;
+	return (pst);
+      }
+
+    /* The code range of partial symtabs sometimes overlap, so, in
+       the loop below, we need to check all partial symtabs and
+       find the one that fits better for the given PC address. We
+       select the partial symtab that contains a symbol whose
+       address is closest to the PC address.  By closest we mean
+       that find_pc_sect_symbol returns the symbol with address
+       that is closest and still less than the given PC.  */
+    for (i = 0; i < nmatches; i++)
       {
-	if (pc >= pst->textlow && pc < pst->texthigh)
+	struct partial_symtab *tpst = matches[i];
+	struct partial_symbol *p;
+
+	p = find_pc_sect_psymbol (tpst, pc, section);
+	if (p != NULL
+	    && SYMBOL_VALUE_ADDRESS (p)
+	    == SYMBOL_VALUE_ADDRESS (msymbol))
 	  {
-	    struct partial_symtab *tpst;
-	    struct partial_symtab *best_pst = pst;
-	    struct partial_symbol *best_psym = NULL;
-	    
-	    /* An objfile that has its functions reordered might have
-	       many partial symbol tables containing the PC, but
-	       we want the partial symbol table that contains the
-	       function containing the PC.  */
-	    if (!(objfile->flags & OBJF_REORDERED) &&
-		section == 0)	/* can't validate section this way */
-	      /* APPLE LOCAL begin cache lookup values for improved 
-		 performance  */
-	      {
-		cached_psymtab = pst;
-		return (pst);
-	      }
-	      /* APPLE LOCAL end cache lookup values for improved 
-		 performance  */
-	    
-	    if (msymbol == NULL)
-	      /* APPLE LOCAL begin cache lookup values for improved 
-		 performance  */
-	      {
-		cached_psymtab = pst;
-		return (pst);
-	      }
-	      /* APPLE LOCAL end cache lookup values for improved 
-		 performance  */
-	    
-	    /* The code range of partial symtabs sometimes overlap, so, in
-	       the loop below, we need to check all partial symtabs and
-	       find the one that fits better for the given PC address. We
-	       select the partial symtab that contains a symbol whose
-	       address is closest to the PC address.  By closest we mean
-	       that find_pc_sect_symbol returns the symbol with address
-	       that is closest and still less than the given PC.  */
-	    for (tpst = pst; tpst != NULL; tpst = tpst->next)
+	    cached_psymtab = tpst;
+	    return (tpst);
+	  }
+	if (p != NULL)
+	  {
+	    /* We found a symbol in this partial symtab which
+	       matches (or is closest to) PC, check whether it
+	       is closer than our current BEST_PSYM.  Since
+	       this symbol address is necessarily lower or
+	       equal to PC, the symbol closer to PC is the
+	       symbol which address is the highest.  */
+	    /* This way we return the psymtab which contains
+	       such best match symbol. This can help in cases
+	       where the symbol information/debuginfo is not
+	       complete, like for instance on IRIX6 with gcc,
+	       where no debug info is emitted for
+	       statics. (See also the nodebug.exp
+	       testcase.)  */
+	    if (best_psym == NULL
+		|| SYMBOL_VALUE_ADDRESS (p)
+		> SYMBOL_VALUE_ADDRESS (best_psym))
 	      {
-		if (pc >= tpst->textlow && pc < tpst->texthigh)
-		  {
-		    struct partial_symbol *p;
-		    
-		    p = find_pc_sect_psymbol (tpst, pc, section);
-		    if (p != NULL
-			&& SYMBOL_VALUE_ADDRESS (p)
-			== SYMBOL_VALUE_ADDRESS (msymbol))
-		      /* APPLE LOCAL begin cache lookup values for improved 
-			 performance  */
-		      {
-			cached_psymtab = tpst;
-			return (tpst);
-		      }
-		    /* APPLE LOCAL end cache lookup values for improved 
-		       performance  */
-		    if (p != NULL)
-		      {
-			/* We found a symbol in this partial symtab which
-			   matches (or is closest to) PC, check whether it
-			   is closer than our current BEST_PSYM.  Since
-			   this symbol address is necessarily lower or
-			   equal to PC, the symbol closer to PC is the
-			   symbol which address is the highest.  */
-			/* This way we return the psymtab which contains
-			   such best match symbol. This can help in cases
-			   where the symbol information/debuginfo is not
-			   complete, like for instance on IRIX6 with gcc,
-			   where no debug info is emitted for
-			   statics. (See also the nodebug.exp
-			   testcase.)  */
-			if (best_psym == NULL
-			    || SYMBOL_VALUE_ADDRESS (p)
-			    > SYMBOL_VALUE_ADDRESS (best_psym))
-			  {
-			    best_psym = p;
-			    best_pst = tpst;
-			  }
-		      }
-		  }
+		best_psym = p;
+		best_pst = tpst;
 	      }
-	    /* APPLE LOCAL cache lookup values for improved performance  */
-	    cached_psymtab = best_pst;
-	    return (best_pst);
 	  }
       }
+    cached_psymtab = best_pst;
+    return (best_pst);
+    /* APPLE LOCAL end psymtab addrmap  */
   }
   /* APPLE LOCAL cache lookup values for improved performance  */
   cached_psymtab = NULL;
@@ -2122,6 +2997,11 @@ lookup_symbol_aux_psymtabs (int block_index, const char *name,
   struct symbol_search *prev;
   struct symbol_search *current;
   /* APPLE LOCAL end return multiple symbols  */
+  /* APPLE LOCAL begin psymtab name index  */
+  struct partial_symtab **psymtabs = NULL;
+  int n_psymtabs, i;
+  struct cleanup *old_chain;
+  /* APPLE LOCAL end psymtab name index  */
 
   /* If we're called with a null string for some bizarre reason, just bail.  */
   if (name == NULL || name[0] == '\0'
@@ -2134,7 +3014,11 @@ lookup_symbol_aux_psymtabs (int block_index, const char *name,
       return NULL;
     }
 
-  ALL_PSYMTABS (objfile, ps)
+  /* APPLE LOCAL begin psymtab name index  */
+  old_chain = make_cleanup (free_current_contents, &psymtabs);
+  ALL_PSYMTABS_DEFINING (objfile, ps, psymtabs, n_psymtabs, i,
+			 name, psymtab_index, domain)
+  /* APPLE LOCAL end psymtab name index  */
   {
     /* Check to see if there is either a direct match, or a
        psym equivalence match.  */
@@ -2158,6 +3042,8 @@ lookup_symbol_aux_psymtabs (int block_index, const char *name,
 	  {
 	    warning ("Error expanding psymtab %s to symtab in "
 		     "lookup_symbol_aux_psymtabs()", ps->filename);
+	    /* APPLE LOCAL psymtab name index  */
+	    do_cleanups (old_chain);
 	    return NULL;
 	  }
 
@@ -2185,6 +3071,8 @@ lookup_symbol_aux_psymtabs (int block_index, const char *name,
               "(if a template, try specifying an instantiation: %s<type>).",
 			   block_index == GLOBAL_BLOCK ? "global" : "static",
 			   name, ps->filename, name, name);
+		/* APPLE LOCAL psymtab name index  */
+		do_cleanups (old_chain);
 		return NULL;
 		  }
 	      }
@@ -2240,10 +3128,14 @@ lookup_symbol_aux_psymtabs (int block_index, const char *name,
 	      }
 	    if (symtab != NULL)
 	      *symtab = s;
+	    /* APPLE LOCAL psymtab name index  */
+	    do_cleanups (old_chain);
 	    return fixup_symbol_section (sym, objfile);
 	  }
       }
   }
+  /* APPLE LOCAL psymtab name index  */
+  do_cleanups (old_chain);
 
   if (!find_all_occurrences
       || *sym_list == NULL)
@@ -2604,6 +3496,11 @@ basic_lookup_transparent_type (const char *name)
   struct blockvector *bv;
   struct objfile *objfile;
   struct block *block;
+  /* APPLE LOCAL begin psymtab name index  */
+  struct partial_symtab **psymtabs = NULL;
+  int n_psymtabs, i;
+  struct cleanup *old_chain;
+  /* APPLE LOCAL end psymtab name index  */
 
   /* Now search all the global symbols.  Do the symtab's first, then
      check the psymtab's. If a psymtab indicates the existence
@@ -2623,7 +3520,11 @@ basic_lookup_transparent_type (const char *name)
       }
   }
 
-  ALL_PSYMTABS (objfile, ps)
+  /* APPLE LOCAL begin psymtab name index  */
+  old_chain = make_cleanup (free_current_contents, &psymtabs);
+  ALL_PSYMTABS_DEFINING (objfile, ps, psymtabs, n_psymtabs, i,
+			 name, 1, STRUCT_DOMAIN)
+  /* APPLE LOCAL end psymtab name index  */
   {
     if (!ps->readin && lookup_partial_symbol (ps, name, NULL,
 					      1, STRUCT_DOMAIN))
@@ -2656,9 +3557,15 @@ basic_lookup_transparent_type (const char *name)
 	      }
 	  }
 	if (!TYPE_IS_OPAQUE (SYMBOL_TYPE (sym)))
-	  return SYMBOL_TYPE (sym);
+	  {
+	    /* APPLE LOCAL psymtab name index  */
+	    do_cleanups (old_chain);
+	    return SYMBOL_TYPE (sym);
+	  }
       }
   }
+  /* APPLE LOCAL psymtab name index  */
+  do_cleanups (old_chain);
 
   /* Now search the static file-level symbols.
      Not strictly correct, but more useful than an error.
@@ -2681,7 +3588,11 @@ basic_lookup_transparent_type (const char *name)
       }
   }
 
-  ALL_PSYMTABS (objfile, ps)
+  /* APPLE LOCAL begin psymtab name index  */
+  old_chain = make_cleanup (free_current_contents, &psymtabs);
+  ALL_PSYMTABS_DEFINING (objfile, ps, psymtabs, n_psymtabs, i,
+			 name, 0, STRUCT_DOMAIN)
+  /* APPLE LOCAL end psymtab name index  */
   {
     if (!ps->readin && lookup_partial_symbol (ps, name, NULL, 0, STRUCT_DOMAIN))
       {
@@ -2712,9 +3623,15 @@ basic_lookup_transparent_type (const char *name)
 	      }
 	  }
 	if (!TYPE_IS_OPAQUE (SYMBOL_TYPE (sym)))
-	  return SYMBOL_TYPE (sym);
+	  {
+	    /* APPLE LOCAL psymtab name index  */
+	    do_cleanups (old_chain);
+	    return SYMBOL_TYPE (sym);
+	  }
       }
   }
+  /* APPLE LOCAL psymtab name index  */
+  do_cleanups (old_chain);
   return (struct type *) 0;
 }
 
@@ -3802,17 +4719,25 @@ find_line_pc_range (struct symtab_and_line sal, CORE_ADDR *startptr,
   if (sal.symtab->linetable == NULL)
     return 0;
 
-  if ((sal.symtab->line_charpos == 0) && (sal.symtab->linetable->lines_are_chars))
+  if (sal.symtab->linetable->lines_are_chars)
     {
-      int fd = open_source_file (sal.symtab);
-      if (fd < 0)
+      /* APPLE LOCAL begin source text cache  */
+      /* The line table may only cover the lines found so far.  */
+      if (sal.symtab->line_charpos == 0
+	  || (!sal.symtab->line_charpos_complete
+	      && sal.line > sal.symtab->nlines))
+	{
+	  int fd = open_source_file (sal.symtab);
+	  if (fd < 0)
+	    return 0;
+	  find_source_lines_upto (sal.symtab, fd, sal.line);
+	  close (fd);
+	}
+      if (sal.line < 1 || sal.line > sal.symtab->nlines)
 	return 0;
-      find_source_lines (sal.symtab, fd);
-      close (fd);
+      /* APPLE LOCAL end source text cache  */
+      line = sal.symtab->line_charpos[sal.line - 1];
     }
-
-  if (sal.symtab->linetable->lines_are_chars)
-    line = sal.symtab->line_charpos[sal.line - 1];
   else
     line = sal.line;
 
@@ -4423,6 +5348,360 @@ sort_search_symbols (struct symbol_search *prevtail, int nfound)
   return symp;
 }
 
+/* APPLE LOCAL begin parallel symbol search  */
+/* "maint set symbol-search-threads": how many threads match the
+   regular expression of "info functions", "info variables", "info
+   types" and "rbreak" against symbol names.  One means the main
+   thread does everything; zero means one thread per online
+   processor.  */
+static int symbol_search_threads = 0;
+
+static void
+show_symbol_search_threads (struct ui_file *file, int from_tty,
+			    struct cmd_list_element *c, const char *value)
+{
+  fprintf_filtered (file, _("\
+The number of threads used to search symbol names is %s.\n"),
+		    value);
+}
+
+void (*search_symbols_progress_hook) (const char *phase, int done, int total,
+				      struct symbol_search *found,
+				      int nfound);
+
+/* The names that one pass of search_symbols matches against its
+   regular expression, and the psymtab, symbol or minimal symbol each
+   one came from.  The main thread collects the names, so a helper
+   thread never has to work out a symbol's natural name (which may
+   allocate).  Each thread compiles REGEXP for itself: the pattern
+   re_comp and re_exec share is not safe to use from several threads,
+   and regexec only lets one thread at a time use any one compiled
+   pattern.  */
+
+struct search_names
+{
+  const char *regexp;
+  const char **names;
+  void **items;
+  char *matched;
+  int n_names;
+  int size;
+};
+
+/* Names are matched this many at a time; between chunks the main
+   thread checks for a quit and reports its progress.  */
+#define SEARCH_NAMES_CHUNK 4096
+
+static void
+search_names_free (void *arg)
+{
+  struct search_names *sn = arg;
+
+  xfree (sn->names);
+  xfree (sn->items);
+  xfree (sn->matched);
+  memset (sn, 0, sizeof (struct search_names));
+}
+
+static void
+search_names_add (struct search_names *sn, const char *name, void *item)
+{
+  if (sn->n_names == sn->size)
+    {
+      sn->size = sn->size ? sn->size * 2 : 1024;
+      sn->names = xrealloc (sn->names, sn->size * sizeof (const char *));
+      sn->items = xrealloc (sn->items, sn->size * sizeof (void *));
+    }
+  sn->names[sn->n_names] = name;
+  sn->items[sn->n_names] = item;
+  sn->n_names++;
+}
+
+static void
+search_names_match_range (struct search_names *sn, regex_t *re,
+			  int lo, int hi)
+{
+  int i;
+
+  for (i = lo; i < hi; i++)
+    sn->matched[i] = re_exec_buf (re, sn->names[i]) != 0;
+}
+
+static void
+search_names_regfree (void *arg)
+{
+  regfree ((regex_t *) arg);
+}
+
+static void
+search_symbols_progress (const char *phase, int done, int total)
+{
+  if (search_symbols_progress_hook != NULL)
+    search_symbols_progress_hook (phase, done, total, NULL, 0);
+}
+
+#ifdef HAVE_PTHREAD_CREATE
+
+/* The helper threads matching one batch of names.  Chunks are handed
+   out in order to whichever thread asks next, the main thread
+   included; since every name has its own slot in MATCHED, the result
+   does not depend on which thread matched what.  */
+
+struct search_names_pool
+{
+  pthread_mutex_t lock;
+  pthread_cond_t cond;
+
+  struct search_names *sn;
+
+  /* The first name no thread has taken yet, and how many names have
+     been matched.  */
+  int next;
+  int n_done;
+
+  int stop;
+
+  pthread_t *threads;
+  int n_threads;
+};
+
+/* Take the next chunk of POOL's names, with POOL's lock held.  Return
+   the index of its first name, or -1 if there is nothing left to do;
+   the chunk ends at POOL->next.  */
+
+static int
+search_names_take_chunk (struct search_names_pool *pool)
+{
+  int lo = pool->next;
+
+  if (pool->stop || lo >= pool->sn->n_names)
+    return -1;
+  pool->next = min (lo + SEARCH_NAMES_CHUNK, pool->sn->n_names);
+  return lo;
+}
+
+static void *
+search_names_helper (void *arg)
+{
+  struct search_names_pool *pool = arg;
+  regex_t re;
+  int lo, hi;
+
+  /* The main thread has already compiled the same expression, so
+     this only fails if we run out of memory; leave the work to the
+     other threads then.  */
+  if (re_comp_buf (&re, pool->sn->regexp) != NULL)
+    return NULL;
+
+  pthread_mutex_lock (&pool->lock);
+  while ((lo = search_names_take_chunk (pool)) >= 0)
+    {
+      hi = pool->next;
+      pthread_mutex_unlock (&pool->lock);
+
+      search_names_match_range (pool->sn, &re, lo, hi);
+
+      pthread_mutex_lock (&pool->lock);
+      pool->n_done += hi - lo;
+      pthread_cond_broadcast (&pool->cond);
+    }
+  pthread_mutex_unlock (&pool->lock);
+
+  regfree (&re);
+  return NULL;
+}
+
+/* Stop POOL's threads and free it.  */
+
+static void
+search_names_stop_pool (void *arg)
+{
+  struct search_names_pool *pool = arg;
+  int i;
+
+  pthread_mutex_lock (&pool->lock);
+  pool->stop = 1;
+  pthread_mutex_unlock (&pool->lock);
+
+  for (i = 0; i < pool->n_threads; i++)
+    pthread_join (pool->threads[i], NULL);
+
+  pthread_cond_destroy (&pool->cond);
+  pthread_mutex_destroy (&pool->lock);
+  xfree (pool->threads);
+  xfree (pool);
+}
+
+/* Match SN's names with the help of "maint set symbol-search-threads"
+   threads; the main thread's share uses RE.  Return zero, having done
+   nothing, if no helper thread could be started.  */
+
+static int
+search_names_match_parallel (struct search_names *sn, regex_t *re,
+			     const char *phase)
+{
+  struct search_names_pool *pool;
+  struct cleanup *old_chain;
+  int n_threads = symbol_search_threads;
+  sigset_t all_signals, old_signals;
+  int i, lo, hi, done;
+
+  if (n_threads == 0)
+    {
+#ifdef _SC_NPROCESSORS_ONLN
+      n_threads = sysconf (_SC_NPROCESSORS_ONLN);
+#endif
+    }
+
+  /* The main thread is one of them, and there is no point in having
+     more threads than chunks.  */
+  n_threads = min (n_threads,
+		   (sn->n_names + SEARCH_NAMES_CHUNK - 1) / SEARCH_NAMES_CHUNK);
+  n_threads--;
+  if (n_threads < 1)
+    return 0;
+
+  pool = XZALLOC (struct search_names_pool);
+  pool->sn = sn;
+  pthread_mutex_init (&pool->lock, NULL);
+  pthread_cond_init (&pool->cond, NULL);
+
+  /* Signals are for the main thread; the helpers inherit a mask that
+     blocks them all.  */
+  sigfillset (&all_signals);
+  pthread_sigmask (SIG_BLOCK, &all_signals, &old_signals);
+
+  pool->threads = xcalloc (n_threads, sizeof (pthread_t));
+  for (i = 0; i < n_threads; i++)
+    {
+      if (pthread_create (&pool->threads[pool->n_threads], NULL,
+			  search_names_helper, pool) != 0)
+	break;
+      pool->n_threads++;
+    }
+
+  pthread_sigmask (SIG_SETMASK, &old_signals, NULL);
+
+  if (pool->n_threads == 0)
+    {
+      search_names_stop_pool (pool);
+      return 0;
+    }
+
+  old_chain = make_cleanup (search_names_stop_pool, pool);
+
+  pthread_mutex_lock (&pool->lock);
+  while ((lo = search_names_take_chunk (pool)) >= 0)
+    {
+      hi = pool->next;
+      pthread_mutex_unlock (&pool->lock);
+
+      search_names_match_range (sn, re, lo, hi);
+
+      pthread_mutex_lock (&pool->lock);
+      pool->n_done += hi - lo;
+      done = pool->n_done;
+      pthread_mutex_unlock (&pool->lock);
+
+      search_symbols_progress (phase, done, sn->n_names);
+      QUIT;
+
+      pthread_mutex_lock (&pool->lock);
+    }
+  while (pool->n_done < sn->n_names)
+    pthread_cond_wait (&pool->cond, &pool->lock);
+  pthread_mutex_unlock (&pool->lock);
+
+  do_cleanups (old_chain);
+  return 1;
+}
+
+#else /* HAVE_PTHREAD_CREATE */
+
+static int
+search_names_match_parallel (struct search_names *sn, regex_t *re,
+			     const char *phase)
+{
+  return 0;
+}
+
+#endif /* HAVE_PTHREAD_CREATE */
+
+/* Set SN->matched[I] to whether SN's name I matches the regular
+   expression REGEXP, which re_comp has accepted; if REGEXP is NULL,
+   everything matches.  PHASE names the pass of search_symbols for
+   search_symbols_progress_hook.  */
+
+static void
+search_names_match (struct search_names *sn, const char *phase,
+		    const char *regexp)
+{
+  struct cleanup *old_chain;
+  const char *val;
+  regex_t re;
+  int lo, hi;
+
+  sn->matched = xrealloc (sn->matched, sn->n_names + 1);
+  if (regexp == NULL)
+    {
+      memset (sn->matched, 1, sn->n_names);
+      return;
+    }
+
+  if (0 != (val = re_comp_buf (&re, regexp)))
+    error (_("Invalid regexp (%s): %s"), val, regexp);
+  old_chain = make_cleanup (search_names_regfree, &re);
+  sn->regexp = regexp;
+
+  if (sn->n_names <= SEARCH_NAMES_CHUNK
+      || !search_names_match_parallel (sn, &re, phase))
+    for (lo = 0; lo < sn->n_names; lo = hi)
+      {
+	hi = min (lo + SEARCH_NAMES_CHUNK, sn->n_names);
+	search_names_match_range (sn, &re, lo, hi);
+	search_symbols_progress (phase, hi, sn->n_names);
+	QUIT;
+      }
+
+  do_cleanups (old_chain);
+}
+
+/* Return non-zero if a symbol of class ACLASS is something
+   search_symbols looks for when searching KIND.  CONST_OK says
+   whether LOC_CONST symbols count as variables; the psymtab scan
+   lets them through, the symtab scan does not.  */
+
+static int
+search_symbols_class_p (domain_enum kind, enum address_class aclass,
+			int const_ok)
+{
+  switch (kind)
+    {
+    case VARIABLES_DOMAIN:
+      return (aclass != LOC_TYPEDEF && aclass != LOC_BLOCK
+	      && (const_ok || aclass != LOC_CONST));
+    case FUNCTIONS_DOMAIN:
+    case METHODS_DOMAIN:
+      return aclass == LOC_BLOCK;
+    case TYPES_DOMAIN:
+      return aclass == LOC_TYPEDEF;
+    default:
+      return 0;
+    }
+}
+
+/* The matches of one block of one symtab, found by the symtab pass of
+   search_symbols: they are the names before END that the previous
+   entry doesn't cover.  */
+
+struct search_block
+{
+  struct symtab *symtab;
+  int block;
+  int end;
+};
+/* APPLE LOCAL end parallel symbol search  */
+
 /* Search the symbol table for matches to the regular expression REGEXP,
    returning the results in *MATCHES.
 
@@ -4437,6 +5716,10 @@ sort_search_symbols (struct symbol_search *prevtail, int nfound)
 
    The results are sorted locally; each symtab's global and static blocks are
    separately alphabetized.
+
+   APPLE LOCAL: The names are matched in parallel if "maint set
+   symbol-search-threads" allows it, and search_symbols_progress_hook
+   is told how far the search has got and what it has found so far.
  */
 void
 search_symbols (char *regexp, domain_enum kind, int nfiles, char *files[],
@@ -4475,6 +5758,14 @@ search_symbols (char *regexp, domain_enum kind, int nfiles, char *files[],
   struct symbol_search *psr;
   struct symbol_search *tail;
   struct cleanup *old_chain = NULL;
+  /* APPLE LOCAL begin parallel symbol search  */
+  struct search_names sn, msn;
+  struct search_block *blocks = NULL;
+  int n_blocks = 0, blocks_size = 0;
+  struct partial_symtab *last_ps;
+  struct cleanup *back_to;
+  int j, k;
+  /* APPLE LOCAL end parallel symbol search  */
 
   if (kind < VARIABLES_DOMAIN)
     error (_("must search on specific domain"));
@@ -4523,61 +5814,57 @@ search_symbols (char *regexp, domain_enum kind, int nfiles, char *files[],
 	error (_("Invalid regexp (%s): %s"), val, regexp);
     }
 
+  /* APPLE LOCAL begin parallel symbol search  */
+  memset (&sn, 0, sizeof (struct search_names));
+  memset (&msn, 0, sizeof (struct search_names));
+  back_to = make_cleanup (search_names_free, &sn);
+  make_cleanup (search_names_free, &msn);
+  make_cleanup (free_current_contents, &blocks);
+
   /* Search through the partial symtabs *first* for all symbols
      matching the regexp.  That way we don't have to reproduce all of
-     the machinery below. */
+     the machinery below.
+
+     Each pass below first collects the names it needs to match, then
+     matches them all at once (in parallel, if there are enough of
+     them), and then goes through the results in the order the names
+     were collected, so the outcome is the same as if each name had
+     been matched where it was found.  */
 
   ALL_PSYMTABS (objfile, ps)
   {
-    struct partial_symbol **bound, **gbound, **sbound;
-    int keep_going = 1;
+    struct partial_symbol **gbound, **sbound;
 
-    if (ps->readin)
+    if (ps->readin || !file_matches (ps->filename, files, nfiles))
       continue;
 
-    gbound = objfile->global_psymbols.list + ps->globals_offset + ps->n_global_syms;
-    sbound = objfile->static_psymbols.list + ps->statics_offset + ps->n_static_syms;
-    bound = gbound;
+    QUIT;
 
-    /* Go through all of the symbols stored in a partial
-       symtab in one loop. */
-    psym = objfile->global_psymbols.list + ps->globals_offset;
-    while (keep_going)
-      {
-	if (psym >= bound)
-	  {
-	    if (bound == gbound && ps->n_static_syms != 0)
-	      {
-		psym = objfile->static_psymbols.list + ps->statics_offset;
-		bound = sbound;
-	      }
-	    else
-	      keep_going = 0;
-	    continue;
-	  }
-	else
-	  {
-	    QUIT;
-
-	    /* If it would match (logic taken from loop below)
-	       load the file and go on to the next one */
-	    if (file_matches (ps->filename, files, nfiles)
-		&& ((regexp == NULL
-		     || re_exec (SYMBOL_NATURAL_NAME (*psym)) != 0)
-		    && ((kind == VARIABLES_DOMAIN && SYMBOL_CLASS (*psym) != LOC_TYPEDEF
-			 && SYMBOL_CLASS (*psym) != LOC_BLOCK)
-			|| (kind == FUNCTIONS_DOMAIN && SYMBOL_CLASS (*psym) == LOC_BLOCK)
-			|| (kind == TYPES_DOMAIN && SYMBOL_CLASS (*psym) == LOC_TYPEDEF)
-			|| (kind == METHODS_DOMAIN && SYMBOL_CLASS (*psym) == LOC_BLOCK))))
-	      {
-		PSYMTAB_TO_SYMTAB (ps);
-		keep_going = 0;
-	      }
-	  }
-	psym++;
-      }
+    gbound = objfile->global_psymbols.list + ps->globals_offset + ps->n_global_syms;
+    sbound = objfile->static_psymbols.list + ps->statics_offset + ps->n_static_syms;
+
+    for (psym = objfile->global_psymbols.list + ps->globals_offset;
+	 psym < gbound; psym++)
+      if (search_symbols_class_p (kind, SYMBOL_CLASS (*psym), 1))
+	search_names_add (&sn, SYMBOL_NATURAL_NAME (*psym), ps);
+    for (psym = objfile->static_psymbols.list + ps->statics_offset;
+	 psym < sbound; psym++)
+      if (search_symbols_class_p (kind, SYMBOL_CLASS (*psym), 1))
+	search_names_add (&sn, SYMBOL_NATURAL_NAME (*psym), ps);
   }
 
+  search_names_match (&sn, "psymbols", regexp);
+
+  /* If it would match (logic taken from loop below) load the file.  */
+  last_ps = NULL;
+  for (j = 0; j < sn.n_names; j++)
+    if (sn.matched[j] && sn.items[j] != last_ps)
+      {
+	last_ps = sn.items[j];
+	PSYMTAB_TO_SYMTAB (last_ps);
+      }
+  search_names_free (&sn);
+
   /* APPLE LOCAL: Make an additional pass over the msymbols raising
      the load level of any objfiles that contain the symbol of interest.
      Otherwise we'll raise it later when we're holding pointers to
@@ -4585,30 +5872,35 @@ search_symbols (char *regexp, domain_enum kind, int nfiles, char *files[],
      when the old objfile is freed and a new one is created and we crash.  */
   if (nfiles == 0 && (kind == VARIABLES_DOMAIN || kind == FUNCTIONS_DOMAIN))
     {
-      struct objfile *tmp;
-      ALL_OBJFILES_SAFE (objfile, tmp)
+      struct objfile *last_objfile = NULL;
+
+      ALL_OBJFILES (objfile)
         {
           ALL_OBJFILE_MSYMBOLS (objfile, msymbol)
             {
               /* APPLE LOCAL fix-and-continue */
               if (MSYMBOL_OBSOLETED (msymbol))
                 continue;
-    
+
 	      if (MSYMBOL_TYPE (msymbol) == ourtype ||
 	          MSYMBOL_TYPE (msymbol) == ourtype2 ||
 	          MSYMBOL_TYPE (msymbol) == ourtype3 ||
 	          MSYMBOL_TYPE (msymbol) == ourtype4)
-	        {
-	          if (regexp == NULL
-                       || re_exec (SYMBOL_NATURAL_NAME (msymbol)) != 0)
-                    {
-                      objfile_set_load_state (objfile, OBJF_SYM_ALL, 1);
-                      /* On to the next objfile.  */
-                      break;
-	            }
-	        }
+		search_names_add (&sn, SYMBOL_NATURAL_NAME (msymbol), objfile);
             }
         }
+
+      search_names_match (&sn, "msymbols", regexp);
+
+      /* This may free and recreate the objfile; the names we collected
+	 from it are not looked at again.  */
+      for (j = 0; j < sn.n_names; j++)
+	if (sn.matched[j] && sn.items[j] != last_objfile)
+	  {
+	    last_objfile = sn.items[j];
+	    objfile_set_load_state (last_objfile, OBJF_SYM_ALL, 1);
+	  }
+      search_names_free (&sn);
     }
 
   /* Here, we search through the minimal symbol tables for functions
@@ -4622,6 +5914,9 @@ search_symbols (char *regexp, domain_enum kind, int nfiles, char *files[],
      to determine if the variable has debug info.
      If the lookup fails, set found_misc so that we will rescan to print
      any matching symbols without debug info.
+
+     The matches are kept in MSN for the last pass, which looks at the
+     same minimal symbols.
    */
 
   if (nfiles == 0 && (kind == VARIABLES_DOMAIN || kind == FUNCTIONS_DOMAIN))
@@ -4638,43 +5933,48 @@ search_symbols (char *regexp, domain_enum kind, int nfiles, char *files[],
 	    MSYMBOL_TYPE (msymbol) == ourtype2 ||
 	    MSYMBOL_TYPE (msymbol) == ourtype3 ||
 	    MSYMBOL_TYPE (msymbol) == ourtype4)
-	  {
-            /* APPLE LOCAL: Don't match the dyld_stub names; no one is
-               interested in seeing them when they're doing an 'rbreak' or
-               what have you.  */
-            if (strncmp (SYMBOL_LINKAGE_NAME (msymbol), "dyld_stub_", 10) == 0)
-              continue;
-
-	    if (regexp == NULL
-		|| re_exec (SYMBOL_NATURAL_NAME (msymbol)) != 0)
-	      {
-		if (0 == find_pc_symtab (SYMBOL_VALUE_ADDRESS (msymbol)))
-		  {
-		    /* FIXME: carlton/2003-02-04: Given that the
-		       semantics of lookup_symbol keeps on changing
-		       slightly, it would be a nice idea if we had a
-		       function lookup_symbol_minsym that found the
-		       symbol associated to a given minimal symbol (if
-		       any).  */
-		    if (kind == FUNCTIONS_DOMAIN)
-		      {
-			found_misc = 1;
-		      }
-		    else
-		      {
-			struct symbol *sym;
-			sym = lookup_symbol (SYMBOL_LINKAGE_NAME (msymbol),
-					  (struct block *) NULL,
-					  VAR_DOMAIN,
-					     0, (struct symtab **) NULL);
-			  if (!sym || SYMBOL_VALUE_ADDRESS (sym) != SYMBOL_VALUE_ADDRESS (msymbol))
-			    found_misc = 1;
-		      }
-		  }
-	      }
-	  }
+	  search_names_add (&msn, SYMBOL_NATURAL_NAME (msymbol), msymbol);
       }
       }
+
+      search_names_match (&msn, "msymbols", regexp);
+
+      for (j = 0; j < msn.n_names; j++)
+	{
+	  if (!msn.matched[j])
+	    continue;
+	  msymbol = msn.items[j];
+
+	  /* APPLE LOCAL: Don't match the dyld_stub names; no one is
+	     interested in seeing them when they're doing an 'rbreak' or
+	     what have you.  */
+	  if (strncmp (SYMBOL_LINKAGE_NAME (msymbol), "dyld_stub_", 10) == 0)
+	    continue;
+
+	  if (0 == find_pc_symtab (SYMBOL_VALUE_ADDRESS (msymbol)))
+	    {
+	      /* FIXME: carlton/2003-02-04: Given that the
+		 semantics of lookup_symbol keeps on changing
+		 slightly, it would be a nice idea if we had a
+		 function lookup_symbol_minsym that found the
+		 symbol associated to a given minimal symbol (if
+		 any).  */
+	      if (kind == FUNCTIONS_DOMAIN)
+		{
+		  found_misc = 1;
+		}
+	      else
+		{
+		  struct symbol *sym;
+		  sym = lookup_symbol (SYMBOL_LINKAGE_NAME (msymbol),
+				       (struct block *) NULL,
+				       VAR_DOMAIN,
+				       0, (struct symtab **) NULL);
+		  if (!sym || SYMBOL_VALUE_ADDRESS (sym) != SYMBOL_VALUE_ADDRESS (msymbol))
+		    found_misc = 1;
+		}
+	    }
+	}
     }
 
   ALL_SYMTABS (objfile, s)
@@ -4685,121 +5985,174 @@ search_symbols (char *regexp, domain_enum kind, int nfiles, char *files[],
        we don't get every symbol many times.
        It happens that the first symtab in the list
        for any given blockvector is the main file.  */
-    if (bv != prev_bv)
+    if (bv != prev_bv && file_matches (s->filename, files, nfiles))
       for (i = GLOBAL_BLOCK; i <= STATIC_BLOCK; i++)
 	{
-	  struct symbol_search *prevtail = tail;
-	  int nfound = 0;
+	  int start = sn.n_names;
+
+	  QUIT;
 	  b = BLOCKVECTOR_BLOCK (bv, i);
 	  ALL_BLOCK_SYMBOLS (b, iter, sym)
 	    {
-	      QUIT;
               /* APPLE LOCAL fix-and-continue */
               if (SYMBOL_OBSOLETED (sym))
                 continue;
 
-	      if (file_matches (s->filename, files, nfiles)
-		  && ((regexp == NULL
-		       || re_exec (SYMBOL_NATURAL_NAME (sym)) != 0)
-		      && ((kind == VARIABLES_DOMAIN && SYMBOL_CLASS (sym) != LOC_TYPEDEF
-			   && SYMBOL_CLASS (sym) != LOC_BLOCK
-			   && SYMBOL_CLASS (sym) != LOC_CONST)
-			  || (kind == FUNCTIONS_DOMAIN && SYMBOL_CLASS (sym) == LOC_BLOCK)
-			  || (kind == TYPES_DOMAIN && SYMBOL_CLASS (sym) == LOC_TYPEDEF)
-			  || (kind == METHODS_DOMAIN && SYMBOL_CLASS (sym) == LOC_BLOCK))))
-		{
-		  /* match */
-		  psr = (struct symbol_search *) xmalloc (sizeof (struct symbol_search));
-		  psr->block = i;
-		  psr->symtab = s;
-		  psr->symbol = sym;
-		  psr->msymbol = NULL;
-		  psr->next = NULL;
-		  if (tail == NULL)
-		    sr = psr;
-		  else
-		    tail->next = psr;
-		  tail = psr;
-		  nfound ++;
-		}
+	      if (search_symbols_class_p (kind, SYMBOL_CLASS (sym), 0))
+		search_names_add (&sn, SYMBOL_NATURAL_NAME (sym), sym);
 	    }
-	  if (nfound > 0)
+
+	  if (sn.n_names > start)
 	    {
-	      if (prevtail == NULL)
+	      if (n_blocks == blocks_size)
 		{
-		  struct symbol_search dummy;
-
-		  dummy.next = sr;
-		  tail = sort_search_symbols (&dummy, nfound);
-		  sr = dummy.next;
-
-		  old_chain = make_cleanup_free_search_symbols (sr);
+		  blocks_size = blocks_size ? blocks_size * 2 : 64;
+		  blocks = xrealloc (blocks,
+				     blocks_size * sizeof (struct search_block));
 		}
-	      else
-		tail = sort_search_symbols (prevtail, nfound);
+	      blocks[n_blocks].symtab = s;
+	      blocks[n_blocks].block = i;
+	      blocks[n_blocks].end = sn.n_names;
+	      n_blocks++;
 	    }
 	}
     prev_bv = bv;
   }
 
+  search_names_match (&sn, "symbols", regexp);
+
+  for (k = 0, j = 0; k < n_blocks; k++)
+    {
+      struct symbol_search *prevtail = tail;
+      int nfound = 0;
+
+      for (; j < blocks[k].end; j++)
+	if (sn.matched[j])
+	  {
+	    /* match */
+	    psr = (struct symbol_search *) xmalloc (sizeof (struct symbol_search));
+	    psr->block = blocks[k].block;
+	    psr->symtab = blocks[k].symtab;
+	    psr->symbol = sn.items[j];
+	    psr->msymbol = NULL;
+	    psr->next = NULL;
+	    if (tail == NULL)
+	      sr = psr;
+	    else
+	      tail->next = psr;
+	    tail = psr;
+	    nfound ++;
+	  }
+      if (nfound > 0)
+	{
+	  if (prevtail == NULL)
+	    {
+	      struct symbol_search dummy;
+
+	      dummy.next = sr;
+	      tail = sort_search_symbols (&dummy, nfound);
+	      sr = dummy.next;
+
+	      old_chain = make_cleanup_free_search_symbols (sr);
+	    }
+	  else
+	    tail = sort_search_symbols (prevtail, nfound);
+
+	  if (search_symbols_progress_hook != NULL)
+	    search_symbols_progress_hook ("symbols", j, sn.n_names,
+					  prevtail != NULL ? prevtail->next : sr,
+					  nfound);
+	}
+    }
+
   /* If there are no eyes, avoid all contact.  I mean, if there are
      no debug symbols, then print directly from the msymbol_vector.  */
 
   if (found_misc || kind != FUNCTIONS_DOMAIN)
     {
-      ALL_OBJFILES (objfile)
-      {
-      ALL_OBJFILE_MSYMBOLS (objfile, msymbol)
-      {
-        /* APPLE LOCAL fix-and-continue */
-        if (MSYMBOL_OBSOLETED (msymbol))
-          continue;
+      struct symbol_search *first_found = NULL;
+      int nfound = 0;
 
-	if (MSYMBOL_TYPE (msymbol) == ourtype ||
-	    MSYMBOL_TYPE (msymbol) == ourtype2 ||
-	    MSYMBOL_TYPE (msymbol) == ourtype3 ||
-	    MSYMBOL_TYPE (msymbol) == ourtype4)
+      if (msn.matched == NULL)
+	{
+	  ALL_OBJFILES (objfile)
 	  {
-	    if (regexp == NULL
-		|| re_exec (SYMBOL_NATURAL_NAME (msymbol)) != 0)
-	      {
-		/* Functions:  Look up by address. */
-		if (kind != FUNCTIONS_DOMAIN ||
-		    (0 == find_pc_symtab (SYMBOL_VALUE_ADDRESS (msymbol))))
-		  {
-		    /* Variables/Absolutes:  Look up by name */
-		    struct symbol *sym;
-		    sym = lookup_symbol (SYMBOL_LINKAGE_NAME (msymbol),
-				       (struct block *) NULL, VAR_DOMAIN,
-					 0, (struct symtab **) NULL); 
-		    if (sym == NULL || SYMBOL_VALUE_ADDRESS (sym) != SYMBOL_VALUE_ADDRESS (msymbol))
-		      {
-			/* match */
-			psr = (struct symbol_search *) xmalloc (sizeof (struct symbol_search));
-			psr->block = i;
-			psr->msymbol = msymbol;
-			psr->symtab = NULL;
-			psr->symbol = NULL;
-			psr->next = NULL;
-			if (tail == NULL)
-			  {
-			    sr = psr;
-			    old_chain = make_cleanup_free_search_symbols (sr);
-			  }
-			else
-			  tail->next = psr;
-			tail = psr;
-		      }
-		  }
-	      }
+	  ALL_OBJFILE_MSYMBOLS (objfile, msymbol)
+	  {
+	    /* APPLE LOCAL fix-and-continue */
+	    if (MSYMBOL_OBSOLETED (msymbol))
+	      continue;
+
+	    if (MSYMBOL_TYPE (msymbol) == ourtype ||
+		MSYMBOL_TYPE (msymbol) == ourtype2 ||
+		MSYMBOL_TYPE (msymbol) == ourtype3 ||
+		MSYMBOL_TYPE (msymbol) == ourtype4)
+	      search_names_add (&msn, SYMBOL_NATURAL_NAME (msymbol), msymbol);
 	  }
-      }
-      }
+	  }
+
+	  search_names_match (&msn, "msymbols", regexp);
+	}
+
+      for (j = 0; j < msn.n_names; j++)
+	{
+	  if (msn.matched[j])
+	    {
+	      msymbol = msn.items[j];
+
+	      /* Functions:  Look up by address. */
+	      if (kind != FUNCTIONS_DOMAIN ||
+		  (0 == find_pc_symtab (SYMBOL_VALUE_ADDRESS (msymbol))))
+		{
+		  /* Variables/Absolutes:  Look up by name */
+		  struct symbol *sym;
+		  sym = lookup_symbol (SYMBOL_LINKAGE_NAME (msymbol),
+				       (struct block *) NULL, VAR_DOMAIN,
+				       0, (struct symtab **) NULL); 
+		  if (sym == NULL || SYMBOL_VALUE_ADDRESS (sym) != SYMBOL_VALUE_ADDRESS (msymbol))
+		    {
+		      /* match */
+		      psr = (struct symbol_search *) xmalloc (sizeof (struct symbol_search));
+		      psr->block = i;
+		      psr->msymbol = msymbol;
+		      psr->symtab = NULL;
+		      psr->symbol = NULL;
+		      psr->next = NULL;
+		      if (tail == NULL)
+			{
+			  sr = psr;
+			  old_chain = make_cleanup_free_search_symbols (sr);
+			}
+		      else
+			tail->next = psr;
+		      tail = psr;
+
+		      if (first_found == NULL)
+			first_found = psr;
+		      nfound++;
+		    }
+		}
+	    }
+
+	  /* Hand what we have found so far to the front end now and
+	     then, rather than all at the end.  */
+	  if (nfound > 0
+	      && ((j + 1) % SEARCH_NAMES_CHUNK == 0 || j + 1 == msn.n_names))
+	    {
+	      if (search_symbols_progress_hook != NULL)
+		search_symbols_progress_hook ("msymbols", j + 1, msn.n_names,
+					      first_found, nfound);
+	      first_found = NULL;
+	      nfound = 0;
+	    }
+	}
     }
 
   *matches = sr;
   if (sr != NULL)
     discard_cleanups (old_chain);
+  do_cleanups (back_to);
+  /* APPLE LOCAL end parallel symbol search  */
 }
 
 /* Helper function for symtab_symbol_info, this function uses
@@ -5072,6 +6425,64 @@ static int return_val_size;
 static int return_val_index;
 static char **return_val;
 
+/* APPLE LOCAL begin completion name index  */
+/* The strings already in RETURN_VAL, so that each completion is
+   added only once.  */
+static htab_t return_val_hash;
+
+/* The most completions a symbol completion list may hold, or
+   UINT_MAX for no limit.  */
+static unsigned int max_completions = 1000;
+
+int symbol_completion_truncated;
+
+static int
+completion_list_eq (const void *a, const void *b)
+{
+  return strcmp ((const char *) a, (const char *) b) == 0;
+}
+
+/* Start an empty completion list with room for SIZE entries.  */
+
+static void
+completion_list_begin (int size)
+{
+  return_val_size = size;
+  return_val_index = 0;
+  return_val = (char **) xmalloc ((return_val_size + 1) * sizeof (char *));
+  return_val[0] = NULL;
+  return_val_hash = htab_create_alloc (size, htab_hash_string,
+				       completion_list_eq, NULL,
+				       xcalloc, xfree);
+}
+
+/* Return the completion list, which now belongs to the caller.  */
+
+static char **
+completion_list_end (void)
+{
+  htab_delete (return_val_hash);
+  return_val_hash = NULL;
+  return return_val;
+}
+
+/* Cleanup to throw away a partly built completion list, for instance
+   when the user interrupts completion with Ctrl-C.  */
+
+static void
+completion_list_discard (void *ignore)
+{
+  int i;
+
+  for (i = 0; i < return_val_index; i++)
+    xfree (return_val[i]);
+  xfree (return_val);
+  return_val = NULL;
+  htab_delete (return_val_hash);
+  return_val_hash = NULL;
+}
+/* APPLE LOCAL end completion name index  */
+
 #define COMPLETION_LIST_ADD_SYMBOL(symbol, sym_text, len, text, word) \
       completion_list_add_name \
 	(SYMBOL_NATURAL_NAME (symbol), (sym_text), (len), (text), (word))
@@ -5118,6 +6529,21 @@ completion_list_add_name (char *symname, char *sym_text, int sym_text_len,
 	strcat (new, symname);
       }
 
+    /* APPLE LOCAL begin completion name index  */
+    if (htab_find (return_val_hash, new) != NULL)
+      {
+	xfree (new);
+	return;
+      }
+    if ((unsigned int) return_val_index >= max_completions)
+      {
+	xfree (new);
+	symbol_completion_truncated = 1;
+	return;
+      }
+    *htab_find_slot (return_val_hash, new, INSERT) = new;
+    /* APPLE LOCAL end completion name index  */
+
     if (return_val_index + 3 > return_val_size)
       {
 	newsize = (return_val_size *= 2) * sizeof (char *);
@@ -5128,64 +6554,250 @@ completion_list_add_name (char *symname, char *sym_text, int sym_text_len,
   }
 }
 
-/* ObjC: In case we are completing on a selector, look as the msymbol
-   again and feed all the selectors into the mill.  */
+/* APPLE LOCAL begin completion name index  */
+/* Each objfile keeps a sorted array of the natural names of its
+   psymbols and msymbols, so that completing a prefix costs a binary
+   search rather than a strncmp against every name.  The names belong
+   to the objfile, except for those derived from ObjC method msymbols,
+   which live on the index's obstack.  */
+
+struct completion_name
+{
+  const char *name;
+
+  /* Non-zero if NAME is only offered when completing text that
+     starts with '[', i.e. an ObjC method typed without its leading
+     '-' or '+'.  */
+  int bracket_only;
+};
+
+struct completion_name_index
+{
+  /* OBJFILE->psymtabs, the lengths of its psymbol lists and its
+     minimal symbol table when the index was built; if any of them
+     change, the index is stale.  */
+  struct partial_symtab *head;
+  int n_global_psymbols;
+  int n_static_psymbols;
+  struct minimal_symbol *msymbols;
+  int minimal_symbol_count;
+
+  /* Sorted by strcmp, without duplicates.  */
+  int n_names;
+  struct completion_name *names;
+
+  struct obstack obstack;
+};
+
+void
+invalidate_completion_name_index (struct objfile *objfile)
+{
+  struct completion_name_index *index = objfile->completion_name_index;
+
+  if (index == NULL)
+    return;
+
+  xfree (index->names);
+  obstack_free (&index->obstack, NULL);
+  xfree (index);
+  objfile->completion_name_index = NULL;
+}
+
+static void
+completion_name_index_add (struct completion_name_index *index,
+			   const char *name, int bracket_only)
+{
+  index->names[index->n_names].name = name;
+  index->names[index->n_names].bracket_only = bracket_only;
+  index->n_names++;
+}
+
+/* ObjC: Add the other names by which the method msymbol METHOD can be
+   completed: without its leading '-' or '+', without its category,
+   and as a bare selector.  */
 
 static void
-completion_list_objc_symbol (struct minimal_symbol *msymbol, char *sym_text,
-			     int sym_text_len, char *text, char *word)
+completion_name_index_add_objc (struct completion_name_index *index,
+				const char *method)
 {
-  static char *tmp = NULL;
-  static unsigned int tmplen = 0;
-    
-  char *method, *category, *selector;
-  char *tmp2 = NULL;
-    
-  method = SYMBOL_NATURAL_NAME (msymbol);
+  const char *category, *selector, *end;
+  char *tmp;
+
+  /* Complete on shortened method name.  */
+  completion_name_index_add (index, method + 1, 1);
 
-  /* Is it a method?  */
-  if ((method[0] != '-') && (method[0] != '+'))
+  selector = strchr (method, ' ');
+  if (selector == NULL)
     return;
+  selector++;
 
-  if (sym_text[0] == '[')
-    /* Complete on shortened method method.  */
-    completion_list_add_name (method + 1, sym_text, sym_text_len, text, word);
-    
-  while ((strlen (method) + 1) >= tmplen)
+  category = strchr (method, '(');
+  if (category != NULL)
+    {
+      tmp = obstack_alloc (&index->obstack,
+			   (category - method) + strlen (selector) + 2);
+      memcpy (tmp, method, category - method);
+      tmp[category - method] = ' ';
+      strcpy (tmp + (category - method) + 1, selector);
+      completion_name_index_add (index, tmp, 0);
+      completion_name_index_add (index, tmp + 1, 1);
+    }
+
+  /* Complete on selector only.  */
+  end = strchr (selector, ']');
+  if (end == NULL)
+    end = selector + strlen (selector);
+  tmp = obsavestring (selector, end - selector, &index->obstack);
+  completion_name_index_add (index, tmp, 0);
+}
+
+static int
+compare_completion_names (const void *a, const void *b)
+{
+  return strcmp (((const struct completion_name *) a)->name,
+		 ((const struct completion_name *) b)->name);
+}
+
+static struct completion_name_index *
+build_completion_name_index (struct objfile *objfile)
+{
+  struct completion_name_index *index;
+  struct partial_symtab *pst;
+  struct partial_symbol **psym, **end;
+  struct minimal_symbol *msymbol;
+  int n, i, j;
+
+  index = XMALLOC (struct completion_name_index);
+  memset (index, 0, sizeof (struct completion_name_index));
+  index->head = objfile->psymtabs;
+  index->n_global_psymbols = (objfile->global_psymbols.next
+			      - objfile->global_psymbols.list);
+  index->n_static_psymbols = (objfile->static_psymbols.next
+			      - objfile->static_psymbols.list);
+  index->msymbols = objfile->msymbols;
+  index->minimal_symbol_count = objfile->minimal_symbol_count;
+  obstack_init (&index->obstack);
+
+  /* An ObjC method msymbol adds up to four more names.  */
+  n = 0;
+  ALL_OBJFILE_PSYMTABS (objfile, pst)
+    n += pst->n_global_syms + pst->n_static_syms;
+  ALL_OBJFILE_MSYMBOLS (objfile, msymbol)
     {
-      if (tmplen == 0)
-	tmplen = 1024;
+      const char *name = SYMBOL_NATURAL_NAME (msymbol);
+
+      n += (name[0] == '-' || name[0] == '+') ? 5 : 1;
+    }
+  index->names = xmalloc ((n + 1) * sizeof (struct completion_name));
+
+  ALL_OBJFILE_PSYMTABS (objfile, pst)
+    {
+      psym = objfile->global_psymbols.list + pst->globals_offset;
+      for (end = psym + pst->n_global_syms; psym < end; psym++)
+	completion_name_index_add (index, SYMBOL_NATURAL_NAME (*psym), 0);
+
+      psym = objfile->static_psymbols.list + pst->statics_offset;
+      for (end = psym + pst->n_static_syms; psym < end; psym++)
+	completion_name_index_add (index, SYMBOL_NATURAL_NAME (*psym), 0);
+    }
+
+  ALL_OBJFILE_MSYMBOLS (objfile, msymbol)
+    {
+      const char *name = SYMBOL_NATURAL_NAME (msymbol);
+
+      completion_name_index_add (index, name, 0);
+      if (name[0] == '-' || name[0] == '+')
+	completion_name_index_add_objc (index, name);
+    }
+
+  qsort (index->names, index->n_names, sizeof (struct completion_name),
+	 compare_completion_names);
+
+  /* Squeeze out the duplicates.  A name is only bracket-only if every
+     copy of it is.  */
+  for (i = 0, j = 0; i < index->n_names; i++)
+    {
+      if (j > 0 && strcmp (index->names[j - 1].name,
+			   index->names[i].name) == 0)
+	index->names[j - 1].bracket_only &= index->names[i].bracket_only;
       else
-	tmplen *= 2;
-      tmp = xrealloc (tmp, tmplen);
+	index->names[j++] = index->names[i];
     }
-  selector = strchr (method, ' ');
-  if (selector != NULL)
-    selector++;
-    
-  category = strchr (method, '(');
-    
-  if ((category != NULL) && (selector != NULL))
+  index->n_names = j;
+
+  return index;
+}
+
+/* Return the completion name index of OBJFILE, building it first if
+   it is missing or stale.  */
+
+static struct completion_name_index *
+objfile_completion_name_index (struct objfile *objfile)
+{
+  struct completion_name_index *index = objfile->completion_name_index;
+
+  if (index != NULL
+      && (index->head != objfile->psymtabs
+	  || index->n_global_psymbols != (objfile->global_psymbols.next
+					  - objfile->global_psymbols.list)
+	  || index->n_static_psymbols != (objfile->static_psymbols.next
+					  - objfile->static_psymbols.list)
+	  || index->msymbols != objfile->msymbols
+	  || index->minimal_symbol_count != objfile->minimal_symbol_count))
     {
-      memcpy (tmp, method, (category - method));
-      tmp[category - method] = ' ';
-      memcpy (tmp + (category - method) + 1, selector, strlen (selector) + 1);
-      completion_list_add_name (tmp, sym_text, sym_text_len, text, word);
-      if (sym_text[0] == '[')
-	completion_list_add_name (tmp + 1, sym_text, sym_text_len, text, word);
+      invalidate_completion_name_index (objfile);
+      index = NULL;
     }
-    
-  if (selector != NULL)
+  if (index == NULL)
+    {
+      index = build_completion_name_index (objfile);
+      objfile->completion_name_index = index;
+    }
+
+  return index;
+}
+
+/* Add to the current completion list each psymbol and msymbol name
+   of OBJFILE which begins with SYM_TEXT.  */
+
+static void
+completion_list_add_objfile_names (struct objfile *objfile, char *sym_text,
+				   int sym_text_len, char *text, char *word)
+{
+  struct completion_name_index *index;
+  struct completion_name *cn;
+  int lo, hi, mid;
+
+  index = objfile_completion_name_index (objfile);
+
+  /* Find the first name not less than SYM_TEXT; the names it is a
+     prefix of all follow it.  */
+  lo = 0;
+  hi = index->n_names;
+  while (lo < hi)
+    {
+      mid = lo + (hi - lo) / 2;
+      if (strcmp (index->names[mid].name, sym_text) < 0)
+	lo = mid + 1;
+      else
+	hi = mid;
+    }
+
+  for (cn = index->names + lo;
+       cn < index->names + index->n_names && !symbol_completion_truncated;
+       cn++)
     {
-      /* Complete on selector only.  */
-      strcpy (tmp, selector);
-      tmp2 = strchr (tmp, ']');
-      if (tmp2 != NULL)
-	*tmp2 = '\0';
-	
-      completion_list_add_name (tmp, sym_text, sym_text_len, text, word);
+      /* If interrupted, then quit. */
+      QUIT;
+      if (strncmp (cn->name, sym_text, sym_text_len) != 0)
+	break;
+      if (cn->bracket_only && sym_text[0] != '[')
+	continue;
+      completion_list_add_name ((char *) cn->name, sym_text, sym_text_len,
+				text, word);
     }
 }
+/* APPLE LOCAL end completion name index  */
 
 /* Break the non-quoted text based on the characters which are in
    symbols. FIXME: This should probably be language-specific. */
@@ -5246,17 +6858,16 @@ make_symbol_completion_list (char *text, char *word)
 {
   struct symbol *sym;
   struct symtab *s;
-  struct partial_symtab *ps;
-  struct minimal_symbol *msymbol;
   struct objfile *objfile;
   struct block *b, *surrounding_static_block = 0;
   struct dict_iterator iter;
   int j;
-  struct partial_symbol **psym;
   /* The symbol we are completing on.  Points in same buffer as text.  */
   char *sym_text;
   /* Length of sym_text.  */
   int sym_text_len;
+  /* APPLE LOCAL completion name index  */
+  struct cleanup *old_chain;
 
   /* Now look for the symbol we are supposed to complete on.
      FIXME: This should be language-specific.  */
@@ -5311,60 +6922,28 @@ make_symbol_completion_list (char *text, char *word)
       }
   }
 
-  return_val_size = 100;
-  return_val_index = 0;
-  return_val = (char **) xmalloc ((return_val_size + 1) * sizeof (char *));
-  return_val[0] = NULL;
+  /* APPLE LOCAL begin completion name index  */
+  completion_list_begin (100);
+  old_chain = make_cleanup (completion_list_discard, NULL);
 
-  /* Look through the partial symtabs for all symbols which begin
-     by matching SYM_TEXT.  Add each one that you find to the list.  */
+  /* Look through the psymbol and msymbol names of each objfile for
+     all symbols which begin by matching SYM_TEXT.  Add each one that
+     you find to the list.  This includes the psymbols of psymtabs
+     which have been read in; the duplicates are dropped.  */
 
   sym_text_len = strlen (sym_text);
 
-  ALL_PSYMTABS (objfile, ps)
-  {
-    /* If the psymtab's been read in we'll get it when we search
-       through the blockvector.  */
-    if (ps->readin)
-      continue;
-
-    for (psym = objfile->global_psymbols.list + ps->globals_offset;
-	 psym < (objfile->global_psymbols.list + ps->globals_offset
-		 + ps->n_global_syms);
-	 psym++)
-      {
-	/* If interrupted, then quit. */
-	QUIT;
-	COMPLETION_LIST_ADD_SYMBOL (*psym, sym_text, sym_text_len, text, word);
-      }
-
-    for (psym = objfile->static_psymbols.list + ps->statics_offset;
-	 psym < (objfile->static_psymbols.list + ps->statics_offset
-		 + ps->n_static_syms);
-	 psym++)
-      {
-	QUIT;
-	COMPLETION_LIST_ADD_SYMBOL (*psym, sym_text, sym_text_len, text, word);
-      }
-  }
-
-  /* At this point scan through the misc symbol vectors and add each
-     symbol you find to the list.  Eventually we want to ignore
-     anything that isn't a text symbol (everything else will be
-     handled by the psymtab code above).  */
-
-  ALL_MSYMBOLS (objfile, msymbol)
-  {
-    QUIT;
-    COMPLETION_LIST_ADD_SYMBOL (msymbol, sym_text, sym_text_len, text, word);
-
-    completion_list_objc_symbol (msymbol, sym_text, sym_text_len, text, word);
-  }
+  ALL_OBJFILES (objfile)
+    completion_list_add_objfile_names (objfile, sym_text, sym_text_len,
+				       text, word);
+  /* APPLE LOCAL end completion name index  */
 
   /* Search upwards from currently selected frame (so that we can
      complete on local vars.  */
 
-  for (b = get_selected_block (0); b != NULL; b = BLOCK_SUPERBLOCK (b))
+  for (b = get_selected_block (0);
+       b != NULL && !symbol_completion_truncated;
+       b = BLOCK_SUPERBLOCK (b))
     {
       if (!BLOCK_SUPERBLOCK (b))
 	{
@@ -5404,6 +6983,9 @@ make_symbol_completion_list (char *text, char *word)
   ALL_SYMTABS (objfile, s)
   {
     QUIT;
+    /* APPLE LOCAL completion name index  */
+    if (symbol_completion_truncated)
+      break;
     b = BLOCKVECTOR_BLOCK (BLOCKVECTOR (s), GLOBAL_BLOCK);
     ALL_BLOCK_SYMBOLS (b, iter, sym)
       {
@@ -5414,6 +6996,9 @@ make_symbol_completion_list (char *text, char *word)
   ALL_SYMTABS (objfile, s)
   {
     QUIT;
+    /* APPLE LOCAL completion name index  */
+    if (symbol_completion_truncated)
+      break;
     b = BLOCKVECTOR_BLOCK (BLOCKVECTOR (s), STATIC_BLOCK);
     /* Don't do this block twice.  */
     if (b == surrounding_static_block)
@@ -5424,7 +7009,10 @@ make_symbol_completion_list (char *text, char *word)
       }
   }
 
-  return (return_val);
+  /* APPLE LOCAL begin completion name index  */
+  discard_cleanups (old_chain);
+  return completion_list_end ();
+  /* APPLE LOCAL end completion name index  */
 }
 
 /* Like make_symbol_completion_list, but returns a list of symbols
@@ -5441,6 +7029,8 @@ make_file_symbol_completion_list (char *text, char *word, char *srcfile)
   char *sym_text;
   /* Length of sym_text.  */
   int sym_text_len;
+  /* APPLE LOCAL completion name index  */
+  struct cleanup *old_chain;
 
   /* Now look for the symbol we are supposed to complete on.
      FIXME: This should be language-specific.  */
@@ -5487,10 +7077,10 @@ make_file_symbol_completion_list (char *text, char *word, char *srcfile)
       }
   }
 
-  return_val_size = 10;
-  return_val_index = 0;
-  return_val = (char **) xmalloc ((return_val_size + 1) * sizeof (char *));
-  return_val[0] = NULL;
+  /* APPLE LOCAL begin completion name index  */
+  completion_list_begin (10);
+  old_chain = make_cleanup (completion_list_discard, NULL);
+  /* APPLE LOCAL end completion name index  */
 
   /* Look through the partial symtabs for all symbols which begin
      by matching SYM_TEXT.  Add each one that you find to the list.  */
@@ -5511,8 +7101,13 @@ make_file_symbol_completion_list (char *text, char *word, char *srcfile)
     }
 
   /* If we have no symtab for that file, return an empty list.  */
+  /* APPLE LOCAL begin completion name index  */
   if (s == NULL)
-    return (return_val);
+    {
+      discard_cleanups (old_chain);
+      return completion_list_end ();
+    }
+  /* APPLE LOCAL end completion name index  */
 
   /* Go through this symtab and check the externs and statics for
      symbols which match.  */
@@ -5529,7 +7124,10 @@ make_file_symbol_completion_list (char *text, char *word, char *srcfile)
       COMPLETION_LIST_ADD_SYMBOL (sym, sym_text, sym_text_len, text, word);
     }
 
-  return (return_val);
+  /* APPLE LOCAL begin completion name index  */
+  discard_cleanups (old_chain);
+  return completion_list_end ();
+  /* APPLE LOCAL end completion name index  */
 }
 
 /* A helper function for make_source_files_completion_list.  It adds
@@ -5963,6 +7561,31 @@ All global and static variable names, or those matching REGEXP."));
   add_com ("rbreak", class_breakpoint, rbreak_command,
 	   _("Set a breakpoint for all functions matching REGEXP."));
 
+  /* APPLE LOCAL begin parallel symbol search  */
+  add_setshow_zinteger_cmd ("symbol-search-threads", class_maintenance,
+			    &symbol_search_threads, _("\
+Set the number of threads used to search symbol names."), _("\
+Show the number of threads used to search symbol names."), _("\
+\"info functions\", \"info variables\", \"info types\" and \"rbreak\"\n\
+match their regular expression against symbol names on this many\n\
+threads.  One means all the work is done by the main thread.  Zero\n\
+means one thread per online processor."),
+			    NULL,
+			    show_symbol_search_threads,
+			    &maintenance_set_cmdlist,
+			    &maintenance_show_cmdlist);
+  /* APPLE LOCAL end parallel symbol search  */
+
+  /* APPLE LOCAL begin completion name index  */
+  add_setshow_uinteger_cmd ("max-completions", no_class, &max_completions, _("\
+Set the maximum number of symbol completions."), _("\
+Show the maximum number of symbol completions."), _("\
+Symbol completion stops looking for more candidates once it has found\n\
+this many.  A value of zero means there is no limit."),
+			    NULL, NULL,
+			    &setlist, &showlist);
+  /* APPLE LOCAL end completion name index  */
+
   if (xdb_commands)
     {
       add_com ("lf", class_info, sources_info,
@@ -372,6 +372,16 @@ struct minimal_symbol
      the `next' pointer for the demangled hash table.  */
 
   struct minimal_symbol *demangled_hash_next;
+
+  /* APPLE LOCAL begin sized msymbol hash  */
+  /* The full msymbol_hash of the linkage name, and msymbol_hash_iw of
+     the demangled name, as of the last time the symbol was entered in
+     the hash tables.  Compared before the names so that most entries
+     on a chain are rejected without a string comparison.  */
+
+  unsigned int hash_value;
+  unsigned int demangled_hash_value;
+  /* APPLE LOCAL end sized msymbol hash  */
 };
 
 #define MSYMBOL_INFO(msymbol)		(msymbol)->info
@@ -862,6 +872,9 @@ struct symtab
   void (*free_func)(struct symtab *symtab);
 
   /* Total number of lines found in source file.  */
+  /* APPLE LOCAL source text cache: Until LINE_CHARPOS_COMPLETE is
+     set, only the lines found so far; find_source_lines_upto finds
+     more.  */
 
   int nlines;
 
@@ -871,6 +884,21 @@ struct symtab
 
   int *line_charpos;
 
+  /* APPLE LOCAL begin source text cache  */
+  /* The number of entries allocated in LINE_CHARPOS, and whether it
+     covers the whole source file yet.  */
+
+  int line_charpos_size;
+  unsigned int line_charpos_complete : 1;
+
+  /* The modification time and size of the source file when
+     LINE_CHARPOS was started, so that lines from an older version are
+     not mixed with lines found later in a newer one.  */
+
+  time_t line_charpos_mtime;
+  long line_charpos_fsize;
+  /* APPLE LOCAL end source text cache  */
+
   /* Language of this source file.  */
 
   enum language language;
@@ -1306,6 +1334,36 @@ extern struct partial_symtab *find_pc_psymtab (CORE_ADDR);
 
 extern struct partial_symtab *find_pc_sect_psymtab (CORE_ADDR, asection *);
 
+/* APPLE LOCAL begin psymtab addrmap  */
+/* Discard the address index of OBJFILE's psymtabs; it is rebuilt on
+   the next address lookup.  */
+
+extern void invalidate_psymtab_addrmap (struct objfile *);
+/* APPLE LOCAL end psymtab addrmap  */
+
+/* APPLE LOCAL begin psymtab name index  */
+/* Discard the name index of OBJFILE's psymtabs; it is rebuilt on the
+   next global symbol lookup.  */
+
+extern void invalidate_psymtab_name_index (struct objfile *);
+/* APPLE LOCAL end psymtab name index  */
+
+/* APPLE LOCAL begin symtab filename index  */
+/* Discard the filename index of OBJFILE's symtabs and psymtabs; it is
+   rebuilt the next time a source file is looked up by name.  */
+
+extern void invalidate_symtab_filename_index (struct objfile *);
+/* APPLE LOCAL end symtab filename index  */
+
+/* APPLE LOCAL begin psymtab indexes  */
+/* Discard all the indexes built over OBJFILE's psymtabs and symtabs:
+   the address and name indexes of the psymtabs, the completion name
+   index and the filename index.  Call this whenever the psymtab list
+   of OBJFILE changes.  */
+
+extern void invalidate_psymtab_indexes (struct objfile *);
+/* APPLE LOCAL end psymtab indexes  */
+
 /* lookup full symbol table by address */
 
 extern struct symtab *find_pc_symtab (CORE_ADDR);
@@ -1358,9 +1416,13 @@ extern unsigned int msymbol_hash_iw (const char *);
 
 extern unsigned int msymbol_hash (const char *);
 
+/* APPLE LOCAL sized msymbol hash  */
 extern void
 add_minsym_to_hash_table (struct minimal_symbol *sym,
-			  struct minimal_symbol **table);
+			  struct objfile *objfile);
+
+/* APPLE LOCAL sized msymbol hash  */
+extern void print_minimal_symbol_hash_statistics (struct objfile *);
 
 /* APPLE LOCAL: Add prototype; called over in dwarf2read.c  */
 extern struct minimal_symbol *lookup_minimal_symbol_by_pc_section_from_objfile
@@ -1536,6 +1598,9 @@ void maintenance_info_symtabs (char *, int);
 
 void maintenance_info_psymtabs (char *, int);
 
+/* APPLE LOCAL maint info memory  */
+void maintenance_info_memory (char *, int);
+
 void maintenance_check_symtabs (char *, int);
 
 /* maint.c */
@@ -1564,6 +1629,18 @@ extern char **make_symbol_completion_list (char *, char *);
 
 extern char **make_file_symbol_completion_list (char *, char *, char *);
 
+/* APPLE LOCAL begin completion name index  */
+/* Non-zero if a symbol completion list stopped growing because it
+   reached "set max-completions".  Cleared by complete_line.  */
+
+extern int symbol_completion_truncated;
+
+/* Discard the completion name index of OBJFILE; it is rebuilt the
+   next time symbols are completed.  */
+
+extern void invalidate_completion_name_index (struct objfile *);
+/* APPLE LOCAL end completion name index  */
+
 extern char **make_source_files_completion_list (char *, char *);
 
 /* symtab.c */
@@ -1633,6 +1710,19 @@ extern void free_search_symbols (struct symbol_search *);
 extern struct cleanup *make_cleanup_free_search_symbols (struct symbol_search
 							 *);
 
+/* APPLE LOCAL begin parallel symbol search  */
+/* If non-NULL, search_symbols calls this as it works, so a front end
+   can show its progress.  PHASE names the pass ("psymbols",
+   "msymbols" or "symbols"), and DONE of TOTAL names have been looked
+   at.  If FOUND is non-NULL, it is the first of NFOUND matches just
+   added to the results, in the order they will have in the list
+   search_symbols returns.  */
+extern void (*search_symbols_progress_hook) (const char *phase, int done,
+					     int total,
+					     struct symbol_search *found,
+					     int nfound);
+/* APPLE LOCAL end parallel symbol search  */
+
 /* The name of the ``main'' function.
    FIXME: cagney/2001-03-20: Can't make main_name() const since some
    of the calling code currently assumes that the string isn't
@@ -1100,7 +1100,32 @@ target_xfer_partial (struct target_ops *ops,
      have a look at it instead.  Memory transfers are more
      complicated.  */
   if (object == TARGET_OBJECT_MEMORY)
-    retval = memory_xfer_partial (ops, readbuf, writebuf, offset, len);
+    {
+      /* APPLE LOCAL begin always-inserted breakpoints  */
+      struct cleanup *old_chain = make_cleanup (null_cleanup, NULL);
+
+      /* Writes over an inserted breakpoint go to its shadow, and the
+	 breakpoint instruction stays in memory.  */
+      if (writebuf != NULL)
+	{
+	  gdb_byte *shadowed = breakpoint_update_shadows (writebuf, offset,
+							  len);
+	  if (shadowed != NULL)
+	    {
+	      make_cleanup (xfree, shadowed);
+	      writebuf = shadowed;
+	    }
+	}
+
+      retval = memory_xfer_partial (ops, readbuf, writebuf, offset, len);
+
+      /* Show what's under any breakpoint we've inserted.  Raw memory
+	 requests (from the dcache) still see the breakpoints.  */
+      if (readbuf != NULL && retval > 0)
+	breakpoint_restore_shadows (readbuf, offset, retval);
+      do_cleanups (old_chain);
+      /* APPLE LOCAL end always-inserted breakpoints  */
+    }
   else
     {
       enum target_object raw_object = object;
@@ -1468,12 +1493,19 @@ target_detach (char *args, int from_tty)
   /* Make sure to turn off debugger mode - 
      we will let the target run a bit before killing it.  */
   do_hand_call_cleanups (ALL_CLEANUPS);
+  /* APPLE LOCAL begin always-inserted breakpoints  */
+  /* Breakpoints may still be inserted in always-inserted mode; don't
+     leave them behind for the program to trip over.  */
+  remove_breakpoints ();
+  /* APPLE LOCAL end always-inserted breakpoints  */
   (current_target.to_detach) (args, from_tty);
 }
 
 void
 target_disconnect (char *args, int from_tty)
 {
+  /* APPLE LOCAL always-inserted breakpoints  */
+  remove_breakpoints ();
   (current_target.to_disconnect) (args, from_tty);
 }
 
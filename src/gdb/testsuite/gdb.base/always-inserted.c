@@ -0,0 +1,38 @@
+/* This testcase is part of GDB, the GNU debugger.
+
+   Copyright 2026 Free Software Foundation, Inc.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.  */
+
+/* The test puts a breakpoint on the first of these bytes, which is
+   never executed.  */
+unsigned char data_bytes[8] = { 1, 2, 3, 4, 5, 6, 7, 8 };
+
+int result;
+
+void
+func (void)
+{
+  result++;
+}
+
+int
+main (void)
+{
+  result = 0;
+  func ();
+  /* The test writes 42 over the breakpoint in data_bytes.  */
+  return data_bytes[0] == 42 && data_bytes[1] == 2 ? 0 : 1;
+}
@@ -0,0 +1,40 @@
+/* This testcase is part of GDB, the GNU debugger.
+
+   Copyright 2026 Free Software Foundation, Inc.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.  */
+/* Enough long names that the index cache's string table grows well
+   past its initial size.  */
+
+#define FN(a, b, c) \
+  int index_cache_long_string_table_function_##a##b##c (int x) \
+  { return x + a##b##c; }
+#define FN10(a, b) \
+  FN (a, b, 0) FN (a, b, 1) FN (a, b, 2) FN (a, b, 3) FN (a, b, 4) \
+  FN (a, b, 5) FN (a, b, 6) FN (a, b, 7) FN (a, b, 8) FN (a, b, 9)
+#define FN100(a) \
+  FN10 (a, 0) FN10 (a, 1) FN10 (a, 2) FN10 (a, 3) FN10 (a, 4) \
+  FN10 (a, 5) FN10 (a, 6) FN10 (a, 7) FN10 (a, 8) FN10 (a, 9)
+
+FN100 (1)
+FN100 (2)
+FN100 (3)
+
+int
+main (void)
+{
+  return index_cache_long_string_table_function_100 (0)
+	 - index_cache_long_string_table_function_399 (-299);
+}
@@ -0,0 +1,46 @@
+/* This testcase is part of GDB, the GNU debugger.
+
+   Copyright 2026 Free Software Foundation, Inc.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.  */
+
+struct cached_struct
+{
+  int field_one;
+  char field_two;
+};
+
+static int static_counter;
+struct cached_struct global_cached;
+
+static int
+static_helper (int x)
+{
+  static_counter += x;
+  return static_counter;
+}
+
+int
+global_function (int x)
+{
+  global_cached.field_one = static_helper (x);
+  return global_cached.field_one;
+}
+
+int
+main (void)
+{
+  return global_function (1) - 1;
+}
@@ -0,0 +1,40 @@
+/* This testcase is part of GDB, the GNU debugger.
+
+   Copyright 2026 Free Software Foundation, Inc.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.  */
+
+/* Twelve functions whose names complete from "cmpl_func_".  */
+
+#define CMPL_FUNC(x) int cmpl_func_##x (void) { return 0; }
+
+CMPL_FUNC (a)
+CMPL_FUNC (b)
+CMPL_FUNC (c)
+CMPL_FUNC (d)
+CMPL_FUNC (e)
+CMPL_FUNC (f)
+CMPL_FUNC (g)
+CMPL_FUNC (h)
+CMPL_FUNC (i)
+CMPL_FUNC (j)
+CMPL_FUNC (k)
+CMPL_FUNC (l)
+
+int
+main (void)
+{
+  return cmpl_func_a ();
+}
@@ -0,0 +1,59 @@
+/* This testcase is part of GDB, the GNU debugger.
+
+   Copyright 2026 Free Software Foundation, Inc.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.  */
+
+/* Large enough that GDB reads it a chunk at a time.  */
+
+#define BIG_ELEMENTS 16384
+
+struct big
+{
+  int data[BIG_ELEMENTS];
+};
+
+struct big big;
+
+struct big
+make_big (int seed)
+{
+  struct big result;
+  int i;
+
+  for (i = 0; i < BIG_ELEMENTS; i++)
+    result.data[i] = seed + i;
+  return result;		/* make_big return */
+}
+
+void
+marker (void)
+{
+}
+
+int
+main (void)
+{
+  int i;
+
+  for (i = 0; i < BIG_ELEMENTS; i++)
+    big.data[i] = i;
+  marker ();
+
+  big = make_big (100000);
+  big = make_big (200000);
+  marker ();
+  return 0;
+}
@@ -0,0 +1,35 @@
+/* This testcase is part of GDB, the GNU debugger.
+
+   Copyright 2026 Free Software Foundation, Inc.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.  */
+
+/* The header defines no symbols, so with stabs its psymtab is empty
+   and is thrown away by discard_psymtab.  */
+#include "psymtab-addrmap.h"
+
+extern int addrmap_func_b (int);
+
+int
+addrmap_func_a (int x)
+{
+  return x + ADDRMAP_INCREMENT;	/* addrmap_func_a line */
+}
+
+int
+main (void)
+{
+  return addrmap_func_b (addrmap_func_a (0));
+}
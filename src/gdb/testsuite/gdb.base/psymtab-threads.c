@@ -0,0 +1,54 @@
+/* This testcase is part of GDB, the GNU debugger.
+
+   Copyright 2026 Free Software Foundation, Inc.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.  */
+
+/* Several compilation units, each with global and static functions,
+   variables and types, so that "maint set dwarf2 psymtab-threads"
+   has more than one unit to hand to its helpers.  */
+
+struct unit0_struct
+{
+  int a;
+  long b;
+};
+
+typedef struct unit0_struct unit0_typedef;
+
+enum unit0_enum { unit0_red, unit0_green };
+
+extern int unit1_function (int);
+extern int unit2_function (int);
+
+static unit0_typedef unit0_static_var;
+int unit0_global_var = 3;
+static int unit0_register_var_holder;
+
+static int
+unit0_static_function (int x)
+{
+  register int r = x + unit0_global_var;
+
+  unit0_register_var_holder = r;
+  return r;
+}
+
+int
+main (void)
+{
+  unit0_static_var.a = unit0_static_function (unit0_green);
+  return unit1_function (unit0_static_var.a) + unit2_function (0) - 7;
+}
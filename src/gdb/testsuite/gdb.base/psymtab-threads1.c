@@ -0,0 +1,42 @@
+/* This testcase is part of GDB, the GNU debugger.
+
+   Copyright 2026 Free Software Foundation, Inc.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.  */
+
+struct unit1_struct
+{
+  char c;
+  struct unit1_struct *next;
+};
+
+static struct unit1_struct unit1_static_var;
+int unit1_global_var = 1;
+
+static int
+unit1_static_function (int x)
+{
+  static int unit1_function_static;
+
+  unit1_function_static += x;
+  return unit1_function_static;
+}
+
+int
+unit1_function (int x)
+{
+  unit1_static_var.c = x;
+  return unit1_static_function (x) + unit1_global_var;
+}
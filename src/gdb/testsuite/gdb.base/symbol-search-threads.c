@@ -0,0 +1,48 @@
+/* This testcase is part of GDB, the GNU debugger.
+
+   Copyright 2026 Free Software Foundation, Inc.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.  */
+
+/* Enough functions and variables that a symbol search is split
+   between several threads.  */
+
+#define FN(a, b, c, d) \
+  int search_fn_##a##b##c##d (void) { return 0; } \
+  int search_var_##a##b##c##d;
+#define FN10(a, b, c) \
+  FN (a, b, c, 0) FN (a, b, c, 1) FN (a, b, c, 2) FN (a, b, c, 3) \
+  FN (a, b, c, 4) FN (a, b, c, 5) FN (a, b, c, 6) FN (a, b, c, 7) \
+  FN (a, b, c, 8) FN (a, b, c, 9)
+#define FN100(a, b) \
+  FN10 (a, b, 0) FN10 (a, b, 1) FN10 (a, b, 2) FN10 (a, b, 3) \
+  FN10 (a, b, 4) FN10 (a, b, 5) FN10 (a, b, 6) FN10 (a, b, 7) \
+  FN10 (a, b, 8) FN10 (a, b, 9)
+#define FN1000(a) \
+  FN100 (a, 0) FN100 (a, 1) FN100 (a, 2) FN100 (a, 3) \
+  FN100 (a, 4) FN100 (a, 5) FN100 (a, 6) FN100 (a, 7) \
+  FN100 (a, 8) FN100 (a, 9)
+
+FN1000 (0)
+FN1000 (1)
+FN1000 (2)
+FN1000 (3)
+FN1000 (4)
+
+int
+main (void)
+{
+  return search_fn_0000 () + search_var_4999;
+}
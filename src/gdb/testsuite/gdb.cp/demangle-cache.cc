@@ -0,0 +1,57 @@
+/* This testcase is part of GDB, the GNU debugger.
+
+   Copyright 2026 Free Software Foundation, Inc.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.  */
+
+namespace dcache
+{
+  class shape
+  {
+  public:
+    shape (int s) : side (s) { }
+    int area (int scale) const;
+    int area (double scale) const;
+    int side;
+  };
+
+  int
+  shape::area (int scale) const
+  {
+    return side * side * scale;		/* area int */
+  }
+
+  int
+  shape::area (double scale) const
+  {
+    return (int) (side * side * scale);	/* area double */
+  }
+
+  template<typename T> T
+  twice (T x)
+  {
+    return x + x;
+  }
+}
+
+int
+main ()
+{
+  dcache::shape s (3);
+  int a = s.area (2);
+
+  a += s.area (1.5);
+  return dcache::twice (a) + (int) dcache::twice<long> (1) == 0;
+}
@@ -0,0 +1,44 @@
+/* This testcase is part of GDB, the GNU debugger.
+
+   Copyright 2026 Free Software Foundation, Inc.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.  */
+
+namespace ns1
+{
+  int global1 = 11;
+  static int static1 = 12;
+
+  struct Type1
+  {
+    int member1;
+  };
+
+  Type1 instance1 = { 13 };
+
+  int
+  func1 (int x)
+  {
+    return x + global1 + static1 + instance1.member1;
+  }
+}
+
+static int file_static1 = 14;
+
+int
+use_file_static1 (void)
+{
+  return file_static1;
+}
@@ -0,0 +1,44 @@
+/* This testcase is part of GDB, the GNU debugger.
+
+   Copyright 2026 Free Software Foundation, Inc.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.  */
+
+namespace ns2
+{
+  int global2 = 21;
+  static int static2 = 22;
+
+  struct Type2
+  {
+    int member2;
+  };
+
+  Type2 instance2 = { 23 };
+
+  int
+  func2 (int x)
+  {
+    return x + global2 + static2 + instance2.member2;
+  }
+}
+
+static int file_static2 = 24;
+
+int
+use_file_static2 (void)
+{
+  return file_static2;
+}
@@ -0,0 +1,57 @@
+/* This testcase is part of GDB, the GNU debugger.
+
+   Copyright 2026 Free Software Foundation, Inc.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+ 
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307,
+   USA.  */
+
+#include <pthread.h>
+#include <unistd.h>
+
+#define NTHREADS 4
+
+volatile int started;
+
+void
+spin_marker (void)
+{
+}
+
+void *
+thread_function (void *arg)
+{
+  __sync_fetch_and_add (&started, 1);
+  for (;;)
+    {
+      spin_marker ();
+      usleep (100000);
+    }
+  return arg;
+}
+
+int
+main (void)
+{
+  pthread_t threads[NTHREADS];
+  int i;
+
+  for (i = 0; i < NTHREADS; i++)
+    pthread_create (&threads[i], NULL, thread_function, NULL);
+
+  /* Wait to be attached to.  */
+  for (;;)
+    sleep (1);
+  return 0;
+}
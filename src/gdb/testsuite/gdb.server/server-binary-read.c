@@ -0,0 +1,50 @@
+/* This testcase is part of GDB, the GNU debugger.
+
+   Copyright 2026 Free Software Foundation, Inc.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+ 
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307,
+   USA.  */
+
+/* Memory whose bytes have to be escaped in 'x' replies, or look like
+   the packet framing: '$', '#', '}', '*' and 0x7f.  */
+
+#define SPECIAL_SIZE 1024
+
+static const unsigned char specials[] = { '$', '#', '}', '*', 0x7f };
+
+/* Byte I is I.  */
+unsigned char all_bytes[256];
+
+/* SPECIALS over and over.  */
+unsigned char special_bytes[SPECIAL_SIZE];
+
+void
+marker (void)
+{
+}
+
+int
+main (void)
+{
+  int i;
+
+  for (i = 0; i < 256; i++)
+    all_bytes[i] = i;
+  for (i = 0; i < SPECIAL_SIZE; i++)
+    special_bytes[i] = specials[i % sizeof (specials)];
+
+  marker ();
+  return 0;
+}
@@ -0,0 +1,73 @@
+/* This testcase is part of GDB, the GNU debugger.
+
+   Copyright 2026 Free Software Foundation, Inc.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+ 
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307,
+   USA.  */
+
+#include <string.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#define BULK_SIZE 65536
+
+/* Filled with (I * 7 + 3) & 0xff, then overwritten by GDB with
+   (I * 13 + 5) & 0xff.  */
+unsigned char bulk_buf[BULK_SIZE];
+
+/* A page of 0x5a bytes directly followed by an unmapped page.  */
+unsigned char *edge_page;
+long page_size;
+
+volatile int bulk_ok = -1;
+
+void
+fill_marker (void)
+{
+}
+
+void
+check_marker (void)
+{
+}
+
+int
+main (void)
+{
+  unsigned char *map;
+  int i;
+
+  for (i = 0; i < BULK_SIZE; i++)
+    bulk_buf[i] = (i * 7 + 3) & 0xff;
+
+  page_size = sysconf (_SC_PAGESIZE);
+  map = mmap (NULL, 2 * page_size, PROT_READ | PROT_WRITE,
+	      MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+  if (map == MAP_FAILED)
+    return 1;
+  munmap (map + page_size, page_size);
+  edge_page = map;
+  memset (edge_page, 0x5a, page_size);
+
+  fill_marker ();
+
+  bulk_ok = 1;
+  for (i = 0; i < BULK_SIZE; i++)
+    if (bulk_buf[i] != ((i * 13 + 5) & 0xff))
+      bulk_ok = 0;
+
+  check_marker ();
+  return 0;
+}
@@ -0,0 +1,68 @@
+/* This testcase is part of GDB, the GNU debugger.
+
+   Copyright 2026 Free Software Foundation, Inc.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307,
+   USA.  */
+
+#include <pthread.h>
+
+#define ITERATIONS 100
+#define NTHREADS 2
+
+volatile int counter;
+
+void
+thread_marker (int i)
+{
+  counter++;
+}
+
+void *
+thread_function (void *arg)
+{
+  int i;
+
+  for (i = 0; i < ITERATIONS; i++)
+    thread_marker (i);
+  return NULL;
+}
+
+void
+run_threads (void)
+{
+  pthread_t threads[NTHREADS];
+  int i;
+
+  for (i = 0; i < NTHREADS; i++)
+    pthread_create (&threads[i], NULL, thread_function, NULL);
+  for (i = 0; i < NTHREADS; i++)
+    pthread_join (threads[i], NULL);
+}
+
+void
+done (void)
+{
+}
+
+int
+main (int argc, char **argv)
+{
+  run_threads ();
+  done ();
+  run_threads ();
+  done ();
+  return 0;
+}
@@ -70,8 +70,10 @@ tui_set_source_content (struct symtab *s, int line_no, int noerror)
 	    }
 	  else
 	    {
-	      if (s->line_charpos == 0)
-		find_source_lines (s, desc);
+	      /* APPLE LOCAL begin source text cache  */
+	      /* Only find the lines the window will show.  */
+	      find_source_lines_upto (s, desc, line_no + nlines);
+	      /* APPLE LOCAL end source text cache  */
 
 	      if (line_no < 1 || line_no > s->nlines)
 		{
@@ -334,6 +336,18 @@ tui_vertical_source_scroll (enum tui_scroll_direction scroll_direction,
 	{
 	  l.line_no = content[0]->which_element.source.line_or_addr.line_no +
 	    num_to_scroll;
+	  /* APPLE LOCAL begin source text cache  */
+	  if (!s->line_charpos_complete && l.line_no > s->nlines)
+	    {
+	      int desc = open_source_file (s);
+
+	      if (desc >= 0)
+		{
+		  find_source_lines_upto (s, desc, l.line_no);
+		  close (desc);
+		}
+	    }
+	  /* APPLE LOCAL end source text cache  */
 	  if (l.line_no > s->nlines)
 	    /*line = s->nlines - win_info->generic.content_size + 1; */
 	    /*elz: fix for dts 23398 */
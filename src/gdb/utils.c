@@ -32,6 +32,8 @@
 #include <sys/resource.h>
 #include <uuid/uuid.h>
 #include <regex.h>
+/* APPLE LOCAL parallel symbol search  */
+#include "gdb_regex.h"
 
 #ifdef TUI
 #include "tui/tui.h"		/* For tui_get_command_dimension.   */
@@ -91,6 +93,9 @@ extern void free ();
 
 void (*deprecated_error_begin_hook) (void);
 
+/* APPLE LOCAL parallel psymtabs  */
+void (*helper_thread_check_hook) (void);
+
 /* Prototypes for local functions */
 
 static void vfprintf_maybe_filtered (struct ui_file *, const char *,
@@ -747,6 +752,10 @@ discard_all_intermediate_continuations (void)
 void
 vwarning (const char *string, va_list args)
 {
+  /* APPLE LOCAL parallel psymtabs  */
+  if (helper_thread_check_hook)
+    helper_thread_check_hook ();
+
   if (deprecated_warning_hook)
     (*deprecated_warning_hook) (string, args);
   else
@@ -850,6 +859,10 @@ internal_vproblem (struct internal_problem *problem,
   int dump_core_p;
   char *reason;
 
+  /* APPLE LOCAL parallel psymtabs  */
+  if (helper_thread_check_hook)
+    helper_thread_check_hook ();
+
   /* Don't allow infinite error/warning recursion.  */
   {
     static char msg[] = "Recursive internal problem.\n";
@@ -4010,15 +4023,41 @@ re_comp (const char *str)
 
 int
 re_exec (const char *str)
+{
+  /* APPLE LOCAL parallel symbol search  */
+  return re_exec_buf (&rebuf, str);
+}
+
+/* APPLE LOCAL begin parallel symbol search  */
+/* Like re_comp, but compile STR into RE, which the caller must
+   regfree, instead of the one pattern re_comp and re_exec share.
+   Several threads matching the same expression each need a copy of
+   their own: regexec lets only one thread at a time use a compiled
+   pattern.  */
+
+const char *
+re_comp_buf (regex_t *re, const char *str)
+{
+  if (regcomp (re, str, regex_fmt) != 0)
+    return "re_comp failed on given pattern";
+  return NULL;
+}
+
+/* Like re_exec, but match STR against RE, compiled by
+   re_comp_buf.  */
+
+int
+re_exec_buf (regex_t *re, const char *str)
 {
   regmatch_t matches[10];
   memset (matches, 0, sizeof (regmatch_t) * 10);
-  if (regexec (&rebuf, str, 10, matches, 0) != 0)
+  if (regexec (re, str, 10, matches, 0) != 0)
     return 0;
   if (matches[0].rm_so == matches[0].rm_eo)
     return 0;
   return 1;
 }
+/* APPLE LOCAL end parallel symbol search  */
 
 /* Some people use re_search() as a simpler way to call regexec() without
    really needing the "find a match, now find the next match, etc" behavior
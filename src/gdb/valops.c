@@ -604,11 +604,13 @@ value_at_lazy (struct type *type, CORE_ADDR addr)
 int
 value_fetch_lazy (struct value *val)
 {
-  CORE_ADDR addr = VALUE_ADDRESS (val) + value_offset (val);
   int length = TYPE_LENGTH (value_enclosing_type (val));
 
+  /* APPLE LOCAL begin partial lazy values  */
+  /* Only read what value_fetch_lazy_range hasn't already.  */
   if (length)
-    read_memory (addr, value_contents_all_raw (val), length);
+    value_fetch_lazy_range (val, 0, length);
+  /* APPLE LOCAL end partial lazy values  */
 
   set_value_lazy (val, 0);
   return 0;
@@ -34,6 +34,8 @@
 #include "valprint.h"
 #include "floatformat.h"
 #include "doublest.h"
+/* APPLE LOCAL partial lazy values  */
+#include "c-lang.h"
 
 #include <errno.h>
 /* APPLE LOCAL: for isprint() */
@@ -190,6 +192,102 @@ show_addressprint (struct ui_file *file, int from_tty,
    or the data is going to have to be passed into here already converted
    to the host byte ordering, whichever is more convenient. */
 
+/* APPLE LOCAL begin partial lazy values  */
+/* The lazy value whose contents are being printed, if any.  Rather
+   than reading all of it first, val_print reads the parts of it that
+   get printed, with val_print_fetch.  */
+static struct value *val_print_lazy_value;
+
+/* Make sure the LENGTH bytes at VALADDR have been read, if they are
+   part of the contents of the lazy value being printed.  */
+
+void
+val_print_fetch (const gdb_byte *valaddr, int length)
+{
+  const gdb_byte *contents;
+
+  if (val_print_lazy_value == NULL || !value_lazy (val_print_lazy_value))
+    return;
+
+  contents = value_contents_all_raw (val_print_lazy_value);
+  if (valaddr >= contents
+      && (valaddr < contents
+	  + TYPE_LENGTH (value_enclosing_type (val_print_lazy_value))))
+    value_fetch_lazy_range (val_print_lazy_value, valaddr - contents, length);
+}
+
+/* Read the parts of an object of TYPE at VALADDR, in the lazy value
+   being printed, that printing it looks at directly.  The elements
+   of an array, and the members of a structure other than bitfields,
+   are read by the val_print calls that print them.  Anything that the
+   C printers would not print that way is read in full.  */
+
+static void
+val_print_fetch_object (struct type *type, const gdb_byte *valaddr)
+{
+  int i;
+
+  if (current_language->la_val_print != c_val_print)
+    {
+      value_fetch_lazy (val_print_lazy_value);
+      return;
+    }
+
+  switch (TYPE_CODE (type))
+    {
+    case TYPE_CODE_ARRAY:
+      break;
+
+    case TYPE_CODE_STRUCT:
+    case TYPE_CODE_UNION:
+      /* Base classes can be anywhere in the object.  */
+      if (TYPE_N_BASECLASSES (type) > 0 || TYPE_HAS_VTABLE (type))
+	value_fetch_lazy (val_print_lazy_value);
+      else if (vtblprint && cp_is_vtbl_ptr_type (type))
+	val_print_fetch (valaddr, TYPE_LENGTH (type));
+      else
+	for (i = 0; i < TYPE_NFIELDS (type); i++)
+	  if (!TYPE_FIELD_STATIC (type, i) && TYPE_FIELD_PACKED (type, i))
+	    val_print_fetch (valaddr + TYPE_FIELD_BITPOS (type, i) / 8,
+			     sizeof (ULONGEST));
+      break;
+
+    default:
+      val_print_fetch (valaddr, TYPE_LENGTH (type));
+      break;
+    }
+}
+
+static void
+restore_val_print_lazy_value (void *arg)
+{
+  val_print_lazy_value = arg;
+}
+
+/* Like val_print, but print from the contents of VAL, reading only
+   the parts of it that get printed if it is lazy.  */
+
+int
+val_print_value (struct type *type, struct value *val, int embedded_offset,
+		 CORE_ADDR address, struct ui_file *stream, int format,
+		 int deref_ref, int recurse, enum val_prettyprint pretty)
+{
+  struct cleanup *old_chain;
+  int ret;
+
+  if (!value_lazy (val))
+    return val_print (type, value_contents_all (val), embedded_offset,
+		      address, stream, format, deref_ref, recurse, pretty);
+
+  old_chain = make_cleanup (restore_val_print_lazy_value,
+			    val_print_lazy_value);
+  val_print_lazy_value = val;
+  ret = val_print (type, value_contents_all_raw (val), embedded_offset,
+		   address, stream, format, deref_ref, recurse, pretty);
+  do_cleanups (old_chain);
+  return ret;
+}
+/* APPLE LOCAL end partial lazy values  */
 
 int
 val_print (struct type *type, const gdb_byte *valaddr, int embedded_offset,
@@ -215,6 +313,11 @@ val_print (struct type *type, const gdb_byte *valaddr, int embedded_offset,
       return (0);
     }
 
+  /* APPLE LOCAL begin partial lazy values  */
+  if (val_print_lazy_value != NULL)
+    val_print_fetch_object (real_type, valaddr + embedded_offset);
+  /* APPLE LOCAL end partial lazy values  */
+
   return (LA_VAL_PRINT (type, valaddr, embedded_offset, address,
 			stream, format, deref_ref, recurse, pretty));
 }
@@ -275,9 +378,10 @@ common_val_print (struct value *val, struct ui_file *stream, int format,
   if (!value_check_printable (val, stream))
     return 0;
 
-  return val_print (value_type (val), value_contents_all (val),
-		    value_embedded_offset (val), VALUE_ADDRESS (val),
-		    stream, format, deref_ref, recurse, pretty);
+  /* APPLE LOCAL partial lazy values  */
+  return val_print_value (value_type (val), val,
+			  value_embedded_offset (val), VALUE_ADDRESS (val),
+			  stream, format, deref_ref, recurse, pretty);
 }
 
 /* Print the value VAL in C-ish syntax on stream STREAM.
@@ -1065,14 +1169,22 @@ val_print_array_elements (struct type *type, const gdb_byte *valaddr,
 	}
       wrap_here (n_spaces (2 + 2 * recurse));
 
+      /* APPLE LOCAL begin partial lazy values  */
+      /* If the array is part of a large lazy value, only read the
+	 elements we print, or count as repeats of one we print.  */
+      val_print_fetch (val_elt_addr (type, valaddr, i), eltlen);
       rep1 = i + 1;
       reps = 1;
-      while ((rep1 < len) &&
-	     !memcmp (val_elt_addr (type, valaddr, i), val_elt_addr (type, valaddr, rep1), eltlen))
+      while (rep1 < len)
 	{
+	  val_print_fetch (val_elt_addr (type, valaddr, rep1), eltlen);
+	  if (memcmp (val_elt_addr (type, valaddr, i),
+		      val_elt_addr (type, valaddr, rep1), eltlen) != 0)
+	    break;
 	  ++reps;
 	  ++rep1;
 	}
+      /* APPLE LOCAL end partial lazy values  */
 
       if (reps > repeat_count_threshold)
 	{
@@ -50,6 +50,9 @@ extern int output_format;
 
 extern int stop_print_at_null;	/* Stop printing at null char? */
 
+/* APPLE LOCAL partial lazy values  */
+extern void val_print_fetch (const gdb_byte *valaddr, int length);
+
 extern void val_print_array_elements (struct type *, const gdb_byte *,
 				      CORE_ADDR, struct ui_file *, int,
 				      int, int, enum val_prettyprint,
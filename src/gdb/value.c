@@ -165,6 +165,14 @@ struct value
   int var_status;
   /* APPLE LOCAL end variable initialized status.  */
 
+  /* APPLE LOCAL begin partial lazy values  */
+  /* If nonzero, the offset from the start of the contents of a bitmap
+     saying which VALUE_FETCH_CHUNK-byte chunks of this lazy value have
+     been read already; see value_fetch_lazy_range.  Only values of at
+     least VALUE_FETCH_MAP_MIN bytes have one.  */
+  int fetch_map_offset;
+  /* APPLE LOCAL end partial lazy values  */
+
   /* Actual contents of the value.  For use of this value; setting it
      uses the stuff above.  Not valid if lazy is nonzero.  Target
      byte-order.  We force it to be aligned properly for any possible
@@ -182,6 +190,17 @@ struct value
      them.  */
 };
 
+/* APPLE LOCAL begin partial lazy values  */
+/* Large lazy values are read from the inferior this many bytes at a
+   time, as their parts are needed.  */
+#define VALUE_FETCH_CHUNK 4096
+#define VALUE_FETCH_MAP_MIN (4 * VALUE_FETCH_CHUNK)
+
+/* The size of the fetch map of a value LENGTH bytes long.  */
+#define VALUE_FETCH_MAP_SIZE(length) \
+  (((length) + VALUE_FETCH_CHUNK * 8 - 1) / (VALUE_FETCH_CHUNK * 8))
+/* APPLE LOCAL end partial lazy values  */
+
 struct cached_value
 {
   char *name;
@@ -297,8 +316,18 @@ allocate_value (struct type *type)
 {
   struct value *val;
   struct type *atype = check_typedef (type);
-
-  val = (struct value *) xzalloc (sizeof (struct value) + TYPE_LENGTH (atype));
+  /* APPLE LOCAL begin partial lazy values  */
+  int length = TYPE_LENGTH (atype);
+  int map_size = 0;
+
+  /* Large values get a map of which parts have been read, after the
+     contents.  */
+  if (length >= VALUE_FETCH_MAP_MIN)
+    map_size = VALUE_FETCH_MAP_SIZE (length);
+
+  val = (struct value *) xzalloc (sizeof (struct value) + length + map_size);
+  val->fetch_map_offset = map_size != 0 ? length : 0;
+  /* APPLE LOCAL end partial lazy values  */
   val->next = all_values;
   all_values = val;
   val->type = type;
@@ -427,7 +456,79 @@ void
 set_value_lazy (struct value *value, int val)
 {
   value->lazy = val;
+  /* APPLE LOCAL begin partial lazy values  */
+  /* Anything read before is out of date now.  */
+  if (val && value->fetch_map_offset != 0)
+    memset (value->aligner.contents + value->fetch_map_offset, 0,
+	    VALUE_FETCH_MAP_SIZE (value->fetch_map_offset));
+  /* APPLE LOCAL end partial lazy values  */
+}
+
+/* APPLE LOCAL begin partial lazy values  */
+/* Make sure that bytes OFFSET to OFFSET + LENGTH - 1 of the contents
+   of VALUE (counted from the start, as for value_contents_all) have
+   been read from the inferior, if VALUE is lazy.  A large value
+   remembers which chunks of it have been read, so only the ones that
+   haven't are read now, and the value stays lazy until all of it has
+   been read; anything smaller is read in full.  */
+
+void
+value_fetch_lazy_range (struct value *value, int offset, int length)
+{
+  CORE_ADDR addr = VALUE_ADDRESS (value) + value_offset (value);
+  int total = TYPE_LENGTH (value_enclosing_type (value));
+  gdb_byte *contents = value->aligner.contents;
+  gdb_byte *map;
+  int chunk, last, start;
+
+  if (!value->lazy)
+    return;
+
+  if (value->fetch_map_offset == 0)
+    {
+      if (total)
+	read_memory (addr, contents, total);
+      value->lazy = 0;
+      return;
+    }
+
+  if (offset < 0)
+    {
+      length += offset;
+      offset = 0;
+    }
+  if (length > total - offset)
+    length = total - offset;
+  if (length <= 0)
+    return;
+
+  map = contents + value->fetch_map_offset;
+  chunk = offset / VALUE_FETCH_CHUNK;
+  last = (offset + length - 1) / VALUE_FETCH_CHUNK;
+  while (chunk <= last)
+    {
+      int lo, hi;
+
+      if (map[chunk / 8] & (1 << (chunk % 8)))
+	{
+	  chunk++;
+	  continue;
+	}
+
+      /* Read this chunk and any unread ones after it in one go.  */
+      for (start = chunk;
+	   chunk <= last && !(map[chunk / 8] & (1 << (chunk % 8)));
+	   chunk++)
+	;
+      lo = start * VALUE_FETCH_CHUNK;
+      hi = min (chunk * VALUE_FETCH_CHUNK, total);
+      read_memory (addr + lo, contents + lo, hi - lo);
+
+      for (; start < chunk; start++)
+	map[start / 8] |= 1 << (start % 8);
+    }
 }
+/* APPLE LOCAL end partial lazy values  */
 
 const gdb_byte *
 value_contents (struct value *value)
@@ -682,6 +783,8 @@ record_latest_value (struct value *val)
      In particular, "set $1 = 50" should not affect the variable from which
      the value was taken, and fast watchpoints should be able to assume that
      a value on the value history never changes.  */
+  /* APPLE LOCAL partial lazy values: This reads every chunk of a
+     large value that has not been read yet.  */
   if (value_lazy (val))
     value_fetch_lazy (val);
   /* We preserve VALUE_LVAL so that the user can find out where it was fetched
@@ -1281,6 +1384,11 @@ value_change_enclosing_type (struct value *val, struct type *new_encl_type)
       new_val = (struct value *) xrealloc (val, sizeof (struct value) + TYPE_LENGTH (new_encl_type));
 
       new_val->enclosing_type = new_encl_type;
+      /* APPLE LOCAL begin partial lazy values  */
+      /* There is no room for the fetch map any more; if the value is
+	 lazy, it will be read in full when it is needed.  */
+      new_val->fetch_map_offset = 0;
+      /* APPLE LOCAL end partial lazy values  */
  
       /* We have to make sure this ends up in the same place in the value
 	 chain as the original copy, so it's clean-up behavior is the same. 
@@ -1322,11 +1430,18 @@ value_primitive_field (struct value *arg1, int offset,
 
   if (TYPE_FIELD_BITSIZE (arg_type, fieldno))
     {
+      /* APPLE LOCAL begin partial lazy values  */
+      /* Only read the bytes unpack_field_as_long looks at.  */
+      value_fetch_lazy_range (arg1,
+			      (value_embedded_offset (arg1) + offset
+			       + TYPE_FIELD_BITPOS (arg_type, fieldno) / 8),
+			      sizeof (ULONGEST));
       v = value_from_longest (type,
 			      unpack_field_as_long (arg_type,
-						    value_contents (arg1)
+						    value_contents_raw (arg1)
 						    + offset,
 						    fieldno));
+      /* APPLE LOCAL end partial lazy values  */
       v->bitpos = TYPE_FIELD_BITPOS (arg_type, fieldno) % 8;
       v->bitsize = TYPE_FIELD_BITSIZE (arg_type, fieldno);
       v->offset = value_offset (arg1) + offset
@@ -208,6 +208,9 @@ extern gdb_byte *value_contents_all_raw (struct value *);
 extern const gdb_byte *value_contents_all (struct value *);
 
 extern int value_fetch_lazy (struct value *val);
+/* APPLE LOCAL partial lazy values  */
+extern void value_fetch_lazy_range (struct value *value, int offset,
+				    int length);
 extern int value_contents_equal (struct value *val1, struct value *val2);
 
 /* APPLE LOCAL begin variable opt states.  */
@@ -531,6 +534,14 @@ extern int val_print (struct type *type, const gdb_byte *valaddr,
 		      int deref_ref, int recurse,
 		      enum val_prettyprint pretty);
 
+/* APPLE LOCAL begin partial lazy values  */
+extern int val_print_value (struct type *type, struct value *val,
+			    int embedded_offset, CORE_ADDR address,
+			    struct ui_file *stream, int format,
+			    int deref_ref, int recurse,
+			    enum val_prettyprint pretty);
+/* APPLE LOCAL end partial lazy values  */
+
 extern int common_val_print (struct value *val,
 			     struct ui_file *stream, int format,
 			     int deref_ref, int recurse,